@@ -57,6 +57,12 @@ typedef enum aom_img_fmt {
   AOM_IMG_FMT_YV1216 = AOM_IMG_FMT_YV12 | AOM_IMG_FMT_HIGHBITDEPTH,
   AOM_IMG_FMT_I42216 = AOM_IMG_FMT_I422 | AOM_IMG_FMT_HIGHBITDEPTH,
   AOM_IMG_FMT_I44416 = AOM_IMG_FMT_I444 | AOM_IMG_FMT_HIGHBITDEPTH,
+/*!\brief Allows detection of the presence of AOM_IMG_FMT_P010 at compile time.
+ */
+#define AOM_HAVE_IMG_FMT_P010 1
+  /*!\brief 4:2:0 16-bit with U and V interleaved, with the samples in the
+   * most significant bits */
+  AOM_IMG_FMT_P010 = AOM_IMG_FMT_NV12 | AOM_IMG_FMT_HIGHBITDEPTH,
 } aom_img_fmt_t; /**< alias for enum aom_img_fmt */
 
 /*!\brief List of supported color primaries */
@@ -45,6 +45,75 @@ extern aom_codec_iface_t *aom_codec_av1_dx(void);
 
 /*!@} - end algorithm interface member group */
 
+/*!\brief A pool of threads that several decoder instances can share.
+ *
+ * See AV1D_SET_THREAD_POOL.
+ */
+typedef struct aom_codec_thread_pool aom_codec_thread_pool_t;
+
+/*!\brief Creates a thread pool.
+ *
+ * \param[in] num_threads Number of threads of the pool, at least 1
+ *
+ * \return The thread pool, or NULL on error or if the library was built
+ * without multithreading support.
+ */
+aom_codec_thread_pool_t *aom_codec_thread_pool_create(int num_threads);
+
+/*!\brief Destroys a thread pool.
+ *
+ * All the decoders that use the pool must have been destroyed first.
+ *
+ * \param[in] pool The thread pool, or NULL
+ */
+void aom_codec_thread_pool_destroy(aom_codec_thread_pool_t *pool);
+
+/*!\brief A frame of one stream of a batch, see aom_codec_decode_batch().
+ */
+typedef struct aom_codec_decode_batch_item {
+  /*! The decoder of the stream, initialized with aom_codec_av1_dx(). */
+  aom_codec_ctx_t *ctx;
+  /*! The data of the frame, as passed to aom_codec_decode(). */
+  const uint8_t *data;
+  /*! Size of data in bytes. */
+  size_t data_sz;
+  /*! Application data associated with the frame, as passed to
+   * aom_codec_decode(). */
+  void *user_priv;
+  /*! Set to the result of decoding the frame. */
+  aom_codec_err_t res;
+} aom_codec_decode_batch_item_t;
+
+/*!\brief Decodes a frame of each of several streams at once.
+ *
+ * Decodes the frame of each item with aom_codec_decode(), as one job per
+ * stream queued on the thread pool. The calling thread decodes the first
+ * stream and then helps with the jobs that have not started yet. The tile,
+ * loop filter and other jobs of the decoders attached to the same pool with
+ * AV1D_SET_THREAD_POOL are queued on it as well, so that the threads of the
+ * pool are shared by all the streams of the batch even when each stream has
+ * a single tile. The decoded frames are then retrieved with
+ * aom_codec_get_frame() on each decoder, as usual.
+ *
+ * \param[in]     pool      The thread pool, or NULL to decode the frames one
+ *                          after the other on the calling thread
+ * \param[in,out] items     The frames to decode, at most one per decoder
+ * \param[in]     num_items Number of items
+ *
+ * \retval #AOM_CODEC_OK
+ *     All the frames were decoded.
+ * \retval #AOM_CODEC_INVALID_PARAM
+ *     An item has no AV1 decoder, or two items have the same decoder. No
+ *     frame was decoded.
+ * \retval #AOM_CODEC_MEM_ERROR
+ *     Memory allocation failed. No frame was decoded.
+ * \return The error of the first item that failed to decode otherwise, see
+ *     the res field of each item and aom_codec_error() on its decoder.
+ */
+aom_codec_err_t aom_codec_decode_batch(aom_codec_thread_pool_t *pool,
+                                       aom_codec_decode_batch_item_t *items,
+                                       int num_items);
+
 /** Data structure that stores bit accounting for debug
  */
 typedef struct Accounting Accounting;
@@ -183,6 +252,168 @@ typedef struct av1_ext_ref_frame {
   int num;
 } av1_ext_ref_frame_t;
 
+/*!\brief Structure to describe a decoded tile group.
+ *
+ * Defines a structure to pass to the callback set with
+ * AV1D_SET_TILE_GROUP_CALLBACK.
+ */
+typedef struct aom_tile_group_info {
+  /*! Index of the first tile of the tile group, in raster order. */
+  int start_tile;
+  /*! Index of the last tile of the tile group, in raster order. */
+  int end_tile;
+  /*! Number of tiles in the frame. */
+  int num_tiles;
+  /*! The frame being decoded. The tiles of the tile group are reconstructed,
+   * but the in-loop filters have only run over the whole frame once
+   * end_tile is num_tiles - 1. Film grain is never applied. */
+  const aom_image_t *img;
+} aom_tile_group_info_t;
+
+/*!\brief Callback invoked after each tile group is decoded. */
+typedef void (*aom_tile_group_cb_fn_t)(void *priv,
+                                       const aom_tile_group_info_t *info);
+
+/*!\brief Structure to hold the tile group callback and its context.
+ *
+ * Defines a structure to pass to AV1D_SET_TILE_GROUP_CALLBACK.
+ */
+typedef struct aom_tile_group_cb {
+  /*! Tile group callback, or NULL to remove it. */
+  aom_tile_group_cb_fn_t cb;
+  /*! Context passed to the callback. */
+  void *priv;
+} aom_tile_group_cb_t;
+
+/*!\brief Structure to hold the time spent in each decoding stage.
+ *
+ * Defines a structure to pass to AV1D_GET_STAGE_STATS. All times are in
+ * microseconds and cover the frames decoded by the last call to
+ * aom_codec_decode(), and the film grain added to the frames returned by
+ * aom_codec_get_frame() since.
+ */
+typedef struct aom_decode_stage_stats {
+  /*! Wall time spent parsing OBUs and headers. */
+  int64_t obu_parse_us;
+  /*! Wall time spent decoding tiles, i.e. entropy decoding and
+   * reconstruction. When row-mt pipelines the loop filter with tile
+   * decoding, it also includes the loop filter. */
+  int64_t tile_decode_us;
+  /*! Time spent entropy decoding tiles, summed over the worker threads. Only
+   * measured with row-mt, which runs entropy decoding and reconstruction as
+   * separate jobs; 0 otherwise. */
+  int64_t entropy_decode_us;
+  /*! Time spent reconstructing tiles, summed over the worker threads. Only
+   * measured with row-mt; 0 otherwise. */
+  int64_t reconstruction_us;
+  /*! Wall time spent in the deblocking loop filter, when it runs after tile
+   * decoding. */
+  int64_t loop_filter_us;
+  /*! Wall time spent in CDEF. */
+  int64_t cdef_us;
+  /*! Wall time spent in superres upscaling. */
+  int64_t superres_us;
+  /*! Wall time spent in loop restoration. */
+  int64_t loop_restoration_us;
+  /*! Wall time spent adding film grain. */
+  int64_t film_grain_us;
+  /*! Time the tile workers were running jobs during tile decoding, summed
+   * over the workers, including the calling thread. */
+  int64_t worker_busy_us;
+  /*! Time the tile workers were idle during tile decoding, summed over the
+   * workers: waiting for a job, for the rows a job depends on, or for the
+   * other workers to finish. */
+  int64_t worker_idle_us;
+} aom_decode_stage_stats_t;
+
+/*!\brief Frames decoded by the AV1 decoder
+ *
+ * Passed to AV1D_SET_DECODE_MODE. In the modes other than
+ * AOM_DECODE_ALL_FRAMES, the decoder still reads the headers of every frame
+ * to track the reference frames, but skips the tiles of the frames the mode
+ * leaves out. Those frames are not returned by aom_codec_get_frame(), nor
+ * are the frames shown later with show_existing_frame from their buffers.
+ */
+typedef enum aom_decode_mode {
+  /*!\brief Decode every frame. This is the default. */
+  AOM_DECODE_ALL_FRAMES = 0,
+  /*!\brief Skip the frames that do not update any reference frame, so that
+   * no other frame depends on them. */
+  AOM_DECODE_REFERENCE_FRAMES = 1,
+  /*!\brief Decode only key frames and intra-only frames. */
+  AOM_DECODE_INTRA_FRAMES = 2,
+} aom_decode_mode_t;
+
+/*!\brief Motion vector in 1/8 luma sample units */
+typedef struct aom_mi_mv {
+  int16_t row; /**< Vertical component */
+  int16_t col; /**< Horizontal component */
+} aom_mi_mv_t;
+
+/*!\brief Read-only view of the mode info of a frame
+ *
+ * Defines a structure to pass to AV1D_GET_FRAME_MI_INFO. Each array has one
+ * entry per 4x4 luma block (mode info unit) of the coded frame, before any
+ * superres upscaling, in raster order with a stride of stride entries. The
+ * entries of a block repeat its values over the units it covers. The values
+ * of bsize, mode and tx_size are those of the BLOCK_SIZE, PREDICTION_MODE and
+ * TX_SIZE enums of av1/common/enums.h.
+ *
+ * The arrays are owned by the decoder and are valid until the next call to
+ * aom_codec_decode() or aom_codec_destroy().
+ */
+typedef struct aom_frame_mi_info {
+  int mi_rows; /**< Height of the frame in mode info units */
+  int mi_cols; /**< Width of the frame in mode info units */
+  int stride;  /**< Distance in entries between two rows of each array */
+  const uint8_t *bsize; /**< Size of the block covering each unit */
+  const uint8_t *mode;  /**< Luma prediction mode */
+  /*! Reference frames, MV_REFERENCE_FRAME values: 0 for intra prediction,
+   * 1 (LAST_FRAME) to 7 (ALTREF_FRAME), and -1 for no second reference. */
+  const int8_t *ref_frame[2];
+  /*! Motion vectors of the references. Only valid for inter blocks. */
+  const aom_mi_mv_t *mv[2];
+  /*! Quantizer index, including delta q and the segment feature. */
+  const uint8_t *qindex;
+  /*! Luma transform size. For a block without residual, the largest
+   * transform size of the block. */
+  const uint8_t *tx_size;
+  const uint8_t *skip_txfm;  /**< 1 if the block has no residual */
+  const uint8_t *segment_id; /**< Segment of the block */
+} aom_frame_mi_info_t;
+
+/*!\brief Largest frames the decoder allocates its buffers for
+ *
+ * Defines a structure to pass to AV1D_SET_FRAME_LIMITS.
+ */
+typedef struct aom_dec_frame_limits {
+  /*! Largest frame width, after any superres upscaling, in pixels. */
+  unsigned int max_width;
+  /*! Largest frame height in pixels. */
+  unsigned int max_height;
+  /*! Largest number of tiles of a frame, or 0 to allocate the tile data for
+   * the number of tiles of each frame as it comes. */
+  unsigned int max_tiles;
+} aom_dec_frame_limits_t;
+
+/*!\brief Memory held by the decoder
+ *
+ * Defines a structure to pass to AV1D_GET_MEMORY_FOOTPRINT. All sizes are in
+ * bytes.
+ */
+typedef struct aom_dec_memory_footprint {
+  /*! Frame buffers allocated by the decoder, with the motion vectors and
+   * segmentation maps stored with each frame. Frame buffers obtained from an
+   * aom_get_frame_buffer_cb_fn_t callback are not included. */
+  uint64_t frame_buffers;
+  /*! Buffers whose size depends on the frame size or the tile layout: mode
+   * info, temporal motion vectors, entropy contexts, tile data, thread
+   * synchronization, and the CDEF and loop restoration buffers. */
+  uint64_t context_buffers;
+  /*! Sum of frame_buffers and context_buffers. */
+  uint64_t total;
+} aom_dec_memory_footprint_t;
+
 /*!\enum aom_dec_control_id
  * \brief AOM decoder control functions
  *
@@ -466,6 +697,157 @@ enum aom_dec_control_id {
    * be used.
    */
   AV1D_GET_MI_INFO,
+
+  /*!\brief Codec control function to set the number of frames decoded in
+   * parallel, unsigned int parameter
+   *
+   * Values 0 and 1 disable frame parallel decoding, which is the default.
+   * Larger values are limited by the number of threads in the decoder
+   * configuration, which are divided among the frames in flight. Each output
+   * frame is returned by aom_codec_get_frame() after the given number of
+   * temporal units minus one have been decoded, so the remaining frames must
+   * be flushed with aom_codec_decode(ctx, NULL, 0, NULL) at the end of the
+   * stream. Frame parallel decoding is not available with the large scale
+   * tile mode, when outputting all layers or with streaming decoding.
+   *
+   * \attention This must be set before the first call to aom_codec_decode().
+   */
+  AV1D_SET_FRAME_PARALLEL,
+
+  /*!\brief Codec control function to add the film grain in place, int
+   * parameter
+   *
+   * When set to nonzero, the film grain is added directly to the decoded frame
+   * buffer of an output frame that is not used as a reference, instead of
+   * to a copy in a buffer obtained from the frame buffer callback. The output
+   * image is then the decoded frame buffer itself, including when it comes
+   * from an external frame buffer. Frames that are still referenced always
+   * get the grain in a separate buffer so that the references stay unmodified.
+   * The images returned by AV1_GET_NEW_FRAME_IMAGE and
+   * AV1_COPY_NEW_FRAME_IMAGE include the grain added in place. The default
+   * value is 0.
+   */
+  AV1D_SET_FILM_GRAIN_IN_PLACE,
+
+  /*!\brief Codec control function to enable streaming decoding, int
+   * parameter
+   *
+   * When set to nonzero, aom_codec_decode() accepts any whole number of OBUs
+   * instead of a complete temporal unit. The tile groups received are decoded
+   * immediately. If the data ends before the last tile group of a frame, the
+   * call returns AOM_CODEC_OK without an output frame, and the next call
+   * continues the frame with the following OBUs. The first call must contain
+   * the sequence header and the first frame header. Streaming decoding is not
+   * available with Annex B streams or the large scale tile mode, and it
+   * disables frame parallel decoding. The default value is 0.
+   *
+   * \attention This must be set before the first call to aom_codec_decode().
+   */
+  AV1D_SET_STREAMING_DECODE,
+
+  /*!\brief Codec control function to set a callback that is invoked after
+   * each tile group is decoded, aom_tile_group_cb_t* parameter
+   *
+   * The callback runs on the thread that called aom_codec_decode(), before
+   * that call returns. It is not invoked in frame parallel mode, where the
+   * tile groups are decoded by the frame workers.
+   */
+  AV1D_SET_TILE_GROUP_CALLBACK,
+
+  /*!\brief Codec control function to run the tile decoding, loop filter,
+   * CDEF, loop restoration, superres and film grain jobs of the decoder on a
+   * shared thread pool, aom_codec_thread_pool_t* parameter
+   *
+   * By default, each decoder instance creates cfg.threads - 1 threads of its
+   * own. With a thread pool, the decoder creates no threads for these jobs
+   * and queues them on the pool instead, which bounds the number of threads
+   * of a process that runs many decoders. cfg.threads still limits the
+   * number of jobs a decoder runs at once. The pool gives the next free
+   * thread to the decoder with the fewest jobs running. The pool must
+   * outlive the decoder. NULL restores the default. Frame parallel decoding
+   * still creates one thread per frame worker.
+   *
+   * \attention This must be set before the first call to aom_codec_decode().
+   */
+  AV1D_SET_THREAD_POOL,
+
+  /*!\brief Codec control function to measure the time spent in each
+   * decoding stage, int parameter
+   *
+   * When set to nonzero, the decoder times its stages so that
+   * AV1D_GET_STAGE_STATS can return them. The default value is 0, which
+   * avoids the overhead of the timers.
+   */
+  AV1D_SET_STAGE_STATS,
+
+  /*!\brief Codec control function to get the time spent in each decoding
+   * stage, aom_decode_stage_stats_t* parameter
+   *
+   * Returns AOM_CODEC_ERROR if AV1D_SET_STAGE_STATS is not enabled, and
+   * AOM_CODEC_INCAPABLE in frame parallel mode, where several frames are
+   * decoded at once.
+   */
+  AV1D_GET_STAGE_STATS,
+
+  /*!\brief Codec control function to select the frames that are decoded,
+   * aom_decode_mode_t parameter
+   *
+   * Skipping frames makes seeking and thumbnail extraction faster. The
+   * default value is AOM_DECODE_ALL_FRAMES. The mode applies from the next
+   * frame on, so a new mode that decodes more frames should be set at a key
+   * frame, as the frames skipped before leave invalid references behind.
+   */
+  AV1D_SET_DECODE_MODE,
+
+  /*!\brief Codec control function to get the mode info of the last decoded
+   * frame, aom_frame_mi_info_t* parameter
+   *
+   * The arrays are filled on the first call after a decode, so the control
+   * costs nothing when unused. Unlike AV1D_GET_MI_INFO, it covers the whole
+   * frame in one call and needs no CONFIG_INSPECTION build. Returns
+   * AOM_CODEC_ERROR if the last call to aom_codec_decode() ended with a frame
+   * whose tiles were not decoded (show_existing_frame, or a frame skipped by
+   * AV1D_SET_DECODE_MODE), or in large scale tile mode. Returns
+   * AOM_CODEC_INCAPABLE in frame parallel mode.
+   */
+  AV1D_GET_FRAME_MI_INFO,
+
+  /*!\brief Codec control function to set the format of the output frames,
+   * aom_img_fmt_t parameter
+   *
+   * With AOM_IMG_FMT_NV12 or AOM_IMG_FMT_P010, the 4:2:0 frames are returned
+   * with interleaved chroma: in AOM_IMG_FMT_NV12 if they are decoded to 8-bit
+   * buffers, and in AOM_IMG_FMT_P010 if they are decoded to 16-bit buffers.
+   * The decoder converts each frame with its worker threads into a frame
+   * buffer obtained from the application, so renderers that need those
+   * formats do not convert the frames themselves. The frames of other
+   * formats, and the tile lists of large scale tile mode, are returned
+   * unchanged. The default value is AOM_IMG_FMT_NONE, which returns the
+   * frames in the planar format they are decoded to.
+   */
+  AV1D_SET_OUTPUT_FORMAT,
+
+  /*!\brief Codec control function to declare the largest frames of the
+   * stream, aom_dec_frame_limits_t* parameter
+   *
+   * The buffers that depend on the frame size or the tile count are then
+   * allocated for these limits by the first frame and reused by every
+   * smaller frame, so that streams which switch resolution, such as
+   * adaptive bitrate streams, do not reallocate them. Frames beyond the
+   * limits fail to decode with AOM_CODEC_UNSUP_BITSTREAM. The thread count
+   * is the one of aom_codec_dec_cfg_t. Must be called before the first call
+   * to aom_codec_decode(), else AOM_CODEC_ERROR is returned. Without limits,
+   * these buffers only grow, when a frame needs more than the earlier ones.
+   */
+  AV1D_SET_FRAME_LIMITS,
+
+  /*!\brief Codec control function to get the memory held by the decoder,
+   * aom_dec_memory_footprint_t* parameter
+   *
+   * Returns AOM_CODEC_INCAPABLE in frame parallel mode, where the frame
+   * workers may be decoding.
+   */
+  AV1D_GET_MEMORY_FOOTPRINT,
 };
 
 /*!\cond */
@@ -598,6 +980,42 @@ AOM_CTRL_USE_TYPE(AOMD_GET_ORDER_HINT, unsigned int *)
 // The AOM_CTRL_USE_TYPE macro can't be used with AV1D_GET_MI_INFO because
 // AV1D_GET_MI_INFO takes more than one parameter.
 #define AOM_CTRL_AV1D_GET_MI_INFO
+
+AOM_CTRL_USE_TYPE(AV1D_SET_FRAME_PARALLEL, unsigned int)
+#define AOM_CTRL_AV1D_SET_FRAME_PARALLEL
+
+AOM_CTRL_USE_TYPE(AV1D_SET_FILM_GRAIN_IN_PLACE, int)
+#define AOM_CTRL_AV1D_SET_FILM_GRAIN_IN_PLACE
+
+AOM_CTRL_USE_TYPE(AV1D_SET_STREAMING_DECODE, int)
+#define AOM_CTRL_AV1D_SET_STREAMING_DECODE
+
+AOM_CTRL_USE_TYPE(AV1D_SET_TILE_GROUP_CALLBACK, aom_tile_group_cb_t *)
+#define AOM_CTRL_AV1D_SET_TILE_GROUP_CALLBACK
+
+AOM_CTRL_USE_TYPE(AV1D_SET_THREAD_POOL, aom_codec_thread_pool_t *)
+#define AOM_CTRL_AV1D_SET_THREAD_POOL
+
+AOM_CTRL_USE_TYPE(AV1D_SET_STAGE_STATS, int)
+#define AOM_CTRL_AV1D_SET_STAGE_STATS
+
+AOM_CTRL_USE_TYPE(AV1D_GET_STAGE_STATS, aom_decode_stage_stats_t *)
+#define AOM_CTRL_AV1D_GET_STAGE_STATS
+
+AOM_CTRL_USE_TYPE(AV1D_SET_DECODE_MODE, int)
+#define AOM_CTRL_AV1D_SET_DECODE_MODE
+
+AOM_CTRL_USE_TYPE(AV1D_GET_FRAME_MI_INFO, aom_frame_mi_info_t *)
+#define AOM_CTRL_AV1D_GET_FRAME_MI_INFO
+
+AOM_CTRL_USE_TYPE(AV1D_SET_OUTPUT_FORMAT, int)
+#define AOM_CTRL_AV1D_SET_OUTPUT_FORMAT
+
+AOM_CTRL_USE_TYPE(AV1D_SET_FRAME_LIMITS, aom_dec_frame_limits_t *)
+#define AOM_CTRL_AV1D_SET_FRAME_LIMITS
+
+AOM_CTRL_USE_TYPE(AV1D_GET_MEMORY_FOOTPRINT, aom_dec_memory_footprint_t *)
+#define AOM_CTRL_AV1D_GET_MEMORY_FOOTPRINT
 /*!\endcond */
 /*! @} - end defgroup aom_decoder */
 #ifdef __cplusplus
@@ -79,7 +79,8 @@ static aom_image_t *img_alloc_helper(
     case AOM_IMG_FMT_I422: bps = 16; break;
     case AOM_IMG_FMT_I444: bps = 24; break;
     case AOM_IMG_FMT_YV1216:
-    case AOM_IMG_FMT_I42016: bps = 24; break;
+    case AOM_IMG_FMT_I42016:
+    case AOM_IMG_FMT_P010: bps = 24; break;
     case AOM_IMG_FMT_I42216: bps = 32; break;
     case AOM_IMG_FMT_I44416: bps = 48; break;
     default: bps = 16; break;
@@ -97,7 +98,8 @@ static aom_image_t *img_alloc_helper(
     case AOM_IMG_FMT_I422:
     case AOM_IMG_FMT_I42016:
     case AOM_IMG_FMT_YV1216:
-    case AOM_IMG_FMT_I42216: xcs = 1; break;
+    case AOM_IMG_FMT_I42216:
+    case AOM_IMG_FMT_P010: xcs = 1; break;
     default: xcs = 0; break;
   }
 
@@ -108,7 +110,8 @@ static aom_image_t *img_alloc_helper(
     case AOM_IMG_FMT_AOMI420:
     case AOM_IMG_FMT_AOMYV12:
     case AOM_IMG_FMT_YV1216:
-    case AOM_IMG_FMT_I42016: ycs = 1; break;
+    case AOM_IMG_FMT_I42016:
+    case AOM_IMG_FMT_P010: ycs = 1; break;
     default: ycs = 0; break;
   }
 
@@ -173,7 +176,7 @@ static aom_image_t *img_alloc_helper(
   img->stride[AOM_PLANE_Y] = stride_in_bytes;
   img->stride[AOM_PLANE_U] = img->stride[AOM_PLANE_V] = stride_in_bytes >> xcs;
 
-  if (fmt == AOM_IMG_FMT_NV12) {
+  if (fmt == AOM_IMG_FMT_NV12 || fmt == AOM_IMG_FMT_P010) {
     // Each row is a row of U and a row of V interleaved, so the stride is twice
     // as long.
     img->stride[AOM_PLANE_U] *= 2;
@@ -250,7 +253,7 @@ int aom_img_set_rect(aom_image_t *img, unsigned int x, unsigned int y,
       unsigned int uv_border_h = border >> img->y_chroma_shift;
       unsigned int uv_x = x >> img->x_chroma_shift;
       unsigned int uv_y = y >> img->y_chroma_shift;
-      if (img->fmt == AOM_IMG_FMT_NV12) {
+      if (img->fmt == AOM_IMG_FMT_NV12 || img->fmt == AOM_IMG_FMT_P010) {
         img->planes[AOM_PLANE_U] = data + uv_x * bytes_per_sample * 2 +
                                    uv_y * img->stride[AOM_PLANE_U];
         img->planes[AOM_PLANE_V] = NULL;
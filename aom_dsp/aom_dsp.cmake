@@ -153,6 +153,9 @@ if(CONFIG_AV1_DECODER)
               "${AOM_ROOT}/aom_dsp/bitreader.c"
               "${AOM_ROOT}/aom_dsp/bitreader.h" "${AOM_ROOT}/aom_dsp/entdec.c"
               "${AOM_ROOT}/aom_dsp/entdec.h")
+
+  list(APPEND AOM_DSP_DECODER_INTRIN_SSE2
+              "${AOM_ROOT}/aom_dsp/x86/entdec_sse2.c")
 endif()
 
 if(CONFIG_AV1_ENCODER)
@@ -418,6 +421,10 @@ function(setup_aom_dsp_targets)
     add_asm_library("aom_dsp_common_sse2" "AOM_DSP_COMMON_ASM_SSE2")
     add_intrinsics_object_library("-msse2" "sse2" "aom_dsp_common"
                                   "AOM_DSP_COMMON_INTRIN_SSE2")
+    if(CONFIG_AV1_DECODER)
+      add_intrinsics_object_library("-msse2" "sse2" "aom_dsp_decoder"
+                                    "AOM_DSP_DECODER_INTRIN_SSE2")
+    endif()
 
     if(CONFIG_AV1_ENCODER)
       if("${AOM_TARGET_CPU}" STREQUAL "x86_64")
@@ -19,6 +19,8 @@ print <<EOF
 #include "av1/common/blockd.h"
 #include "av1/common/enums.h"
 
+struct od_ec_dec;
+
 EOF
 }
 forward_decls qw/aom_dsp_forward_decls/;
@@ -640,6 +642,14 @@ if (aom_config("CONFIG_AV1_HIGHBITDEPTH") eq "yes") {
   specialize qw/aom_highbd_lpf_horizontal_4_dual neon sse2 avx2/;
 }
 
+#
+# Entropy decoder
+#
+if (aom_config("CONFIG_AV1_DECODER") eq "yes") {
+  add_proto qw/int od_ec_decode_cdf_q15/, "struct od_ec_dec *dec, const uint16_t *icdf, int nsyms";
+  specialize qw/od_ec_decode_cdf_q15 sse2/;
+}
+
 #
 # Encoder functions.
 #
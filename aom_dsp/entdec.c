@@ -10,6 +10,9 @@
  */
 
 #include <assert.h>
+
+#include "config/aom_dsp_rtcd.h"
+
 #include "aom_dsp/entdec.h"
 #include "aom_dsp/prob.h"
 
@@ -75,7 +78,7 @@
 
 /*The return value of od_ec_dec_tell does not change across an od_ec_dec_refill
    call.*/
-static void od_ec_dec_refill(od_ec_dec *dec) {
+void od_ec_dec_refill(od_ec_dec *dec) {
   int s;
   od_ec_window dif;
   int16_t cnt;
@@ -114,29 +117,6 @@ static void od_ec_dec_refill(od_ec_dec *dec) {
   dec->bptr = bptr;
 }
 
-/*Takes updated dif and range values, renormalizes them so that
-   32768 <= rng < 65536 (reading more bytes from the stream into dif if
-   necessary), and stores them back in the decoder context.
-  dif: The new value of dif.
-  rng: The new value of the range.
-  ret: The value to return.
-  Return: ret.
-          This allows the compiler to jump to this function via a tail-call.*/
-static int od_ec_dec_normalize(od_ec_dec *dec, od_ec_window dif, unsigned rng,
-                               int ret) {
-  int d;
-  assert(rng <= 65535U);
-  /*The number of leading zeros in the 16-bit binary representation of rng.*/
-  d = 16 - OD_ILOG_NZ(rng);
-  /*d bits in dec->dif are consumed.*/
-  dec->cnt -= d;
-  /*This is equivalent to shifting in 1's instead of 0's.*/
-  dec->dif = ((dif + 1) << d) - 1;
-  dec->rng = rng << d;
-  if (dec->cnt < 0) od_ec_dec_refill(dec);
-  return ret;
-}
-
 /*Initializes the decoder.
   buf: The input buffer to use.
   storage: The size in bytes of the input buffer.*/
@@ -158,6 +138,7 @@ void od_ec_dec_init(od_ec_dec *dec, const unsigned char *buf,
 int od_ec_decode_bool_q15(od_ec_dec *dec, unsigned f) {
   od_ec_window dif;
   od_ec_window vw;
+  od_ec_window mask;
   unsigned r;
   unsigned r_new;
   unsigned v;
@@ -171,13 +152,14 @@ int od_ec_decode_bool_q15(od_ec_dec *dec, unsigned f) {
   v = ((r >> 8) * (uint32_t)(f >> EC_PROB_SHIFT) >> (7 - EC_PROB_SHIFT));
   v += EC_MIN_PROB;
   vw = (od_ec_window)v << (OD_EC_WINDOW_SIZE - 16);
-  ret = 1;
-  r_new = v;
-  if (dif >= vw) {
-    r_new = r - v;
-    dif -= vw;
-    ret = 0;
-  }
+  /*The decoded bits are close to random, so select the sub-range with a mask
+     instead of a hard-to-predict branch.
+    mask is all ones when the bit is 0, in which case the new range is r - v
+     and vw is removed from dif; otherwise the new range is v.*/
+  ret = dif < vw;
+  mask = (od_ec_window)ret - 1;
+  r_new = v + ((r - 2 * v) & mask);
+  dif -= vw & mask;
   return od_ec_dec_normalize(dec, dif, r_new, ret);
 }
 
@@ -190,7 +172,8 @@ int od_ec_decode_bool_q15(od_ec_dec *dec, unsigned f) {
   nsyms: The number of symbols in the alphabet.
          This should be at most 16.
   Return: The decoded symbol s.*/
-int od_ec_decode_cdf_q15(od_ec_dec *dec, const uint16_t *icdf, int nsyms) {
+int od_ec_decode_cdf_q15_c(struct od_ec_dec *dec, const uint16_t *icdf,
+                           int nsyms) {
   od_ec_window dif;
   unsigned r;
   unsigned c;
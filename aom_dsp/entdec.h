@@ -11,7 +11,11 @@
 
 #ifndef AOM_AOM_DSP_ENTDEC_H_
 #define AOM_AOM_DSP_ENTDEC_H_
+#include <assert.h>
 #include <limits.h>
+
+#include "config/aom_dsp_rtcd.h"
+
 #include "aom_dsp/entcode.h"
 
 #ifdef __cplusplus
@@ -57,14 +61,38 @@ struct od_ec_dec {
 
 /*See entdec.c for further documentation.*/
 
+void od_ec_dec_refill(od_ec_dec *dec) OD_ARG_NONNULL(1);
+
+/*Takes updated dif and range values, renormalizes them so that
+   32768 <= rng < 65536 (reading more bytes from the stream into dif if
+   necessary), and stores them back in the decoder context.
+  This is shared by the C and SIMD versions of od_ec_decode_cdf_q15().
+  dif: The new value of dif.
+  rng: The new value of the range.
+  ret: The value to return.
+  Return: ret.
+          This allows the compiler to jump to this function via a tail-call.*/
+static INLINE int od_ec_dec_normalize(od_ec_dec *dec, od_ec_window dif,
+                                      unsigned rng, int ret) {
+  int d;
+  assert(rng <= 65535U);
+  /*The number of leading zeros in the 16-bit binary representation of rng.*/
+  d = 16 - OD_ILOG_NZ(rng);
+  /*d bits in dec->dif are consumed.*/
+  dec->cnt -= d;
+  /*This is equivalent to shifting in 1's instead of 0's.*/
+  dec->dif = ((dif + 1) << d) - 1;
+  dec->rng = rng << d;
+  if (dec->cnt < 0) od_ec_dec_refill(dec);
+  return ret;
+}
+
 void od_ec_dec_init(od_ec_dec *dec, const unsigned char *buf, uint32_t storage)
     OD_ARG_NONNULL(1) OD_ARG_NONNULL(2);
 
 OD_WARN_UNUSED_RESULT int od_ec_decode_bool_q15(od_ec_dec *dec, unsigned f)
     OD_ARG_NONNULL(1);
-OD_WARN_UNUSED_RESULT int od_ec_decode_cdf_q15(od_ec_dec *dec,
-                                               const uint16_t *cdf, int nsyms)
-    OD_ARG_NONNULL(1) OD_ARG_NONNULL(2);
+/*od_ec_decode_cdf_q15() is declared in config/aom_dsp_rtcd.h.*/
 
 OD_WARN_UNUSED_RESULT uint32_t od_ec_dec_bits_(od_ec_dec *dec, unsigned ftb)
     OD_ARG_NONNULL(1);
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <assert.h>
+#include <emmintrin.h>
+
+#include "config/aom_dsp_rtcd.h"
+
+#include "aom_dsp/entdec.h"
+#include "aom_ports/bitops.h"
+
+// The SIMD version of od_ec_decode_cdf_q15() computes the threshold of every
+// symbol at once,
+//   v[i] = ((r >> 8) * (icdf[i] >> EC_PROB_SHIFT) >> (7 - EC_PROB_SHIFT)) +
+//          EC_MIN_PROB * (nsyms - 1 - i),
+// as _mm_mulhi_epu16((icdf[i] >> EC_PROB_SHIFT) << (EC_PROB_SHIFT + 1),
+// r & 0xff00) + EC_MIN_PROB * (nsyms - 1 - i). This relies on the icdf values
+// being below 32768, which holds for every adapted CDF.
+//
+// The thresholds decrease strictly, so the lanes with c < v[i] form a prefix
+// of any window of consecutive symbols. Returns the length of that prefix,
+// given the byte mask of the 16-bit lanes where c < v[i].
+static INLINE int count_cdf_lanes(unsigned mask) {
+  return mask ? (get_msb(mask) + 1) >> 1 : 0;
+}
+
+// Recomputes the bounds of the range of the decoded symbol ret and updates the
+// decoder state like od_ec_decode_cdf_q15_c().
+static INLINE int decode_cdf_finish(od_ec_dec *dec, const uint16_t *icdf,
+                                    int nsyms, int ret) {
+  const od_ec_window dif = dec->dif;
+  const unsigned r = dec->rng;
+  const int N = nsyms - 1;
+  unsigned u = r;
+  unsigned v;
+  assert(ret >= 0 && ret <= N);
+  if (ret > 0) {
+    u = ((r >> 8) * (uint32_t)(icdf[ret - 1] >> EC_PROB_SHIFT) >>
+         (7 - EC_PROB_SHIFT));
+    u += EC_MIN_PROB * (N - ret + 1);
+  }
+  v = ((r >> 8) * (uint32_t)(icdf[ret] >> EC_PROB_SHIFT) >>
+       (7 - EC_PROB_SHIFT));
+  v += EC_MIN_PROB * (N - ret);
+  assert((unsigned)(dif >> (OD_EC_WINDOW_SIZE - 16)) >= v);
+  assert(v < u);
+  assert(u <= r);
+  return od_ec_dec_normalize(
+      dec, dif - ((od_ec_window)v << (OD_EC_WINDOW_SIZE - 16)), u - v, ret);
+}
+
+// Returns the byte mask of the lanes of icdf_16 whose threshold is above c.
+// c_16 holds c ^ 0x8000 so that a signed comparison can be used.
+static INLINE unsigned cdf_lanes_above_sse2(__m128i icdf_16, __m128i rng_16,
+                                            __m128i c_16,
+                                            __m128i min_prob_16) {
+  const __m128i sign_16 = _mm_set1_epi16((int16_t)0x8000);
+  const __m128i prob_16 = _mm_slli_epi16(
+      _mm_srli_epi16(icdf_16, EC_PROB_SHIFT), EC_PROB_SHIFT + 1);
+  const __m128i v_16 =
+      _mm_add_epi16(_mm_mulhi_epu16(prob_16, rng_16), min_prob_16);
+  return (unsigned)_mm_movemask_epi8(
+      _mm_cmpgt_epi16(_mm_xor_si128(v_16, sign_16), c_16));
+}
+
+// Compares c with the thresholds of two windows of 8 symbols, one ending at
+// symbol nsyms - 1 and one starting at symbol 0, which between them cover all
+// the symbols. The loads never read past icdf[nsyms - 1], whose threshold is
+// 0, so if no lane of the last window compares above c, the symbol is in the
+// first window.
+int od_ec_decode_cdf_q15_sse2(struct od_ec_dec *dec, const uint16_t *icdf,
+                              int nsyms) {
+  const int N = nsyms - 1;
+  assert(dec->dif >> (OD_EC_WINDOW_SIZE - 16) < dec->rng);
+  assert(icdf[N] == OD_ICDF(CDF_PROB_TOP));
+  assert(32768U <= dec->rng);
+  assert(nsyms <= 16);
+  // The scalar search is faster for alphabets of up to 8 symbols.
+  if (nsyms <= 8) return od_ec_decode_cdf_q15_c(dec, icdf, nsyms);
+
+  const unsigned c = (unsigned)(dec->dif >> (OD_EC_WINDOW_SIZE - 16));
+  const __m128i rng_16 = _mm_set1_epi16((int16_t)(dec->rng & 0xff00));
+  const __m128i c_16 = _mm_set1_epi16((int16_t)(c ^ 0x8000));
+  const __m128i min_prob_end = _mm_setr_epi16(
+      7 * EC_MIN_PROB, 6 * EC_MIN_PROB, 5 * EC_MIN_PROB, 4 * EC_MIN_PROB,
+      3 * EC_MIN_PROB, 2 * EC_MIN_PROB, EC_MIN_PROB, 0);
+  const unsigned mask_end =
+      cdf_lanes_above_sse2(_mm_loadu_si128((const __m128i *)(icdf + N - 7)),
+                           rng_16, c_16, min_prob_end);
+  int ret;
+  if (mask_end) {
+    ret = N - 7 + count_cdf_lanes(mask_end);
+  } else {
+    const __m128i min_prob_start = _mm_add_epi16(
+        min_prob_end, _mm_set1_epi16((int16_t)(EC_MIN_PROB * (N - 7))));
+    const unsigned mask_start =
+        cdf_lanes_above_sse2(_mm_loadu_si128((const __m128i *)icdf), rng_16,
+                             c_16, min_prob_start);
+    ret = count_cdf_lanes(mask_start);
+  }
+  return decode_cdf_finish(dec, icdf, nsyms, ret);
+}
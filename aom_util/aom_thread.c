@@ -21,6 +21,7 @@
 #endif
 
 #include <assert.h>
+#include <limits.h>
 #include <string.h>  // for memset()
 
 #include "config/aom_config.h"
@@ -42,30 +43,58 @@ struct AVxWorkerImpl {
 
 static void execute(AVxWorker *const worker);  // Forward declaration.
 
-static THREADFN thread_loop(void *ptr) {
-  AVxWorker *const worker = (AVxWorker *)ptr;
+static void set_thread_name(const char *thread_name) {
 #ifdef __APPLE__
-  if (worker->thread_name != NULL) {
+  if (thread_name != NULL) {
     // Apple's version of pthread_setname_np takes one argument and operates on
     // the current thread only. The maximum size of the thread_name buffer was
     // noted in the Chromium source code and was confirmed by experiments. If
     // thread_name is too long, pthread_setname_np returns -1 with errno
     // ENAMETOOLONG (63).
-    char thread_name[64];
-    strncpy(thread_name, worker->thread_name, sizeof(thread_name) - 1);
-    thread_name[sizeof(thread_name) - 1] = '\0';
-    pthread_setname_np(thread_name);
+    char name[64];
+    strncpy(name, thread_name, sizeof(name) - 1);
+    name[sizeof(name) - 1] = '\0';
+    pthread_setname_np(name);
   }
 #elif (defined(__GLIBC__) && !defined(__GNU__)) || defined(__BIONIC__)
-  if (worker->thread_name != NULL) {
+  if (thread_name != NULL) {
     // Linux and Android require names (with nul) fit in 16 chars, otherwise
     // pthread_setname_np() returns ERANGE (34).
-    char thread_name[16];
-    strncpy(thread_name, worker->thread_name, sizeof(thread_name) - 1);
-    thread_name[sizeof(thread_name) - 1] = '\0';
-    pthread_setname_np(pthread_self(), thread_name);
+    char name[16];
+    strncpy(name, thread_name, sizeof(name) - 1);
+    name[sizeof(name) - 1] = '\0';
+    pthread_setname_np(pthread_self(), name);
   }
 #endif
+}
+
+// Initializes the attributes of the worker threads. Returns false in case of
+// error.
+static int init_thread_attr(pthread_attr_t *const attr) {
+  if (pthread_attr_init(attr)) return 0;
+    // Debug ASan builds require at least ~1MiB of stack; prevents
+    // failures on macOS arm64 where the default is 512KiB.
+    // See: https://crbug.com/aomedia/3379
+#if defined(AOM_ADDRESS_SANITIZER) && defined(__APPLE__) && AOM_ARCH_ARM && \
+    !defined(NDEBUG)
+  const size_t kMinStackSize = 1024 * 1024;
+#else
+  const size_t kMinStackSize = 256 * 1024;
+#endif
+  size_t stacksize;
+  if (!pthread_attr_getstacksize(attr, &stacksize)) {
+    if (stacksize < kMinStackSize &&
+        pthread_attr_setstacksize(attr, kMinStackSize)) {
+      pthread_attr_destroy(attr);
+      return 0;
+    }
+  }
+  return 1;
+}
+
+static THREADFN thread_loop(void *ptr) {
+  AVxWorker *const worker = (AVxWorker *)ptr;
+  set_thread_name(worker->thread_name);
   pthread_mutex_lock(&worker->impl_->mutex_);
   for (;;) {
     while (worker->status_ == AVX_WORKER_STATUS_OK) {  // wait in idling mode
@@ -116,6 +145,204 @@ static void change_state(AVxWorker *const worker, AVxWorkerStatus new_status) {
   pthread_mutex_unlock(&worker->impl_->mutex_);
 }
 
+//------------------------------------------------------------------------------
+// Thread pool
+
+typedef struct {
+  AVxThreadPool *pool;
+  pthread_t thread;
+  AVxWorker *job;  // the job being run by the thread, or NULL
+} AVxPoolThread;
+
+struct AVxThreadPool {
+  pthread_mutex_t mutex_;
+  pthread_cond_t job_cond_;   // signaled when a job is queued or on exit
+  pthread_cond_t done_cond_;  // broadcast when a job finishes
+  AVxPoolThread *threads_;
+  int num_threads_;
+  // FIFO of the launched jobs that no thread has started yet, linked through
+  // AVxWorker::pool_next.
+  AVxWorker *queue_head_;
+  AVxWorker *queue_tail_;
+  int exit_;
+};
+
+static void unlink_pool_job(AVxThreadPool *const pool, AVxWorker *const job,
+                            AVxWorker *const prev) {
+  if (prev != NULL) {
+    prev->pool_next = job->pool_next;
+  } else {
+    pool->queue_head_ = job->pool_next;
+  }
+  if (pool->queue_tail_ == job) pool->queue_tail_ = prev;
+  job->pool_next = NULL;
+  job->pool_queued = 0;
+}
+
+// Removes the next job to run from the queue. The oldest job of the client
+// that has the fewest jobs running goes first, so that a client that launches
+// many jobs does not delay the other clients.
+static AVxWorker *dequeue_pool_job(AVxThreadPool *const pool) {
+  AVxWorker *best = NULL;
+  AVxWorker *best_prev = NULL;
+  int best_running = INT_MAX;
+  AVxWorker *prev = NULL;
+  for (AVxWorker *job = pool->queue_head_; job != NULL;
+       prev = job, job = job->pool_next) {
+    int running = 0;
+    for (int i = 0; i < pool->num_threads_; ++i) {
+      const AVxWorker *const other = pool->threads_[i].job;
+      running += other != NULL && other->pool_client == job->pool_client;
+    }
+    if (running < best_running) {
+      best = job;
+      best_prev = prev;
+      best_running = running;
+      if (running == 0) break;
+    }
+  }
+  if (best != NULL) unlink_pool_job(pool, best, best_prev);
+  return best;
+}
+
+static THREADFN pool_thread_loop(void *ptr) {
+  AVxPoolThread *const thread = (AVxPoolThread *)ptr;
+  AVxThreadPool *const pool = thread->pool;
+  set_thread_name("aom pool worker");
+  pthread_mutex_lock(&pool->mutex_);
+  for (;;) {
+    while (pool->queue_head_ == NULL && !pool->exit_) {
+      pthread_cond_wait(&pool->job_cond_, &pool->mutex_);
+    }
+    if (pool->queue_head_ == NULL) break;
+    AVxWorker *const job = dequeue_pool_job(pool);
+    thread->job = job;
+    pthread_mutex_unlock(&pool->mutex_);
+    execute(job);
+    pthread_mutex_lock(&pool->mutex_);
+    thread->job = NULL;
+    assert(job->status_ == AVX_WORKER_STATUS_WORKING);
+    job->status_ = AVX_WORKER_STATUS_OK;
+    pthread_cond_broadcast(&pool->done_cond_);
+  }
+  pthread_mutex_unlock(&pool->mutex_);
+  return THREAD_EXIT_SUCCESS;
+}
+
+// Waits for the job of a pooled worker to finish. A job that no pool thread
+// has started yet is run on the calling thread instead, so the caller always
+// makes progress even if the pool is busy with the jobs of other clients.
+static void sync_pooled(AVxWorker *const worker) {
+  AVxThreadPool *const pool = worker->pool;
+  pthread_mutex_lock(&pool->mutex_);
+  if (worker->pool_queued) {
+    AVxWorker *prev = NULL;
+    AVxWorker *job = pool->queue_head_;
+    while (job != worker) {
+      prev = job;
+      job = job->pool_next;
+    }
+    unlink_pool_job(pool, worker, prev);
+    pthread_mutex_unlock(&pool->mutex_);
+    execute(worker);
+    pthread_mutex_lock(&pool->mutex_);
+    worker->status_ = AVX_WORKER_STATUS_OK;
+  }
+  while (worker->status_ > AVX_WORKER_STATUS_OK) {
+    pthread_cond_wait(&pool->done_cond_, &pool->mutex_);
+  }
+  pthread_mutex_unlock(&pool->mutex_);
+}
+
+static void launch_pooled(AVxWorker *const worker) {
+  AVxThreadPool *const pool = worker->pool;
+  sync_pooled(worker);
+  pthread_mutex_lock(&pool->mutex_);
+  if (worker->status_ == AVX_WORKER_STATUS_OK) {
+    worker->status_ = AVX_WORKER_STATUS_WORKING;
+    worker->pool_queued = 1;
+    worker->pool_next = NULL;
+    if (pool->queue_tail_ != NULL) {
+      pool->queue_tail_->pool_next = worker;
+    } else {
+      pool->queue_head_ = worker;
+    }
+    pool->queue_tail_ = worker;
+    pthread_cond_signal(&pool->job_cond_);
+  }
+  pthread_mutex_unlock(&pool->mutex_);
+}
+
+AVxThreadPool *aom_thread_pool_create(int num_threads) {
+  if (num_threads <= 0) return NULL;
+  AVxThreadPool *const pool = (AVxThreadPool *)aom_calloc(1, sizeof(*pool));
+  if (pool == NULL) return NULL;
+  pool->threads_ =
+      (AVxPoolThread *)aom_calloc(num_threads, sizeof(*pool->threads_));
+  if (pool->threads_ == NULL) goto Error;
+  if (pthread_mutex_init(&pool->mutex_, NULL)) goto Error;
+  if (pthread_cond_init(&pool->job_cond_, NULL)) {
+    pthread_mutex_destroy(&pool->mutex_);
+    goto Error;
+  }
+  if (pthread_cond_init(&pool->done_cond_, NULL)) {
+    pthread_cond_destroy(&pool->job_cond_);
+    pthread_mutex_destroy(&pool->mutex_);
+    goto Error;
+  }
+  pthread_attr_t attr;
+  if (!init_thread_attr(&attr)) {
+    // No thread is running, so destroying the pool only frees it.
+    aom_thread_pool_destroy(pool);
+    return NULL;
+  }
+  for (int i = 0; i < num_threads; ++i) {
+    AVxPoolThread *const thread = &pool->threads_[i];
+    thread->pool = pool;
+    if (pthread_create(&thread->thread, &attr, pool_thread_loop, thread)) {
+      break;
+    }
+    ++pool->num_threads_;
+  }
+  pthread_attr_destroy(&attr);
+  if (pool->num_threads_ < num_threads) {
+    aom_thread_pool_destroy(pool);
+    return NULL;
+  }
+  return pool;
+
+Error:
+  aom_free(pool->threads_);
+  aom_free(pool);
+  return NULL;
+}
+
+void aom_thread_pool_destroy(AVxThreadPool *pool) {
+  if (pool == NULL) return;
+  pthread_mutex_lock(&pool->mutex_);
+  assert(pool->queue_head_ == NULL);
+  pool->exit_ = 1;
+  pthread_cond_broadcast(&pool->job_cond_);
+  pthread_mutex_unlock(&pool->mutex_);
+  for (int i = 0; i < pool->num_threads_; ++i) {
+    pthread_join(pool->threads_[i].thread, NULL);
+  }
+  pthread_cond_destroy(&pool->done_cond_);
+  pthread_cond_destroy(&pool->job_cond_);
+  pthread_mutex_destroy(&pool->mutex_);
+  aom_free(pool->threads_);
+  aom_free(pool);
+}
+
+#else  // !CONFIG_MULTITHREAD
+
+AVxThreadPool *aom_thread_pool_create(int num_threads) {
+  (void)num_threads;
+  return NULL;
+}
+
+void aom_thread_pool_destroy(AVxThreadPool *pool) { (void)pool; }
+
 #endif  // CONFIG_MULTITHREAD
 
 //------------------------------------------------------------------------------
@@ -127,7 +354,11 @@ static void init(AVxWorker *const worker) {
 
 static int sync(AVxWorker *const worker) {
 #if CONFIG_MULTITHREAD
-  change_state(worker, AVX_WORKER_STATUS_OK);
+  if (worker->pool != NULL) {
+    sync_pooled(worker);
+  } else {
+    change_state(worker, AVX_WORKER_STATUS_OK);
+  }
 #endif
   assert(worker->status_ <= AVX_WORKER_STATUS_OK);
   return !worker->had_error;
@@ -138,6 +369,11 @@ static int reset(AVxWorker *const worker) {
   worker->had_error = 0;
   if (worker->status_ < AVX_WORKER_STATUS_OK) {
 #if CONFIG_MULTITHREAD
+    if (worker->pool != NULL) {
+      // The jobs run on the threads of the pool.
+      worker->status_ = AVX_WORKER_STATUS_OK;
+      return 1;
+    }
     worker->impl_ = (AVxWorkerImpl *)aom_calloc(1, sizeof(*worker->impl_));
     if (worker->impl_ == NULL) {
       return 0;
@@ -150,24 +386,7 @@ static int reset(AVxWorker *const worker) {
       goto Error;
     }
     pthread_attr_t attr;
-    if (pthread_attr_init(&attr)) goto Error2;
-      // Debug ASan builds require at least ~1MiB of stack; prevents
-      // failures on macOS arm64 where the default is 512KiB.
-      // See: https://crbug.com/aomedia/3379
-#if defined(AOM_ADDRESS_SANITIZER) && defined(__APPLE__) && AOM_ARCH_ARM && \
-    !defined(NDEBUG)
-    const size_t kMinStackSize = 1024 * 1024;
-#else
-    const size_t kMinStackSize = 256 * 1024;
-#endif
-    size_t stacksize;
-    if (!pthread_attr_getstacksize(&attr, &stacksize)) {
-      if (stacksize < kMinStackSize &&
-          pthread_attr_setstacksize(&attr, kMinStackSize)) {
-        pthread_attr_destroy(&attr);
-        goto Error2;
-      }
-    }
+    if (!init_thread_attr(&attr)) goto Error2;
     pthread_mutex_lock(&worker->impl_->mutex_);
     ok = !pthread_create(&worker->impl_->thread_, &attr, thread_loop, worker);
     if (ok) worker->status_ = AVX_WORKER_STATUS_OK;
@@ -200,7 +419,11 @@ static void execute(AVxWorker *const worker) {
 
 static void launch(AVxWorker *const worker) {
 #if CONFIG_MULTITHREAD
-  change_state(worker, AVX_WORKER_STATUS_WORKING);
+  if (worker->pool != NULL) {
+    launch_pooled(worker);
+  } else {
+    change_state(worker, AVX_WORKER_STATUS_WORKING);
+  }
 #else
   execute(worker);
 #endif
@@ -208,7 +431,10 @@ static void launch(AVxWorker *const worker) {
 
 static void end(AVxWorker *const worker) {
 #if CONFIG_MULTITHREAD
-  if (worker->impl_ != NULL) {
+  if (worker->pool != NULL) {
+    sync_pooled(worker);
+    worker->status_ = AVX_WORKER_STATUS_NOT_OK;
+  } else if (worker->impl_ != NULL) {
     change_state(worker, AVX_WORKER_STATUS_NOT_OK);
     pthread_join(worker->impl_->thread_, NULL);
     pthread_mutex_destroy(&worker->impl_->mutex_);
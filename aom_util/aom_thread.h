@@ -36,8 +36,11 @@ typedef int (*AVxWorkerHook)(void *, void *);
 // Platform-dependent implementation details for the worker.
 typedef struct AVxWorkerImpl AVxWorkerImpl;
 
+// A pool of threads shared by workers, see aom_thread_pool_create().
+typedef struct AVxThreadPool AVxThreadPool;
+
 // Synchronization object used to launch job in the worker thread
-typedef struct {
+typedef struct AVxWorker {
   AVxWorkerImpl *impl_;
   AVxWorkerStatus status_;
   // Thread name for the debugger. If not NULL, must point to a string that
@@ -48,6 +51,17 @@ typedef struct {
   void *data1;         // first argument passed to 'hook'
   void *data2;         // second argument passed to 'hook'
   int had_error;       // true if a call to 'hook' returned false
+  // If not NULL, the jobs launched on the worker run on the threads of this
+  // pool and the worker has no thread of its own. Must be set after init()
+  // and before reset().
+  AVxThreadPool *pool;
+  // The pool shares its threads fairly between the workers of different
+  // clients, e.g. one client per decoder instance.
+  const void *pool_client;
+  // Private to the pool: the next job in its queue, and whether the job of
+  // this worker is queued.
+  struct AVxWorker *pool_next;
+  int pool_queued;
 } AVxWorker;
 
 // The interface for all thread-worker related functions. All these functions
@@ -85,6 +99,16 @@ int aom_set_worker_interface(const AVxWorkerInterface *const winterface);
 // Retrieve the currently set thread worker interface.
 const AVxWorkerInterface *aom_get_worker_interface(void);
 
+// Creates a pool of num_threads threads that run the jobs launched on the
+// workers attached to it, in the order they are launched except that the
+// clients with fewer jobs running go first. A worker that syncs on a job that
+// has not started yet runs it on the calling thread. Returns NULL in case of
+// error, and always if CONFIG_MULTITHREAD is 0.
+AVxThreadPool *aom_thread_pool_create(int num_threads);
+
+// Destroys the pool. The workers attached to it must have been ended.
+void aom_thread_pool_destroy(AVxThreadPool *pool);
+
 //------------------------------------------------------------------------------
 
 #ifdef __cplusplus
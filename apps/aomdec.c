@@ -29,6 +29,7 @@
 #include "aom/aomdx.h"
 #include "aom_ports/aom_timer.h"
 #include "aom_ports/mem_ops.h"
+#include "aom_util/aom_pthread.h"
 #include "common/args.h"
 #include "common/ivfdec.h"
 #include "common/md5_utils.h"
@@ -105,6 +106,13 @@ static const arg_def_t outallarg = ARG_DEF(
     NULL, "all-layers", 0, "Output all decoded frames of a scalable bitstream");
 static const arg_def_t skipfilmgrain =
     ARG_DEF(NULL, "skip-film-grain", 0, "Skip film grain application");
+static const arg_def_t filmgraininplace =
+    ARG_DEF(NULL, "film-grain-in-place", 0,
+            "Apply film grain in place to frames that are not references");
+static const arg_def_t pipelinearg =
+    ARG_DEF(NULL, "pipeline", 1,
+            "Read input and write output on separate threads, queueing up "
+            "to n frames (default: 0, off)");
 
 static const arg_def_t *all_args[] = {
   &help,           &codecarg, &use_yv12,      &use_i420,
@@ -113,7 +121,7 @@ static const arg_def_t *all_args[] = {
   &threadsarg,     &rowmtarg, &verbosearg,    &scalearg,
   &fb_arg,         &md5arg,   &framestatsarg, &continuearg,
   &outbitdeptharg, &isannexb, &oppointarg,    &outallarg,
-  &skipfilmgrain,  NULL
+  &skipfilmgrain,  &filmgraininplace, &pipelinearg, NULL
 };
 
 #if CONFIG_LIBYUV
@@ -440,6 +448,570 @@ static FILE *open_outfile(const char *name) {
   }
 }
 
+// Output settings shared by the decode loop and the output thread.
+struct OutputContext {
+  const char *outfile_pattern;
+  FILE *outfile;
+  MD5Context *md5_ctx;
+  const struct AvxRational *framerate;
+  int single_file;
+  int use_y4m;
+  int do_md5;
+  int flipuv;
+  int opt_raw;
+};
+
+// Writes |img| to the output file, or adds it to the MD5 sum. |frame_out| is
+// the 1-based index of the output frame and |frame_in| the number of input
+// frames read when it was decoded.
+static void write_output_frame(const struct OutputContext *out,
+                               const aom_image_t *img, int frame_in,
+                               int frame_out) {
+  const int PLANES_YUV[] = { AOM_PLANE_Y, AOM_PLANE_U, AOM_PLANE_V };
+  const int PLANES_YVU[] = { AOM_PLANE_Y, AOM_PLANE_V, AOM_PLANE_U };
+  const int *planes = out->flipuv ? PLANES_YVU : PLANES_YUV;
+  const int num_planes = (out->opt_raw && img->monochrome) ? 1 : 3;
+
+  if (out->single_file) {
+    if (out->use_y4m) {
+      char y4m_buf[Y4M_BUFFER_SIZE] = { 0 };
+      size_t len = 0;
+      if (frame_out == 1) {
+        // Y4M file header
+        len = y4m_write_file_header(y4m_buf, sizeof(y4m_buf), img->d_w,
+                                    img->d_h, out->framerate, img->monochrome,
+                                    img->csp, img->fmt, img->bit_depth,
+                                    img->range);
+        if (img->csp == AOM_CSP_COLOCATED) {
+          fprintf(stderr,
+                  "Warning: Y4M lacks a colorspace for colocated "
+                  "chroma. Using a placeholder.\n");
+        }
+        if (out->do_md5) {
+          MD5Update(out->md5_ctx, (md5byte *)y4m_buf, (unsigned int)len);
+        } else {
+          fputs(y4m_buf, out->outfile);
+        }
+      }
+
+      // Y4M frame header
+      len = y4m_write_frame_header(y4m_buf, sizeof(y4m_buf));
+      if (out->do_md5) {
+        MD5Update(out->md5_ctx, (md5byte *)y4m_buf, (unsigned int)len);
+        y4m_update_image_md5(img, planes, out->md5_ctx);
+      } else {
+        fputs(y4m_buf, out->outfile);
+        y4m_write_image_file(img, planes, out->outfile);
+      }
+    } else {
+      if (out->do_md5) {
+        raw_update_image_md5(img, planes, num_planes, out->md5_ctx);
+      } else {
+        raw_write_image_file(img, planes, num_planes, out->outfile);
+      }
+    }
+  } else {
+    char outfile_name[PATH_MAX] = { 0 };
+    generate_filename(out->outfile_pattern, outfile_name, PATH_MAX, img->d_w,
+                      img->d_h, frame_in);
+    if (out->do_md5) {
+      MD5Context md5_ctx;
+      unsigned char md5_digest[16];
+      MD5Init(&md5_ctx);
+      if (out->use_y4m) {
+        y4m_update_image_md5(img, planes, &md5_ctx);
+      } else {
+        raw_update_image_md5(img, planes, num_planes, &md5_ctx);
+      }
+      MD5Final(md5_digest, &md5_ctx);
+      print_md5(md5_digest, outfile_name);
+    } else {
+      FILE *outfile = open_outfile(outfile_name);
+      if (out->use_y4m) {
+        y4m_write_image_file(img, planes, outfile);
+      } else {
+        raw_write_image_file(img, planes, num_planes, outfile);
+      }
+      fclose(outfile);
+    }
+  }
+}
+
+#if CONFIG_MULTITHREAD
+// Frame buffers handed to the decoder while the output thread runs. A buffer
+// is reused only once the decoder has released it and the output thread is
+// done with every queued image that points into it, so decoded frames are
+// written without being copied.
+struct PipelineFrameBuffer {
+  uint8_t *data;
+  size_t size;
+  int in_use;
+  int pending_output;
+};
+
+struct PipelineFrameBufferPool {
+  pthread_mutex_t mutex;
+  struct PipelineFrameBuffer **fbs;
+  int num_fbs;
+};
+
+// Unlike get_av1_frame_buffer(), grows the pool when every buffer is held by
+// either the decoder or the output queue.
+static int get_pipeline_frame_buffer(void *cb_priv, size_t min_size,
+                                     aom_codec_frame_buffer_t *fb) {
+  struct PipelineFrameBufferPool *const pool =
+      (struct PipelineFrameBufferPool *)cb_priv;
+  struct PipelineFrameBuffer *buf = NULL;
+  int ret = -1;
+
+  pthread_mutex_lock(&pool->mutex);
+  for (int i = 0; i < pool->num_fbs; ++i) {
+    if (!pool->fbs[i]->in_use && !pool->fbs[i]->pending_output) {
+      buf = pool->fbs[i];
+      break;
+    }
+  }
+  if (!buf) {
+    struct PipelineFrameBuffer **const fbs =
+        (struct PipelineFrameBuffer **)realloc(
+            pool->fbs, (pool->num_fbs + 1) * sizeof(*fbs));
+    if (fbs) {
+      pool->fbs = fbs;
+      buf = (struct PipelineFrameBuffer *)calloc(1, sizeof(*buf));
+      if (buf) pool->fbs[pool->num_fbs++] = buf;
+    }
+  }
+  if (buf && buf->size < min_size) {
+    free(buf->data);
+    buf->data = (uint8_t *)calloc(min_size, sizeof(uint8_t));
+    buf->size = buf->data ? min_size : 0;
+  }
+  if (buf && buf->data) {
+    buf->in_use = 1;
+    fb->data = buf->data;
+    fb->size = buf->size;
+    fb->priv = buf;
+    ret = 0;
+  }
+  pthread_mutex_unlock(&pool->mutex);
+  return ret;
+}
+
+static int release_pipeline_frame_buffer(void *cb_priv,
+                                         aom_codec_frame_buffer_t *fb) {
+  struct PipelineFrameBufferPool *const pool =
+      (struct PipelineFrameBufferPool *)cb_priv;
+  struct PipelineFrameBuffer *const buf =
+      (struct PipelineFrameBuffer *)fb->priv;
+  pthread_mutex_lock(&pool->mutex);
+  buf->in_use = 0;
+  pthread_mutex_unlock(&pool->mutex);
+  return 0;
+}
+
+// Returns the pool buffer that holds the pixels of |img| with its output
+// count raised, or NULL if the image lives in memory owned by the decoder.
+static struct PipelineFrameBuffer *hold_image_frame_buffer(
+    struct PipelineFrameBufferPool *pool, const aom_image_t *img) {
+  struct PipelineFrameBuffer *buf = NULL;
+  pthread_mutex_lock(&pool->mutex);
+  for (int i = 0; i < pool->num_fbs; ++i) {
+    struct PipelineFrameBuffer *const fb = pool->fbs[i];
+    if (fb == img->fb_priv && fb->in_use && img->planes[0] >= fb->data &&
+        img->planes[0] < fb->data + fb->size) {
+      ++fb->pending_output;
+      buf = fb;
+      break;
+    }
+  }
+  pthread_mutex_unlock(&pool->mutex);
+  return buf;
+}
+
+static void release_image_frame_buffer(struct PipelineFrameBufferPool *pool,
+                                       struct PipelineFrameBuffer *buf) {
+  pthread_mutex_lock(&pool->mutex);
+  --buf->pending_output;
+  pthread_mutex_unlock(&pool->mutex);
+}
+
+struct InputSlot {
+  uint8_t *buf;
+  size_t bytes_in_buffer;
+  size_t buffer_size;
+};
+
+// Reads temporal units ahead of the decoder into a ring of |depth| slots. The
+// slot at |head| stays with the decoder until it asks for the next one.
+struct InputPrefetch {
+  struct AvxDecInputContext *input;
+  // The reader state of the decode loop. WebM frames are read into it and
+  // copied to a slot since webm_read_frame() owns its buffer.
+  uint8_t **buf;
+  size_t *bytes_in_buffer;
+  size_t *buffer_size;
+  pthread_t thread;
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  struct InputSlot *slots;
+  int depth;
+  int head;
+  int count;
+  int held;
+  int eof;
+  int stop;
+};
+
+static int read_input_slot(struct InputPrefetch *prefetch,
+                           struct InputSlot *slot) {
+#if CONFIG_WEBM_IO
+  if (prefetch->input->aom_input_ctx->file_type == FILE_TYPE_WEBM) {
+    if (read_frame(prefetch->input, prefetch->buf, prefetch->bytes_in_buffer,
+                   prefetch->buffer_size)) {
+      return 1;
+    }
+    const size_t bytes = *prefetch->bytes_in_buffer;
+    if (slot->buffer_size < bytes) {
+      uint8_t *const new_buf = (uint8_t *)realloc(slot->buf, bytes);
+      if (!new_buf) return -1;
+      slot->buf = new_buf;
+      slot->buffer_size = bytes;
+    }
+    memcpy(slot->buf, *prefetch->buf, bytes);
+    slot->bytes_in_buffer = bytes;
+    return 0;
+  }
+#endif
+  return read_frame(prefetch->input, &slot->buf, &slot->bytes_in_buffer,
+                    &slot->buffer_size);
+}
+
+static THREADFN input_prefetch_thread(void *arg) {
+  struct InputPrefetch *const prefetch = (struct InputPrefetch *)arg;
+  pthread_mutex_lock(&prefetch->mutex);
+  while (!prefetch->stop) {
+    if (prefetch->count == prefetch->depth) {
+      pthread_cond_wait(&prefetch->cond, &prefetch->mutex);
+      continue;
+    }
+    struct InputSlot *const slot =
+        &prefetch->slots[(prefetch->head + prefetch->count) % prefetch->depth];
+    pthread_mutex_unlock(&prefetch->mutex);
+    const int done = read_input_slot(prefetch, slot);
+    pthread_mutex_lock(&prefetch->mutex);
+    if (done) {
+      prefetch->eof = 1;
+    } else {
+      ++prefetch->count;
+    }
+    pthread_cond_broadcast(&prefetch->cond);
+    if (done) break;
+  }
+  pthread_mutex_unlock(&prefetch->mutex);
+  return THREAD_EXIT_SUCCESS;
+}
+
+// Returns the next temporal unit in |data| and |data_size|, or a nonzero
+// value at the end of the input, as read_frame() does.
+static int input_prefetch_pop(struct InputPrefetch *prefetch,
+                              const uint8_t **data, size_t *data_size) {
+  int ret = 1;
+  pthread_mutex_lock(&prefetch->mutex);
+  if (prefetch->held) {
+    prefetch->head = (prefetch->head + 1) % prefetch->depth;
+    --prefetch->count;
+    prefetch->held = 0;
+    pthread_cond_broadcast(&prefetch->cond);
+  }
+  while (!prefetch->count && !prefetch->eof) {
+    pthread_cond_wait(&prefetch->cond, &prefetch->mutex);
+  }
+  if (prefetch->count) {
+    const struct InputSlot *const slot = &prefetch->slots[prefetch->head];
+    *data = slot->buf;
+    *data_size = slot->bytes_in_buffer;
+    prefetch->held = 1;
+    ret = 0;
+  }
+  pthread_mutex_unlock(&prefetch->mutex);
+  return ret;
+}
+
+struct OutputFrame {
+  aom_image_t img;
+  // Set when |img| was scaled or shifted by the decode loop. Freed once
+  // written.
+  aom_image_t *owned_img;
+  // Set when |img| points into a decoder frame buffer. Released once written.
+  struct PipelineFrameBuffer *fb;
+  int frame_in;
+  int frame_out;
+};
+
+// Bounded queue of frames waiting to be written or hashed by the output
+// thread. The decode loop blocks when |depth| frames are queued.
+struct OutputQueue {
+  const struct OutputContext *out;
+  struct PipelineFrameBufferPool *fb_pool;
+  pthread_t thread;
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  struct OutputFrame *frames;
+  int depth;
+  int head;
+  int count;
+  int stop;
+};
+
+static THREADFN output_thread(void *arg) {
+  struct OutputQueue *const queue = (struct OutputQueue *)arg;
+  pthread_mutex_lock(&queue->mutex);
+  while (1) {
+    while (!queue->count && !queue->stop) {
+      pthread_cond_wait(&queue->cond, &queue->mutex);
+    }
+    if (!queue->count) break;
+    struct OutputFrame *const frame = &queue->frames[queue->head];
+    pthread_mutex_unlock(&queue->mutex);
+
+    write_output_frame(queue->out, &frame->img, frame->frame_in,
+                       frame->frame_out);
+    if (frame->owned_img) aom_img_free(frame->owned_img);
+    if (frame->fb) release_image_frame_buffer(queue->fb_pool, frame->fb);
+
+    pthread_mutex_lock(&queue->mutex);
+    queue->head = (queue->head + 1) % queue->depth;
+    --queue->count;
+    pthread_cond_broadcast(&queue->cond);
+  }
+  pthread_mutex_unlock(&queue->mutex);
+  return THREAD_EXIT_SUCCESS;
+}
+
+static void output_queue_push(struct OutputQueue *queue,
+                              const struct OutputFrame *frame) {
+  pthread_mutex_lock(&queue->mutex);
+  while (queue->count == queue->depth) {
+    pthread_cond_wait(&queue->cond, &queue->mutex);
+  }
+  queue->frames[(queue->head + queue->count) % queue->depth] = *frame;
+  ++queue->count;
+  pthread_cond_broadcast(&queue->cond);
+  pthread_mutex_unlock(&queue->mutex);
+}
+
+static void output_queue_drain(struct OutputQueue *queue) {
+  pthread_mutex_lock(&queue->mutex);
+  while (queue->count) pthread_cond_wait(&queue->cond, &queue->mutex);
+  pthread_mutex_unlock(&queue->mutex);
+}
+#endif  // CONFIG_MULTITHREAD
+
+// State of the --pipeline mode, in which an input thread reads ahead of the
+// decoder and an output thread writes or hashes the decoded frames.
+struct DecodePipeline {
+#if CONFIG_MULTITHREAD
+  struct PipelineFrameBufferPool fb_pool;
+  struct InputPrefetch input;
+  struct OutputQueue output;
+  int initialized;
+#endif
+  int input_running;
+  int output_running;
+};
+
+#if CONFIG_MULTITHREAD
+// Starts the input thread, and the output thread unless |out| is NULL. The
+// decoder must not have decoded any frame yet since its frame buffer
+// functions are replaced. Returns 0 on failure.
+static int start_decode_pipeline(struct DecodePipeline *pipeline,
+                                 aom_codec_ctx_t *decoder,
+                                 struct AvxDecInputContext *input,
+                                 uint8_t **buf, size_t *bytes_in_buffer,
+                                 size_t *buffer_size,
+                                 const struct OutputContext *out, int depth) {
+  struct InputPrefetch *const prefetch = &pipeline->input;
+  struct OutputQueue *const queue = &pipeline->output;
+
+  if (pthread_mutex_init(&pipeline->fb_pool.mutex, NULL) ||
+      pthread_mutex_init(&prefetch->mutex, NULL) ||
+      pthread_cond_init(&prefetch->cond, NULL) ||
+      pthread_mutex_init(&queue->mutex, NULL) ||
+      pthread_cond_init(&queue->cond, NULL)) {
+    fprintf(stderr, "Failed to initialize the decode pipeline\n");
+    return 0;
+  }
+  pipeline->initialized = 1;
+
+  // Keep one slot for the temporal unit being decoded.
+  prefetch->depth = depth + 1;
+  prefetch->slots =
+      (struct InputSlot *)calloc(prefetch->depth, sizeof(*prefetch->slots));
+  queue->depth = depth;
+  queue->frames =
+      (struct OutputFrame *)calloc(queue->depth, sizeof(*queue->frames));
+  if (!prefetch->slots || !queue->frames) {
+    fprintf(stderr, "Failed to allocate the decode pipeline\n");
+    return 0;
+  }
+
+  if (out) {
+    if (aom_codec_set_frame_buffer_functions(
+            decoder, get_pipeline_frame_buffer, release_pipeline_frame_buffer,
+            &pipeline->fb_pool)) {
+      fprintf(stderr, "Failed to configure pipeline frame buffers: %s\n",
+              aom_codec_error(decoder));
+      return 0;
+    }
+    queue->out = out;
+    queue->fb_pool = &pipeline->fb_pool;
+    if (pthread_create(&queue->thread, NULL, output_thread, queue)) {
+      fprintf(stderr, "Failed to create the output thread\n");
+      return 0;
+    }
+    pipeline->output_running = 1;
+  }
+
+  prefetch->input = input;
+  prefetch->buf = buf;
+  prefetch->bytes_in_buffer = bytes_in_buffer;
+  prefetch->buffer_size = buffer_size;
+  if (pthread_create(&prefetch->thread, NULL, input_prefetch_thread,
+                     prefetch)) {
+    fprintf(stderr, "Failed to create the input thread\n");
+    return 0;
+  }
+  pipeline->input_running = 1;
+  return 1;
+}
+
+// Hands |img| to the output thread. A scaled or shifted image is taken over
+// from |scaled_img| or |img_shifted|, which are replaced or cleared so the
+// decode loop does not reuse it. Returns 0 on failure.
+static int queue_output_frame(struct DecodePipeline *pipeline,
+                              const struct OutputContext *out,
+                              aom_image_t *img, aom_image_t **scaled_img,
+                              aom_image_t **img_shifted, int frame_in,
+                              int frame_out) {
+  struct OutputFrame frame;
+  memset(&frame, 0, sizeof(frame));
+  frame.img = *img;
+  frame.frame_in = frame_in;
+  frame.frame_out = frame_out;
+
+  if (img == *img_shifted) {
+    frame.owned_img = img;
+    *img_shifted = NULL;
+  } else if (img == *scaled_img) {
+    aom_image_t *const next =
+        aom_img_alloc(NULL, img->fmt, img->d_w, img->d_h, 16);
+    if (!next) return 0;
+    next->bit_depth = img->bit_depth;
+    next->monochrome = img->monochrome;
+    next->csp = img->csp;
+    frame.owned_img = img;
+    *scaled_img = next;
+  } else {
+    frame.fb = hold_image_frame_buffer(&pipeline->fb_pool, img);
+    if (!frame.fb) {
+      // The image is only valid until the next decode call, so write it now
+      // after everything queued before it.
+      output_queue_drain(&pipeline->output);
+      write_output_frame(out, img, frame_in, frame_out);
+      return 1;
+    }
+  }
+  output_queue_push(&pipeline->output, &frame);
+  return 1;
+}
+
+// Joins the pipeline threads after the output thread has written every
+// queued frame.
+static void stop_decode_pipeline(struct DecodePipeline *pipeline) {
+  if (pipeline->input_running) {
+    struct InputPrefetch *const prefetch = &pipeline->input;
+    pthread_mutex_lock(&prefetch->mutex);
+    prefetch->stop = 1;
+    pthread_cond_broadcast(&prefetch->cond);
+    pthread_mutex_unlock(&prefetch->mutex);
+    pthread_join(prefetch->thread, NULL);
+    pipeline->input_running = 0;
+  }
+  if (pipeline->output_running) {
+    struct OutputQueue *const queue = &pipeline->output;
+    pthread_mutex_lock(&queue->mutex);
+    queue->stop = 1;
+    pthread_cond_broadcast(&queue->cond);
+    pthread_mutex_unlock(&queue->mutex);
+    pthread_join(queue->thread, NULL);
+    pipeline->output_running = 0;
+  }
+}
+
+// Must be called after the decoder is destroyed, as the decoder releases its
+// frame buffers into the pool.
+static void free_decode_pipeline(struct DecodePipeline *pipeline) {
+  if (!pipeline->initialized) return;
+  struct InputPrefetch *const prefetch = &pipeline->input;
+  struct PipelineFrameBufferPool *const pool = &pipeline->fb_pool;
+  if (prefetch->slots) {
+    for (int i = 0; i < prefetch->depth; ++i) free(prefetch->slots[i].buf);
+    free(prefetch->slots);
+  }
+  free(pipeline->output.frames);
+  for (int i = 0; i < pool->num_fbs; ++i) {
+    free(pool->fbs[i]->data);
+    free(pool->fbs[i]);
+  }
+  free(pool->fbs);
+  pthread_mutex_destroy(&pool->mutex);
+  pthread_mutex_destroy(&prefetch->mutex);
+  pthread_cond_destroy(&prefetch->cond);
+  pthread_mutex_destroy(&pipeline->output.mutex);
+  pthread_cond_destroy(&pipeline->output.cond);
+  pipeline->initialized = 0;
+}
+#endif  // CONFIG_MULTITHREAD
+
+// Reads the next temporal unit into |data| and |data_size|, from the input
+// thread if it runs. Returns nonzero at the end of the input.
+static int read_next_frame(struct DecodePipeline *pipeline,
+                           struct AvxDecInputContext *input, uint8_t **buf,
+                           size_t *bytes_in_buffer, size_t *buffer_size,
+                           const uint8_t **data, size_t *data_size) {
+#if CONFIG_MULTITHREAD
+  if (pipeline->input_running) {
+    return input_prefetch_pop(&pipeline->input, data, data_size);
+  }
+#else
+  (void)pipeline;
+#endif
+  const int ret = read_frame(input, buf, bytes_in_buffer, buffer_size);
+  *data = *buf;
+  *data_size = *bytes_in_buffer;
+  return ret;
+}
+
+// Writes |img|, or queues it for the output thread if it runs. Returns 0 on
+// failure.
+static int output_frame(struct DecodePipeline *pipeline,
+                        const struct OutputContext *out, aom_image_t *img,
+                        aom_image_t **scaled_img, aom_image_t **img_shifted,
+                        int frame_in, int frame_out) {
+#if CONFIG_MULTITHREAD
+  if (pipeline->output_running) {
+    return queue_output_frame(pipeline, out, img, scaled_img, img_shifted,
+                              frame_in, frame_out);
+  }
+#else
+  (void)pipeline;
+#endif
+  (void)scaled_img;
+  (void)img_shifted;
+  write_output_frame(out, img, frame_in, frame_out);
+  return 1;
+}
+
 static int main_loop(int argc, const char **argv_) {
   aom_codec_ctx_t decoder;
   char *fn = NULL;
@@ -471,12 +1043,17 @@ static int main_loop(int argc, const char **argv_) {
   int operating_point = 0;
   int output_all_layers = 0;
   int skip_film_grain = 0;
+  int film_grain_in_place = 0;
   int enable_row_mt = 0;
   aom_image_t *scaled_img = NULL;
   aom_image_t *img_shifted = NULL;
   int frame_avail, got_data, flush_decoder = 0;
   int num_external_frame_buffers = 0;
   struct ExternalFrameBufferList ext_fb_list = { 0, NULL };
+  int pipeline_depth = 0;
+  struct DecodePipeline pipeline;
+  struct OutputContext output_ctx;
+  memset(&pipeline, 0, sizeof(pipeline));
 
   const char *outfile_pattern = NULL;
   char outfile_name[PATH_MAX] = { 0 };
@@ -593,6 +1170,16 @@ static int main_loop(int argc, const char **argv_) {
       output_all_layers = 1;
     } else if (arg_match(&arg, &skipfilmgrain, argi)) {
       skip_film_grain = 1;
+    } else if (arg_match(&arg, &filmgraininplace, argi)) {
+      film_grain_in_place = 1;
+    } else if (arg_match(&arg, &pipelinearg, argi)) {
+      pipeline_depth = arg_parse_uint(&arg);
+#if !CONFIG_MULTITHREAD
+      if (pipeline_depth > 0) {
+        die("Error: --pipeline is not supported when CONFIG_MULTITHREAD = "
+            "0.\n");
+      }
+#endif
     } else {
       argj++;
     }
@@ -603,6 +1190,9 @@ static int main_loop(int argc, const char **argv_) {
     if (argi[0][0] == '-' && strlen(argi[0]) > 1)
       die("Error: Unrecognized option %s\n", *argi);
 
+  if (pipeline_depth > 0 && num_external_frame_buffers > 0)
+    die("Error: --pipeline cannot be combined with --frame-buffers.\n");
+
   /* Handle non-option arguments */
   fn = argv[0];
 
@@ -742,6 +1332,13 @@ static int main_loop(int argc, const char **argv_) {
     goto fail;
   }
 
+  if (AOM_CODEC_CONTROL_TYPECHECKED(&decoder, AV1D_SET_FILM_GRAIN_IN_PLACE,
+                                    film_grain_in_place)) {
+    fprintf(stderr, "Failed to set film_grain_in_place: %s\n",
+            aom_codec_error(&decoder));
+    goto fail;
+  }
+
   if (AOM_CODEC_CONTROL_TYPECHECKED(&decoder, AV1D_SET_ROW_MT, enable_row_mt)) {
     fprintf(stderr, "Failed to set row multithreading mode: %s\n",
             aom_codec_error(&decoder));
@@ -771,6 +1368,25 @@ static int main_loop(int argc, const char **argv_) {
     }
   }
 
+  output_ctx.outfile_pattern = outfile_pattern;
+  output_ctx.outfile = outfile;
+  output_ctx.md5_ctx = &md5_ctx;
+  output_ctx.framerate = &aom_input_ctx.framerate;
+  output_ctx.single_file = single_file;
+  output_ctx.use_y4m = use_y4m;
+  output_ctx.do_md5 = do_md5;
+  output_ctx.flipuv = flipuv;
+  output_ctx.opt_raw = opt_raw;
+
+#if CONFIG_MULTITHREAD
+  if (pipeline_depth > 0 &&
+      !start_decode_pipeline(&pipeline, &decoder, &input, &buf,
+                             &bytes_in_buffer, &buffer_size,
+                             noblit ? NULL : &output_ctx, pipeline_depth)) {
+    goto fail;
+  }
+#endif
+
   frame_avail = 1;
   got_data = 0;
 
@@ -782,16 +1398,19 @@ static int main_loop(int argc, const char **argv_) {
     aom_image_t *img;
     struct aom_usec_timer timer;
     int corrupted = 0;
+    const uint8_t *data = NULL;
+    size_t data_size = 0;
 
     frame_avail = 0;
     if (!stop_after || frame_in < stop_after) {
-      if (!read_frame(&input, &buf, &bytes_in_buffer, &buffer_size)) {
+      if (!read_next_frame(&pipeline, &input, &buf, &bytes_in_buffer,
+                           &buffer_size, &data, &data_size)) {
         frame_avail = 1;
         frame_in++;
 
         aom_usec_timer_start(&timer);
 
-        if (aom_codec_decode(&decoder, buf, bytes_in_buffer, NULL)) {
+        if (aom_codec_decode(&decoder, data, data_size, NULL)) {
           const char *detail = aom_codec_error_detail(&decoder);
           aom_tools_warn("Failed to decode frame %d: %s", frame_in,
                          aom_codec_error(&decoder));
@@ -808,7 +1427,7 @@ static int main_loop(int argc, const char **argv_) {
                            aom_codec_error(&decoder));
             if (!keep_going) goto fail;
           }
-          fprintf(framestats_file, "%d,%d\r\n", (int)bytes_in_buffer, qp);
+          fprintf(framestats_file, "%d,%d\r\n", (int)data_size, qp);
         }
 
         aom_usec_timer_mark(&timer);
@@ -851,10 +1470,6 @@ static int main_loop(int argc, const char **argv_) {
       if (progress) show_progress(frame_in, frame_out, dx_time);
 
       if (!noblit) {
-        const int PLANES_YUV[] = { AOM_PLANE_Y, AOM_PLANE_U, AOM_PLANE_V };
-        const int PLANES_YVU[] = { AOM_PLANE_Y, AOM_PLANE_V, AOM_PLANE_U };
-        const int *planes = flipuv ? PLANES_YVU : PLANES_YUV;
-
         if (do_scale) {
           if (frame_out == 1) {
             // If the output frames are to be scaled to a fixed display size
@@ -921,89 +1536,31 @@ static int main_loop(int argc, const char **argv_) {
         aom_input_ctx.width = img->d_w;
         aom_input_ctx.height = img->d_h;
 
-        int num_planes = (opt_raw && img->monochrome) ? 1 : 3;
-        if (single_file) {
-          if (use_y4m) {
-            char y4m_buf[Y4M_BUFFER_SIZE] = { 0 };
-            size_t len = 0;
-            if (frame_out == 1) {
-              // Y4M file header
-              len = y4m_write_file_header(
-                  y4m_buf, sizeof(y4m_buf), aom_input_ctx.width,
-                  aom_input_ctx.height, &aom_input_ctx.framerate,
-                  img->monochrome, img->csp, img->fmt, img->bit_depth,
-                  img->range);
-              if (img->csp == AOM_CSP_COLOCATED) {
-                fprintf(stderr,
-                        "Warning: Y4M lacks a colorspace for colocated "
-                        "chroma. Using a placeholder.\n");
-              }
-              if (do_md5) {
-                MD5Update(&md5_ctx, (md5byte *)y4m_buf, (unsigned int)len);
-              } else {
-                fputs(y4m_buf, outfile);
-              }
-            }
-
-            // Y4M frame header
-            len = y4m_write_frame_header(y4m_buf, sizeof(y4m_buf));
-            if (do_md5) {
-              MD5Update(&md5_ctx, (md5byte *)y4m_buf, (unsigned int)len);
-              y4m_update_image_md5(img, planes, &md5_ctx);
-            } else {
-              fputs(y4m_buf, outfile);
-              y4m_write_image_file(img, planes, outfile);
-            }
-          } else {
-            if (frame_out == 1) {
-              // Check if --yv12 or --i420 options are consistent with the
-              // bit-stream decoded
-              if (opt_i420) {
-                if (img->fmt != AOM_IMG_FMT_I420 &&
-                    img->fmt != AOM_IMG_FMT_I42016) {
-                  fprintf(stderr,
-                          "Cannot produce i420 output for bit-stream.\n");
-                  goto fail;
-                }
-              }
-              if (opt_yv12) {
-                if ((img->fmt != AOM_IMG_FMT_I420 &&
-                     img->fmt != AOM_IMG_FMT_YV12) ||
-                    img->bit_depth != 8) {
-                  fprintf(stderr,
-                          "Cannot produce yv12 output for bit-stream.\n");
-                  goto fail;
-                }
-              }
-            }
-            if (do_md5) {
-              raw_update_image_md5(img, planes, num_planes, &md5_ctx);
-            } else {
-              raw_write_image_file(img, planes, num_planes, outfile);
+        // Check if --yv12 or --i420 options are consistent with the
+        // bit-stream decoded
+        if (single_file && !use_y4m && frame_out == 1) {
+          if (opt_i420) {
+            if (img->fmt != AOM_IMG_FMT_I420 &&
+                img->fmt != AOM_IMG_FMT_I42016) {
+              fprintf(stderr, "Cannot produce i420 output for bit-stream.\n");
+              goto fail;
             }
           }
-        } else {
-          generate_filename(outfile_pattern, outfile_name, PATH_MAX, img->d_w,
-                            img->d_h, frame_in);
-          if (do_md5) {
-            MD5Init(&md5_ctx);
-            if (use_y4m) {
-              y4m_update_image_md5(img, planes, &md5_ctx);
-            } else {
-              raw_update_image_md5(img, planes, num_planes, &md5_ctx);
-            }
-            MD5Final(md5_digest, &md5_ctx);
-            print_md5(md5_digest, outfile_name);
-          } else {
-            outfile = open_outfile(outfile_name);
-            if (use_y4m) {
-              y4m_write_image_file(img, planes, outfile);
-            } else {
-              raw_write_image_file(img, planes, num_planes, outfile);
+          if (opt_yv12) {
+            if ((img->fmt != AOM_IMG_FMT_I420 &&
+                 img->fmt != AOM_IMG_FMT_YV12) ||
+                img->bit_depth != 8) {
+              fprintf(stderr, "Cannot produce yv12 output for bit-stream.\n");
+              goto fail;
             }
-            fclose(outfile);
           }
         }
+
+        if (!output_frame(&pipeline, &output_ctx, img, &scaled_img,
+                          &img_shifted, frame_in, frame_out)) {
+          fprintf(stderr, "Error allocating image\n");
+          goto fail;
+        }
       }
     }
   }
@@ -1021,11 +1578,19 @@ static int main_loop(int argc, const char **argv_) {
 
 fail:
 
+#if CONFIG_MULTITHREAD
+  stop_decode_pipeline(&pipeline);
+#endif
+
   if (aom_codec_destroy(&decoder)) {
     fprintf(stderr, "Failed to destroy decoder: %s\n",
             aom_codec_error(&decoder));
   }
 
+#if CONFIG_MULTITHREAD
+  free_decode_pipeline(&pipeline);
+#endif
+
 fail2:
 
   if (!noblit && single_file) {
@@ -104,11 +104,14 @@ list(APPEND AOM_AV1_DECODER_SOURCES
             "${AOM_ROOT}/av1/decoder/decodetxb.h"
             "${AOM_ROOT}/av1/decoder/detokenize.c"
             "${AOM_ROOT}/av1/decoder/detokenize.h"
+            "${AOM_ROOT}/av1/decoder/dthread.c"
             "${AOM_ROOT}/av1/decoder/dthread.h"
             "${AOM_ROOT}/av1/decoder/grain_synthesis.c"
             "${AOM_ROOT}/av1/decoder/grain_synthesis.h"
             "${AOM_ROOT}/av1/decoder/obu.h"
-            "${AOM_ROOT}/av1/decoder/obu.c")
+            "${AOM_ROOT}/av1/decoder/obu.c"
+            "${AOM_ROOT}/av1/decoder/output_format.c"
+            "${AOM_ROOT}/av1/decoder/output_format.h")
 
 list(APPEND AOM_AV1_ENCODER_SOURCES
             "${AOM_ROOT}/av1/av1_cx_iface.c"
@@ -294,6 +297,7 @@ list(APPEND AOM_AV1_COMMON_INTRIN_SSE4_1
             "${AOM_ROOT}/av1/common/x86/warp_plane_sse4.c")
 
 list(APPEND AOM_AV1_COMMON_INTRIN_AVX2
+            "${AOM_ROOT}/av1/common/x86/av1_convolve_horiz_rs_avx2.c"
             "${AOM_ROOT}/av1/common/x86/av1_inv_txfm_avx2.c"
             "${AOM_ROOT}/av1/common/x86/av1_inv_txfm_avx2.h"
             "${AOM_ROOT}/av1/common/x86/cdef_block_avx2.c"
@@ -311,6 +315,17 @@ list(APPEND AOM_AV1_COMMON_INTRIN_AVX2
 list(APPEND AOM_AV1_ENCODER_ASM_SSE2 "${AOM_ROOT}/av1/encoder/x86/dct_sse2.asm"
             "${AOM_ROOT}/av1/encoder/x86/error_sse2.asm")
 
+list(APPEND AOM_AV1_DECODER_INTRIN_SSE4_1
+            "${AOM_ROOT}/av1/decoder/x86/decodetxb_sse4.c"
+            "${AOM_ROOT}/av1/decoder/x86/grain_synthesis_sse4.c")
+
+list(APPEND AOM_AV1_DECODER_INTRIN_AVX2
+            "${AOM_ROOT}/av1/decoder/x86/decodetxb_avx2.c"
+            "${AOM_ROOT}/av1/decoder/x86/grain_synthesis_avx2.c")
+
+list(APPEND AOM_AV1_DECODER_INTRIN_NEON
+            "${AOM_ROOT}/av1/decoder/arm/decodetxb_neon.c")
+
 list(APPEND AOM_AV1_ENCODER_INTRIN_SSE2
             "${AOM_ROOT}/av1/encoder/x86/av1_fwd_txfm_sse2.c"
             "${AOM_ROOT}/av1/encoder/x86/av1_fwd_txfm_sse2.h"
@@ -642,6 +657,13 @@ function(setup_av1_targets)
     add_intrinsics_object_library("-msse4.1" "sse4" "aom_av1_common"
                                   "AOM_AV1_COMMON_INTRIN_SSE4_1")
 
+    if(CONFIG_AV1_DECODER)
+      if(AOM_AV1_DECODER_INTRIN_SSE4_1)
+        add_intrinsics_object_library("-msse4.1" "sse4" "aom_av1_decoder"
+                                      "AOM_AV1_DECODER_INTRIN_SSE4_1")
+      endif()
+    endif()
+
     if(CONFIG_AV1_ENCODER)
       if("${AOM_TARGET_CPU}" STREQUAL "x86_64")
         add_asm_library("aom_av1_encoder_ssse3"
@@ -670,6 +692,13 @@ function(setup_av1_targets)
     add_intrinsics_object_library("-mavx2" "avx2" "aom_av1_common"
                                   "AOM_AV1_COMMON_INTRIN_AVX2")
 
+    if(CONFIG_AV1_DECODER)
+      if(AOM_AV1_DECODER_INTRIN_AVX2)
+        add_intrinsics_object_library("-mavx2" "avx2" "aom_av1_decoder"
+                                      "AOM_AV1_DECODER_INTRIN_AVX2")
+      endif()
+    endif()
+
     if(CONFIG_AV1_ENCODER)
       add_intrinsics_object_library("-mavx2" "avx2" "aom_av1_encoder"
                                     "AOM_AV1_ENCODER_INTRIN_AVX2")
@@ -679,6 +708,13 @@ function(setup_av1_targets)
   if(HAVE_NEON)
     add_intrinsics_object_library("${AOM_NEON_INTRIN_FLAG}" "neon"
                                   "aom_av1_common" "AOM_AV1_COMMON_INTRIN_NEON")
+    if(CONFIG_AV1_DECODER)
+      if(AOM_AV1_DECODER_INTRIN_NEON)
+        add_intrinsics_object_library("${AOM_NEON_INTRIN_FLAG}" "neon"
+                                      "aom_av1_decoder"
+                                      "AOM_AV1_DECODER_INTRIN_NEON")
+      endif()
+    endif()
     if(CONFIG_AV1_ENCODER)
       add_intrinsics_object_library("${AOM_NEON_INTRIN_FLAG}" "neon"
                                     "aom_av1_encoder"
@@ -38,9 +38,25 @@
 #include "av1/decoder/dthread.h"
 #include "av1/decoder/grain_synthesis.h"
 #include "av1/decoder/obu.h"
+#include "av1/decoder/output_format.h"
 
 #include "av1/av1_iface_common.h"
 
+// Maximum number of frames decoded concurrently in frame parallel decoding.
+#define MAX_FRAME_PARALLEL_WORKERS 8
+
+// A shown frame waiting to be returned by decoder_get_frame() in frame parallel
+// decoding.
+typedef struct PendingOutputFrame {
+  RefCntBuffer *buf;
+  void *user_priv;
+  aom_metadata_array_t *metadata;
+} PendingOutputFrame;
+
+struct aom_codec_thread_pool {
+  AVxThreadPool *pool;
+};
+
 struct aom_codec_alg_priv {
   aom_codec_priv_t base;
   aom_codec_dec_cfg_t cfg;
@@ -53,6 +69,7 @@ struct aom_codec_alg_priv {
   int byte_alignment;
   int skip_loop_filter;
   int skip_film_grain;
+  int film_grain_in_place;
   int decode_tile_row;
   int decode_tile_col;
   unsigned int tile_mode;
@@ -62,11 +79,51 @@ struct aom_codec_alg_priv {
   unsigned int is_annexb;
   int operating_point;
   int output_all_layers;
-
+  int streaming_decode;
+  aom_tile_group_cb_t tile_group_cb;
+  aom_codec_thread_pool_t *thread_pool;
+  int stage_stats;
+  aom_decode_mode_t decode_mode;
+  // AOM_IMG_FMT_NV12 if the output frames are converted to their semi-planar
+  // format, AOM_IMG_FMT_NONE otherwise.
+  aom_img_fmt_t output_format;
+  aom_dec_frame_limits_t frame_limits;
+
+  // Mode info arrays returned by AV1D_GET_FRAME_MI_INFO, filled on demand
+  // once per decoder_decode() call.
+  aom_frame_mi_info_t mi_info;
+  int mi_info_ready;
+  uint8_t *mi_info_buf;
+  size_t mi_info_buf_size;
+
+  // The frame worker that decoded (or, in frame parallel decoding, parsed) the
+  // last frame. It points into frame_workers.
   AVxWorker *frame_worker;
+  AVxWorker *frame_workers;
+  int num_frame_workers;
+
+  // Frame parallel decoding: up to num_frame_workers frames are decoded at
+  // the same time and each output frame is returned num_frame_workers - 1
+  // temporal units late.
+  unsigned int frame_parallel;
+  int next_frame_worker;
+  // Error of a deferred frame, reported by the next decoder_decode() call.
+  aom_codec_err_t frame_parallel_err;
+  // Output frame of the temporal unit being decoded.
+  RefCntBuffer *tu_output_frame;
+  PendingOutputFrame output_queue[MAX_FRAME_PARALLEL_WORKERS + 1];
+  int output_queue_size;
+  // Frames returned by decoder_get_frame(), released by the next
+  // decoder_decode() call.
+  RefCntBuffer *returned_frames[MAX_FRAME_PARALLEL_WORKERS + 1];
+  int num_returned_frames;
 
   aom_image_t image_with_grain;
-  aom_codec_frame_buffer_t grain_image_frame_buffers[MAX_NUM_SPATIAL_LAYERS];
+  aom_image_t semi_planar_image;
+  // Frame buffers of the images with grain and of the semi-planar images. An
+  // output frame may need one of each.
+  aom_codec_frame_buffer_t grain_image_frame_buffers[2 * AOMMAX(
+      MAX_NUM_SPATIAL_LAYERS, MAX_FRAME_PARALLEL_WORKERS + 1)];
   size_t num_grain_image_frame_buffers;
   int need_resync;  // wait for key/intra-only frame
   // BufferPool that holds all reference frames. Shared by all the FrameWorkers.
@@ -117,10 +174,17 @@ static aom_codec_err_t decoder_init(aom_codec_ctx_t *ctx) {
   return AOM_CODEC_OK;
 }
 
-static aom_codec_err_t decoder_destroy(aom_codec_alg_priv_t *ctx) {
-  if (ctx->frame_worker != NULL) {
-    AVxWorker *const worker = ctx->frame_worker;
-    aom_get_worker_interface()->end(worker);
+static void destroy_frame_workers(aom_codec_alg_priv_t *ctx) {
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+
+  // In frame parallel decoding a frame worker may be waiting for the frames
+  // of the others, so all of them are finished before any is torn down.
+  for (int i = 0; i < ctx->num_frame_workers; ++i) {
+    winterface->sync(&ctx->frame_workers[i]);
+  }
+  for (int i = 0; i < ctx->num_frame_workers; ++i) {
+    AVxWorker *const worker = &ctx->frame_workers[i];
+    winterface->end(worker);
     FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
     if (frame_worker_data != NULL && frame_worker_data->pbi != NULL) {
       AV1Decoder *const pbi = frame_worker_data->pbi;
@@ -132,8 +196,22 @@ static aom_codec_err_t decoder_destroy(aom_codec_alg_priv_t *ctx) {
       av1_free_restoration_buffers(&pbi->common);
       av1_decoder_remove(pbi);
     }
+    if (frame_worker_data != NULL) aom_free(frame_worker_data->scratch_buffer);
     aom_free(frame_worker_data);
   }
+  aom_free(ctx->frame_workers);
+  ctx->frame_workers = NULL;
+  ctx->frame_worker = NULL;
+  ctx->num_frame_workers = 0;
+
+  for (int i = 0; i < ctx->output_queue_size; ++i) {
+    aom_img_metadata_array_free(ctx->output_queue[i].metadata);
+  }
+  ctx->output_queue_size = 0;
+}
+
+static aom_codec_err_t decoder_destroy(aom_codec_alg_priv_t *ctx) {
+  destroy_frame_workers(ctx);
 
   if (ctx->buffer_pool) {
     for (size_t i = 0; i < ctx->num_grain_image_frame_buffers; i++) {
@@ -143,14 +221,15 @@ static aom_codec_err_t decoder_destroy(aom_codec_alg_priv_t *ctx) {
     av1_free_ref_frame_buffers(ctx->buffer_pool);
     av1_free_internal_frame_buffers(&ctx->buffer_pool->int_frame_buffers);
 #if CONFIG_MULTITHREAD
+    pthread_cond_destroy(&ctx->buffer_pool->progress_cond);
     pthread_mutex_destroy(&ctx->buffer_pool->pool_mutex);
 #endif
   }
 
-  aom_free(ctx->frame_worker);
   aom_free(ctx->buffer_pool);
   assert(!ctx->img.self_allocd);
   aom_img_free(&ctx->img);
+  aom_free(ctx->mi_info_buf);
   aom_free(ctx);
   return AOM_CODEC_OK;
 }
@@ -425,8 +504,88 @@ static int frame_worker_hook(void *arg1, void *arg2) {
   return !result;
 }
 
-static aom_codec_err_t init_decoder(aom_codec_alg_priv_t *ctx) {
+// Decodes the tile groups of the frame parsed last by this frame worker.
+static int frame_parallel_worker_hook(void *arg1, void *arg2) {
+  FrameWorkerData *const frame_worker_data = (FrameWorkerData *)arg1;
+  (void)arg2;
+
+  return !av1_decode_deferred_frame(frame_worker_data->pbi);
+}
+
+static aom_codec_err_t init_frame_worker(aom_codec_alg_priv_t *ctx,
+                                         AVxWorker *worker, int max_threads) {
   const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  const int frame_parallel_decode = ctx->num_frame_workers > 1;
+
+  winterface->init(worker);
+  worker->thread_name = "aom frameworker";
+  worker->data1 = aom_memalign(32, sizeof(FrameWorkerData));
+  if (worker->data1 == NULL) {
+    set_error_detail(ctx, "Failed to allocate frame_worker_data");
+    return AOM_CODEC_MEM_ERROR;
+  }
+  FrameWorkerData *frame_worker_data = (FrameWorkerData *)worker->data1;
+  frame_worker_data->scratch_buffer = NULL;
+  frame_worker_data->scratch_buffer_size = 0;
+  frame_worker_data->pbi = av1_decoder_create(ctx->buffer_pool);
+  if (frame_worker_data->pbi == NULL) {
+    set_error_detail(ctx, "Failed to allocate frame_worker_data->pbi");
+    return AOM_CODEC_MEM_ERROR;
+  }
+  frame_worker_data->frame_context_ready = 0;
+  frame_worker_data->received_frame = 0;
+  frame_worker_data->pbi->allow_lowbitdepth = ctx->cfg.allow_lowbitdepth;
+
+  // If decoding in serial mode, FrameWorker thread could create tile worker
+  // thread or loopfilter thread.
+  frame_worker_data->pbi->max_threads = max_threads;
+  if (ctx->thread_pool != NULL) {
+    frame_worker_data->pbi->thread_pool = ctx->thread_pool->pool;
+    frame_worker_data->pbi->thread_pool_client = ctx;
+  }
+  frame_worker_data->pbi->common.reserved_width =
+      (int)ctx->frame_limits.max_width;
+  frame_worker_data->pbi->common.reserved_height =
+      (int)ctx->frame_limits.max_height;
+  frame_worker_data->pbi->reserved_tiles = (int)ctx->frame_limits.max_tiles;
+  frame_worker_data->pbi->inv_tile_order = ctx->invert_tile_order;
+  frame_worker_data->pbi->common.tiles.large_scale = ctx->tile_mode;
+  frame_worker_data->pbi->is_annexb = ctx->is_annexb;
+  frame_worker_data->pbi->dec_tile_row = ctx->decode_tile_row;
+  frame_worker_data->pbi->dec_tile_col = ctx->decode_tile_col;
+  frame_worker_data->pbi->operating_point = ctx->operating_point;
+  frame_worker_data->pbi->output_all_layers = ctx->output_all_layers;
+  frame_worker_data->pbi->ext_tile_debug = ctx->ext_tile_debug;
+  frame_worker_data->pbi->row_mt = ctx->row_mt;
+  frame_worker_data->pbi->is_fwd_kf_present = 0;
+  frame_worker_data->pbi->is_arf_frame_present = 0;
+  frame_worker_data->pbi->frame_parallel_decode = frame_parallel_decode;
+
+  if (frame_parallel_decode) {
+    worker->hook = frame_parallel_worker_hook;
+    if (!winterface->reset(worker)) {
+      set_error_detail(ctx, "Failed to create frame worker thread");
+      return AOM_CODEC_ERROR;
+    }
+  } else {
+    worker->hook = frame_worker_hook;
+  }
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t init_decoder(aom_codec_alg_priv_t *ctx) {
+  int num_frame_workers = 1;
+#if CONFIG_MULTITHREAD
+  // Frame parallel decoding shares the decoder threads between the frame
+  // workers and does not support the large scale tile, layer output and
+  // streaming modes.
+  if (!ctx->tile_mode && !ctx->ext_tile_debug && !ctx->output_all_layers &&
+      !ctx->streaming_decode) {
+    num_frame_workers = (int)AOMMIN(ctx->frame_parallel, ctx->cfg.threads);
+    num_frame_workers =
+        clamp(num_frame_workers, 1, MAX_FRAME_PARALLEL_WORKERS);
+  }
+#endif
 
   ctx->last_show_frame = NULL;
   ctx->need_resync = 1;
@@ -434,7 +593,10 @@ static aom_codec_err_t init_decoder(aom_codec_alg_priv_t *ctx) {
 
   ctx->buffer_pool = (BufferPool *)aom_calloc(1, sizeof(BufferPool));
   if (ctx->buffer_pool == NULL) return AOM_CODEC_MEM_ERROR;
-  ctx->buffer_pool->num_frame_bufs = FRAME_BUFFERS;
+  // Each additional frame worker keeps a frame in flight, its reference map
+  // update and up to two output frames alive.
+  ctx->buffer_pool->num_frame_bufs =
+      FRAME_BUFFERS + 4 * (num_frame_workers - 1);
   ctx->buffer_pool->frame_bufs = (RefCntBuffer *)aom_calloc(
       ctx->buffer_pool->num_frame_bufs, sizeof(*ctx->buffer_pool->frame_bufs));
   if (ctx->buffer_pool->frame_bufs == NULL) {
@@ -454,54 +616,40 @@ static aom_codec_err_t init_decoder(aom_codec_alg_priv_t *ctx) {
     set_error_detail(ctx, "Failed to allocate buffer pool mutex");
     return AOM_CODEC_MEM_ERROR;
   }
+  if (pthread_cond_init(&ctx->buffer_pool->progress_cond, NULL)) {
+    pthread_mutex_destroy(&ctx->buffer_pool->pool_mutex);
+    aom_free(ctx->buffer_pool->frame_bufs);
+    ctx->buffer_pool->frame_bufs = NULL;
+    ctx->buffer_pool->num_frame_bufs = 0;
+    aom_free(ctx->buffer_pool);
+    ctx->buffer_pool = NULL;
+    set_error_detail(ctx, "Failed to allocate buffer pool condition variable");
+    return AOM_CODEC_MEM_ERROR;
+  }
 #endif
 
-  ctx->frame_worker = (AVxWorker *)aom_malloc(sizeof(*ctx->frame_worker));
-  if (ctx->frame_worker == NULL) {
+  ctx->frame_workers = (AVxWorker *)aom_calloc(num_frame_workers,
+                                               sizeof(*ctx->frame_workers));
+  if (ctx->frame_workers == NULL) {
     set_error_detail(ctx, "Failed to allocate frame_worker");
     return AOM_CODEC_MEM_ERROR;
   }
+  ctx->num_frame_workers = num_frame_workers;
+  ctx->frame_worker = &ctx->frame_workers[0];
+  ctx->next_frame_worker = 0;
 
-  AVxWorker *const worker = ctx->frame_worker;
-  winterface->init(worker);
-  worker->thread_name = "aom frameworker";
-  worker->data1 = aom_memalign(32, sizeof(FrameWorkerData));
-  if (worker->data1 == NULL) {
-    winterface->end(worker);
-    aom_free(worker);
-    ctx->frame_worker = NULL;
-    set_error_detail(ctx, "Failed to allocate frame_worker_data");
-    return AOM_CODEC_MEM_ERROR;
-  }
-  FrameWorkerData *frame_worker_data = (FrameWorkerData *)worker->data1;
-  frame_worker_data->pbi = av1_decoder_create(ctx->buffer_pool);
-  if (frame_worker_data->pbi == NULL) {
-    winterface->end(worker);
-    aom_free(frame_worker_data);
-    aom_free(worker);
-    ctx->frame_worker = NULL;
-    set_error_detail(ctx, "Failed to allocate frame_worker_data->pbi");
-    return AOM_CODEC_MEM_ERROR;
+  const int max_threads =
+      num_frame_workers > 1
+          ? AOMMAX(1, (int)ctx->cfg.threads / num_frame_workers)
+          : (int)ctx->cfg.threads;
+  for (int i = 0; i < num_frame_workers; ++i) {
+    const aom_codec_err_t res =
+        init_frame_worker(ctx, &ctx->frame_workers[i], max_threads);
+    if (res != AOM_CODEC_OK) {
+      destroy_frame_workers(ctx);
+      return res;
+    }
   }
-  frame_worker_data->frame_context_ready = 0;
-  frame_worker_data->received_frame = 0;
-  frame_worker_data->pbi->allow_lowbitdepth = ctx->cfg.allow_lowbitdepth;
-
-  // If decoding in serial mode, FrameWorker thread could create tile worker
-  // thread or loopfilter thread.
-  frame_worker_data->pbi->max_threads = ctx->cfg.threads;
-  frame_worker_data->pbi->inv_tile_order = ctx->invert_tile_order;
-  frame_worker_data->pbi->common.tiles.large_scale = ctx->tile_mode;
-  frame_worker_data->pbi->is_annexb = ctx->is_annexb;
-  frame_worker_data->pbi->dec_tile_row = ctx->decode_tile_row;
-  frame_worker_data->pbi->dec_tile_col = ctx->decode_tile_col;
-  frame_worker_data->pbi->operating_point = ctx->operating_point;
-  frame_worker_data->pbi->output_all_layers = ctx->output_all_layers;
-  frame_worker_data->pbi->ext_tile_debug = ctx->ext_tile_debug;
-  frame_worker_data->pbi->row_mt = ctx->row_mt;
-  frame_worker_data->pbi->is_fwd_kf_present = 0;
-  frame_worker_data->pbi->is_arf_frame_present = 0;
-  worker->hook = frame_worker_hook;
 
   init_buffer_callbacks(ctx);
 
@@ -516,6 +664,127 @@ static INLINE void check_resync(aom_codec_alg_priv_t *const ctx,
     ctx->need_resync = 0;
 }
 
+// Waits for the deferred frame of a frame worker. Its error, if any, is
+// reported by the next decoder_decode() call.
+static void sync_frame_worker(aom_codec_alg_priv_t *ctx, AVxWorker *worker) {
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  if (winterface->sync(worker)) return;
+
+  worker->had_error = 0;
+  FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+  if (ctx->frame_parallel_err == AOM_CODEC_OK) {
+    ctx->frame_parallel_err =
+        update_error_state(ctx, &frame_worker_data->pbi->error);
+  }
+  // Wait for a key frame or intra only frame.
+  ctx->need_resync = 1;
+  FrameWorkerData *const last_frame_worker_data =
+      (FrameWorkerData *)ctx->frame_worker->data1;
+  last_frame_worker_data->pbi->need_resync = 1;
+}
+
+// Waits for all frame workers and makes the references of the last parsed
+// frame current, so that they can be accessed by the controls.
+static void sync_frame_workers(aom_codec_alg_priv_t *ctx) {
+  if (ctx->num_frame_workers <= 1) return;
+  for (int i = 0; i < ctx->num_frame_workers; ++i) {
+    sync_frame_worker(ctx, &ctx->frame_workers[i]);
+  }
+  FrameWorkerData *const frame_worker_data =
+      (FrameWorkerData *)ctx->frame_worker->data1;
+  av1_frameworker_commit_ref_frame_map(frame_worker_data->pbi);
+}
+
+// Parses one frame on the calling thread and hands its tile groups to the
+// next frame worker.
+static aom_codec_err_t frame_parallel_decode_one(aom_codec_alg_priv_t *ctx,
+                                                 const uint8_t **data,
+                                                 size_t data_sz,
+                                                 void *user_priv) {
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+
+  if (ctx->tile_mode || ctx->ext_tile_debug || ctx->output_all_layers)
+    return AOM_CODEC_INCAPABLE;
+
+  AVxWorker *const worker = &ctx->frame_workers[ctx->next_frame_worker];
+  FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+  AV1Decoder *const pbi = frame_worker_data->pbi;
+  BufferPool *const pool = ctx->buffer_pool;
+
+  sync_frame_worker(ctx, worker);
+  if (worker != ctx->frame_worker) {
+    const FrameWorkerData *const prev_frame_worker_data =
+        (FrameWorkerData *)ctx->frame_worker->data1;
+    av1_frameworker_copy_context(pbi, prev_frame_worker_data->pbi);
+  }
+
+  // The tile data is read by the frame worker after this call returns.
+  if (frame_worker_data->scratch_buffer_size < data_sz) {
+    aom_free(frame_worker_data->scratch_buffer);
+    frame_worker_data->scratch_buffer_size = 0;
+    frame_worker_data->scratch_buffer = (uint8_t *)aom_malloc(data_sz);
+    if (frame_worker_data->scratch_buffer == NULL) {
+      set_error_detail(ctx, "Failed to allocate frame_worker_data buffer");
+      return AOM_CODEC_MEM_ERROR;
+    }
+    frame_worker_data->scratch_buffer_size = data_sz;
+  }
+  memcpy(frame_worker_data->scratch_buffer, *data, data_sz);
+  frame_worker_data->data = frame_worker_data->scratch_buffer;
+  frame_worker_data->data_size = data_sz;
+  frame_worker_data->user_priv = user_priv;
+
+  pbi->common.tiles.large_scale = 0;
+  pbi->dec_tile_row = ctx->decode_tile_row;
+  pbi->dec_tile_col = ctx->decode_tile_col;
+  pbi->ext_tile_debug = ctx->ext_tile_debug;
+  pbi->row_mt = ctx->row_mt;
+  pbi->ext_refs = ctx->ext_refs;
+  pbi->is_annexb = ctx->is_annexb;
+  pbi->skip_loop_filter = ctx->skip_loop_filter;
+  pbi->skip_film_grain = ctx->skip_film_grain;
+  pbi->decode_mode = ctx->decode_mode;
+  pbi->common.features.byte_alignment = ctx->byte_alignment;
+
+  lock_buffer_pool(pool);
+  for (size_t j = 0; j < pbi->num_output_frames; j++) {
+    decrease_ref_count(pbi->output_frames[j], pool);
+  }
+  pbi->num_output_frames = 0;
+  unlock_buffer_pool(pool);
+
+  const uint8_t *data_start = frame_worker_data->scratch_buffer;
+  const int result = av1_receive_compressed_data(pbi, data_sz, &data_start);
+  *data += data_start - frame_worker_data->scratch_buffer;
+
+  ctx->frame_worker = worker;
+  ctx->next_frame_worker =
+      (ctx->next_frame_worker + 1) % ctx->num_frame_workers;
+
+  aom_codec_err_t res = AOM_CODEC_OK;
+  if (result != 0) {
+    pbi->need_resync = 1;
+    ctx->need_resync = 1;
+    res = update_error_state(ctx, &pbi->error);
+  }
+  check_resync(ctx, pbi);
+
+  if (pbi->num_output_frames > 0) {
+    // The output frame of a temporal unit is the last one shown in it.
+    lock_buffer_pool(pool);
+    decrease_ref_count(ctx->tu_output_frame, pool);
+    ctx->tu_output_frame = pbi->output_frames[pbi->num_output_frames - 1];
+    ++ctx->tu_output_frame->ref_count;
+    unlock_buffer_pool(pool);
+  }
+
+  if (pbi->num_deferred_tgs > 0) {
+    worker->had_error = 0;
+    winterface->launch(worker);
+  }
+  return res;
+}
+
 static aom_codec_err_t decode_one(aom_codec_alg_priv_t *ctx,
                                   const uint8_t **data, size_t data_sz,
                                   void *user_priv) {
@@ -534,6 +803,9 @@ static aom_codec_err_t decode_one(aom_codec_alg_priv_t *ctx,
     if (!ctx->si.is_kf && !is_intra_only) return AOM_CODEC_ERROR;
   }
 
+  if (ctx->num_frame_workers > 1)
+    return frame_parallel_decode_one(ctx, data, data_sz, user_priv);
+
   AVxWorker *const worker = ctx->frame_worker;
   FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
   frame_worker_data->data = *data;
@@ -549,6 +821,12 @@ static aom_codec_err_t decode_one(aom_codec_alg_priv_t *ctx,
   frame_worker_data->pbi->ext_refs = ctx->ext_refs;
 
   frame_worker_data->pbi->is_annexb = ctx->is_annexb;
+  // Annex B temporal units are parsed whole by decoder_decode().
+  frame_worker_data->pbi->streaming_decode =
+      ctx->streaming_decode && !ctx->is_annexb;
+  frame_worker_data->pbi->tile_group_cb = ctx->tile_group_cb;
+  frame_worker_data->pbi->stage_stats_enabled = ctx->stage_stats;
+  frame_worker_data->pbi->decode_mode = ctx->decode_mode;
 
   worker->had_error = 0;
   winterface->execute(worker);
@@ -571,13 +849,33 @@ static void release_pending_output_frames(aom_codec_alg_priv_t *ctx) {
   if (ctx->frame_worker) {
     BufferPool *const pool = ctx->buffer_pool;
     lock_buffer_pool(pool);
-    AVxWorker *const worker = ctx->frame_worker;
-    FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
-    struct AV1Decoder *pbi = frame_worker_data->pbi;
-    for (size_t j = 0; j < pbi->num_output_frames; j++) {
-      decrease_ref_count(pbi->output_frames[j], pool);
+    for (int i = 0; i < ctx->num_returned_frames; i++) {
+      decrease_ref_count(ctx->returned_frames[i], pool);
+    }
+    ctx->num_returned_frames = 0;
+    decrease_ref_count(ctx->tu_output_frame, pool);
+    ctx->tu_output_frame = NULL;
+    // Frames that were not retrieved are dropped, but the last
+    // num_frame_workers - 1 temporal units may still be decoding.
+    const int max_queued = ctx->num_frame_workers - 1;
+    int dropped = 0;
+    while (ctx->output_queue_size - dropped > max_queued) {
+      PendingOutputFrame *const frame = &ctx->output_queue[dropped++];
+      decrease_ref_count(frame->buf, pool);
+      aom_img_metadata_array_free(frame->metadata);
+    }
+    ctx->output_queue_size -= dropped;
+    memmove(ctx->output_queue, ctx->output_queue + dropped,
+            ctx->output_queue_size * sizeof(*ctx->output_queue));
+    for (int i = 0; i < ctx->num_frame_workers; i++) {
+      FrameWorkerData *const frame_worker_data =
+          (FrameWorkerData *)ctx->frame_workers[i].data1;
+      struct AV1Decoder *pbi = frame_worker_data->pbi;
+      for (size_t j = 0; j < pbi->num_output_frames; j++) {
+        decrease_ref_count(pbi->output_frames[j], pool);
+      }
+      pbi->num_output_frames = 0;
     }
-    pbi->num_output_frames = 0;
     unlock_buffer_pool(pool);
     for (size_t j = 0; j < ctx->num_grain_image_frame_buffers; j++) {
       pool->release_fb_cb(pool->cb_priv, &ctx->grain_image_frame_buffers[j]);
@@ -596,6 +894,7 @@ static aom_codec_err_t decoder_inspect(aom_codec_alg_priv_t *ctx,
   aom_codec_err_t res = AOM_CODEC_OK;
 
   release_pending_output_frames(ctx);
+  ctx->mi_info_ready = 0;
 
   /* Sanity checks */
   /* NULL data ptr allowed if data_sz is 0 too */
@@ -641,6 +940,7 @@ static aom_codec_err_t decoder_inspect(aom_codec_alg_priv_t *ctx,
     res = init_decoder(ctx);
     if (res != AOM_CODEC_OK) return res;
   }
+  if (ctx->num_frame_workers > 1) return AOM_CODEC_INCAPABLE;
   FrameWorkerData *const frame_worker_data =
       (FrameWorkerData *)ctx->frame_worker->data1;
   AV1Decoder *const pbi = frame_worker_data->pbi;
@@ -686,6 +986,7 @@ static aom_codec_err_t decoder_decode(aom_codec_alg_priv_t *ctx,
 #endif
 
   release_pending_output_frames(ctx);
+  ctx->mi_info_ready = 0;
 
   /* Sanity checks */
   /* NULL data ptr allowed if data_sz is 0 too */
@@ -707,6 +1008,11 @@ static aom_codec_err_t decoder_decode(aom_codec_alg_priv_t *ctx,
   const uint8_t *data_start = data;
   const uint8_t *data_end = data + data_sz;
 
+  if (ctx->num_frame_workers == 1) {
+    AV1Decoder *const pbi = ((FrameWorkerData *)ctx->frame_worker->data1)->pbi;
+    av1_zero(pbi->stage_stats);
+  }
+
   if (ctx->is_annexb) {
     // read the size of this temporal unit
     size_t length_of_size;
@@ -749,6 +1055,25 @@ static aom_codec_err_t decoder_decode(aom_codec_alg_priv_t *ctx,
     }
   }
 
+  if (ctx->num_frame_workers > 1) {
+    if (ctx->tu_output_frame != NULL) {
+      FrameWorkerData *const frame_worker_data =
+          (FrameWorkerData *)ctx->frame_worker->data1;
+      PendingOutputFrame *const frame =
+          &ctx->output_queue[ctx->output_queue_size++];
+      assert(ctx->output_queue_size <= ctx->num_frame_workers);
+      frame->buf = ctx->tu_output_frame;
+      frame->user_priv = user_priv;
+      frame->metadata = frame_worker_data->pbi->metadata;
+      frame_worker_data->pbi->metadata = NULL;
+      ctx->tu_output_frame = NULL;
+    }
+    if (ctx->frame_parallel_err != AOM_CODEC_OK) {
+      res = ctx->frame_parallel_err;
+      ctx->frame_parallel_err = AOM_CODEC_OK;
+    }
+  }
+
   return res;
 }
 
@@ -765,13 +1090,47 @@ static void *AllocWithGetFrameBufferCb(void *priv, size_t size) {
   return param->fb->data;
 }
 
-// If grain_params->apply_grain is false, returns img. Otherwise, adds film
-// grain to img, saves the result in grain_img, and returns grain_img.
-static aom_image_t *add_grain_if_needed(aom_codec_alg_priv_t *ctx,
-                                        aom_image_t *img,
-                                        aom_image_t *grain_img,
-                                        aom_film_grain_t *grain_params) {
-  if (!grain_params->apply_grain) return img;
+// Returns 1 if buf is not in the reference frame maps of the frame workers nor
+// queued for output again, so adding the grain to it changes no other frame.
+static int is_unreferenced_frame(aom_codec_alg_priv_t *ctx,
+                                 const RefCntBuffer *buf) {
+  BufferPool *const pool = ctx->buffer_pool;
+  int referenced = 0;
+
+  lock_buffer_pool(pool);
+  for (int i = 0; i < ctx->num_frame_workers; ++i) {
+    const AV1Decoder *const pbi =
+        ((FrameWorkerData *)ctx->frame_workers[i].data1)->pbi;
+    for (int j = 0; j < REF_FRAMES; ++j) {
+      if (pbi->common.ref_frame_map[j] == buf ||
+          pbi->next_ref_frame_map[j] == buf) {
+        referenced = 1;
+      }
+    }
+  }
+  for (int i = 0; i < ctx->output_queue_size; ++i) {
+    if (ctx->output_queue[i].buf == buf) referenced = 1;
+  }
+  unlock_buffer_pool(pool);
+  return !referenced;
+}
+
+// Adds film grain to img, saves the result in grain_img, and returns
+// grain_img. The grain is added to img itself instead if in place film grain
+// is enabled and img is the frame buffer buf, which no other frame references.
+static aom_image_t *add_grain(aom_codec_alg_priv_t *ctx, aom_image_t *img,
+                              aom_image_t *grain_img,
+                              aom_film_grain_t *grain_params,
+                              const RefCntBuffer *buf, AVxWorker *tile_workers,
+                              int num_tile_workers) {
+  if (ctx->film_grain_in_place && buf != NULL &&
+      is_unreferenced_frame(ctx, buf)) {
+    if (av1_add_film_grain_mt(grain_params, img, img, tile_workers,
+                              num_tile_workers)) {
+      return NULL;
+    }
+    return img;
+  }
 
   const int w_even = ALIGN_POWER_OF_TWO_UNSIGNED(img->d_w, 1);
   const int h_even = ALIGN_POWER_OF_TWO_UNSIGNED(img->d_h, 1);
@@ -789,7 +1148,8 @@ static aom_image_t *add_grain_if_needed(aom_codec_alg_priv_t *ctx,
 
   grain_img->user_priv = img->user_priv;
   grain_img->fb_priv = fb->priv;
-  if (av1_add_film_grain(grain_params, img, grain_img)) {
+  if (av1_add_film_grain_mt(grain_params, img, grain_img, tile_workers,
+                            num_tile_workers)) {
     pool->release_fb_cb(pool->cb_priv, fb);
     return NULL;
   }
@@ -798,6 +1158,73 @@ static aom_image_t *add_grain_if_needed(aom_codec_alg_priv_t *ctx,
   return grain_img;
 }
 
+// If grain_params->apply_grain is false, returns img. Otherwise, adds film
+// grain to img as described for add_grain().
+static aom_image_t *add_grain_if_needed(aom_codec_alg_priv_t *ctx,
+                                        aom_image_t *img,
+                                        aom_image_t *grain_img,
+                                        aom_film_grain_t *grain_params,
+                                        const RefCntBuffer *buf) {
+  if (!grain_params->apply_grain) return img;
+
+  // The tile workers are idle once the frame is decoded, except in frame
+  // parallel mode where they may be decoding a later frame.
+  if (ctx->num_frame_workers > 1) {
+    return add_grain(ctx, img, grain_img, grain_params, buf, NULL, 0);
+  }
+  AV1Decoder *const pbi = ((FrameWorkerData *)ctx->frame_worker->data1)->pbi;
+  struct aom_usec_timer timer;
+  start_stage_timing(pbi, &timer);
+  aom_image_t *const res = add_grain(ctx, img, grain_img, grain_params, buf,
+                                     pbi->tile_workers, pbi->num_workers);
+  end_stage_timing(pbi, &timer, &pbi->stage_stats.film_grain_us);
+  return res;
+}
+
+// If no output format is set or img has no semi-planar format, returns img.
+// Otherwise converts img to its semi-planar format in semi_planar_img, which
+// uses a frame buffer of the application, and returns semi_planar_img.
+static aom_image_t *convert_output_if_needed(aom_codec_alg_priv_t *ctx,
+                                             aom_image_t *img,
+                                             aom_image_t *semi_planar_img) {
+  if (ctx->output_format == AOM_IMG_FMT_NONE) return img;
+  const aom_img_fmt_t fmt = av1_get_semi_planar_format(img->fmt);
+  if (fmt == AOM_IMG_FMT_NONE) return img;
+
+  BufferPool *const pool = ctx->buffer_pool;
+  aom_codec_frame_buffer_t *fb =
+      &ctx->grain_image_frame_buffers[ctx->num_grain_image_frame_buffers];
+  AllocCbParam param;
+  param.pool = pool;
+  param.fb = fb;
+  if (!aom_img_alloc_with_cb(semi_planar_img, fmt, img->d_w, img->d_h, 16,
+                             AllocWithGetFrameBufferCb, &param)) {
+    return NULL;
+  }
+  semi_planar_img->user_priv = img->user_priv;
+  semi_planar_img->fb_priv = fb->priv;
+  // The metadata stays owned by img.
+  semi_planar_img->metadata = img->metadata;
+
+  // As for the film grain, the tile workers are only idle outside of frame
+  // parallel mode.
+  AVxWorker *tile_workers = NULL;
+  int num_tile_workers = 0;
+  if (ctx->num_frame_workers == 1) {
+    AV1Decoder *const pbi = ((FrameWorkerData *)ctx->frame_worker->data1)->pbi;
+    tile_workers = pbi->tile_workers;
+    num_tile_workers = pbi->num_workers;
+  }
+  if (av1_convert_to_semi_planar_mt(img, semi_planar_img, tile_workers,
+                                    num_tile_workers)) {
+    pool->release_fb_cb(pool->cb_priv, fb);
+    return NULL;
+  }
+
+  ctx->num_grain_image_frame_buffers++;
+  return semi_planar_img;
+}
+
 // Copies and clears the metadata from AV1Decoder.
 static void move_decoder_metadata_to_img(AV1Decoder *pbi, aom_image_t *img) {
   if (pbi->metadata && img) {
@@ -807,6 +1234,54 @@ static void move_decoder_metadata_to_img(AV1Decoder *pbi, aom_image_t *img) {
   }
 }
 
+// Returns the oldest output frame once num_frame_workers - 1 later temporal
+// units have been received, or any remaining one after a flush.
+static aom_image_t *frame_parallel_get_frame(aom_codec_alg_priv_t *ctx) {
+  BufferPool *const pool = ctx->buffer_pool;
+  const int min_queued = ctx->flushed ? 1 : ctx->num_frame_workers;
+
+  while (ctx->output_queue_size >= min_queued) {
+    const PendingOutputFrame frame = ctx->output_queue[0];
+    ctx->output_queue_size--;
+    memmove(ctx->output_queue, ctx->output_queue + 1,
+            ctx->output_queue_size * sizeof(*ctx->output_queue));
+
+    RefCntBuffer *const output_frame_buf = frame.buf;
+    av1_frameworker_wait_rows(pool, output_frame_buf, INT_MAX);
+    ctx->last_show_frame = output_frame_buf;
+    if (ctx->need_resync || output_frame_buf->buf.corrupted) {
+      ctx->need_resync = 1;
+      aom_img_metadata_array_free(frame.metadata);
+      lock_buffer_pool(pool);
+      decrease_ref_count(output_frame_buf, pool);
+      unlock_buffer_pool(pool);
+      continue;
+    }
+    // Released by the next decoder_decode() call.
+    ctx->returned_frames[ctx->num_returned_frames++] = output_frame_buf;
+
+    aom_img_remove_metadata(&ctx->img);
+    yuvconfig2image(&ctx->img, &output_frame_buf->buf, frame.user_priv);
+    ctx->img.metadata = frame.metadata;
+    ctx->img.fb_priv = output_frame_buf->raw_frame_buffer.priv;
+    ctx->img.temporal_id = output_frame_buf->temporal_id;
+    ctx->img.spatial_id = output_frame_buf->spatial_id;
+    aom_film_grain_t grain_params = output_frame_buf->film_grain_params;
+    if (ctx->skip_film_grain) grain_params.apply_grain = 0;
+    aom_image_t *res =
+        add_grain_if_needed(ctx, &ctx->img, &ctx->image_with_grain,
+                            &grain_params, output_frame_buf);
+    if (!res) {
+      set_error_detail(ctx, "Grain synthesis failed");
+      return NULL;
+    }
+    res = convert_output_if_needed(ctx, res, &ctx->semi_planar_image);
+    if (!res) set_error_detail(ctx, "Output format conversion failed");
+    return res;
+  }
+  return NULL;
+}
+
 static aom_image_t *decoder_get_frame(aom_codec_alg_priv_t *ctx,
                                       aom_codec_iter_t *iter) {
   aom_image_t *img = NULL;
@@ -822,6 +1297,7 @@ static aom_image_t *decoder_get_frame(aom_codec_alg_priv_t *ctx,
   if (ctx->frame_worker == NULL) {
     return NULL;
   }
+  if (ctx->num_frame_workers > 1) return frame_parallel_get_frame(ctx);
   const AVxWorkerInterface *const winterface = aom_get_worker_interface();
   AVxWorker *const worker = ctx->frame_worker;
   FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
@@ -913,8 +1389,10 @@ static aom_image_t *decoder_get_frame(aom_codec_alg_priv_t *ctx,
   img->temporal_id = output_frame_buf->temporal_id;
   img->spatial_id = output_frame_buf->spatial_id;
   if (pbi->skip_film_grain) grain_params->apply_grain = 0;
+  // A tile of the frame cannot be extended to even dimensions in place.
   aom_image_t *res =
-      add_grain_if_needed(ctx, img, &ctx->image_with_grain, grain_params);
+      add_grain_if_needed(ctx, img, &ctx->image_with_grain, grain_params,
+                          pbi->ext_tile_debug ? NULL : output_frame_buf);
   if (!res) {
     pbi->error.error_code = AOM_CODEC_CORRUPT_FRAME;
     pbi->error.has_detail = 1;
@@ -922,6 +1400,14 @@ static aom_image_t *decoder_get_frame(aom_codec_alg_priv_t *ctx,
              "Grain synthesis failed\n");
     return res;
   }
+  res = convert_output_if_needed(ctx, res, &ctx->semi_planar_image);
+  if (!res) {
+    pbi->error.error_code = AOM_CODEC_MEM_ERROR;
+    pbi->error.has_detail = 1;
+    snprintf(pbi->error.detail, sizeof(pbi->error.detail),
+             "Output format conversion failed\n");
+    return res;
+  }
   *index += 1;  // Advance the iterator to point to the next image
   return res;
 }
@@ -949,6 +1435,7 @@ static aom_codec_err_t ctrl_set_reference(aom_codec_alg_priv_t *ctx,
   av1_ref_frame_t *const data = va_arg(args, av1_ref_frame_t *);
 
   if (data) {
+    sync_frame_workers(ctx);
     av1_ref_frame_t *const frame = data;
     YV12_BUFFER_CONFIG sd;
     AVxWorker *const worker = ctx->frame_worker;
@@ -965,6 +1452,7 @@ static aom_codec_err_t ctrl_copy_reference(aom_codec_alg_priv_t *ctx,
                                            va_list args) {
   const av1_ref_frame_t *const frame = va_arg(args, av1_ref_frame_t *);
   if (frame) {
+    sync_frame_workers(ctx);
     YV12_BUFFER_CONFIG sd;
     AVxWorker *const worker = ctx->frame_worker;
     FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
@@ -979,6 +1467,7 @@ static aom_codec_err_t ctrl_get_reference(aom_codec_alg_priv_t *ctx,
                                           va_list args) {
   av1_ref_frame_t *data = va_arg(args, av1_ref_frame_t *);
   if (data) {
+    sync_frame_workers(ctx);
     YV12_BUFFER_CONFIG *fb;
     AVxWorker *const worker = ctx->frame_worker;
     FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
@@ -995,6 +1484,7 @@ static aom_codec_err_t ctrl_get_new_frame_image(aom_codec_alg_priv_t *ctx,
                                                 va_list args) {
   aom_image_t *new_img = va_arg(args, aom_image_t *);
   if (new_img) {
+    sync_frame_workers(ctx);
     YV12_BUFFER_CONFIG new_frame;
     AVxWorker *const worker = ctx->frame_worker;
     FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
@@ -1014,6 +1504,7 @@ static aom_codec_err_t ctrl_copy_new_frame_image(aom_codec_alg_priv_t *ctx,
                                                  va_list args) {
   aom_image_t *img = va_arg(args, aom_image_t *);
   if (img) {
+    sync_frame_workers(ctx);
     YV12_BUFFER_CONFIG new_frame;
     AVxWorker *const worker = ctx->frame_worker;
     FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
@@ -1314,6 +1805,7 @@ static aom_codec_err_t ctrl_get_tile_data(aom_codec_alg_priv_t *ctx,
 
   if (tile_data) {
     if (ctx->frame_worker) {
+      sync_frame_workers(ctx);
       AVxWorker *const worker = ctx->frame_worker;
       FrameWorkerData *const frame_worker_data =
           (FrameWorkerData *)worker->data1;
@@ -1510,6 +2002,7 @@ static aom_codec_err_t ctrl_get_mi_info(aom_codec_alg_priv_t *ctx,
   FrameWorkerData *const frame_worker_data =
       (FrameWorkerData *)ctx->frame_worker->data1;
   if (frame_worker_data == NULL) return AOM_CODEC_ERROR;
+  sync_frame_workers(ctx);
 
   AV1_COMMON *cm = &frame_worker_data->pbi->common;
   const int mi_rows = cm->mi_params.mi_rows;
@@ -1526,6 +2019,101 @@ static aom_codec_err_t ctrl_get_mi_info(aom_codec_alg_priv_t *ctx,
   return AOM_CODEC_OK;
 }
 
+// Fills ctx->mi_info with the mode info of the last frame decoded by pbi.
+static aom_codec_err_t fill_frame_mi_info(aom_codec_alg_priv_t *ctx,
+                                          const AV1Decoder *pbi) {
+  const AV1_COMMON *const cm = &pbi->common;
+  const CommonModeInfoParams *const mi_params = &cm->mi_params;
+  const int mi_rows = mi_params->mi_rows;
+  const int mi_cols = mi_params->mi_cols;
+  const size_t num_units = (size_t)mi_rows * mi_cols;
+  // Two motion vector arrays, then eight arrays of one byte per unit.
+  const size_t buf_size = num_units * (2 * sizeof(aom_mi_mv_t) + 8);
+  if (buf_size > ctx->mi_info_buf_size) {
+    aom_free(ctx->mi_info_buf);
+    ctx->mi_info_buf_size = 0;
+    ctx->mi_info_buf = (uint8_t *)aom_malloc(buf_size);
+    if (ctx->mi_info_buf == NULL) return AOM_CODEC_MEM_ERROR;
+    ctx->mi_info_buf_size = buf_size;
+  }
+
+  aom_mi_mv_t *const mv0 = (aom_mi_mv_t *)ctx->mi_info_buf;
+  aom_mi_mv_t *const mv1 = mv0 + num_units;
+  uint8_t *const bsize = (uint8_t *)(mv1 + num_units);
+  uint8_t *const mode = bsize + num_units;
+  int8_t *const ref_frame0 = (int8_t *)(mode + num_units);
+  int8_t *const ref_frame1 = ref_frame0 + num_units;
+  uint8_t *const qindex = (uint8_t *)(ref_frame1 + num_units);
+  uint8_t *const tx_size = qindex + num_units;
+  uint8_t *const skip_txfm = tx_size + num_units;
+  uint8_t *const segment_id = skip_txfm + num_units;
+
+  for (int mi_row = 0; mi_row < mi_rows; ++mi_row) {
+    MB_MODE_INFO *const *const mi_row_grid =
+        mi_params->mi_grid_base + mi_row * mi_params->mi_stride;
+    size_t idx = (size_t)mi_row * mi_cols;
+    for (int mi_col = 0; mi_col < mi_cols; ++mi_col, ++idx) {
+      const MB_MODE_INFO *const mbmi = mi_row_grid[mi_col];
+      const BLOCK_SIZE block_size = mbmi->bsize;
+      bsize[idx] = block_size;
+      mode[idx] = mbmi->mode;
+      ref_frame0[idx] = mbmi->ref_frame[0];
+      ref_frame1[idx] = mbmi->ref_frame[1];
+      mv0[idx].row = mbmi->mv[0].as_mv.row;
+      mv0[idx].col = mbmi->mv[0].as_mv.col;
+      mv1[idx].row = mbmi->mv[1].as_mv.row;
+      mv1[idx].col = mbmi->mv[1].as_mv.col;
+      qindex[idx] =
+          av1_get_qindex(&cm->seg, mbmi->segment_id, mbmi->current_qindex);
+      if (is_inter_block(mbmi)) {
+        const int blk_row = mi_row & (mi_size_high[block_size] - 1);
+        const int blk_col = mi_col & (mi_size_wide[block_size] - 1);
+        tx_size[idx] = mbmi->inter_tx_size[av1_get_txb_size_index(
+            block_size, blk_row, blk_col)];
+      } else {
+        tx_size[idx] = mbmi->tx_size;
+      }
+      skip_txfm[idx] = mbmi->skip_txfm;
+      segment_id[idx] = mbmi->segment_id;
+    }
+  }
+
+  aom_frame_mi_info_t *const info = &ctx->mi_info;
+  info->mi_rows = mi_rows;
+  info->mi_cols = mi_cols;
+  info->stride = mi_cols;
+  info->bsize = bsize;
+  info->mode = mode;
+  info->ref_frame[0] = ref_frame0;
+  info->ref_frame[1] = ref_frame1;
+  info->mv[0] = mv0;
+  info->mv[1] = mv1;
+  info->qindex = qindex;
+  info->tx_size = tx_size;
+  info->skip_txfm = skip_txfm;
+  info->segment_id = segment_id;
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_get_frame_mi_info(aom_codec_alg_priv_t *ctx,
+                                              va_list args) {
+  aom_frame_mi_info_t *const info = va_arg(args, aom_frame_mi_info_t *);
+  if (info == NULL) return AOM_CODEC_INVALID_PARAM;
+  if (ctx->frame_worker == NULL) return AOM_CODEC_ERROR;
+  if (ctx->num_frame_workers > 1) return AOM_CODEC_INCAPABLE;
+  const AV1Decoder *const pbi =
+      ((FrameWorkerData *)ctx->frame_worker->data1)->pbi;
+  if (!pbi->mi_grid_valid) return AOM_CODEC_ERROR;
+
+  if (!ctx->mi_info_ready) {
+    const aom_codec_err_t res = fill_frame_mi_info(ctx, pbi);
+    if (res != AOM_CODEC_OK) return res;
+    ctx->mi_info_ready = 1;
+  }
+  *info = ctx->mi_info;
+  return AOM_CODEC_OK;
+}
+
 static aom_codec_err_t ctrl_set_invert_tile_order(aom_codec_alg_priv_t *ctx,
                                                   va_list args) {
   ctx->invert_tile_order = va_arg(args, int);
@@ -1546,7 +2134,8 @@ static aom_codec_err_t ctrl_set_byte_alignment(aom_codec_alg_priv_t *ctx,
     return AOM_CODEC_INVALID_PARAM;
 
   ctx->byte_alignment = byte_alignment;
-  if (ctx->frame_worker) {
+  // Frame parallel decoding applies the setting to each frame it parses.
+  if (ctx->frame_worker && ctx->num_frame_workers == 1) {
     AVxWorker *const worker = ctx->frame_worker;
     FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
     frame_worker_data->pbi->common.features.byte_alignment = byte_alignment;
@@ -1558,7 +2147,8 @@ static aom_codec_err_t ctrl_set_skip_loop_filter(aom_codec_alg_priv_t *ctx,
                                                  va_list args) {
   ctx->skip_loop_filter = va_arg(args, int);
 
-  if (ctx->frame_worker) {
+  // Frame parallel decoding applies the setting to each frame it parses.
+  if (ctx->frame_worker && ctx->num_frame_workers == 1) {
     AVxWorker *const worker = ctx->frame_worker;
     FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
     frame_worker_data->pbi->skip_loop_filter = ctx->skip_loop_filter;
@@ -1571,7 +2161,8 @@ static aom_codec_err_t ctrl_set_skip_film_grain(aom_codec_alg_priv_t *ctx,
                                                 va_list args) {
   ctx->skip_film_grain = va_arg(args, int);
 
-  if (ctx->frame_worker) {
+  // Frame parallel decoding applies the setting to each frame it parses.
+  if (ctx->frame_worker && ctx->num_frame_workers == 1) {
     AVxWorker *const worker = ctx->frame_worker;
     FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
     frame_worker_data->pbi->skip_film_grain = ctx->skip_film_grain;
@@ -1591,6 +2182,7 @@ static aom_codec_err_t ctrl_get_accounting(aom_codec_alg_priv_t *ctx,
 
   if (acct) {
     if (ctx->frame_worker) {
+      sync_frame_workers(ctx);
       AVxWorker *const worker = ctx->frame_worker;
       FrameWorkerData *const frame_worker_data =
           (FrameWorkerData *)worker->data1;
@@ -1668,6 +2260,136 @@ static aom_codec_err_t ctrl_set_row_mt(aom_codec_alg_priv_t *ctx,
   return AOM_CODEC_OK;
 }
 
+static aom_codec_err_t ctrl_set_film_grain_in_place(aom_codec_alg_priv_t *ctx,
+                                                    va_list args) {
+  ctx->film_grain_in_place = va_arg(args, int);
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_set_frame_parallel(aom_codec_alg_priv_t *ctx,
+                                               va_list args) {
+  // The frame workers are created on the first decode call.
+  if (ctx->frame_worker != NULL) return AOM_CODEC_ERROR;
+  ctx->frame_parallel = va_arg(args, unsigned int);
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_set_streaming_decode(aom_codec_alg_priv_t *ctx,
+                                                 va_list args) {
+  // The number of frame workers is chosen on the first decode call.
+  if (ctx->frame_worker != NULL) return AOM_CODEC_ERROR;
+  ctx->streaming_decode = va_arg(args, int);
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_set_tile_group_callback(aom_codec_alg_priv_t *ctx,
+                                                    va_list args) {
+  const aom_tile_group_cb_t *const tile_group_cb =
+      va_arg(args, aom_tile_group_cb_t *);
+  if (tile_group_cb == NULL) return AOM_CODEC_INVALID_PARAM;
+  ctx->tile_group_cb = *tile_group_cb;
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_set_thread_pool(aom_codec_alg_priv_t *ctx,
+                                            va_list args) {
+  // The tile workers of the frame workers are attached to the pool when they
+  // are created.
+  if (ctx->frame_worker != NULL) return AOM_CODEC_ERROR;
+  ctx->thread_pool = va_arg(args, aom_codec_thread_pool_t *);
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_set_stage_stats(aom_codec_alg_priv_t *ctx,
+                                            va_list args) {
+  ctx->stage_stats = va_arg(args, int);
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_set_output_format(aom_codec_alg_priv_t *ctx,
+                                              va_list args) {
+  const aom_img_fmt_t fmt = (aom_img_fmt_t)va_arg(args, int);
+  if (fmt != AOM_IMG_FMT_NONE && fmt != AOM_IMG_FMT_NV12 &&
+      fmt != AOM_IMG_FMT_P010) {
+    return AOM_CODEC_INVALID_PARAM;
+  }
+  ctx->output_format =
+      fmt == AOM_IMG_FMT_NONE ? AOM_IMG_FMT_NONE : AOM_IMG_FMT_NV12;
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_set_frame_limits(aom_codec_alg_priv_t *ctx,
+                                             va_list args) {
+  const aom_dec_frame_limits_t *const limits =
+      va_arg(args, aom_dec_frame_limits_t *);
+  if (limits == NULL || limits->max_width == 0 || limits->max_height == 0 ||
+      limits->max_width > 65536 || limits->max_height > 65536 ||
+      limits->max_tiles > MAX_TILES) {
+    return AOM_CODEC_INVALID_PARAM;
+  }
+  // The buffers are allocated for the limits from the first frame on.
+  if (ctx->frame_worker != NULL) return AOM_CODEC_ERROR;
+  ctx->frame_limits = *limits;
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_set_decode_mode(aom_codec_alg_priv_t *ctx,
+                                            va_list args) {
+  const int mode = va_arg(args, int);
+  if (mode < AOM_DECODE_ALL_FRAMES || mode > AOM_DECODE_INTRA_FRAMES)
+    return AOM_CODEC_INVALID_PARAM;
+  ctx->decode_mode = (aom_decode_mode_t)mode;
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_get_stage_stats(aom_codec_alg_priv_t *ctx,
+                                            va_list args) {
+  aom_decode_stage_stats_t *const stats =
+      va_arg(args, aom_decode_stage_stats_t *);
+  if (stats == NULL) return AOM_CODEC_INVALID_PARAM;
+  if (!ctx->stage_stats) return AOM_CODEC_ERROR;
+  if (ctx->frame_worker == NULL) {
+    memset(stats, 0, sizeof(*stats));
+    return AOM_CODEC_OK;
+  }
+  if (ctx->num_frame_workers > 1) return AOM_CODEC_INCAPABLE;
+  const AV1Decoder *const pbi =
+      ((FrameWorkerData *)ctx->frame_worker->data1)->pbi;
+  *stats = pbi->stage_stats;
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_get_memory_footprint(aom_codec_alg_priv_t *ctx,
+                                                 va_list args) {
+  aom_dec_memory_footprint_t *const footprint =
+      va_arg(args, aom_dec_memory_footprint_t *);
+  if (footprint == NULL) return AOM_CODEC_INVALID_PARAM;
+  memset(footprint, 0, sizeof(*footprint));
+  if (ctx->frame_worker == NULL) return AOM_CODEC_OK;
+  // The other frame workers may be decoding.
+  if (ctx->num_frame_workers > 1) return AOM_CODEC_INCAPABLE;
+
+  const AV1Decoder *const pbi =
+      ((FrameWorkerData *)ctx->frame_worker->data1)->pbi;
+  BufferPool *const pool = ctx->buffer_pool;
+  lock_buffer_pool(pool);
+  const InternalFrameBufferList *const int_fbs = &pool->int_frame_buffers;
+  for (int i = 0; i < int_fbs->num_internal_frame_buffers; i++)
+    footprint->frame_buffers += int_fbs->int_fb[i].size;
+  // The motion vectors and segmentation maps stored with the frames.
+  for (int i = 0; i < pool->num_frame_bufs; i++) {
+    const RefCntBuffer *const buf = &pool->frame_bufs[i];
+    if (buf->mvs == NULL) continue;
+    footprint->frame_buffers +=
+        (uint64_t)buf->mvs_alloc_size * sizeof(*buf->mvs) +
+        (uint64_t)buf->seg_map_alloc_size * sizeof(*buf->seg_map);
+  }
+  unlock_buffer_pool(pool);
+  footprint->context_buffers = av1_dec_context_buffers_size(pbi);
+  footprint->total = footprint->frame_buffers + footprint->context_buffers;
+  return AOM_CODEC_OK;
+}
+
 static aom_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { AV1_COPY_REFERENCE, ctrl_copy_reference },
 
@@ -1687,6 +2409,15 @@ static aom_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { AV1D_SET_ROW_MT, ctrl_set_row_mt },
   { AV1D_SET_EXT_REF_PTR, ctrl_set_ext_ref_ptr },
   { AV1D_SET_SKIP_FILM_GRAIN, ctrl_set_skip_film_grain },
+  { AV1D_SET_FRAME_PARALLEL, ctrl_set_frame_parallel },
+  { AV1D_SET_FILM_GRAIN_IN_PLACE, ctrl_set_film_grain_in_place },
+  { AV1D_SET_STREAMING_DECODE, ctrl_set_streaming_decode },
+  { AV1D_SET_TILE_GROUP_CALLBACK, ctrl_set_tile_group_callback },
+  { AV1D_SET_THREAD_POOL, ctrl_set_thread_pool },
+  { AV1D_SET_STAGE_STATS, ctrl_set_stage_stats },
+  { AV1D_SET_DECODE_MODE, ctrl_set_decode_mode },
+  { AV1D_SET_OUTPUT_FORMAT, ctrl_set_output_format },
+  { AV1D_SET_FRAME_LIMITS, ctrl_set_frame_limits },
 
   // Getters
   { AOMD_GET_FRAME_CORRUPTED, ctrl_get_frame_corrupted },
@@ -1717,6 +2448,9 @@ static aom_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { AOMD_GET_BASE_Q_IDX, ctrl_get_base_q_idx },
   { AOMD_GET_ORDER_HINT, ctrl_get_order_hint },
   { AV1D_GET_MI_INFO, ctrl_get_mi_info },
+  { AV1D_GET_STAGE_STATS, ctrl_get_stage_stats },
+  { AV1D_GET_FRAME_MI_INFO, ctrl_get_frame_mi_info },
+  { AV1D_GET_MEMORY_FOOTPRINT, ctrl_get_memory_footprint },
   CTRL_MAP_END,
 };
 
@@ -1786,3 +2520,81 @@ aom_codec_iface_t aom_codec_av1_inspect_algo = {
 };
 
 aom_codec_iface_t *aom_codec_av1_dx(void) { return &aom_codec_av1_dx_algo; }
+
+aom_codec_thread_pool_t *aom_codec_thread_pool_create(int num_threads) {
+  aom_codec_thread_pool_t *const pool =
+      (aom_codec_thread_pool_t *)aom_malloc(sizeof(*pool));
+  if (pool == NULL) return NULL;
+  pool->pool = aom_thread_pool_create(num_threads);
+  if (pool->pool == NULL) {
+    aom_free(pool);
+    return NULL;
+  }
+  return pool;
+}
+
+void aom_codec_thread_pool_destroy(aom_codec_thread_pool_t *pool) {
+  if (pool == NULL) return;
+  aom_thread_pool_destroy(pool->pool);
+  aom_free(pool);
+}
+
+static int decode_batch_item_hook(void *arg1, void *unused) {
+  (void)unused;
+  aom_codec_decode_batch_item_t *const item =
+      (aom_codec_decode_batch_item_t *)arg1;
+  item->res = aom_codec_decode(item->ctx, item->data, item->data_sz,
+                               item->user_priv);
+  return item->res == AOM_CODEC_OK;
+}
+
+aom_codec_err_t aom_codec_decode_batch(aom_codec_thread_pool_t *pool,
+                                       aom_codec_decode_batch_item_t *items,
+                                       int num_items) {
+  if (num_items < 0 || (num_items > 0 && items == NULL))
+    return AOM_CODEC_INVALID_PARAM;
+  for (int i = 0; i < num_items; ++i) {
+    const aom_codec_ctx_t *const ctx = items[i].ctx;
+    if (ctx == NULL || ctx->iface != &aom_codec_av1_dx_algo ||
+        ctx->priv == NULL) {
+      return AOM_CODEC_INVALID_PARAM;
+    }
+    // A decoder decodes one frame at a time.
+    for (int j = 0; j < i; ++j) {
+      if (items[j].ctx == ctx) return AOM_CODEC_INVALID_PARAM;
+    }
+  }
+
+  if (pool == NULL || num_items == 1) {
+    for (int i = 0; i < num_items; ++i) decode_batch_item_hook(&items[i], NULL);
+  } else if (num_items > 1) {
+    const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+    AVxWorker *const workers =
+        (AVxWorker *)aom_malloc(num_items * sizeof(*workers));
+    if (workers == NULL) return AOM_CODEC_MEM_ERROR;
+    for (int i = 0; i < num_items; ++i) {
+      AVxWorker *const worker = &workers[i];
+      winterface->init(worker);
+      // The decoder is the client of the pool for its own jobs too, so that
+      // the pool runs the frames of the other streams before the tile jobs
+      // of a stream that is already being decoded.
+      worker->pool = pool->pool;
+      worker->pool_client = (aom_codec_alg_priv_t *)items[i].ctx->priv;
+      worker->hook = decode_batch_item_hook;
+      worker->data1 = &items[i];
+      worker->data2 = NULL;
+      winterface->reset(worker);
+    }
+    for (int i = 1; i < num_items; ++i) winterface->launch(&workers[i]);
+    winterface->execute(&workers[0]);
+    // sync() runs the frames that no thread of the pool has started yet.
+    for (int i = 1; i < num_items; ++i) winterface->sync(&workers[i]);
+    for (int i = 0; i < num_items; ++i) winterface->end(&workers[i]);
+    aom_free(workers);
+  }
+
+  for (int i = 0; i < num_items; ++i) {
+    if (items[i].res != AOM_CODEC_OK) return items[i].res;
+  }
+  return AOM_CODEC_OK;
+}
@@ -64,7 +64,7 @@ static INLINE void free_cdef_linebuf_conditional(
     AV1_COMMON *const cm, const size_t *new_linebuf_size) {
   CdefInfo *cdef_info = &cm->cdef_info;
   for (int plane = 0; plane < MAX_MB_PLANE; plane++) {
-    if (new_linebuf_size[plane] != cdef_info->allocated_linebuf_size[plane]) {
+    if (new_linebuf_size[plane] > cdef_info->allocated_linebuf_size[plane]) {
       aom_free(cdef_info->linebuf[plane]);
       cdef_info->linebuf[plane] = NULL;
     }
@@ -77,12 +77,12 @@ static INLINE void free_cdef_bufs_conditional(AV1_COMMON *const cm,
                                               const size_t *new_colbuf_size,
                                               const size_t new_srcbuf_size) {
   CdefInfo *cdef_info = &cm->cdef_info;
-  if (new_srcbuf_size != cdef_info->allocated_srcbuf_size) {
+  if (new_srcbuf_size > cdef_info->allocated_srcbuf_size) {
     aom_free(*srcbuf);
     *srcbuf = NULL;
   }
   for (int plane = 0; plane < MAX_MB_PLANE; plane++) {
-    if (new_colbuf_size[plane] != cdef_info->allocated_colbuf_size[plane]) {
+    if (new_colbuf_size[plane] > cdef_info->allocated_colbuf_size[plane]) {
       aom_free(colbuf[plane]);
       colbuf[plane] = NULL;
     }
@@ -198,9 +198,10 @@ void av1_alloc_cdef_buffers(AV1_COMMON *const cm,
   size_t new_colbuf_size[MAX_MB_PLANE] = { 0 };
   size_t new_srcbuf_size = 0;
   CdefInfo *const cdef_info = &cm->cdef_info;
-  // Check for configuration change
-  const int num_mi_rows =
-      (cm->mi_params.mi_rows + MI_SIZE_64X64 - 1) / MI_SIZE_64X64;
+  // The buffers only grow, so that they are allocated once for the largest
+  // frame size.
+  const int mi_rows = av1_alloc_mi_rows(cm);
+  const int num_mi_rows = (mi_rows + MI_SIZE_64X64 - 1) / MI_SIZE_64X64;
   const int is_num_workers_changed =
       cdef_info->allocated_num_workers != num_workers;
   const int is_cdef_enabled =
@@ -210,8 +211,7 @@ void av1_alloc_cdef_buffers(AV1_COMMON *const cm,
   // followed by bottom linebuf.
   // ping-pong is to avoid top linebuf over-write by consecutive row.
   int num_bufs = 3;
-  if (num_workers > 1)
-    num_bufs = (cm->mi_params.mi_rows + MI_SIZE_64X64 - 1) / MI_SIZE_64X64;
+  if (num_workers > 1) num_bufs = num_mi_rows;
 
   if (is_cdef_enabled) {
     // Calculate src buffer size
@@ -221,7 +221,7 @@ void av1_alloc_cdef_buffers(AV1_COMMON *const cm,
           plane == AOM_PLANE_Y ? 0 : cm->seq_params->subsampling_x;
       // Calculate top and bottom line buffer size
       const int luma_stride =
-          ALIGN_POWER_OF_TWO(cm->mi_params.mi_cols << MI_SIZE_LOG2, 4);
+          ALIGN_POWER_OF_TWO(av1_alloc_mi_cols(cm) << MI_SIZE_LOG2, 4);
       new_linebuf_size[plane] = sizeof(*cdef_info->linebuf) * num_bufs *
                                 (CDEF_VBORDER << 1) * (luma_stride >> shift);
       // Calculate column buffer size
@@ -260,15 +260,21 @@ void av1_alloc_cdef_buffers(AV1_COMMON *const cm,
     }
   }
 
-  if (cdef_info->allocated_mi_rows != num_mi_rows)
+  if (cdef_info->allocated_mi_rows < num_mi_rows) {
     free_cdef_row_sync(&cdef_sync->cdef_row_mt, cdef_info->allocated_mi_rows);
+    cdef_info->allocated_mi_rows = num_mi_rows;
+  }
 
   // Store allocated sizes for reallocation
-  cdef_info->allocated_srcbuf_size = new_srcbuf_size;
-  av1_copy(cdef_info->allocated_colbuf_size, new_colbuf_size);
-  av1_copy(cdef_info->allocated_linebuf_size, new_linebuf_size);
+  cdef_info->allocated_srcbuf_size =
+      AOMMAX(cdef_info->allocated_srcbuf_size, new_srcbuf_size);
+  for (int plane = 0; plane < MAX_MB_PLANE; plane++) {
+    cdef_info->allocated_colbuf_size[plane] = AOMMAX(
+        cdef_info->allocated_colbuf_size[plane], new_colbuf_size[plane]);
+    cdef_info->allocated_linebuf_size[plane] = AOMMAX(
+        cdef_info->allocated_linebuf_size[plane], new_linebuf_size[plane]);
+  }
   // Store configuration to check change in configuration
-  cdef_info->allocated_mi_rows = num_mi_rows;
   cdef_info->allocated_num_workers = num_workers;
 
   if (!is_cdef_enabled) return;
@@ -311,13 +317,15 @@ void av1_alloc_restoration_buffers(AV1_COMMON *cm, bool is_sgr_enabled) {
   // of height 64 luma pixels but with an offset by RESTORATION_UNIT_OFFSET
   // luma pixels to match the output from CDEF. We will need to store 2 *
   // RESTORATION_CTX_VERT lines of data for each stripe.
-  int mi_h = cm->mi_params.mi_rows;
+  // The line buffers only grow, so that they are allocated once for the
+  // largest frame size.
+  int mi_h = av1_alloc_mi_rows(cm);
   const int ext_h = RESTORATION_UNIT_OFFSET + (mi_h << MI_SIZE_LOG2);
   const int num_stripes = (ext_h + 63) / 64;
 
   // Now we need to allocate enough space to store the line buffers for the
   // stripes
-  const int frame_w = cm->superres_upscaled_width;
+  const int frame_w = AOMMAX(cm->superres_upscaled_width, cm->reserved_width);
   const int use_highbd = cm->seq_params->use_highbitdepth;
 
   for (int p = 0; p < num_planes; ++p) {
@@ -329,7 +337,7 @@ void av1_alloc_restoration_buffers(AV1_COMMON *cm, bool is_sgr_enabled) {
                          << use_highbd;
     RestorationStripeBoundaries *boundaries = &cm->rst_info[p].boundaries;
 
-    if (buf_size != boundaries->stripe_boundary_size ||
+    if (buf_size > boundaries->stripe_boundary_size ||
         boundaries->stripe_boundary_above == NULL ||
         boundaries->stripe_boundary_below == NULL) {
       aom_free(boundaries->stripe_boundary_above);
@@ -139,6 +139,9 @@ typedef struct RefCntBuffer {
   unsigned int pyramid_level;
   MV_REF *mvs;
   uint8_t *seg_map;
+  // Number of entries mvs and seg_map are allocated for.
+  int mvs_alloc_size;
+  int seg_map_alloc_size;
   struct segmentation seg;
   int mi_rows;
   int mi_cols;
@@ -167,6 +170,18 @@ typedef struct RefCntBuffer {
   int8_t mode_deltas[MAX_MODE_LF_DELTAS];
 
   FRAME_CONTEXT frame_context;
+
+  // Decode progress of this buffer in frame parallel decoding. These are
+  // protected by BufferPool::pool_mutex. A buffer that is not being decoded
+  // by a frame worker has decode_in_progress == 0 and is fully available.
+  int decode_in_progress;
+  // Set once mvs, seg_map and frame_context of this frame have been written.
+  int parse_done;
+  // Number of luma pixel rows of buf that are final.
+  int decoded_rows;
+  // Set by the decoder when the decode mode skipped the tiles of this frame,
+  // which leaves the pixels of buf invalid.
+  int decode_skipped;
 } RefCntBuffer;
 
 typedef struct BufferPool {
@@ -177,6 +192,8 @@ typedef struct BufferPool {
 // https://chromium-review.googlesource.com/c/webm/libvpx/+/560630.
 #if CONFIG_MULTITHREAD
   pthread_mutex_t pool_mutex;
+  // Signaled whenever the decode progress of a frame buffer advances.
+  pthread_cond_t progress_cond;
 #endif
 
   // Private data associated with the frame buffer callbacks.
@@ -802,6 +819,18 @@ typedef struct AV1Common {
   int superres_upscaled_height; /*!< Super-resolved frame height */
   /**@}*/
 
+  /**
+   * \name Largest frame dimensions the frame size dependent buffers are
+   * allocated for.
+   * Set by the decoder from AV1D_SET_FRAME_LIMITS, so that the buffers are
+   * allocated once for the largest frame and reused by the smaller ones. Zero
+   * when the buffers are allocated for the current frame.
+   */
+  /**@{*/
+  int reserved_width;  /*!< Reserved frame width, after superres upscaling */
+  int reserved_height; /*!< Reserved frame height */
+  /**@}*/
+
   /*!
    * The denominator of the superres scale used by this frame.
    * Note: The numerator is fixed to be SCALE_NUMERATOR.
@@ -1220,6 +1249,20 @@ static INLINE int frame_might_allow_warped_motion(const AV1_COMMON *cm) {
          cm->seq_params->enable_warped_motion;
 }
 
+// Returns the number of mode info rows the frame size dependent buffers are
+// allocated for: those of the current frame, or of the reserved frame size
+// if it is larger.
+static INLINE int av1_alloc_mi_rows(const AV1_COMMON *cm) {
+  return AOMMAX(cm->mi_params.mi_rows,
+                ALIGN_POWER_OF_TWO(cm->reserved_height, 3) >> MI_SIZE_LOG2);
+}
+
+// Same as av1_alloc_mi_rows() for the mode info columns.
+static INLINE int av1_alloc_mi_cols(const AV1_COMMON *cm) {
+  return AOMMAX(cm->mi_params.mi_cols,
+                ALIGN_POWER_OF_TWO(cm->reserved_width, 3) >> MI_SIZE_LOG2);
+}
+
 static INLINE void ensure_mv_buffer(RefCntBuffer *buf, AV1_COMMON *cm) {
   const int buf_rows = buf->mi_rows;
   const int buf_cols = buf->mi_cols;
@@ -1227,28 +1270,51 @@ static INLINE void ensure_mv_buffer(RefCntBuffer *buf, AV1_COMMON *cm) {
 
   if (buf->mvs == NULL || buf_rows != mi_params->mi_rows ||
       buf_cols != mi_params->mi_cols) {
-    aom_free(buf->mvs);
     buf->mi_rows = mi_params->mi_rows;
     buf->mi_cols = mi_params->mi_cols;
-    CHECK_MEM_ERROR(cm, buf->mvs,
-                    (MV_REF *)aom_calloc(((mi_params->mi_rows + 1) >> 1) *
-                                             ((mi_params->mi_cols + 1) >> 1),
-                                         sizeof(*buf->mvs)));
-    aom_free(buf->seg_map);
-    CHECK_MEM_ERROR(
-        cm, buf->seg_map,
-        (uint8_t *)aom_calloc(mi_params->mi_rows * mi_params->mi_cols,
-                              sizeof(*buf->seg_map)));
+    const int mvs_size =
+        ((mi_params->mi_rows + 1) >> 1) * ((mi_params->mi_cols + 1) >> 1);
+    const int seg_map_size = mi_params->mi_rows * mi_params->mi_cols;
+    // The arrays only grow, and are allocated for the reserved frame size, so
+    // that a frame buffer reused by a smaller frame keeps them. They are
+    // cleared like newly allocated ones.
+    if (buf->mvs == NULL || buf->mvs_alloc_size < mvs_size ||
+        buf->seg_map_alloc_size < seg_map_size) {
+      const int alloc_rows = av1_alloc_mi_rows(cm);
+      const int alloc_cols = av1_alloc_mi_cols(cm);
+      aom_free(buf->mvs);
+      buf->mvs_alloc_size = 0;
+      CHECK_MEM_ERROR(cm, buf->mvs,
+                      (MV_REF *)aom_calloc(((alloc_rows + 1) >> 1) *
+                                               ((alloc_cols + 1) >> 1),
+                                           sizeof(*buf->mvs)));
+      buf->mvs_alloc_size = ((alloc_rows + 1) >> 1) * ((alloc_cols + 1) >> 1);
+      aom_free(buf->seg_map);
+      buf->seg_map_alloc_size = 0;
+      CHECK_MEM_ERROR(cm, buf->seg_map,
+                      (uint8_t *)aom_calloc(alloc_rows * alloc_cols,
+                                            sizeof(*buf->seg_map)));
+      buf->seg_map_alloc_size = alloc_rows * alloc_cols;
+    } else {
+      memset(buf->mvs, 0, mvs_size * sizeof(*buf->mvs));
+      memset(buf->seg_map, 0, seg_map_size * sizeof(*buf->seg_map));
+    }
   }
 
   const int mem_size =
       ((mi_params->mi_rows + MAX_MIB_SIZE) >> 1) * (mi_params->mi_stride >> 1);
 
   if (cm->tpl_mvs == NULL || cm->tpl_mvs_mem_size < mem_size) {
+    const int alloc_mem_size =
+        AOMMAX(mem_size, ((av1_alloc_mi_rows(cm) + MAX_MIB_SIZE) >> 1) *
+                             (ALIGN_POWER_OF_TWO(av1_alloc_mi_cols(cm),
+                                                 MAX_MIB_SIZE_LOG2) >>
+                              1));
     aom_free(cm->tpl_mvs);
-    CHECK_MEM_ERROR(cm, cm->tpl_mvs,
-                    (TPL_MV_REF *)aom_calloc(mem_size, sizeof(*cm->tpl_mvs)));
-    cm->tpl_mvs_mem_size = mem_size;
+    CHECK_MEM_ERROR(
+        cm, cm->tpl_mvs,
+        (TPL_MV_REF *)aom_calloc(alloc_mem_size, sizeof(*cm->tpl_mvs)));
+    cm->tpl_mvs_mem_size = alloc_mem_size;
   }
 }
 
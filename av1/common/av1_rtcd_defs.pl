@@ -98,11 +98,11 @@ if ($opts{arch} eq "x86_64") {
 }
 
 add_proto qw/void av1_convolve_horiz_rs/, "const uint8_t *src, int src_stride, uint8_t *dst, int dst_stride, int w, int h, const int16_t *x_filters, int x0_qn, int x_step_qn";
-specialize qw/av1_convolve_horiz_rs sse4_1/;
+specialize qw/av1_convolve_horiz_rs sse4_1 avx2/;
 
 if(aom_config("CONFIG_AV1_HIGHBITDEPTH") eq "yes") {
   add_proto qw/void av1_highbd_convolve_horiz_rs/, "const uint16_t *src, int src_stride, uint16_t *dst, int dst_stride, int w, int h, const int16_t *x_filters, int x0_qn, int x_step_qn, int bd";
-  specialize qw/av1_highbd_convolve_horiz_rs sse4_1 neon/;
+  specialize qw/av1_highbd_convolve_horiz_rs sse4_1 avx2 neon/;
 
   add_proto qw/void av1_highbd_wiener_convolve_add_src/, "const uint8_t *src, ptrdiff_t src_stride, uint8_t *dst, ptrdiff_t dst_stride, const int16_t *filter_x, int x_step_q4, const int16_t *filter_y, int y_step_q4, int w, int h, const WienerConvolveParams *conv_params, int bd";
   specialize qw/av1_highbd_wiener_convolve_add_src ssse3 avx2 neon/;
@@ -282,6 +282,25 @@ specialize "av1_round_shift_array", qw/sse4_1 neon/;
 add_proto qw/void av1_resize_and_extend_frame/, "const YV12_BUFFER_CONFIG *src, YV12_BUFFER_CONFIG *dst, const InterpFilter filter, const int phase, const int num_planes";
 specialize qw/av1_resize_and_extend_frame ssse3 neon/;
 
+# Film grain synthesis functions.
+if (aom_config("CONFIG_AV1_DECODER") eq "yes") {
+  add_proto qw/void av1_add_luma_grain/, "uint8_t *luma, int luma_stride, const int *grain, int grain_stride, const int *scaling_lut, int width, int height, int scaling_shift, int min_val, int max_val";
+  specialize qw/av1_add_luma_grain sse4_1 avx2/;
+
+  add_proto qw/void av1_add_chroma_grain/, "uint8_t *chroma, int chroma_stride, const uint8_t *luma, int luma_stride, const int *grain, int grain_stride, const int *scaling_lut, int width, int height, int chroma_subsamp_x, int luma_mult, int mult, int offset, int scaling_shift, int min_val, int max_val";
+  specialize qw/av1_add_chroma_grain sse4_1 avx2/;
+
+  add_proto qw/void av1_highbd_add_luma_grain/, "uint16_t *luma, int luma_stride, const int *grain, int grain_stride, const int *scaling_lut, int width, int height, int scaling_shift, int min_val, int max_val";
+  specialize qw/av1_highbd_add_luma_grain sse4_1 avx2/;
+
+  add_proto qw/void av1_highbd_add_chroma_grain/, "uint16_t *chroma, int chroma_stride, const uint16_t *luma, int luma_stride, const int *grain, int grain_stride, const int *scaling_lut, int width, int height, int chroma_subsamp_x, int luma_mult, int mult, int offset, int scaling_shift, int min_val, int max_val, int bd";
+  specialize qw/av1_highbd_add_chroma_grain sse4_1 avx2/;
+
+  # Coefficient dequantization.
+  add_proto qw/void av1_dequant_coeffs/, "tran_low_t *coeffs, int n, int dc_q, int ac_q, int shift, int bd";
+  specialize qw/av1_dequant_coeffs sse4_1 avx2 neon/;
+}
+
 #
 # Encoder functions below this point.
 #
@@ -1207,9 +1207,9 @@ bool av1_resize_and_extend_frame_nonnormative(const YV12_BUFFER_CONFIG *src,
   return true;
 }
 
-void av1_upscale_normative_rows(const AV1_COMMON *cm, const uint8_t *src,
-                                int src_stride, uint8_t *dst, int dst_stride,
-                                int plane, int rows) {
+static bool upscale_normative_rows(const AV1_COMMON *cm, const uint8_t *src,
+                                   int src_stride, uint8_t *dst, int dst_stride,
+                                   int plane, int rows) {
   const int is_uv = (plane > 0);
   const int ss_x = is_uv && cm->seq_params->subsampling_x;
   const int downscaled_plane_width = ROUND_POWER_OF_TWO(cm->width, ss_x);
@@ -1268,24 +1268,116 @@ void av1_upscale_normative_rows(const AV1_COMMON *cm, const uint8_t *src,
                                      dst_ptr, rows, dst_width, dst_stride,
                                      x_step_qn, x0_qn, pad_left, pad_right);
 #endif
-    if (!success) {
-      aom_internal_error(cm->error, AOM_CODEC_MEM_ERROR,
-                         "Error upscaling frame");
-    }
+    if (!success) return false;
     // Update the fractional pixel offset to prepare for the next tile column.
     x0_qn += (dst_width * x_step_qn) - (src_width << RS_SCALE_SUBPEL_BITS);
   }
+  return true;
+}
+
+void av1_upscale_normative_rows(const AV1_COMMON *cm, const uint8_t *src,
+                                int src_stride, uint8_t *dst, int dst_stride,
+                                int plane, int rows) {
+  if (!upscale_normative_rows(cm, src, src_stride, dst, dst_stride, plane,
+                              rows)) {
+    aom_internal_error(cm->error, AOM_CODEC_MEM_ERROR,
+                       "Error upscaling frame");
+  }
+}
+
+// A band of rows of all the planes, upscaled by one worker.
+typedef struct {
+  const AV1_COMMON *cm;
+  const YV12_BUFFER_CONFIG *src;
+  YV12_BUFFER_CONFIG *dst;
+  // First and last (exclusive) luma row of the band.
+  int start_row;
+  int end_row;
+} UpscaleRowsJob;
+
+// The tile columns of a band are upscaled in order: each one temporarily
+// extends its source rows into its neighbours, and the SIMD kernels may write
+// past its right edge. Different bands touch different rows only.
+static int upscale_rows_worker_hook(void *arg1, void *arg2) {
+  (void)arg2;
+  const UpscaleRowsJob *const job = (const UpscaleRowsJob *)arg1;
+  const YV12_BUFFER_CONFIG *const src = job->src;
+  YV12_BUFFER_CONFIG *const dst = job->dst;
+  const int num_planes = av1_num_planes(job->cm);
+
+  for (int i = 0; i < num_planes; ++i) {
+    const int is_uv = (i > 0);
+    const int ss_y = is_uv ? src->subsampling_y : 0;
+    const int start_row = ROUND_POWER_OF_TWO(job->start_row, ss_y);
+    const int end_row = ROUND_POWER_OF_TWO(job->end_row, ss_y);
+    if (!upscale_normative_rows(
+            job->cm, src->buffers[i] + start_row * src->strides[is_uv],
+            src->strides[is_uv],
+            dst->buffers[i] + start_row * dst->strides[is_uv],
+            dst->strides[is_uv], i, end_row - start_row)) {
+      return 0;
+    }
+  }
+  return 1;
 }
 
 void av1_upscale_normative_and_extend_frame(const AV1_COMMON *cm,
                                             const YV12_BUFFER_CONFIG *src,
-                                            YV12_BUFFER_CONFIG *dst) {
+                                            YV12_BUFFER_CONFIG *dst,
+                                            AVxWorker *workers,
+                                            int num_workers) {
   const int num_planes = av1_num_planes(cm);
-  for (int i = 0; i < num_planes; ++i) {
-    const int is_uv = (i > 0);
-    av1_upscale_normative_rows(cm, src->buffers[i], src->strides[is_uv],
-                               dst->buffers[i], dst->strides[is_uv], i,
-                               src->crop_heights[is_uv]);
+  const int height = src->y_crop_height;
+  // Bands start at even rows so that they split the chroma rows too.
+  const int band_height =
+      ALIGN_POWER_OF_TWO((height + AOMMAX(num_workers, 1) - 1) /
+                             AOMMAX(num_workers, 1),
+                         3);
+  const int num_bands = (height + band_height - 1) / band_height;
+
+  if (num_bands <= 1) {
+    for (int i = 0; i < num_planes; ++i) {
+      const int is_uv = (i > 0);
+      av1_upscale_normative_rows(cm, src->buffers[i], src->strides[is_uv],
+                                 dst->buffers[i], dst->strides[is_uv], i,
+                                 src->crop_heights[is_uv]);
+    }
+  } else {
+    assert(num_bands <= num_workers);
+    const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+    UpscaleRowsJob *const jobs =
+        (UpscaleRowsJob *)aom_malloc(num_bands * sizeof(*jobs));
+    if (!jobs) {
+      aom_internal_error(cm->error, AOM_CODEC_MEM_ERROR,
+                         "Failed to allocate upscale jobs");
+    }
+    for (int i = num_bands - 1; i >= 0; i--) {
+      AVxWorker *const worker = &workers[i];
+      UpscaleRowsJob *const job = &jobs[i];
+      job->cm = cm;
+      job->src = src;
+      job->dst = dst;
+      job->start_row = i * band_height;
+      job->end_row = AOMMIN(height, (i + 1) * band_height);
+      worker->hook = upscale_rows_worker_hook;
+      worker->data1 = job;
+      worker->data2 = NULL;
+      worker->had_error = 0;
+      // The first band is upscaled by the calling thread.
+      if (i == 0)
+        winterface->execute(worker);
+      else
+        winterface->launch(worker);
+    }
+    int had_error = workers[0].had_error;
+    for (int i = num_bands - 1; i > 0; i--) {
+      if (!winterface->sync(&workers[i])) had_error = 1;
+    }
+    aom_free(jobs);
+    if (had_error) {
+      aom_internal_error(cm->error, AOM_CODEC_MEM_ERROR,
+                         "Error upscaling frame");
+    }
   }
 
   aom_extend_frame_borders(dst, num_planes);
@@ -1410,7 +1502,8 @@ static void copy_buffer_config(const YV12_BUFFER_CONFIG *const src,
 // TODO(afergs): aom_ vs av1_ functions? Which can I use?
 // Upscale decoded image.
 void av1_superres_upscale(AV1_COMMON *cm, BufferPool *const pool,
-                          bool alloc_pyramid) {
+                          bool alloc_pyramid, AVxWorker *workers,
+                          int num_workers) {
   const int num_planes = av1_num_planes(cm);
   if (!av1_superres_scaled(cm)) return;
   const SequenceHeader *const seq_params = cm->seq_params;
@@ -1492,7 +1585,8 @@ void av1_superres_upscale(AV1_COMMON *cm, BufferPool *const pool,
 
   // Scale up and back into frame_to_show.
   assert(frame_to_show->y_crop_width != cm->width);
-  av1_upscale_normative_and_extend_frame(cm, &copy_buffer, frame_to_show);
+  av1_upscale_normative_and_extend_frame(cm, &copy_buffer, frame_to_show,
+                                         workers, num_workers);
 
   // Free the copy buffer
   aom_free_frame_buffer(&copy_buffer);
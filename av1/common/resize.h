@@ -14,6 +14,7 @@
 
 #include <stdio.h>
 #include "aom/aom_integer.h"
+#include "aom_util/aom_thread.h"
 #include "av1/common/av1_common_int.h"
 
 #ifdef __cplusplus
@@ -67,9 +68,13 @@ void av1_highbd_resize_frame444(const uint8_t *y, int y_stride,
 void av1_upscale_normative_rows(const AV1_COMMON *cm, const uint8_t *src,
                                 int src_stride, uint8_t *dst, int dst_stride,
                                 int plane, int rows);
+// Upscales src into dst and extends the borders of dst. With more than one
+// worker, the rows are split into bands that are upscaled in parallel.
 void av1_upscale_normative_and_extend_frame(const AV1_COMMON *cm,
                                             const YV12_BUFFER_CONFIG *src,
-                                            YV12_BUFFER_CONFIG *dst);
+                                            YV12_BUFFER_CONFIG *dst,
+                                            AVxWorker *workers,
+                                            int num_workers);
 
 YV12_BUFFER_CONFIG *av1_realloc_and_scale_if_required(
     AV1_COMMON *cm, YV12_BUFFER_CONFIG *unscaled, YV12_BUFFER_CONFIG *scaled,
@@ -95,7 +100,8 @@ void av1_calculate_scaled_superres_size(int *width, int *height,
 void av1_calculate_unscaled_superres_size(int *width, int *height, int denom);
 
 void av1_superres_upscale(AV1_COMMON *cm, BufferPool *const pool,
-                          bool alloc_pyramid);
+                          bool alloc_pyramid, AVxWorker *workers,
+                          int num_workers);
 
 bool av1_resize_plane_to_half(const uint8_t *const input, int height, int width,
                               int in_stride, uint8_t *output, int height2,
@@ -77,15 +77,35 @@ void av1_alloc_restoration_struct(AV1_COMMON *cm, RestorationInfo *rsi,
   rsi->horz_units = horz_units;
   rsi->vert_units = vert_units;
 
+  if (rsi->unit_info != NULL && rsi->num_rest_units <= rsi->num_allocated_units)
+    return;
+
+  // Allocate for the smallest units of the reserved frame size, so that the
+  // later frames reuse the array.
+  int num_units = rsi->num_rest_units;
+  if (cm->reserved_width > 0) {
+    const int ss_x = is_uv && cm->seq_params->subsampling_x;
+    const int ss_y = is_uv && cm->seq_params->subsampling_y;
+    const int min_unit_size = (RESTORATION_UNITSIZE_MAX >> 2) >> (ss_x && ss_y);
+    num_units = AOMMAX(
+        num_units,
+        av1_lr_count_units(min_unit_size, (cm->reserved_width + ss_x) >> ss_x) *
+            av1_lr_count_units(min_unit_size,
+                               (cm->reserved_height + ss_y) >> ss_y));
+  }
+
   aom_free(rsi->unit_info);
+  rsi->num_allocated_units = 0;
   CHECK_MEM_ERROR(cm, rsi->unit_info,
                   (RestorationUnitInfo *)aom_memalign(
-                      16, sizeof(*rsi->unit_info) * rsi->num_rest_units));
+                      16, sizeof(*rsi->unit_info) * num_units));
+  rsi->num_allocated_units = num_units;
 }
 
 void av1_free_restoration_struct(RestorationInfo *rst_info) {
   aom_free(rst_info->unit_info);
   rst_info->unit_info = NULL;
+  rst_info->num_allocated_units = 0;
 }
 
 #if 0
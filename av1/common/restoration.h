@@ -279,6 +279,12 @@ typedef struct {
    */
   RestorationUnitInfo *unit_info;
 
+  /*!
+   * Number of restoration units unit_info is allocated for, set by
+   * av1_alloc_restoration_struct
+   */
+  int num_allocated_units;
+
   /*!
    * Restoration Stripe boundary info
    */
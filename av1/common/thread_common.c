@@ -939,8 +939,16 @@ static void foreach_rest_unit_in_planes_mt(AV1LrStruct *lr_ctxt,
 
   if (!lr_sync->sync_range || num_rows_lr > lr_sync->rows ||
       num_workers > lr_sync->num_workers || num_planes > lr_sync->num_planes) {
+    // Allocate for the smallest units of the reserved frame size so that
+    // smaller frames reuse it.
+    const int alloc_rows_lr =
+        cm->reserved_height > 0
+            ? AOMMAX(num_rows_lr,
+                     av1_lr_count_units(RESTORATION_UNITSIZE_MAX >> 2,
+                                        cm->reserved_height))
+            : num_rows_lr;
     av1_loop_restoration_dealloc(lr_sync);
-    av1_loop_restoration_alloc(lr_sync, cm, num_workers, num_rows_lr,
+    av1_loop_restoration_alloc(lr_sync, cm, num_workers, alloc_rows_lr,
                                num_planes, cm->width);
   }
   lr_sync->lr_mt_exit = false;
@@ -1238,6 +1246,11 @@ void av1_cdef_frame_mt(AV1_COMMON *const cm, MACROBLOCKD *const xd,
                        num_planes);
 
   reset_cdef_job_info(cdef_sync);
+  // The row sync data may be allocated for a larger frame, whose last row was
+  // left done.
+  const int nvfb = (cm->mi_params.mi_rows + MI_SIZE_64X64 - 1) / MI_SIZE_64X64;
+  for (int fbr = 0; fbr < nvfb; fbr++)
+    cdef_sync->cdef_row_mt[fbr].is_row_done = 0;
   prepare_cdef_frame_workers(cm, xd, cdef_worker, cdef_sb_row_worker_hook,
                              workers, cdef_sync, num_workers,
                              cdef_init_fb_row_fn, do_extend_border);
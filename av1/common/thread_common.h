@@ -133,6 +133,9 @@ typedef struct AV1CdefSyncData {
 #if CONFIG_MULTITHREAD
   // Mutex lock used while dispatching jobs.
   pthread_mutex_t *mutex_;
+  // Signaled when a loop filter row is done, if the search runs along with
+  // the loop filter.
+  pthread_cond_t *cond_;
 #endif  // CONFIG_MULTITHREAD
   // Data related to CDEF row mt sync information
   AV1CdefRowSync *cdef_row_mt;
@@ -145,6 +148,17 @@ typedef struct AV1CdefSyncData {
   // Initialized to false, set to true by the worker thread that encounters
   // an error in order to abort the processing of other worker threads.
   bool cdef_mt_exit;
+  // Number of planes whose horizontal edges are filtered, for each loop filter
+  // row, if the search runs along with the loop filter.
+  int *lf_planes_done;
+  // Number of rows allocated in lf_planes_done.
+  int lf_rows_alloc;
+  // Number of loop filter rows, and of planes filtered in each of them.
+  int lf_rows;
+  int lf_num_planes;
+  // Number of loop filter rows at the top of the frame that are fully
+  // filtered.
+  int lf_rows_done;
 } AV1CdefSync;
 
 void av1_cdef_frame_mt(AV1_COMMON *const cm, MACROBLOCKD *const xd,
@@ -265,10 +279,13 @@ static AOM_INLINE void loop_filter_frame_mt_init(
   const int sb_rows =
       CEIL_POWER_OF_TWO(cm->mi_params.mi_rows, num_mis_in_lpf_unit_height_log2);
 
-  if (!lf_sync->sync_range || sb_rows != lf_sync->rows ||
+  if (!lf_sync->sync_range || sb_rows > lf_sync->rows ||
       num_workers > lf_sync->num_workers) {
+    // Allocate for the reserved frame size so that smaller frames reuse it.
+    const int alloc_sb_rows = CEIL_POWER_OF_TWO(
+        av1_alloc_mi_rows(cm), num_mis_in_lpf_unit_height_log2);
     av1_loop_filter_dealloc(lf_sync);
-    av1_loop_filter_alloc(lf_sync, cm, sb_rows, cm->width, num_workers);
+    av1_loop_filter_alloc(lf_sync, cm, alloc_sb_rows, cm->width, num_workers);
   }
   lf_sync->lf_mt_exit = false;
 
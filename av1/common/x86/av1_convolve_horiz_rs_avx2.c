@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <assert.h>
+#include <immintrin.h>
+
+#include "config/av1_rtcd.h"
+
+#include "av1/common/convolve.h"
+#include "av1/common/resize.h"
+#include "aom_dsp/x86/synonyms.h"
+#include "aom_dsp/x86/synonyms_avx2.h"
+
+static INLINE const int16_t *get_rs_filter(const int16_t *x_filters, int x_qn) {
+  const int x_filter_idx = (x_qn & RS_SCALE_SUBPEL_MASK) >> RS_SCALE_EXTRA_BITS;
+  assert(x_filter_idx <= RS_SUBPEL_MASK);
+  return &x_filters[x_filter_idx * UPSCALE_NORMATIVE_TAPS];
+}
+
+// Loads the filters of output pixels i and i + 4 into the two lanes, for
+// i = 0..3.
+static INLINE void load_rs_filters_x8(const int16_t *x_filters, int x_qn,
+                                      int x_step_qn, __m256i *fil) {
+  for (int i = 0; i < 4; ++i) {
+    fil[i] =
+        yy_loadu2_128(get_rs_filter(x_filters, x_qn + (i + 4) * x_step_qn),
+                      get_rs_filter(x_filters, x_qn + i * x_step_qn));
+  }
+}
+
+// Sums the products in each 32-bit quarter of conv[i], which hold output
+// pixels i and i + 4, and rounds them. Returns output pixels 0..3 in the low
+// lane and 4..7 in the high lane.
+static INLINE __m256i round_rs_sums_x8(const __m256i *conv) {
+  const __m256i round_add = _mm256_set1_epi32((1 << FILTER_BITS) >> 1);
+  // Reduce horizontally and add, i.e. in each lane
+  // ([ D C B A ], [ S R Q P ]) -> [ S+R Q+P D+C B+A ]
+  const __m256i conv01_32 = _mm256_hadd_epi32(conv[0], conv[1]);
+  const __m256i conv23_32 = _mm256_hadd_epi32(conv[2], conv[3]);
+  const __m256i conv0123_32 = _mm256_hadd_epi32(conv01_32, conv23_32);
+  return _mm256_srai_epi32(_mm256_add_epi32(conv0123_32, round_add),
+                           FILTER_BITS);
+}
+
+// Note: If the crop width is not a multiple of 4, then, unlike the C version,
+// this function will overwrite some of the padding on the right hand side of
+// the frame, like the SSE4.1 version.
+void av1_convolve_horiz_rs_avx2(const uint8_t *src, int src_stride,
+                                uint8_t *dst, int dst_stride, int w, int h,
+                                const int16_t *x_filters, int x0_qn,
+                                int x_step_qn) {
+  assert(UPSCALE_NORMATIVE_TAPS == 8);
+
+  const uint8_t *const src_start = src - (UPSCALE_NORMATIVE_TAPS / 2 - 1);
+
+  int x_qn = x0_qn;
+  int x = 0;
+  for (; x + 8 <= w; x += 8, x_qn += 8 * x_step_qn) {
+    __m256i fil[4];
+    load_rs_filters_x8(x_filters, x_qn, x_step_qn, fil);
+
+    int src_x[8];
+    for (int i = 0; i < 8; ++i) {
+      src_x[i] = (x_qn + i * x_step_qn) >> RS_SCALE_SUBPEL_BITS;
+    }
+
+    const uint8_t *src_y = src_start;
+    uint8_t *dst_y = dst;
+    for (int y = 0; y < h; y++, src_y += src_stride, dst_y += dst_stride) {
+      __m256i conv[4];
+      for (int i = 0; i < 4; ++i) {
+        // Load the 8 source pixels of output pixels i and i + 4 and
+        // zero-extend them to 16 bits, one per lane.
+        const __m128i src_8 = _mm_unpacklo_epi64(
+            xx_loadl_64(&src_y[src_x[i]]), xx_loadl_64(&src_y[src_x[i + 4]]));
+        conv[i] = _mm256_madd_epi16(_mm256_cvtepu8_epi16(src_8), fil[i]);
+      }
+      const __m256i shifted_32 = round_rs_sums_x8(conv);
+
+      // Pack to 8 bits, which leaves pixels 0..3 in the low 32 bits of the
+      // low lane and 4..7 in the low 32 bits of the high lane.
+      const __m256i shifted_16 = _mm256_packus_epi32(shifted_32, shifted_32);
+      const __m256i shifted_8 = _mm256_packus_epi16(shifted_16, shifted_16);
+      const __m128i res_8 =
+          _mm_unpacklo_epi32(_mm256_castsi256_si128(shifted_8),
+                             _mm256_extracti128_si256(shifted_8, 1));
+      xx_storel_64(&dst_y[x], res_8);
+    }
+  }
+
+  if (x < w) {
+    av1_convolve_horiz_rs_sse4_1(src, src_stride, dst + x, dst_stride, w - x,
+                                 h, x_filters, x_qn, x_step_qn);
+  }
+}
+
+#if CONFIG_AV1_HIGHBITDEPTH
+// Note: If the crop width is not a multiple of 4, then, unlike the C version,
+// this function will overwrite some of the padding on the right hand side of
+// the frame, like the SSE4.1 version.
+void av1_highbd_convolve_horiz_rs_avx2(const uint16_t *src, int src_stride,
+                                       uint16_t *dst, int dst_stride, int w,
+                                       int h, const int16_t *x_filters,
+                                       int x0_qn, int x_step_qn, int bd) {
+  assert(UPSCALE_NORMATIVE_TAPS == 8);
+  assert(bd == 8 || bd == 10 || bd == 12);
+
+  const uint16_t *const src_start = src - (UPSCALE_NORMATIVE_TAPS / 2 - 1);
+  const __m128i clip_maximum = _mm_set1_epi16((1 << bd) - 1);
+
+  int x_qn = x0_qn;
+  int x = 0;
+  for (; x + 8 <= w; x += 8, x_qn += 8 * x_step_qn) {
+    __m256i fil[4];
+    load_rs_filters_x8(x_filters, x_qn, x_step_qn, fil);
+
+    int src_x[8];
+    for (int i = 0; i < 8; ++i) {
+      src_x[i] = (x_qn + i * x_step_qn) >> RS_SCALE_SUBPEL_BITS;
+    }
+
+    const uint16_t *src_y = src_start;
+    uint16_t *dst_y = dst;
+    for (int y = 0; y < h; y++, src_y += src_stride, dst_y += dst_stride) {
+      __m256i conv[4];
+      for (int i = 0; i < 4; ++i) {
+        // Load the 8 source pixels of output pixels i and i + 4, one per
+        // lane.
+        const __m256i src_16 =
+            yy_loadu2_128(&src_y[src_x[i + 4]], &src_y[src_x[i]]);
+        conv[i] = _mm256_madd_epi16(src_16, fil[i]);
+      }
+      const __m256i shifted_32 = round_rs_sums_x8(conv);
+
+      // Pack to 16 bits, which leaves pixels 0..3 in the low 64 bits of the
+      // low lane and 4..7 in the low 64 bits of the high lane.
+      const __m256i shifted_16 = _mm256_packus_epi32(shifted_32, shifted_32);
+      const __m128i res_16 =
+          _mm_unpacklo_epi64(_mm256_castsi256_si128(shifted_16),
+                             _mm256_extracti128_si256(shifted_16, 1));
+
+      // Clip the values at (1 << bd) - 1
+      xx_storeu_128(&dst_y[x], _mm_min_epi16(res_16, clip_maximum));
+    }
+  }
+
+  if (x < w) {
+    av1_highbd_convolve_horiz_rs_sse4_1(src, src_stride, dst + x, dst_stride,
+                                        w - x, h, x_filters, x_qn, x_step_qn,
+                                        bd);
+  }
+}
+#endif  // CONFIG_AV1_HIGHBITDEPTH
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <arm_neon.h>
+
+#include "config/av1_rtcd.h"
+
+void av1_dequant_coeffs_neon(tran_low_t *coeffs, int n, int dc_q, int ac_q,
+                             int shift, int bd) {
+  const uint32x4_t mask = vdupq_n_u32(0xffffff);
+  const int32x4_t neg_shift = vdupq_n_s32(-shift);
+  const int32x4_t max = vdupq_n_s32((1 << (7 + bd)) - 1);
+  const int32x4_t min = vdupq_n_s32(-(1 << (7 + bd)));
+  uint32x4_t dqv = vsetq_lane_u32((uint32_t)dc_q, vdupq_n_u32(ac_q), 0);
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const int32x4_t level = vld1q_s32(coeffs + i);
+    const uint32x4_t abs_level = vreinterpretq_u32_s32(vabsq_s32(level));
+    const uint32x4_t dq =
+        vshlq_u32(vandq_u32(vmulq_u32(abs_level, dqv), mask), neg_shift);
+    const int32x4_t dq_s32 = vreinterpretq_s32_u32(dq);
+    const int32x4_t res = vbslq_s32(vcltq_s32(level, vdupq_n_s32(0)),
+                                    vnegq_s32(dq_s32), dq_s32);
+    vst1q_s32(coeffs + i, vminq_s32(vmaxq_s32(res, min), max));
+    dqv = vdupq_n_u32(ac_q);
+  }
+  if (i < n) {
+    av1_dequant_coeffs_c(coeffs + i, n - i, i ? ac_q : dc_q, ac_q, shift, bd);
+  }
+}
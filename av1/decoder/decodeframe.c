@@ -10,6 +10,7 @@
  */
 
 #include <assert.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <stddef.h>
 
@@ -363,7 +364,7 @@ static AOM_INLINE void set_offsets(AV1_COMMON *const cm, MACROBLOCKD *const xd,
   set_mi_row_col(xd, tile, mi_row, bh, mi_col, bw, mi_params->mi_rows,
                  mi_params->mi_cols);
 
-  av1_setup_dst_planes(xd->plane, bsize, &cm->cur_frame->buf, mi_row, mi_col, 0,
+  av1_setup_dst_planes(xd->plane, bsize, xd->cur_buf, mi_row, mi_col, 0,
                        num_planes);
 }
 
@@ -658,6 +659,19 @@ static AOM_INLINE void dec_calc_subpel_params_and_extend(
       inter_pred_params->use_hbd_buf, mc_buf[ref], pre, src_stride);
 }
 
+// Returns the buffer that the reference frame 'frame' is predicted from. In
+// multi-threaded tile list decoding, each worker replaces the planes of the
+// first reference frame with the external reference of its tile, as
+// av1_set_reference_dec() does for single-threaded decoding.
+static INLINE const YV12_BUFFER_CONFIG *dec_get_ref_buf(
+    const AV1_COMMON *const cm, const DecoderCodingBlock *dcb,
+    MV_REFERENCE_FRAME frame) {
+  if (dcb->ext_ref_buf != NULL &&
+      get_ref_frame_map_idx(cm, frame) == cm->remapped_ref_idx[0])
+    return dcb->ext_ref_buf;
+  return &get_ref_frame_buf(cm, frame)->buf;
+}
+
 #define IS_DEC 1
 #include "av1/common/reconinter_template.inc"
 #undef IS_DEC
@@ -667,8 +681,8 @@ static void dec_build_inter_predictors(const AV1_COMMON *cm,
                                        const MB_MODE_INFO *mi,
                                        int build_for_obmc, int bw, int bh,
                                        int mi_x, int mi_y) {
-  build_inter_predictors(cm, &dcb->xd, plane, mi, build_for_obmc, bw, bh, mi_x,
-                         mi_y, dcb->mc_buf);
+  build_inter_predictors(cm, dcb, plane, mi, build_for_obmc, bw, bh, mi_x,
+                         mi_y);
 }
 
 static AOM_INLINE void dec_build_inter_predictor(const AV1_COMMON *cm,
@@ -696,6 +710,21 @@ static AOM_INLINE void dec_build_inter_predictor(const AV1_COMMON *cm,
   }
 }
 
+// Points the OBMC prediction from a neighboring block at the external
+// reference of the worker, if any.
+static INLINE void dec_setup_ext_ref_pre_planes(
+    const AV1_COMMON *const cm, DecoderCodingBlock *dcb,
+    const MB_MODE_INFO *nb_mbmi, int mi_row, int mi_col, int num_planes) {
+  if (dcb->ext_ref_buf == NULL) return;
+  MACROBLOCKD *const xd = &dcb->xd;
+  for (int ref = 0; ref < 1 + has_second_ref(nb_mbmi); ++ref) {
+    const MV_REFERENCE_FRAME frame = nb_mbmi->ref_frame[ref];
+    if (get_ref_frame_map_idx(cm, frame) != cm->remapped_ref_idx[0]) continue;
+    av1_setup_pre_planes(xd, ref, dcb->ext_ref_buf, mi_row, mi_col,
+                         xd->block_ref_scale_factors[ref], num_planes);
+  }
+}
+
 static INLINE void dec_build_prediction_by_above_pred(
     MACROBLOCKD *const xd, int rel_mi_row, int rel_mi_col, uint8_t op_mi_size,
     int dir, MB_MODE_INFO *above_mbmi, void *fun_ctxt, const int num_planes) {
@@ -709,6 +738,9 @@ static INLINE void dec_build_prediction_by_above_pred(
 
   av1_setup_build_prediction_by_above_pred(xd, rel_mi_col, op_mi_size,
                                            &backup_mbmi, ctxt, num_planes);
+  dec_setup_ext_ref_pre_planes(ctxt->cm, (DecoderCodingBlock *)ctxt->dcb,
+                               &backup_mbmi, xd->mi_row, above_mi_col,
+                               num_planes);
   mi_x = above_mi_col << MI_SIZE_LOG2;
   mi_y = xd->mi_row << MI_SIZE_LOG2;
 
@@ -765,6 +797,9 @@ static INLINE void dec_build_prediction_by_left_pred(
 
   av1_setup_build_prediction_by_left_pred(xd, rel_mi_row, op_mi_size,
                                           &backup_mbmi, ctxt, num_planes);
+  dec_setup_ext_ref_pre_planes(ctxt->cm, (DecoderCodingBlock *)ctxt->dcb,
+                               &backup_mbmi, left_mi_row, xd->mi_col,
+                               num_planes);
   mi_x = xd->mi_col << MI_SIZE_LOG2;
   mi_y = left_mi_row << MI_SIZE_LOG2;
   const BLOCK_SIZE bsize = xd->mi[0]->bsize;
@@ -828,8 +863,8 @@ static AOM_INLINE void dec_build_obmc_inter_predictors_sb(
                                      dst_stride2);
   const int mi_row = xd->mi_row;
   const int mi_col = xd->mi_col;
-  av1_setup_dst_planes(xd->plane, xd->mi[0]->bsize, &cm->cur_frame->buf, mi_row,
-                       mi_col, 0, num_planes);
+  av1_setup_dst_planes(xd->plane, xd->mi[0]->bsize, xd->cur_buf, mi_row, mi_col,
+                       0, num_planes);
   av1_build_obmc_inter_prediction(cm, xd, dst_buf1, dst_stride1, dst_buf2,
                                   dst_stride2);
 }
@@ -842,6 +877,136 @@ static AOM_INLINE void cfl_store_inter_block(AV1_COMMON *const cm,
   }
 }
 
+static AOM_INLINE void wait_for_ref_frame_rows(const AV1_COMMON *const cm,
+                                               DecoderCodingBlock *dcb,
+                                               MV_REFERENCE_FRAME frame,
+                                               int rows) {
+  int *const rows_ready = &dcb->ref_rows_ready[frame - LAST_FRAME];
+  if (*rows_ready >= rows) return;
+  RefCntBuffer *const ref_buf = get_ref_frame_buf(cm, frame);
+  if (ref_buf == NULL) return;
+  *rows_ready = av1_frameworker_wait_rows(cm->buffer_pool, ref_buf, rows);
+}
+
+// In frame parallel decoding the reference frames may still be decoded by
+// other frame workers. Waits until the reference rows read by the current
+// block are ready.
+static AOM_INLINE void wait_for_ref_rows(const AV1_COMMON *const cm,
+                                         DecoderCodingBlock *dcb,
+                                         BLOCK_SIZE bsize) {
+  const MACROBLOCKD *const xd = &dcb->xd;
+  const MB_MODE_INFO *const mbmi = xd->mi[0];
+
+  if (mbmi->motion_mode == OBMC_CAUSAL) {
+    // The neighboring predictions may use any of the reference frames.
+    for (MV_REFERENCE_FRAME frame = LAST_FRAME; frame <= ALTREF_FRAME; ++frame)
+      wait_for_ref_frame_rows(cm, dcb, frame, INT_MAX);
+    return;
+  }
+
+  for (int ref = 0; ref < 1 + has_second_ref(mbmi); ++ref) {
+    const MV_REFERENCE_FRAME frame = mbmi->ref_frame[ref];
+    if (frame < LAST_FRAME) continue;
+    // Warped, scaled and sub8x8 chroma predictions may read anywhere in the
+    // reference, so they wait for the whole frame.
+    int rows = INT_MAX;
+    if (mbmi->motion_mode == SIMPLE_TRANSLATION &&
+        xd->global_motion[frame].wmtype <= TRANSLATION &&
+        block_size_wide[bsize] >= 8 && block_size_high[bsize] >= 8 &&
+        !av1_is_scaled(get_ref_scale_factors_const(cm, frame))) {
+      // Bottom of the displaced block plus the interpolation filter taps,
+      // which span twice as many luma rows for subsampled chroma.
+      rows = xd->mi_row * MI_SIZE + block_size_high[bsize] +
+             ((mbmi->mv[ref].as_mv.row + 7) >> 3) + 2 * AOM_INTERP_EXTEND + 1;
+    }
+    wait_for_ref_frame_rows(cm, dcb, frame, rows);
+  }
+}
+
+// Prefetches the w x h region of a reference plane at (x, y), clamped to the
+// plane and its border.
+static AOM_INLINE void prefetch_ref_plane(const YV12_BUFFER_CONFIG *const buf,
+                                          int plane, int x, int y, int w,
+                                          int h) {
+  const int is_uv = plane > 0;
+  const int ss_x = is_uv ? buf->subsampling_x : 0;
+  const int ss_y = is_uv ? buf->subsampling_y : 0;
+  const int border_x = buf->border >> ss_x;
+  const int border_y = buf->border >> ss_y;
+  const int x0 = clamp(x, -border_x, buf->widths[is_uv] + border_x - 1);
+  const int x1 = clamp(x + w, x0 + 1, buf->widths[is_uv] + border_x);
+  const int y0 = clamp(y, -border_y, buf->heights[is_uv] + border_y - 1);
+  const int y1 = clamp(y + h, y0 + 1, buf->heights[is_uv] + border_y);
+  const int hbd = (buf->flags & YV12_FLAG_HIGHBITDEPTH) != 0;
+  const uint8_t *const base =
+      hbd ? (const uint8_t *)CONVERT_TO_SHORTPTR(buf->buffers[plane])
+          : buf->buffers[plane];
+  const ptrdiff_t stride = (ptrdiff_t)buf->strides[is_uv] << hbd;
+  const int start = x0 << hbd;
+  const int end = x1 << hbd;
+  for (int row = y0; row < y1; ++row) {
+    const uint8_t *const p = base + row * stride;
+    for (int col = start; col < end; col += 64) __builtin_prefetch(p + col);
+    __builtin_prefetch(p + end - 1);
+  }
+}
+
+// Prefetches the reference pixels read by the translational prediction of an
+// inter block, so that they are in the cache when the block is reconstructed.
+static AOM_INLINE void prefetch_inter_block_refs(
+    const AV1_COMMON *const cm, const DecoderCodingBlock *const dcb,
+    const MB_MODE_INFO *const mbmi, int mi_row, int mi_col) {
+  if (!is_inter_block(mbmi) || is_intrabc_block(mbmi)) return;
+  const int num_planes = av1_num_planes(cm);
+  const int bw = block_size_wide[mbmi->bsize];
+  const int bh = block_size_high[mbmi->bsize];
+  for (int ref = 0; ref < 1 + has_second_ref(mbmi); ++ref) {
+    const MV_REFERENCE_FRAME frame = mbmi->ref_frame[ref];
+    if (av1_is_scaled(get_ref_scale_factors_const(cm, frame))) continue;
+    const MV mv = mbmi->mv[ref].as_mv;
+    // Top left corner of the displaced block and the interpolation filter
+    // taps around it.
+    const int x = mi_col * MI_SIZE + (mv.col >> 3) - (AOM_INTERP_EXTEND - 1);
+    const int y = mi_row * MI_SIZE + (mv.row >> 3) - (AOM_INTERP_EXTEND - 1);
+    const int w = bw + 2 * AOM_INTERP_EXTEND - 1;
+    const int h = bh + 2 * AOM_INTERP_EXTEND - 1;
+    // In frame parallel decoding the rows may not be decoded yet.
+    if (dcb->ref_rows_ready[frame - LAST_FRAME] < y + h) continue;
+    const YV12_BUFFER_CONFIG *const buf = dec_get_ref_buf(cm, dcb, frame);
+    prefetch_ref_plane(buf, AOM_PLANE_Y, x, y, w, h);
+    for (int plane = 1; plane < num_planes; ++plane) {
+      const int ss_x = buf->subsampling_x;
+      const int ss_y = buf->subsampling_y;
+      prefetch_ref_plane(buf, plane, x >> ss_x, y >> ss_y,
+                         ((w - 1) >> ss_x) + 1, ((h - 1) >> ss_y) + 1);
+    }
+  }
+}
+
+// Prefetches the references of the inter blocks of the superblock at
+// (mi_row, mi_col), whose mode info is already decoded.
+static AOM_INLINE void prefetch_sb_inter_refs(const AV1_COMMON *const cm,
+                                              const DecoderCodingBlock *dcb,
+                                              const TileInfo *const tile_info,
+                                              int mi_row, int mi_col) {
+  const CommonModeInfoParams *const mi_params = &cm->mi_params;
+  const int mib_size = cm->seq_params->mib_size;
+  const int row_end = AOMMIN(mi_row + mib_size, tile_info->mi_row_end);
+  const int col_end = AOMMIN(mi_col + mib_size, tile_info->mi_col_end);
+  for (int r = mi_row; r < row_end; ++r) {
+    MB_MODE_INFO **const grid =
+        mi_params->mi_grid_base + r * mi_params->mi_stride;
+    for (int c = mi_col; c < col_end; ++c) {
+      const MB_MODE_INFO *const mbmi = grid[c];
+      // Only visit the top left unit of each block.
+      if (mbmi == NULL || (c > mi_col && grid[c - 1] == mbmi) ||
+          (r > mi_row && grid[c - mi_params->mi_stride] == mbmi))
+        continue;
+      prefetch_inter_block_refs(cm, dcb, mbmi, r, c);
+    }
+  }
+}
+
 static AOM_INLINE void predict_inter_block(AV1_COMMON *const cm,
                                            DecoderCodingBlock *dcb,
                                            BLOCK_SIZE bsize) {
@@ -850,6 +1015,7 @@ static AOM_INLINE void predict_inter_block(AV1_COMMON *const cm,
   const int num_planes = av1_num_planes(cm);
   const int mi_row = xd->mi_row;
   const int mi_col = xd->mi_col;
+  wait_for_ref_rows(cm, dcb, bsize);
   for (int ref = 0; ref < 1 + has_second_ref(mbmi); ++ref) {
     const MV_REFERENCE_FRAME frame = mbmi->ref_frame[ref];
     if (frame < LAST_FRAME) {
@@ -857,13 +1023,13 @@ static AOM_INLINE void predict_inter_block(AV1_COMMON *const cm,
       assert(frame == INTRA_FRAME);
       assert(ref == 0);
     } else {
-      const RefCntBuffer *ref_buf = get_ref_frame_buf(cm, frame);
+      const YV12_BUFFER_CONFIG *ref_buf = dec_get_ref_buf(cm, dcb, frame);
       const struct scale_factors *ref_scale_factors =
           get_ref_scale_factors_const(cm, frame);
 
       xd->block_ref_scale_factors[ref] = ref_scale_factors;
-      av1_setup_pre_planes(xd, ref, &ref_buf->buf, mi_row, mi_col,
-                           ref_scale_factors, num_planes);
+      av1_setup_pre_planes(xd, ref, ref_buf, mi_row, mi_col, ref_scale_factors,
+                           num_planes);
     }
   }
 
@@ -1133,9 +1299,14 @@ static AOM_INLINE void parse_decode_block(AV1Decoder *const pbi,
   MACROBLOCKD *const xd = &dcb->xd;
   decode_mbmi_block(pbi, dcb, mi_row, mi_col, r, partition, bsize);
 
+  AV1_COMMON *cm = &pbi->common;
+  // When the block is reconstructed right after it is parsed, fetch its
+  // references while the coefficients are read.
+  if (td->predict_inter_block_visit == predict_inter_block)
+    prefetch_inter_block_refs(cm, dcb, xd->mi[0], mi_row, mi_col);
+
   av1_visit_palette(pbi, xd, r, av1_decode_palette_tokens);
 
-  AV1_COMMON *cm = &pbi->common;
   const int num_planes = av1_num_planes(cm);
   MB_MODE_INFO *mbmi = xd->mi[0];
   int inter_block_tx = is_inter_block(mbmi) || is_intrabc_block(mbmi);
@@ -1210,7 +1381,7 @@ static AOM_INLINE void set_offsets_for_pred_and_recon(AV1Decoder *const pbi,
   set_mi_row_col(xd, tile, mi_row, bh, mi_col, bw, mi_params->mi_rows,
                  mi_params->mi_cols);
 
-  av1_setup_dst_planes(xd->plane, bsize, &cm->cur_frame->buf, mi_row, mi_col, 0,
+  av1_setup_dst_planes(xd->plane, bsize, xd->cur_buf, mi_row, mi_col, 0,
                        num_planes);
 }
 
@@ -1907,6 +2078,15 @@ static AOM_INLINE void resize_context_buffers(AV1_COMMON *cm, int width,
                        "Dimensions of %dx%d beyond allowed size of %dx%d.",
                        width, height, DECODE_WIDTH_LIMIT, DECODE_HEIGHT_LIMIT);
 #endif
+  if (cm->reserved_width > 0 &&
+      (cm->superres_upscaled_width > cm->reserved_width ||
+       cm->superres_upscaled_height > cm->reserved_height)) {
+    aom_internal_error(cm->error, AOM_CODEC_UNSUP_BITSTREAM,
+                       "Dimensions of %dx%d beyond the frame limits of %dx%d.",
+                       cm->superres_upscaled_width,
+                       cm->superres_upscaled_height, cm->reserved_width,
+                       cm->reserved_height);
+  }
   if (cm->width != width || cm->height != height) {
     const int new_mi_rows = CEIL_POWER_OF_TWO(height, MI_SIZE_LOG2);
     const int new_mi_cols = CEIL_POWER_OF_TWO(width, MI_SIZE_LOG2);
@@ -1915,7 +2095,11 @@ static AOM_INLINE void resize_context_buffers(AV1_COMMON *cm, int width,
     // dimensions as well as the overall size.
     if (new_mi_cols > cm->mi_params.mi_cols ||
         new_mi_rows > cm->mi_params.mi_rows) {
-      if (av1_alloc_context_buffers(cm, width, height, BLOCK_4X4)) {
+      // With frame limits, the buffers are allocated once for the largest
+      // frame.
+      if (av1_alloc_context_buffers(cm, AOMMAX(width, cm->reserved_width),
+                                    AOMMAX(height, cm->reserved_height),
+                                    BLOCK_4X4)) {
         // The cm->mi_* values have been cleared and any existing context
         // buffers have been freed. Clear cm->width and cm->height to be
         // consistent and to force a realloc next time.
@@ -1924,9 +2108,8 @@ static AOM_INLINE void resize_context_buffers(AV1_COMMON *cm, int width,
         aom_internal_error(cm->error, AOM_CODEC_MEM_ERROR,
                            "Failed to allocate context buffers");
       }
-    } else {
-      cm->mi_params.set_mb_mi(&cm->mi_params, width, height, BLOCK_4X4);
     }
+    cm->mi_params.set_mb_mi(&cm->mi_params, width, height, BLOCK_4X4);
     av1_init_mi_buffers(&cm->mi_params);
     cm->width = width;
     cm->height = height;
@@ -2175,6 +2358,12 @@ static AOM_INLINE void read_tile_info(AV1Decoder *const pbi,
   AV1_COMMON *const cm = &pbi->common;
 
   read_tile_info_max_tile(cm, rb);
+  if (pbi->reserved_tiles > 0 &&
+      cm->tiles.rows * cm->tiles.cols > pbi->reserved_tiles) {
+    aom_internal_error(&pbi->error, AOM_CODEC_UNSUP_BITSTREAM,
+                       "%d tiles beyond the frame limit of %d tiles.",
+                       cm->tiles.rows * cm->tiles.cols, pbi->reserved_tiles);
+  }
 
   pbi->context_update_tile_id = 0;
   if (cm->tiles.rows * cm->tiles.cols > 1) {
@@ -2459,15 +2648,22 @@ static AOM_INLINE void set_cb_buffer(AV1Decoder *pbi, DecoderCodingBlock *dcb,
   xd->color_index_map_offset[1] = 0;
 }
 
+// Allocates the tile data for n_tiles tiles, or for the reserved number of
+// tiles if it is larger. The tile data only grows, so a frame with fewer
+// tiles than an earlier one reuses it.
 static AOM_INLINE void decoder_alloc_tile_data(AV1Decoder *pbi,
                                                const int n_tiles) {
   AV1_COMMON *const cm = &pbi->common;
+  if (pbi->tile_data != NULL && n_tiles <= pbi->allocated_tiles) return;
+  const int alloc_tiles = AOMMAX(n_tiles, pbi->reserved_tiles);
+  for (int i = 0; i < pbi->allocated_tiles; i++)
+    av1_dec_row_mt_dealloc(&pbi->tile_data[i].dec_row_mt_sync);
   aom_free(pbi->tile_data);
   pbi->allocated_tiles = 0;
   CHECK_MEM_ERROR(cm, pbi->tile_data,
-                  aom_memalign(32, n_tiles * sizeof(*pbi->tile_data)));
-  pbi->allocated_tiles = n_tiles;
-  for (int i = 0; i < n_tiles; i++) {
+                  aom_memalign(32, alloc_tiles * sizeof(*pbi->tile_data)));
+  pbi->allocated_tiles = alloc_tiles;
+  for (int i = 0; i < alloc_tiles; i++) {
     TileDataDec *const tile_data = pbi->tile_data + i;
     av1_zero(tile_data->dec_row_mt_sync);
   }
@@ -2551,8 +2747,10 @@ void av1_dec_row_mt_dealloc(AV1DecRowMTSync *dec_row_mt_sync) {
   }
 }
 
+// Waits until the SBs above and to the top right of SB (r, c) are decoded. The
+// time spent waiting is added to *idle_time.
 static INLINE void sync_read(AV1DecRowMTSync *const dec_row_mt_sync, int r,
-                             int c) {
+                             int c, int64_t *idle_time) {
 #if CONFIG_MULTITHREAD
   const int nsync = dec_row_mt_sync->sync_range;
 
@@ -2560,9 +2758,16 @@ static INLINE void sync_read(AV1DecRowMTSync *const dec_row_mt_sync, int r,
     pthread_mutex_t *const mutex = &dec_row_mt_sync->mutex_[r - 1];
     pthread_mutex_lock(mutex);
 
-    while (c > dec_row_mt_sync->cur_sb_col[r - 1] - nsync -
-                   dec_row_mt_sync->intrabc_extra_top_right_sb_delay) {
-      pthread_cond_wait(&dec_row_mt_sync->cond_[r - 1], mutex);
+    if (c > dec_row_mt_sync->cur_sb_col[r - 1] - nsync -
+                dec_row_mt_sync->intrabc_extra_top_right_sb_delay) {
+      struct aom_usec_timer timer;
+      aom_usec_timer_start(&timer);
+      while (c > dec_row_mt_sync->cur_sb_col[r - 1] - nsync -
+                     dec_row_mt_sync->intrabc_extra_top_right_sb_delay) {
+        pthread_cond_wait(&dec_row_mt_sync->cond_[r - 1], mutex);
+      }
+      aom_usec_timer_mark(&timer);
+      *idle_time += aom_usec_timer_elapsed(&timer);
     }
     pthread_mutex_unlock(mutex);
   }
@@ -2570,6 +2775,7 @@ static INLINE void sync_read(AV1DecRowMTSync *const dec_row_mt_sync, int r,
   (void)dec_row_mt_sync;
   (void)r;
   (void)c;
+  (void)idle_time;
 #endif  // CONFIG_MULTITHREAD
 }
 
@@ -2637,7 +2843,8 @@ static AOM_INLINE void decode_tile_sb_row(AV1Decoder *pbi, ThreadData *const td,
     set_cb_buffer(pbi, &td->dcb, pbi->cb_buffer_base, num_planes, mi_row,
                   mi_col);
 
-    sync_read(&tile_data->dec_row_mt_sync, sb_row_in_tile, sb_col_in_tile);
+    sync_read(&tile_data->dec_row_mt_sync, sb_row_in_tile, sb_col_in_tile,
+              &td->row_mt_idle_time);
 
 #if CONFIG_MULTITHREAD
     pthread_mutex_lock(pbi->row_mt_mutex_);
@@ -2648,6 +2855,11 @@ static AOM_INLINE void decode_tile_sb_row(AV1Decoder *pbi, ThreadData *const td,
 #endif
 
     if (!row_mt_exit) {
+      // The mode info of the whole row is parsed, so fetch the references of
+      // the next superblock while this one is reconstructed.
+      const int next_mi_col = mi_col + cm->seq_params->mib_size;
+      if (next_mi_col < tile_info->mi_col_end)
+        prefetch_sb_inter_refs(cm, &td->dcb, tile_info, mi_row, next_mi_col);
       // Decoding of the super-block
       decode_partition(pbi, td, mi_row, mi_col, td->bit_reader,
                        cm->seq_params->sb_size, 0x2);
@@ -2808,9 +3020,7 @@ static const uint8_t *decode_tiles(AV1Decoder *pbi, const uint8_t *data,
 #endif  // EXT_TILE_DEBUG
     get_tile_buffers(pbi, data, data_end, tile_buffers, start_tile, end_tile);
 
-  if (pbi->tile_data == NULL || n_tiles != pbi->allocated_tiles) {
-    decoder_alloc_tile_data(pbi, n_tiles);
-  }
+  decoder_alloc_tile_data(pbi, n_tiles);
   if (pbi->dcb.xd.seg_mask == NULL)
     CHECK_MEM_ERROR(cm, pbi->dcb.xd.seg_mask,
                     (uint8_t *)aom_memalign(
@@ -2969,6 +3179,9 @@ static int tile_worker_hook(void *arg1, void *arg2) {
   }
   thread_data->error_info.setjmp = 1;
 
+  struct aom_usec_timer timer;
+  start_stage_timing(pbi, &timer);
+
   allow_update_cdf = cm->tiles.large_scale ? 0 : 1;
   allow_update_cdf = allow_update_cdf && !cm->features.disable_cdf_update;
 
@@ -2991,10 +3204,91 @@ static int tile_worker_hook(void *arg1, void *arg2) {
       break;
     }
   }
+  end_stage_timing(pbi, &timer, &td->busy_time);
+  thread_data->error_info.setjmp = 0;
+  return !td->dcb.corrupted;
+}
+
+// Sets up the destination and reference buffers of a tile of a tile list. The
+// destination is a view of the tile list output buffer in which the tile,
+// addressed in frame coordinates, lands in its slot.
+static AOM_INLINE void setup_tile_list_bufs(AV1Decoder *const pbi,
+                                            ThreadData *const td,
+                                            const TileListEntryDec *entry,
+                                            const TileInfo *tile_info) {
+  AV1_COMMON *const cm = &pbi->common;
+  const YV12_BUFFER_CONFIG *const outbuf = &pbi->tile_list_outbuf;
+  YV12_BUFFER_CONFIG *const dst = &td->tile_list_dst_buf;
+  YV12_BUFFER_CONFIG *const ref = &td->tile_list_ref_buf;
+  int tile_width, tile_height;
+
+  av1_get_uniform_tile_size(cm, &tile_width, &tile_height);
+  *dst = cm->cur_frame->buf;
+  dst->flags = outbuf->flags;
+  for (int plane = 0; plane < MAX_MB_PLANE; ++plane) {
+    const int is_uv = plane > 0;
+    const int ssx = is_uv ? cm->seq_params->subsampling_x : 0;
+    const int ssy = is_uv ? cm->seq_params->subsampling_y : 0;
+    const int x = ((entry->output_col * tile_width * MI_SIZE) >> ssx) -
+                  ((tile_info->mi_col_start * MI_SIZE) >> ssx);
+    const int y = ((entry->output_row * tile_height * MI_SIZE) >> ssy) -
+                  ((tile_info->mi_row_start * MI_SIZE) >> ssy);
+    dst->strides[is_uv] = outbuf->strides[is_uv];
+    dst->buffers[plane] =
+        outbuf->buffers[plane] + (ptrdiff_t)y * outbuf->strides[is_uv] + x;
+  }
+  td->dcb.xd.cur_buf = dst;
+
+  *ref = cm->ref_frame_map[cm->remapped_ref_idx[0]]->buf;
+  ref->y_buffer = entry->ext_ref->y_buffer;
+  ref->u_buffer = entry->ext_ref->u_buffer;
+  ref->v_buffer = entry->ext_ref->v_buffer;
+  td->dcb.ext_ref_buf = ref;
+}
+
+static int tile_list_worker_hook(void *arg1, void *arg2) {
+  DecWorkerData *const thread_data = (DecWorkerData *)arg1;
+  AV1Decoder *const pbi = (AV1Decoder *)arg2;
+  ThreadData *const td = thread_data->td;
+
+  // The jmp_buf is valid only for the duration of the function that calls
+  // setjmp(). Therefore, this function must reset the 'setjmp' field to 0
+  // before it returns.
+  if (setjmp(thread_data->error_info.jmp)) {
+    thread_data->error_info.setjmp = 0;
+    thread_data->td->dcb.corrupted = 1;
+    return 0;
+  }
+  thread_data->error_info.setjmp = 1;
+
+  struct aom_usec_timer timer;
+  start_stage_timing(pbi, &timer);
+
+  set_decode_func_pointers(td, 0x3);
+
+  while (!td->dcb.corrupted) {
+    TileJobsDec *cur_job_info = get_dec_job_info(&pbi->tile_mt_info);
+    if (cur_job_info == NULL) break;
+
+    // The entries of a job share the same tile, so they are decoded in order.
+    TileDataDec *const tile_data = cur_job_info->tile_data;
+    for (int i = 0;
+         i < cur_job_info->num_tile_list_entries && !td->dcb.corrupted; ++i) {
+      const TileListEntryDec *const entry =
+          &cur_job_info->tile_list_entries[i];
+      tile_worker_hook_init(pbi, thread_data, &entry->tile_buffer, tile_data,
+                            0);
+      setup_tile_list_bufs(pbi, td, entry, &tile_data->tile_info);
+      decode_tile(pbi, td, entry->tile_row, entry->tile_col);
+    }
+  }
+  end_stage_timing(pbi, &timer, &td->busy_time);
   thread_data->error_info.setjmp = 0;
   return !td->dcb.corrupted;
 }
 
+// Returns the number of workers that a tile normally gets. Workers that find
+// no job in the tiles below this number steal SB rows from the other tiles.
 static INLINE int get_max_row_mt_workers_per_tile(AV1_COMMON *cm,
                                                   const TileInfo *tile) {
   // NOTE: Currently value of max workers is calculated based
@@ -3035,6 +3329,7 @@ static int get_next_job_info(AV1Decoder *const pbi,
   const int sb_mi_size = mi_size_wide[cm->seq_params->sb_size];
   int num_mis_to_decode, num_threads_working;
   int num_mis_waiting_for_decode;
+  int min_at_max_workers = 1;
   int min_threads_working = INT_MAX;
   int max_mis_to_decode = 0;
   int tile_row_idx, tile_col_idx;
@@ -3080,16 +3375,25 @@ static int get_next_job_info(AV1Decoder *const pbi,
 
       assert(num_mis_to_decode >= num_mis_waiting_for_decode);
 
-      // Pick the tile which has minimum number of threads working on it.
+      // Pick the tile which has minimum number of threads working on it,
+      // preferring the tiles that have fewer than their maximum number of
+      // workers. A worker only takes a tile at its maximum if no other tile
+      // has an SB row to decode, so that the workers of the tiles that are
+      // done help with the tiles that remain instead of waiting.
       if (num_mis_waiting_for_decode > 0) {
-        if (num_threads_working < min_threads_working) {
+        const int at_max_workers =
+            num_threads_working >=
+            get_max_row_mt_workers_per_tile(cm, &tile_data->tile_info);
+        if (at_max_workers < min_at_max_workers ||
+            (at_max_workers == min_at_max_workers &&
+             num_threads_working < min_threads_working)) {
+          min_at_max_workers = at_max_workers;
           min_threads_working = num_threads_working;
           max_mis_to_decode = 0;
         }
-        if (num_threads_working == min_threads_working &&
-            num_mis_to_decode > max_mis_to_decode &&
-            num_threads_working <
-                get_max_row_mt_workers_per_tile(cm, &tile_data->tile_info)) {
+        if (at_max_workers == min_at_max_workers &&
+            num_threads_working == min_threads_working &&
+            num_mis_to_decode > max_mis_to_decode) {
           max_mis_to_decode = num_mis_to_decode;
           tile_row = tile_row_idx;
           tile_col = tile_col_idx;
@@ -3186,6 +3490,78 @@ static AOM_INLINE void parse_tile_row_mt(AV1Decoder *pbi, ThreadData *const td,
   aom_merge_corrupted_flag(&dcb->corrupted, corrupted);
 }
 
+// Makes the workers waiting in loop_filter_rows_with_dec() return when
+// decoding is aborted.
+static AOM_INLINE void signal_lpf_mt_with_dec_exit(AV1Decoder *const pbi) {
+  AV1LfSync *const lf_sync = &pbi->lf_row_sync;
+
+  if (!pbi->frame_row_mt_info.pipeline_lpf_mt_with_dec) return;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(lf_sync->job_mutex);
+  lf_sync->lf_mt_exit = true;
+  pthread_mutex_unlock(lf_sync->job_mutex);
+#endif
+  av1_set_vert_loop_filter_done(&pbi->common, lf_sync, MAX_MIB_SIZE_LOG2);
+}
+
+// Loop filters the frame with the jobs queued by lpf_mt_with_dec_init(). A
+// row of the frame is filtered once it and the SB row below it are decoded,
+// as the intra prediction of the SB row below reads its unfiltered pixels.
+static AOM_INLINE void loop_filter_rows_with_dec(
+    AV1Decoder *const pbi, DecWorkerData *const thread_data) {
+  AV1_COMMON *const cm = &pbi->common;
+  AV1DecRowMTInfo *const frame_row_mt_info = &pbi->frame_row_mt_info;
+  AV1LfSync *const lf_sync = &pbi->lf_row_sync;
+  LFWorkerData *const lf_data =
+      &lf_sync->lfdata[thread_data - pbi->thread_data];
+  const int mib_size_log2 = cm->seq_params->mib_size_log2;
+  const int sb_rows = CEIL_POWER_OF_TWO(cm->mi_params.mi_rows, mib_size_log2);
+  const int tile_cols =
+      frame_row_mt_info->tile_cols_end - frame_row_mt_info->tile_cols_start;
+  AV1LfMTInfo *cur_job_info;
+
+  while ((cur_job_info = get_lf_job_info(lf_sync)) != NULL) {
+    const int start_sb_row = cur_job_info->mi_row >> mib_size_log2;
+    const int end_sb_row = AOMMIN(
+        sb_rows - 1, (cur_job_info->mi_row + MAX_MIB_SIZE) >> mib_size_log2);
+    int row_mt_exit = 0;
+#if CONFIG_MULTITHREAD
+    struct aom_usec_timer timer;
+    int waited = 0;
+    pthread_mutex_lock(pbi->row_mt_mutex_);
+    while (1) {
+      row_mt_exit = frame_row_mt_info->row_mt_exit;
+      int sb_row = start_sb_row;
+      while (sb_row <= end_sb_row &&
+             frame_row_mt_info->num_tile_cols_done[sb_row] == tile_cols)
+        ++sb_row;
+      if (row_mt_exit || sb_row > end_sb_row) break;
+      if (!waited) {
+        aom_usec_timer_start(&timer);
+        waited = 1;
+      }
+      pthread_cond_wait(pbi->row_mt_cond_, pbi->row_mt_mutex_);
+    }
+    pthread_mutex_unlock(pbi->row_mt_mutex_);
+    if (waited) {
+      aom_usec_timer_mark(&timer);
+      thread_data->td->row_mt_idle_time += aom_usec_timer_elapsed(&timer);
+    }
+#else
+    (void)start_sb_row;
+    (void)end_sb_row;
+    (void)tile_cols;
+#endif
+    if (row_mt_exit) return;
+
+    av1_thread_loop_filter_rows(
+        lf_data->frame_buffer, lf_data->cm, lf_data->planes, lf_data->xd,
+        cur_job_info->mi_row, cur_job_info->plane, cur_job_info->dir,
+        cur_job_info->lpf_opt_level, lf_sync, &thread_data->error_info,
+        lf_data->params_buf, lf_data->tx_buf, MAX_MIB_SIZE_LOG2);
+  }
+}
+
 static int row_mt_worker_hook(void *arg1, void *arg2) {
   DecWorkerData *const thread_data = (DecWorkerData *)arg1;
   AV1Decoder *const pbi = (AV1Decoder *)arg2;
@@ -3214,10 +3590,14 @@ static int row_mt_worker_hook(void *arg1, void *arg2) {
     // wait upon the completion of SB's present in erroneous row are not waiting
     // indefinitely.
     signal_decoding_done_for_erroneous_row(pbi, &thread_data->td->dcb.xd);
+    signal_lpf_mt_with_dec_exit(pbi);
     return 0;
   }
   thread_data->error_info.setjmp = 1;
 
+  struct aom_usec_timer timer;
+  start_stage_timing(pbi, &timer);
+
   AV1_COMMON *cm = &pbi->common;
   allow_update_cdf = cm->tiles.large_scale ? 0 : 1;
   allow_update_cdf = allow_update_cdf && !cm->features.disable_cdf_update;
@@ -3241,7 +3621,10 @@ static int row_mt_worker_hook(void *arg1, void *arg2) {
       pthread_mutex_unlock(pbi->row_mt_mutex_);
 #endif
       // decode tile
+      struct aom_usec_timer parse_timer;
+      start_stage_timing(pbi, &parse_timer);
       parse_tile_row_mt(pbi, td, tile_data);
+      end_stage_timing(pbi, &parse_timer, &td->row_mt_parse_time);
 #if CONFIG_MULTITHREAD
       pthread_mutex_lock(pbi->row_mt_mutex_);
 #endif
@@ -3264,6 +3647,7 @@ static int row_mt_worker_hook(void *arg1, void *arg2) {
     pthread_cond_broadcast(pbi->row_mt_cond_);
     pthread_mutex_unlock(pbi->row_mt_mutex_);
 #endif
+    signal_lpf_mt_with_dec_exit(pbi);
     return 0;
   }
 
@@ -3276,10 +3660,16 @@ static int row_mt_worker_hook(void *arg1, void *arg2) {
 #if CONFIG_MULTITHREAD
     pthread_mutex_lock(pbi->row_mt_mutex_);
 #endif
-    while (!get_next_job_info(pbi, &next_job_info, &end_of_frame)) {
+    if (!get_next_job_info(pbi, &next_job_info, &end_of_frame)) {
+      struct aom_usec_timer idle_timer;
+      aom_usec_timer_start(&idle_timer);
+      while (!get_next_job_info(pbi, &next_job_info, &end_of_frame)) {
 #if CONFIG_MULTITHREAD
-      pthread_cond_wait(pbi->row_mt_cond_, pbi->row_mt_mutex_);
+        pthread_cond_wait(pbi->row_mt_cond_, pbi->row_mt_mutex_);
 #endif
+      }
+      aom_usec_timer_mark(&idle_timer);
+      td->row_mt_idle_time += aom_usec_timer_elapsed(&idle_timer);
     }
 #if CONFIG_MULTITHREAD
     pthread_mutex_unlock(pbi->row_mt_mutex_);
@@ -3299,16 +3689,38 @@ static int row_mt_worker_hook(void *arg1, void *arg2) {
     av1_init_macroblockd(cm, &td->dcb.xd);
     td->dcb.xd.error_info = &thread_data->error_info;
 
+    // The time decode_tile_sb_row() waits for the SB rows above is idle time.
+    const int64_t idle_time = td->row_mt_idle_time;
+    struct aom_usec_timer recon_timer;
+    start_stage_timing(pbi, &recon_timer);
     decode_tile_sb_row(pbi, td, &tile_data->tile_info, mi_row);
+    end_stage_timing(pbi, &recon_timer, &td->row_mt_recon_time);
+    td->row_mt_recon_time -= td->row_mt_idle_time - idle_time;
 
 #if CONFIG_MULTITHREAD
     pthread_mutex_lock(pbi->row_mt_mutex_);
 #endif
     dec_row_mt_sync->num_threads_working--;
+    if (frame_row_mt_info->pipeline_lpf_mt_with_dec) {
+      const int sb_row = mi_row >> cm->seq_params->mib_size_log2;
+      const int tile_cols = frame_row_mt_info->tile_cols_end -
+                            frame_row_mt_info->tile_cols_start;
+      // Wake up the workers waiting to loop filter this SB row.
+      if (++frame_row_mt_info->num_tile_cols_done[sb_row] == tile_cols) {
+#if CONFIG_MULTITHREAD
+        pthread_cond_broadcast(pbi->row_mt_cond_);
+#endif
+      }
+    }
 #if CONFIG_MULTITHREAD
     pthread_mutex_unlock(pbi->row_mt_mutex_);
 #endif
   }
+
+  if (frame_row_mt_info->pipeline_lpf_mt_with_dec)
+    loop_filter_rows_with_dec(pbi, thread_data);
+
+  end_stage_timing(pbi, &timer, &td->busy_time);
   thread_data->error_info.setjmp = 0;
   return !td->dcb.corrupted;
 }
@@ -3343,11 +3755,8 @@ static AOM_INLINE void enqueue_tile_jobs(AV1Decoder *pbi, AV1_COMMON *cm,
 }
 
 static AOM_INLINE void alloc_dec_jobs(AV1DecTileMT *tile_mt_info,
-                                      AV1_COMMON *cm, int tile_rows,
-                                      int tile_cols) {
-  tile_mt_info->alloc_tile_rows = tile_rows;
-  tile_mt_info->alloc_tile_cols = tile_cols;
-  int num_tiles = tile_rows * tile_cols;
+                                      AV1_COMMON *cm, int num_tiles) {
+  tile_mt_info->alloc_tiles = num_tiles;
 #if CONFIG_MULTITHREAD
   {
     CHECK_MEM_ERROR(cm, tile_mt_info->job_mutex,
@@ -3442,6 +3851,10 @@ static AOM_INLINE void reset_dec_workers(AV1Decoder *pbi,
       thread_data->td->dcb.xd.tmp_obmc_bufs[j] =
           thread_data->td->tmp_obmc_bufs[j];
     }
+    thread_data->td->row_mt_idle_time = 0;
+    thread_data->td->row_mt_parse_time = 0;
+    thread_data->td->row_mt_recon_time = 0;
+    thread_data->td->busy_time = 0;
     winterface->sync(worker);
 
     worker->hook = worker_hook;
@@ -3487,6 +3900,26 @@ static AOM_INLINE void sync_dec_workers(AV1Decoder *pbi, int num_workers) {
   pbi->dcb.corrupted = corrupted;
 }
 
+// Adds the times of the tile workers to the stage statistics. The timer was
+// started before the workers were launched.
+static AOM_INLINE void add_dec_worker_stats(AV1Decoder *pbi,
+                                            struct aom_usec_timer *timer,
+                                            int num_workers) {
+  if (!pbi->stage_stats_enabled) return;
+  aom_decode_stage_stats_t *const stats = &pbi->stage_stats;
+  aom_usec_timer_mark(timer);
+  const int64_t elapsed = aom_usec_timer_elapsed(timer);
+  int64_t busy_time = 0;
+  for (int worker_idx = 0; worker_idx < num_workers; ++worker_idx) {
+    const ThreadData *const td = pbi->thread_data[worker_idx].td;
+    busy_time += AOMMAX(td->busy_time - td->row_mt_idle_time, 0);
+    stats->entropy_decode_us += td->row_mt_parse_time;
+    stats->reconstruction_us += td->row_mt_recon_time;
+  }
+  stats->worker_busy_us += busy_time;
+  stats->worker_idle_us += AOMMAX(elapsed * num_workers - busy_time, 0);
+}
+
 static AOM_INLINE void decode_mt_init(AV1Decoder *pbi) {
   AV1_COMMON *const cm = &pbi->common;
   const AVxWorkerInterface *const winterface = aom_get_worker_interface();
@@ -3506,6 +3939,8 @@ static AOM_INLINE void decode_mt_init(AV1Decoder *pbi) {
 
       winterface->init(worker);
       worker->thread_name = "aom tile worker";
+      worker->pool = pbi->thread_pool;
+      worker->pool_client = pbi->thread_pool_client;
       if (worker_idx != 0 && !winterface->reset(worker)) {
         aom_internal_error(&pbi->error, AOM_CODEC_ERROR,
                            "Tile decoder thread creation failed");
@@ -3542,10 +3977,10 @@ static AOM_INLINE void tile_mt_queue(AV1Decoder *pbi, int tile_cols,
                                      int tile_cols_end, int start_tile,
                                      int end_tile) {
   AV1_COMMON *const cm = &pbi->common;
-  if (pbi->tile_mt_info.alloc_tile_cols != tile_cols ||
-      pbi->tile_mt_info.alloc_tile_rows != tile_rows) {
+  if (pbi->tile_mt_info.alloc_tiles < tile_rows * tile_cols) {
     av1_dealloc_dec_jobs(&pbi->tile_mt_info);
-    alloc_dec_jobs(&pbi->tile_mt_info, cm, tile_rows, tile_cols);
+    alloc_dec_jobs(&pbi->tile_mt_info, cm,
+                   AOMMAX(tile_rows * tile_cols, pbi->reserved_tiles));
   }
   enqueue_tile_jobs(pbi, cm, tile_rows_start, tile_rows_end, tile_cols_start,
                     tile_cols_end, start_tile, end_tile);
@@ -3614,9 +4049,7 @@ static const uint8_t *decode_tiles_mt(AV1Decoder *pbi, const uint8_t *data,
 #endif  // EXT_TILE_DEBUG
     get_tile_buffers(pbi, data, data_end, tile_buffers, start_tile, end_tile);
 
-  if (pbi->tile_data == NULL || n_tiles != pbi->allocated_tiles) {
-    decoder_alloc_tile_data(pbi, n_tiles);
-  }
+  decoder_alloc_tile_data(pbi, n_tiles);
   if (pbi->dcb.xd.seg_mask == NULL)
     CHECK_MEM_ERROR(cm, pbi->dcb.xd.seg_mask,
                     (uint8_t *)aom_memalign(
@@ -3632,9 +4065,12 @@ static const uint8_t *decode_tiles_mt(AV1Decoder *pbi, const uint8_t *data,
   tile_mt_queue(pbi, tile_cols, tile_rows, tile_rows_start, tile_rows_end,
                 tile_cols_start, tile_cols_end, start_tile, end_tile);
 
+  struct aom_usec_timer timer;
   reset_dec_workers(pbi, tile_worker_hook, num_workers);
+  start_stage_timing(pbi, &timer);
   launch_dec_workers(pbi, data_end, num_workers);
   sync_dec_workers(pbi, num_workers);
+  add_dec_worker_stats(pbi, &timer, num_workers);
 
   if (pbi->dcb.corrupted)
     aom_internal_error(&pbi->error, AOM_CODEC_CORRUPT_FRAME,
@@ -3653,12 +4089,99 @@ static const uint8_t *decode_tiles_mt(AV1Decoder *pbi, const uint8_t *data,
   return aom_reader_find_end(&tile_data->bit_reader);
 }
 
+static int compare_tile_list_entries(const void *a, const void *b) {
+  const TileListEntryDec *const entry1 = (const TileListEntryDec *)a;
+  const TileListEntryDec *const entry2 = (const TileListEntryDec *)b;
+  if (entry1->tile_row != entry2->tile_row)
+    return entry1->tile_row - entry2->tile_row;
+  if (entry1->tile_col != entry2->tile_col)
+    return entry1->tile_col - entry2->tile_col;
+  if (entry1->output_row != entry2->output_row)
+    return entry1->output_row - entry2->output_row;
+  return entry1->output_col - entry2->output_col;
+}
+
+void av1_decode_tile_list_mt(AV1Decoder *pbi, const uint8_t *data_end,
+                             int num_entries) {
+  AV1_COMMON *const cm = &pbi->common;
+  CommonTileParams *const tiles = &cm->tiles;
+  AV1DecTileMT *const tile_mt_info = &pbi->tile_mt_info;
+  TileListEntryDec *const entries = pbi->tile_list_entries;
+  const int n_tiles = tiles->cols * tiles->rows;
+
+  assert(tiles->large_scale && tiles->single_tile_decoding);
+  assert(num_entries > 0 && num_entries <= MAX_TILES);
+
+  pbi->dcb.xd.error_info = cm->error;
+  decode_mt_init(pbi);
+
+  decoder_alloc_tile_data(pbi, n_tiles);
+  if (pbi->dcb.xd.seg_mask == NULL)
+    CHECK_MEM_ERROR(cm, pbi->dcb.xd.seg_mask,
+                    (uint8_t *)aom_memalign(
+                        16, 2 * MAX_SB_SQUARE * sizeof(*pbi->dcb.xd.seg_mask)));
+
+  for (int row = 0; row < tiles->rows; row++) {
+    for (int col = 0; col < tiles->cols; col++) {
+      TileDataDec *tile_data = pbi->tile_data + row * tiles->cols + col;
+      av1_tile_init(&tile_data->tile_info, cm, row, col);
+    }
+  }
+
+  if (tile_mt_info->alloc_tiles < tiles->rows * tiles->cols) {
+    av1_dealloc_dec_jobs(tile_mt_info);
+    alloc_dec_jobs(tile_mt_info, cm,
+                   AOMMAX(tiles->rows * tiles->cols, pbi->reserved_tiles));
+  }
+
+  // The entries that use the same tile share its mode info and contexts, so
+  // each tile becomes one job that decodes its entries one after another.
+  qsort(entries, num_entries, sizeof(*entries), compare_tile_list_entries);
+  tile_mt_info->jobs_enqueued = 0;
+  tile_mt_info->jobs_dequeued = 0;
+  TileJobsDec *job = NULL;
+  for (int i = 0; i < num_entries; ++i) {
+    const TileListEntryDec *const entry = &entries[i];
+    if (job == NULL || entry->tile_row != entry[-1].tile_row ||
+        entry->tile_col != entry[-1].tile_col) {
+      job = tile_mt_info->job_queue + tile_mt_info->jobs_enqueued++;
+      job->tile_buffer = NULL;
+      job->tile_data =
+          pbi->tile_data + entry->tile_row * tiles->cols + entry->tile_col;
+      job->tile_list_entries = entry;
+      job->num_tile_list_entries = 0;
+    }
+    job->num_tile_list_entries++;
+  }
+  assert(tile_mt_info->jobs_enqueued <= n_tiles);
+
+  const int num_workers =
+      AOMMIN(pbi->max_threads, tile_mt_info->jobs_enqueued);
+  struct aom_usec_timer timer;
+  reset_dec_workers(pbi, tile_list_worker_hook, num_workers);
+  start_stage_timing(pbi, &timer);
+  launch_dec_workers(pbi, data_end, num_workers);
+  sync_dec_workers(pbi, num_workers);
+  add_dec_worker_stats(pbi, &timer, num_workers);
+  end_stage_timing(pbi, &timer, &pbi->stage_stats.tile_decode_us);
+
+  if (pbi->dcb.corrupted)
+    aom_internal_error(&pbi->error, AOM_CODEC_CORRUPT_FRAME,
+                       "Failed to decode tile data");
+}
+
 static AOM_INLINE void dec_alloc_cb_buf(AV1Decoder *pbi) {
   AV1_COMMON *const cm = &pbi->common;
   int size = ((cm->mi_params.mi_rows >> cm->seq_params->mib_size_log2) + 1) *
              ((cm->mi_params.mi_cols >> cm->seq_params->mib_size_log2) + 1);
 
   if (pbi->cb_buffer_alloc_size < size) {
+    // With frame limits, allocate for the superblocks of the largest frame.
+    if (cm->reserved_width > 0) {
+      size = AOMMAX(size,
+                    ((av1_alloc_mi_rows(cm) >> MIN_MIB_SIZE_LOG2) + 1) *
+                        ((av1_alloc_mi_cols(cm) >> MIN_MIB_SIZE_LOG2) + 1));
+    }
     av1_dec_free_cb_buf(pbi);
     CHECK_MEM_ERROR(cm, pbi->cb_buffer_base,
                     aom_memalign(32, sizeof(*pbi->cb_buffer_base) * size));
@@ -3735,6 +4258,53 @@ static AOM_INLINE void row_mt_frame_init(AV1Decoder *pbi, int tile_rows_start,
 #endif
 }
 
+// Queues the loop filter jobs of the frame for the row-mt decode workers, if
+// the loop filter is enabled.
+static AOM_INLINE void lpf_mt_with_dec_init(AV1Decoder *pbi, int num_workers) {
+#if CONFIG_MULTITHREAD
+  AV1_COMMON *const cm = &pbi->common;
+  AV1DecRowMTInfo *const frame_row_mt_info = &pbi->frame_row_mt_info;
+  const int num_planes = av1_num_planes(cm);
+  const int sb_rows =
+      CEIL_POWER_OF_TWO(cm->mi_params.mi_rows, cm->seq_params->mib_size_log2);
+  int planes_to_lf[MAX_MB_PLANE];
+
+  if (!check_planes_to_loop_filter(&cm->lf, planes_to_lf, 0, num_planes))
+    return;
+
+  if (frame_row_mt_info->allocated_sb_rows < sb_rows) {
+    const int alloc_sb_rows =
+        cm->reserved_height > 0
+            ? AOMMAX(sb_rows, CEIL_POWER_OF_TWO(av1_alloc_mi_rows(cm),
+                                                MIN_MIB_SIZE_LOG2))
+            : sb_rows;
+    aom_free(frame_row_mt_info->num_tile_cols_done);
+    frame_row_mt_info->allocated_sb_rows = 0;
+    CHECK_MEM_ERROR(cm, frame_row_mt_info->num_tile_cols_done,
+                    aom_malloc(sizeof(*frame_row_mt_info->num_tile_cols_done) *
+                               alloc_sb_rows));
+    frame_row_mt_info->allocated_sb_rows = alloc_sb_rows;
+  }
+  memset(frame_row_mt_info->num_tile_cols_done, 0,
+         sizeof(*frame_row_mt_info->num_tile_cols_done) * sb_rows);
+
+  av1_loop_filter_frame_init(cm, 0, num_planes);
+  // The filter data is allocated for all the threads, so that a frame with
+  // more SB rows, and hence more workers, does not reallocate the sync data.
+  loop_filter_frame_mt_init(cm, 0, cm->mi_params.mi_rows, planes_to_lf,
+                            pbi->max_threads, &pbi->lf_row_sync, 0,
+                            MAX_MIB_SIZE_LOG2);
+  for (int i = 0; i < num_workers; ++i) {
+    loop_filter_data_reset(&pbi->lf_row_sync.lfdata[i], &cm->cur_frame->buf,
+                           cm, &pbi->dcb.xd);
+  }
+  frame_row_mt_info->pipeline_lpf_mt_with_dec = 1;
+#else
+  (void)pbi;
+  (void)num_workers;
+#endif
+}
+
 static const uint8_t *decode_tiles_row_mt(AV1Decoder *pbi, const uint8_t *data,
                                           const uint8_t *data_end,
                                           int start_tile, int end_tile) {
@@ -3800,15 +4370,7 @@ static const uint8_t *decode_tiles_row_mt(AV1Decoder *pbi, const uint8_t *data,
 #endif  // EXT_TILE_DEBUG
     get_tile_buffers(pbi, data, data_end, tile_buffers, start_tile, end_tile);
 
-  if (pbi->tile_data == NULL || n_tiles != pbi->allocated_tiles) {
-    if (pbi->tile_data != NULL) {
-      for (int i = 0; i < pbi->allocated_tiles; i++) {
-        TileDataDec *const tile_data = pbi->tile_data + i;
-        av1_dec_row_mt_dealloc(&tile_data->dec_row_mt_sync);
-      }
-    }
-    decoder_alloc_tile_data(pbi, n_tiles);
-  }
+  decoder_alloc_tile_data(pbi, n_tiles);
   if (pbi->dcb.xd.seg_mask == NULL)
     CHECK_MEM_ERROR(cm, pbi->dcb.xd.seg_mask,
                     (uint8_t *)aom_memalign(
@@ -3819,20 +4381,30 @@ static const uint8_t *decode_tiles_row_mt(AV1Decoder *pbi, const uint8_t *data,
       TileDataDec *tile_data = pbi->tile_data + row * tiles->cols + col;
       av1_tile_init(&tile_data->tile_info, cm, row, col);
 
-      max_sb_rows = AOMMAX(max_sb_rows,
-                           av1_get_sb_rows_in_tile(cm, &tile_data->tile_info));
-      num_workers += get_max_row_mt_workers_per_tile(cm, &tile_data->tile_info);
+      const int sb_rows = av1_get_sb_rows_in_tile(cm, &tile_data->tile_info);
+      max_sb_rows = AOMMAX(max_sb_rows, sb_rows);
+      // Each SB row of a tile can keep a worker busy once the workers steal
+      // rows across tiles.
+      num_workers += sb_rows;
     }
   }
   num_workers = AOMMIN(num_workers, max_threads);
 
-  if (pbi->allocated_row_mt_sync_rows != max_sb_rows) {
-    for (int i = 0; i < n_tiles; ++i) {
+  if (pbi->allocated_row_mt_sync_rows < max_sb_rows) {
+    // The sync data only grows, and is allocated for all the tiles of the
+    // tile data and the SB rows of the reserved frame size, so that the later
+    // frames reuse it.
+    const int alloc_sb_rows =
+        cm->reserved_height > 0
+            ? AOMMAX(max_sb_rows, CEIL_POWER_OF_TWO(av1_alloc_mi_rows(cm),
+                                                    MIN_MIB_SIZE_LOG2))
+            : max_sb_rows;
+    for (int i = 0; i < pbi->allocated_tiles; ++i) {
       TileDataDec *const tile_data = pbi->tile_data + i;
       av1_dec_row_mt_dealloc(&tile_data->dec_row_mt_sync);
-      dec_row_mt_alloc(&tile_data->dec_row_mt_sync, cm, max_sb_rows);
+      dec_row_mt_alloc(&tile_data->dec_row_mt_sync, cm, alloc_sb_rows);
     }
-    pbi->allocated_row_mt_sync_rows = max_sb_rows;
+    pbi->allocated_row_mt_sync_rows = alloc_sb_rows;
   }
 
   tile_mt_queue(pbi, tile_cols, tile_rows, tile_rows_start, tile_rows_end,
@@ -3843,9 +4415,20 @@ static const uint8_t *decode_tiles_row_mt(AV1Decoder *pbi, const uint8_t *data,
   row_mt_frame_init(pbi, tile_rows_start, tile_rows_end, tile_cols_start,
                     tile_cols_end, start_tile, end_tile, max_sb_rows);
 
+  // The loop filter can only start on a row once the whole frame is being
+  // decoded, i.e. when this tile group holds all the tiles.
+  if (!tiles->large_scale && !tiles->single_tile_decoding &&
+      !cm->features.allow_intrabc && start_tile == 0 &&
+      end_tile == n_tiles - 1 && num_workers > 1) {
+    lpf_mt_with_dec_init(pbi, num_workers);
+  }
+
+  struct aom_usec_timer timer;
   reset_dec_workers(pbi, row_mt_worker_hook, num_workers);
+  start_stage_timing(pbi, &timer);
   launch_dec_workers(pbi, data_end, num_workers);
   sync_dec_workers(pbi, num_workers);
+  add_dec_worker_stats(pbi, &timer, num_workers);
 
   if (pbi->dcb.corrupted)
     aom_internal_error(&pbi->error, AOM_CODEC_CORRUPT_FRAME,
@@ -5021,9 +5604,12 @@ static int read_uncompressed_header(AV1Decoder *pbi,
   if (above_contexts->num_planes < av1_num_planes(cm) ||
       above_contexts->num_mi_cols < cm->mi_params.mi_cols ||
       above_contexts->num_tile_rows < cm->tiles.rows) {
+    // With frame limits, allocate for the largest frame and tile rows.
+    const int num_tile_rows =
+        AOMMAX(cm->tiles.rows, AOMMIN(pbi->reserved_tiles, MAX_TILE_ROWS));
     av1_free_above_context_buffers(above_contexts);
-    if (av1_alloc_above_context_buffers(above_contexts, cm->tiles.rows,
-                                        cm->mi_params.mi_cols,
+    if (av1_alloc_above_context_buffers(above_contexts, num_tile_rows,
+                                        av1_alloc_mi_cols(cm),
                                         av1_num_planes(cm))) {
       aom_internal_error(&pbi->error, AOM_CODEC_MEM_ERROR,
                          "Failed to allocate context buffers");
@@ -5153,7 +5739,21 @@ static AOM_INLINE void superres_post_decode(AV1Decoder *pbi) {
   if (!av1_superres_scaled(cm)) return;
   assert(!cm->features.all_lossless);
 
-  av1_superres_upscale(cm, pool, 0);
+  // Superres runs between CDEF and loop restoration, so the tile workers are
+  // free to upscale bands of rows.
+  av1_superres_upscale(cm, pool, 0, pbi->tile_workers, pbi->num_workers);
+}
+
+// Returns whether pbi->decode_mode leaves out the current frame. Its headers
+// are still read, so the reference frames it refreshes are tracked.
+static int is_frame_skipped_by_decode_mode(const AV1Decoder *pbi) {
+  const AV1_COMMON *const cm = &pbi->common;
+  switch (pbi->decode_mode) {
+    case AOM_DECODE_REFERENCE_FRAMES:
+      return cm->current_frame.refresh_frame_flags == 0;
+    case AOM_DECODE_INTRA_FRAMES: return !frame_is_intra_only(cm);
+    default: return 0;
+  }
 }
 
 uint32_t av1_decode_frame_headers_and_setup(AV1Decoder *pbi,
@@ -5163,6 +5763,9 @@ uint32_t av1_decode_frame_headers_and_setup(AV1Decoder *pbi,
   const int num_planes = av1_num_planes(cm);
   MACROBLOCKD *const xd = &pbi->dcb.xd;
 
+  // Set again once the tiles of this frame are decoded.
+  pbi->mi_grid_valid = 0;
+
 #if CONFIG_BITSTREAM_DEBUG
   if (cm->seq_params->order_hint_info.enable_order_hint) {
     aom_bitstream_queue_set_frame_read(cm->current_frame.order_hint * 2 +
@@ -5218,10 +5821,45 @@ uint32_t av1_decode_frame_headers_and_setup(AV1Decoder *pbi,
   cm->mi_params.setup_mi(&cm->mi_params);
 
   av1_calculate_ref_frame_side(cm);
-  if (cm->features.allow_ref_frame_mvs) av1_setup_motion_field(cm);
 
   av1_setup_block_planes(xd, cm->seq_params->subsampling_x,
                          cm->seq_params->subsampling_y, num_planes);
+
+  // The tiles of a skipped frame are not decoded, so neither its motion field
+  // nor its entropy context is needed.
+  cm->cur_frame->decode_skipped = is_frame_skipped_by_decode_mode(pbi);
+
+  // In frame parallel decoding this waits for the reference frames, so it is
+  // done by the frame worker before decoding the deferred tile groups.
+  if (!pbi->frame_parallel_decode && !cm->cur_frame->decode_skipped)
+    av1_setup_frame_refs_and_context(pbi);
+
+  pbi->dcb.corrupted = 0;
+  return uncomp_hdr_size;
+}
+
+void av1_setup_frame_refs_and_context(AV1Decoder *pbi) {
+  AV1_COMMON *const cm = &pbi->common;
+
+  for (int i = 0; i < INTER_REFS_PER_FRAME; ++i) {
+    pbi->dcb.ref_rows_ready[i] = pbi->frame_parallel_decode ? 0 : INT_MAX;
+  }
+
+  if (pbi->frame_parallel_decode && !frame_is_intra_only(cm)) {
+    // The mvs, seg_map and frame_context of the reference frames are written
+    // by the frame workers decoding them.
+    for (int i = LAST_FRAME; i <= ALTREF_FRAME; ++i) {
+      RefCntBuffer *const ref_buf = get_ref_frame_buf(cm, i);
+      if (ref_buf == NULL) continue;
+      if (av1_frameworker_wait_parse_done(cm->buffer_pool, ref_buf)) {
+        aom_internal_error(&pbi->error, AOM_CODEC_CORRUPT_FRAME,
+                           "Reference frame is corrupted");
+      }
+    }
+  }
+
+  if (cm->features.allow_ref_frame_mvs) av1_setup_motion_field(cm);
+
   if (cm->features.primary_ref_frame == PRIMARY_REF_NONE) {
     // use the default frame context values
     *cm->fc = *cm->default_frame_context;
@@ -5231,9 +5869,6 @@ uint32_t av1_decode_frame_headers_and_setup(AV1Decoder *pbi,
   if (!cm->fc->initialized)
     aom_internal_error(&pbi->error, AOM_CODEC_CORRUPT_FRAME,
                        "Uninitialized entropy context.");
-
-  pbi->dcb.corrupted = 0;
-  return uncomp_hdr_size;
 }
 
 // Once-per-frame initialization
@@ -5270,15 +5905,27 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
   if (initialize_flag) setup_frame_info(pbi);
   const int num_planes = av1_num_planes(cm);
 
+  aom_decode_stage_stats_t *const stats = &pbi->stage_stats;
+  struct aom_usec_timer timer;
+  start_stage_timing(pbi, &timer);
+  // Set by decode_tiles_row_mt() if the loop filter runs along with it.
+  pbi->frame_row_mt_info.pipeline_lpf_mt_with_dec = 0;
   if (pbi->max_threads > 1 && !(tiles->large_scale && !pbi->ext_tile_debug) &&
-      pbi->row_mt)
+      pbi->row_mt) {
     *p_data_end =
         decode_tiles_row_mt(pbi, data, data_end, start_tile, end_tile);
-  else if (pbi->max_threads > 1 && tile_count_tg > 1 &&
-           !(tiles->large_scale && !pbi->ext_tile_debug))
+    end_stage_timing(pbi, &timer, &stats->tile_decode_us);
+  } else if (pbi->max_threads > 1 && tile_count_tg > 1 &&
+             !(tiles->large_scale && !pbi->ext_tile_debug)) {
     *p_data_end = decode_tiles_mt(pbi, data, data_end, start_tile, end_tile);
-  else
+    end_stage_timing(pbi, &timer, &stats->tile_decode_us);
+  } else {
+    const int64_t tile_decode_time = stats->tile_decode_us;
     *p_data_end = decode_tiles(pbi, data, data_end, start_tile, end_tile);
+    end_stage_timing(pbi, &timer, &stats->tile_decode_us);
+    // The calling thread is the only worker.
+    stats->worker_busy_us += stats->tile_decode_us - tile_decode_time;
+  }
 
   // If the bit stream is monochrome, set the U and V buffers to a constant.
   if (num_planes < 3) {
@@ -5289,15 +5936,39 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
     return;
   }
 
+  if (!pbi->dcb.corrupted) {
+    if (cm->features.refresh_frame_context == REFRESH_FRAME_CONTEXT_BACKWARD) {
+      assert(pbi->context_update_tile_id < pbi->allocated_tiles);
+      *cm->fc = pbi->tile_data[pbi->context_update_tile_id].tctx;
+      av1_reset_cdf_symbol_counters(cm->fc);
+    }
+  } else {
+    aom_internal_error(&pbi->error, AOM_CODEC_CORRUPT_FRAME,
+                       "Decode failed. Frame data is corrupted.");
+  }
+
+  if (!tiles->large_scale) {
+    cm->cur_frame->frame_context = *cm->fc;
+    pbi->mi_grid_valid = 1;
+  }
+
+  // The frames parsed after this one only need its pixels from now on.
+  if (pbi->frame_parallel_decode) {
+    av1_frameworker_set_parse_done(cm->buffer_pool, cm->cur_frame);
+  }
+
   av1_alloc_cdef_buffers(cm, &pbi->cdef_worker, &pbi->cdef_sync,
                          pbi->num_workers, 1);
   av1_alloc_cdef_sync(cm, &pbi->cdef_sync, pbi->num_workers);
 
   if (!cm->features.allow_intrabc && !tiles->single_tile_decoding) {
-    if (cm->lf.filter_level[0] || cm->lf.filter_level[1]) {
+    if ((cm->lf.filter_level[0] || cm->lf.filter_level[1]) &&
+        !pbi->frame_row_mt_info.pipeline_lpf_mt_with_dec) {
+      start_stage_timing(pbi, &timer);
       av1_loop_filter_frame_mt(&cm->cur_frame->buf, cm, &pbi->dcb.xd, 0,
                                num_planes, 0, pbi->tile_workers,
                                pbi->num_workers, &pbi->lf_row_sync, 0);
+      end_stage_timing(pbi, &timer, &stats->loop_filter_us);
     }
 
     const int do_cdef =
@@ -5314,11 +5985,15 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
     // as it happens in extend_mc_border().
     int do_extend_border_mt = 0;
     if (!optimized_loop_restoration) {
-      if (do_loop_restoration)
+      if (do_loop_restoration) {
+        start_stage_timing(pbi, &timer);
         av1_loop_restoration_save_boundary_lines(&pbi->common.cur_frame->buf,
                                                  cm, 0);
+        end_stage_timing(pbi, &timer, &stats->loop_restoration_us);
+      }
 
       if (do_cdef) {
+        start_stage_timing(pbi, &timer);
         if (pbi->num_workers > 1) {
           av1_cdef_frame_mt(cm, &pbi->dcb.xd, pbi->cdef_worker,
                             pbi->tile_workers, &pbi->cdef_sync,
@@ -5328,11 +6003,15 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
           av1_cdef_frame(&pbi->common.cur_frame->buf, cm, &pbi->dcb.xd,
                          av1_cdef_init_fb_row);
         }
+        end_stage_timing(pbi, &timer, &stats->cdef_us);
       }
 
+      start_stage_timing(pbi, &timer);
       superres_post_decode(pbi);
+      end_stage_timing(pbi, &timer, &stats->superres_us);
 
       if (do_loop_restoration) {
+        start_stage_timing(pbi, &timer);
         av1_loop_restoration_save_boundary_lines(&pbi->common.cur_frame->buf,
                                                  cm, 1);
         if (pbi->num_workers > 1) {
@@ -5345,11 +6024,13 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
                                             cm, optimized_loop_restoration,
                                             &pbi->lr_ctxt);
         }
+        end_stage_timing(pbi, &timer, &stats->loop_restoration_us);
       }
     } else {
       // In no cdef and no superres case. Provide an optimized version of
       // loop_restoration_filter.
       if (do_loop_restoration) {
+        start_stage_timing(pbi, &timer);
         if (pbi->num_workers > 1) {
           av1_loop_restoration_filter_frame_mt(
               (YV12_BUFFER_CONFIG *)xd->cur_buf, cm, optimized_loop_restoration,
@@ -5360,33 +6041,21 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
                                             cm, optimized_loop_restoration,
                                             &pbi->lr_ctxt);
         }
+        end_stage_timing(pbi, &timer, &stats->loop_restoration_us);
       }
     }
   }
 
-  if (!pbi->dcb.corrupted) {
-    if (cm->features.refresh_frame_context == REFRESH_FRAME_CONTEXT_BACKWARD) {
-      assert(pbi->context_update_tile_id < pbi->allocated_tiles);
-      *cm->fc = pbi->tile_data[pbi->context_update_tile_id].tctx;
-      av1_reset_cdf_symbol_counters(cm->fc);
-    }
-  } else {
-    aom_internal_error(&pbi->error, AOM_CODEC_CORRUPT_FRAME,
-                       "Decode failed. Frame data is corrupted.");
-  }
-
 #if CONFIG_INSPECTION
   if (pbi->inspect_cb != NULL) {
     (*pbi->inspect_cb)(pbi, pbi->inspect_ctx);
   }
 #endif
 
-  // Non frame parallel update frame context here.
-  if (!tiles->large_scale) {
-    cm->cur_frame->frame_context = *cm->fc;
-  }
-
-  if (cm->show_frame && !cm->seq_params->order_hint_info.enable_order_hint) {
+  // In frame parallel decoding the frame number is updated when the frame is
+  // parsed.
+  if (!pbi->frame_parallel_decode && cm->show_frame &&
+      !cm->seq_params->order_hint_info.enable_order_hint) {
     ++cm->current_frame.frame_number;
   }
 }
@@ -41,11 +41,23 @@ uint32_t av1_decode_frame_headers_and_setup(struct AV1Decoder *pbi,
                                             struct aom_read_bit_buffer *rb,
                                             int trailing_bits_present);
 
+// Sets up the motion field projection and the entropy context of the current
+// frame from its reference frames. In frame parallel decoding this waits until
+// the reference frames have been parsed by their frame workers.
+void av1_setup_frame_refs_and_context(struct AV1Decoder *pbi);
+
 void av1_decode_tg_tiles_and_wrapup(struct AV1Decoder *pbi, const uint8_t *data,
                                     const uint8_t *data_end,
                                     const uint8_t **p_data_end, int start_tile,
                                     int end_tile, int initialize_flag);
 
+// Decodes the 'num_entries' tiles of pbi->tile_list_entries with the tile
+// workers. Each tile is reconstructed straight into its slot of
+// pbi->tile_list_outbuf. Only used when no loop filter is applied in large
+// scale tile decoding.
+void av1_decode_tile_list_mt(struct AV1Decoder *pbi, const uint8_t *data_end,
+                             int num_entries);
+
 // Implements the color_config() function in the spec. Reports errors by
 // calling rb->error_handler() or aom_internal_error().
 void av1_read_color_config(struct aom_read_bit_buffer *rb,
@@ -173,6 +173,102 @@ void av1_dec_free_cb_buf(AV1Decoder *pbi) {
   pbi->cb_buffer_alloc_size = 0;
 }
 
+#if CONFIG_MULTITHREAD
+#define SYNC_ROW_SIZE \
+  (sizeof(int) + sizeof(pthread_mutex_t) + sizeof(pthread_cond_t))
+#else
+#define SYNC_ROW_SIZE sizeof(int)
+#endif  // CONFIG_MULTITHREAD
+
+static uint64_t cdef_buffers_size(const AV1Decoder *pbi) {
+  const CdefInfo *const cdef_info = &pbi->common.cdef_info;
+  uint64_t size = 0;
+  for (int plane = 0; plane < MAX_MB_PLANE; plane++) {
+    if (cdef_info->linebuf[plane] == NULL) continue;
+    size += cdef_info->allocated_linebuf_size[plane];
+  }
+  // The source and column buffers of worker 0 and of the other workers.
+  const int num_workers = pbi->cdef_worker != NULL
+                              ? AOMMAX(cdef_info->allocated_num_workers, 1)
+                              : 1;
+  for (int idx = 0; idx < num_workers; idx++) {
+    uint16_t *const *colbuf =
+        idx == 0 ? cdef_info->colbuf : pbi->cdef_worker[idx].colbuf;
+    const uint16_t *srcbuf =
+        idx == 0 ? cdef_info->srcbuf : pbi->cdef_worker[idx].srcbuf;
+    if (srcbuf != NULL) size += cdef_info->allocated_srcbuf_size;
+    for (int plane = 0; plane < MAX_MB_PLANE; plane++) {
+      if (colbuf[plane] != NULL)
+        size += cdef_info->allocated_colbuf_size[plane];
+    }
+  }
+  if (pbi->cdef_sync.cdef_row_mt != NULL)
+    size += (uint64_t)cdef_info->allocated_mi_rows *
+            (sizeof(AV1CdefRowSync) + SYNC_ROW_SIZE - sizeof(int));
+  return size;
+}
+
+static uint64_t restoration_buffers_size(const AV1Decoder *pbi) {
+  const AV1_COMMON *const cm = &pbi->common;
+  uint64_t size = cm->rst_frame.buffer_alloc_sz;
+  if (cm->rst_tmpbuf != NULL) size += RESTORATION_TMPBUF_SIZE;
+  if (cm->rlbs != NULL) size += sizeof(RestorationLineBuffers);
+  for (int plane = 0; plane < MAX_MB_PLANE; plane++) {
+    const RestorationInfo *const rsi = &cm->rst_info[plane];
+    size += (uint64_t)rsi->num_allocated_units * sizeof(*rsi->unit_info);
+    if (rsi->boundaries.stripe_boundary_above != NULL)
+      size += 2 * (uint64_t)rsi->boundaries.stripe_boundary_size;
+  }
+  const AV1LrSync *const lr_sync = &pbi->lr_row_sync;
+  if (lr_sync->lrworkerdata != NULL) {
+    // The last worker uses the buffers of cm.
+    size += (uint64_t)(lr_sync->num_workers - 1) *
+            (RESTORATION_TMPBUF_SIZE + sizeof(RestorationLineBuffers));
+    size += (uint64_t)lr_sync->num_workers * sizeof(*lr_sync->lrworkerdata);
+    size += (uint64_t)lr_sync->rows * lr_sync->num_planes *
+            (SYNC_ROW_SIZE + sizeof(*lr_sync->job_queue));
+  }
+  return size;
+}
+
+uint64_t av1_dec_context_buffers_size(const AV1Decoder *pbi) {
+  const AV1_COMMON *const cm = &pbi->common;
+  const CommonModeInfoParams *const mi_params = &cm->mi_params;
+  uint64_t size =
+      (uint64_t)mi_params->mi_alloc_size * sizeof(*mi_params->mi_alloc) +
+      (uint64_t)mi_params->mi_grid_size *
+          (sizeof(*mi_params->mi_grid_base) + sizeof(*mi_params->tx_type_map));
+  size += (uint64_t)cm->tpl_mvs_mem_size * sizeof(*cm->tpl_mvs);
+
+  const CommonContexts *const above_contexts = &cm->above_contexts;
+  size += (uint64_t)above_contexts->num_tile_rows *
+          above_contexts->num_mi_cols *
+          (above_contexts->num_planes * sizeof(ENTROPY_CONTEXT) +
+           sizeof(PARTITION_CONTEXT) + sizeof(TXFM_CONTEXT));
+
+  size += cdef_buffers_size(pbi);
+  size += restoration_buffers_size(pbi);
+
+  size += (uint64_t)pbi->allocated_tiles * sizeof(*pbi->tile_data);
+  for (int i = 0; i < pbi->allocated_tiles; i++) {
+    size += (uint64_t)pbi->tile_data[i].dec_row_mt_sync.allocated_sb_rows *
+            SYNC_ROW_SIZE;
+  }
+  size += (uint64_t)pbi->tile_mt_info.alloc_tiles *
+          sizeof(*pbi->tile_mt_info.job_queue);
+  size += (uint64_t)pbi->cb_buffer_alloc_size * sizeof(*pbi->cb_buffer_base);
+  size += (uint64_t)pbi->frame_row_mt_info.allocated_sb_rows *
+          sizeof(*pbi->frame_row_mt_info.num_tile_cols_done);
+
+  const AV1LfSync *const lf_sync = &pbi->lf_row_sync;
+  if (lf_sync->lfdata != NULL) {
+    size += (uint64_t)lf_sync->num_workers * sizeof(*lf_sync->lfdata);
+    size += (uint64_t)lf_sync->rows * MAX_MB_PLANE *
+            (SYNC_ROW_SIZE + 2 * sizeof(*lf_sync->job_queue));
+  }
+  return size;
+}
+
 void av1_decoder_remove(AV1Decoder *pbi) {
   int i;
 
@@ -181,6 +277,8 @@ void av1_decoder_remove(AV1Decoder *pbi) {
   // Free the tile list output buffer.
   aom_free_frame_buffer(&pbi->tile_list_outbuf);
 
+  aom_free(pbi->frame_header_copy);
+
   aom_get_worker_interface()->end(&pbi->lf_worker);
   aom_free(pbi->lf_worker.data1);
 
@@ -216,6 +314,7 @@ void av1_decoder_remove(AV1Decoder *pbi) {
   }
   aom_free(pbi->tile_data);
   aom_free(pbi->tile_workers);
+  aom_free(pbi->frame_row_mt_info.num_tile_cols_done);
 
   if (pbi->num_workers > 0) {
     av1_loop_filter_dealloc(&pbi->lf_row_sync);
@@ -228,6 +327,7 @@ void av1_decoder_remove(AV1Decoder *pbi) {
   aom_accounting_clear(&pbi->accounting);
 #endif
   av1_free_mc_tmp_buf(&pbi->td);
+  aom_free(pbi->deferred_tgs);
   aom_img_metadata_array_free(pbi->metadata);
   av1_remove_common(&pbi->common);
   aom_free(pbi);
@@ -326,6 +426,21 @@ aom_codec_err_t av1_set_reference_dec(AV1_COMMON *cm, int idx,
   return cm->error->error_code;
 }
 
+aom_codec_err_t av1_check_external_reference_dec(
+    AV1_COMMON *cm, int idx, const YV12_BUFFER_CONFIG *sd) {
+  const YV12_BUFFER_CONFIG *const ref_buf = get_ref_frame(cm, idx);
+
+  if (ref_buf == NULL) {
+    aom_internal_error(cm->error, AOM_CODEC_ERROR, "No reference frame");
+    return AOM_CODEC_ERROR;
+  }
+  if (!equal_dimensions_and_border(ref_buf, sd)) {
+    aom_internal_error(cm->error, AOM_CODEC_ERROR,
+                       "Incorrect buffer dimensions");
+  }
+  return cm->error->error_code;
+}
+
 aom_codec_err_t av1_copy_new_frame_dec(AV1_COMMON *cm,
                                        YV12_BUFFER_CONFIG *new_frame,
                                        YV12_BUFFER_CONFIG *sd) {
@@ -340,15 +455,33 @@ aom_codec_err_t av1_copy_new_frame_dec(AV1_COMMON *cm,
   return cm->error->error_code;
 }
 
+// Sets pbi->next_ref_frame_map to cm->ref_frame_map with the slots in
+// refresh_frame_flags pointing to cm->cur_frame. The buffer pool must be
+// locked by the caller.
+static void set_next_ref_frame_map(AV1Decoder *pbi, int refresh_frame_flags) {
+  AV1_COMMON *const cm = &pbi->common;
+  BufferPool *const pool = cm->buffer_pool;
+
+  for (int i = 0; i < REF_FRAMES; i++) {
+    RefCntBuffer *const buf =
+        ((refresh_frame_flags >> i) & 1) ? cm->cur_frame : cm->ref_frame_map[i];
+    if (buf != NULL) ++buf->ref_count;
+    decrease_ref_count(pbi->next_ref_frame_map[i], pool);
+    pbi->next_ref_frame_map[i] = buf;
+  }
+}
+
 static void release_current_frame(AV1Decoder *pbi) {
   AV1_COMMON *const cm = &pbi->common;
   BufferPool *const pool = cm->buffer_pool;
 
   cm->cur_frame->buf.corrupted = 1;
   lock_buffer_pool(pool);
+  if (pbi->frame_parallel_decode) set_next_ref_frame_map(pbi, 0);
   decrease_ref_count(cm->cur_frame, pool);
   unlock_buffer_pool(pool);
   cm->cur_frame = NULL;
+  pbi->num_deferred_tgs = 0;
 }
 
 // If any buffer updating is signaled it should be done here.
@@ -364,23 +497,41 @@ static void update_frame_buffers(AV1Decoder *pbi, int frame_decoded) {
   if (frame_decoded) {
     lock_buffer_pool(pool);
 
+    if (pbi->num_deferred_tgs > 0) {
+      // Keep a reference to cm->cur_frame for av1_decode_deferred_frame().
+      // Frames parsed from now on wait for its decode progress.
+      ++cm->cur_frame->ref_count;
+      cm->cur_frame->decode_in_progress = 1;
+      cm->cur_frame->parse_done = 0;
+      cm->cur_frame->decoded_rows = 0;
+    }
+
     // In ext-tile decoding, the camera frame header is only decoded once. So,
     // we don't update the references here.
     if (!pbi->camera_frame_header_ready) {
-      // The following for loop needs to release the reference stored in
-      // cm->ref_frame_map[ref_index] before storing a reference to
-      // cm->cur_frame in cm->ref_frame_map[ref_index].
-      for (mask = cm->current_frame.refresh_frame_flags; mask; mask >>= 1) {
-        if (mask & 1) {
-          decrease_ref_count(cm->ref_frame_map[ref_index], pool);
-          cm->ref_frame_map[ref_index] = cm->cur_frame;
-          ++cm->cur_frame->ref_count;
+      if (pbi->frame_parallel_decode) {
+        // cm->ref_frame_map is still needed to decode the deferred tile
+        // groups, so the refresh only applies to the map of the next frame.
+        set_next_ref_frame_map(pbi, cm->current_frame.refresh_frame_flags);
+      } else {
+        // The following for loop needs to release the reference stored in
+        // cm->ref_frame_map[ref_index] before storing a reference to
+        // cm->cur_frame in cm->ref_frame_map[ref_index].
+        for (mask = cm->current_frame.refresh_frame_flags; mask; mask >>= 1) {
+          if (mask & 1) {
+            decrease_ref_count(cm->ref_frame_map[ref_index], pool);
+            cm->ref_frame_map[ref_index] = cm->cur_frame;
+            ++cm->cur_frame->ref_count;
+          }
+          ++ref_index;
         }
-        ++ref_index;
       }
     }
 
-    if (cm->show_existing_frame || cm->show_frame) {
+    // Frames skipped by the decode mode are not output, including when shown
+    // with show_existing_frame.
+    if ((cm->show_existing_frame || cm->show_frame) &&
+        !cm->cur_frame->decode_skipped) {
       if (pbi->output_all_layers) {
         // Append this frame to the output queue
         if (pbi->num_output_frames >= MAX_NUM_SPATIAL_LAYERS) {
@@ -410,9 +561,16 @@ static void update_frame_buffers(AV1Decoder *pbi, int frame_decoded) {
   } else {
     // Nothing was decoded, so just drop this frame buffer
     lock_buffer_pool(pool);
+    if (pbi->frame_parallel_decode) set_next_ref_frame_map(pbi, 0);
     decrease_ref_count(cm->cur_frame, pool);
     unlock_buffer_pool(pool);
+    pbi->num_deferred_tgs = 0;
   }
+
+  // The deferred tile groups are decoded into cm->cur_frame with the current
+  // references.
+  if (pbi->num_deferred_tgs > 0) return;
+
   cm->cur_frame = NULL;
 
   if (!pbi->camera_frame_header_ready) {
@@ -443,7 +601,9 @@ int av1_receive_compressed_data(AV1Decoder *pbi, size_t size,
     if (ref_buf != NULL) ref_buf->buf.corrupted = 1;
   }
 
-  if (assign_cur_frame_new_fb(cm) == NULL) {
+  // In streaming decoding, cm->cur_frame may still hold a frame that is
+  // continued by this call.
+  if (!pbi->frame_in_progress && assign_cur_frame_new_fb(cm) == NULL) {
     pbi->error.error_code = AOM_CODEC_MEM_ERROR;
     return 1;
   }
@@ -470,8 +630,19 @@ int av1_receive_compressed_data(AV1Decoder *pbi, size_t size,
 
   pbi->error.setjmp = 1;
 
+  // The stages timed within aom_decode_frame_from_obus() are not OBU parsing.
+  aom_decode_stage_stats_t *const stats = &pbi->stage_stats;
+  const int64_t nested_stage_time =
+      stats->tile_decode_us + stats->loop_filter_us + stats->cdef_us +
+      stats->superres_us + stats->loop_restoration_us;
+  struct aom_usec_timer timer;
+  start_stage_timing(pbi, &timer);
   int frame_decoded =
       aom_decode_frame_from_obus(pbi, source, source + size, psource);
+  end_stage_timing(pbi, &timer, &stats->obu_parse_us);
+  stats->obu_parse_us -= stats->tile_decode_us + stats->loop_filter_us +
+                         stats->cdef_us + stats->superres_us +
+                         stats->loop_restoration_us - nested_stage_time;
 
   if (frame_decoded < 0) {
     assert(pbi->error.error_code != AOM_CODEC_OK);
@@ -480,6 +651,13 @@ int av1_receive_compressed_data(AV1Decoder *pbi, size_t size,
     return 1;
   }
 
+  // The rest of the frame comes in a later call, which keeps decoding into
+  // cm->cur_frame.
+  if (pbi->frame_in_progress) {
+    pbi->error.setjmp = 0;
+    return 0;
+  }
+
 #if TXCOEFF_TIMER
   cm->cum_txcoeff_timer += cm->txcoeff_timer;
   fprintf(stderr,
@@ -520,6 +698,77 @@ int av1_receive_compressed_data(AV1Decoder *pbi, size_t size,
   return 0;
 }
 
+static void release_deferred_frame(AV1Decoder *pbi, int corrupted) {
+  AV1_COMMON *const cm = &pbi->common;
+  BufferPool *const pool = cm->buffer_pool;
+  RefCntBuffer *const cur_frame = cm->cur_frame;
+
+  // The other frame workers read the corrupted flag with the pool locked.
+  lock_buffer_pool(pool);
+  if (corrupted) cur_frame->buf.corrupted = 1;
+  unlock_buffer_pool(pool);
+  av1_frameworker_set_decoded_rows(pool, cur_frame, INT_MAX);
+  lock_buffer_pool(pool);
+  decrease_ref_count(cur_frame, pool);
+  unlock_buffer_pool(pool);
+  cm->cur_frame = NULL;
+  pbi->num_deferred_tgs = 0;
+
+  for (int i = 0; i < INTER_REFS_PER_FRAME; i++) {
+    cm->remapped_ref_idx[i] = INVALID_IDX;
+  }
+}
+
+int av1_decode_deferred_frame(AV1Decoder *pbi) {
+  assert(pbi->frame_parallel_decode && pbi->num_deferred_tgs > 0);
+  pbi->error.error_code = AOM_CODEC_OK;
+  pbi->error.has_detail = 0;
+
+  // The jmp_buf is valid only for the duration of the function that calls
+  // setjmp(). Therefore, this function must reset the 'setjmp' field to 0
+  // before it returns.
+  if (setjmp(pbi->error.jmp)) {
+    const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+
+    pbi->error.setjmp = 0;
+
+    // Synchronize all threads immediately as a subsequent decode call may
+    // cause a resize invalidating some allocations.
+    winterface->sync(&pbi->lf_worker);
+    for (int i = 0; i < pbi->num_workers; ++i) {
+      winterface->sync(&pbi->tile_workers[i]);
+    }
+
+    // Frames waiting on this one must not block forever.
+    release_deferred_frame(pbi, 1);
+    return -1;
+  }
+
+  pbi->error.setjmp = 1;
+
+  av1_setup_frame_refs_and_context(pbi);
+
+  for (int i = 0; i < pbi->num_deferred_tgs; i++) {
+    const DeferredTileGroup *const tg = &pbi->deferred_tgs[i];
+    const uint8_t *p_data_end;
+    av1_decode_tg_tiles_and_wrapup(pbi, tg->data, tg->data_end, &p_data_end,
+                                   tg->start_tile, tg->end_tile,
+                                   tg->is_first_tg);
+
+    // If there are extra padding bytes, they should all be zero
+    while (p_data_end < tg->data_end) {
+      if (*p_data_end++ != 0) {
+        aom_internal_error(&pbi->error, AOM_CODEC_CORRUPT_FRAME,
+                           "Nonzero padding bytes after tile group");
+      }
+    }
+  }
+
+  pbi->error.setjmp = 0;
+  release_deferred_frame(pbi, 0);
+  return 0;
+}
+
 // Get the frame at a particular index in the output queue
 int av1_get_raw_frame(AV1Decoder *pbi, size_t index, YV12_BUFFER_CONFIG **sd,
                       aom_film_grain_t **grain_params) {
@@ -15,7 +15,9 @@
 #include "config/aom_config.h"
 
 #include "aom/aom_codec.h"
+#include "aom/aomdx.h"
 #include "aom_dsp/bitreader.h"
+#include "aom_ports/aom_timer.h"
 #include "aom_scale/yv12config.h"
 #include "aom_util/aom_thread.h"
 
@@ -81,10 +83,31 @@ typedef struct DecoderCodingBlock {
    * in xd->ref_mv_stack[i].
    */
   uint8_t ref_mv_count[MODE_CTX_REF_FRAMES];
+  /*!
+   * Number of luma rows of each reference frame known to be decoded. Set to
+   * INT_MAX when no frame parallel decoding is in progress.
+   */
+  int ref_rows_ready[INTER_REFS_PER_FRAME];
+  /*!
+   * In multi-threaded tile list decoding, the external reference that replaces
+   * the planes of the first reference frame for the current tile. NULL
+   * otherwise.
+   */
+  const YV12_BUFFER_CONFIG *ext_ref_buf;
 } DecoderCodingBlock;
 
 /*!\cond */
 
+// A tile group whose decoding is deferred to the frame worker thread in frame
+// parallel decoding.
+typedef struct DeferredTileGroup {
+  const uint8_t *data;
+  const uint8_t *data_end;
+  int start_tile;
+  int end_tile;
+  int is_first_tg;
+} DeferredTileGroup;
+
 typedef void (*decode_block_visitor_fn_t)(const AV1_COMMON *const cm,
                                           DecoderCodingBlock *dcb,
                                           aom_reader *const r, const int plane,
@@ -129,6 +152,20 @@ typedef struct ThreadData {
   decode_block_visitor_fn_t inverse_tx_inter_block_visit;
   predict_inter_block_visitor_fn_t predict_inter_block_visit;
   cfl_store_inter_block_visitor_fn_t cfl_store_inter_block_visit;
+
+  // Times in microseconds spent by this worker in the tile group being
+  // decoded. row_mt_idle_time is the time spent waiting in row-mt decoding,
+  // either for a job or for the SB rows its job depends on. The other times
+  // are only measured when the stage statistics are enabled.
+  int64_t row_mt_idle_time;
+  int64_t row_mt_parse_time;
+  int64_t row_mt_recon_time;
+  int64_t busy_time;  // Time spent in the worker hook.
+
+  // In multi-threaded tile list decoding, the slot of the tile list output
+  // buffer and the external reference of the current tile, seen as frames.
+  YV12_BUFFER_CONFIG tile_list_dst_buf;
+  YV12_BUFFER_CONFIG tile_list_ref_buf;
 } ThreadData;
 
 typedef struct AV1DecRowMTJobInfo {
@@ -189,6 +226,14 @@ typedef struct AV1DecRowMTInfo {
   // Boolean: Initialized to 0 (false). Set to 1 (true) on error to abort
   // decoding.
   int row_mt_exit;
+
+  // Boolean: Set to 1 (true) when the workers loop filter the SB rows of the
+  // frame as soon as they are decoded, instead of after the whole frame.
+  int pipeline_lpf_mt_with_dec;
+  // Number of tile columns that have decoded each SB row of the frame. Only
+  // maintained when pipeline_lpf_mt_with_dec is set.
+  int *num_tile_cols_done;
+  int allocated_sb_rows;
 } AV1DecRowMTInfo;
 
 typedef struct TileDataDec {
@@ -213,9 +258,24 @@ typedef struct EXTERNAL_REFERENCES {
   int num;
 } EXTERNAL_REFERENCES;
 
+// A tile of a large scale tile list OBU.
+typedef struct TileListEntryDec {
+  TileBufferDec tile_buffer;
+  const YV12_BUFFER_CONFIG *ext_ref;
+  int tile_row;
+  int tile_col;
+  // Position of the decoded tile in the tile list output buffer, in tiles.
+  int output_row;
+  int output_col;
+} TileListEntryDec;
+
 typedef struct TileJobsDec {
   TileBufferDec *tile_buffer;
   TileDataDec *tile_data;
+  // In tile list decoding, the entries of the tile list that use this tile.
+  // They are decoded one after another by the worker that takes the job.
+  const TileListEntryDec *tile_list_entries;
+  int num_tile_list_entries;
 } TileJobsDec;
 
 typedef struct AV1DecTileMTData {
@@ -225,8 +285,7 @@ typedef struct AV1DecTileMTData {
   TileJobsDec *job_queue;
   int jobs_enqueued;
   int jobs_dequeued;
-  int alloc_tile_rows;
-  int alloc_tile_cols;
+  int alloc_tiles;
 } AV1DecTileMT;
 
 typedef struct AV1Decoder {
@@ -242,10 +301,18 @@ typedef struct AV1Decoder {
   AV1CdefWorkerData *cdef_worker;
   AVxWorker *tile_workers;
   int num_workers;
+  // If not NULL, the tile workers run their jobs on this shared pool. The
+  // jobs of all the AV1Decoders with the same thread_pool_client are
+  // scheduled as those of one client.
+  AVxThreadPool *thread_pool;
+  const void *thread_pool_client;
   DecWorkerData *thread_data;
   ThreadData td;
   TileDataDec *tile_data;
   int allocated_tiles;
+  // Largest number of tiles of a frame set by AV1D_SET_FRAME_LIMITS, or 0.
+  // The tile data and the tile jobs are allocated for it.
+  int reserved_tiles;
 
   TileBufferDec tile_buffers[MAX_TILE_ROWS][MAX_TILE_COLS];
   AV1DecTileMT tile_mt_info;
@@ -315,6 +382,8 @@ typedef struct AV1Decoder {
 
   EXTERNAL_REFERENCES ext_refs;
   YV12_BUFFER_CONFIG tile_list_outbuf;
+  // The tiles of the tile list OBU being decoded by multiple threads.
+  TileListEntryDec tile_list_entries[MAX_TILES];
 
   // Coding block buffer for the current frame.
   // Allocated and used only for multi-threaded decoding with 'row_mt == 0'.
@@ -369,6 +438,71 @@ typedef struct AV1Decoder {
    * Number of spatial layers: may be > 1 for SVC (scalable vector coding).
    */
   unsigned int number_spatial_layers;
+
+  /*!
+   * If true, the frame headers are parsed by the caller and the tile groups
+   * are decoded later by av1_decode_deferred_frame(), while other decoder
+   * instances sharing the buffer pool work on neighboring frames.
+   */
+  int frame_parallel_decode;
+
+  /*!
+   * Reference frame map after the refresh of the last frame parsed. In frame
+   * parallel decoding cm->ref_frame_map keeps the map the deferred frame was
+   * parsed with.
+   */
+  RefCntBuffer *next_ref_frame_map[REF_FRAMES];
+
+  /*!
+   * Tile groups of the current frame that are still to be decoded.
+   */
+  DeferredTileGroup *deferred_tgs;
+  int num_deferred_tgs;
+  int deferred_tgs_alloc_size;
+
+  /*!
+   * If true, aom_decode_frame_from_obus() may run out of data before the last
+   * tile group of a frame. The frame is then kept in cm->cur_frame and the
+   * next call continues it with the following OBUs.
+   */
+  int streaming_decode;
+
+  /*!
+   * True while cm->cur_frame holds a frame of which some tile groups have not
+   * been received yet.
+   */
+  int frame_in_progress;
+
+  /*!
+   * A copy of the frame header of the frame in progress, which the redundant
+   * frame headers received in later calls are compared with.
+   */
+  uint8_t *frame_header_copy;
+  size_t frame_header_copy_alloc_size;
+
+  /*!
+   * Called after each tile group is decoded, if set.
+   */
+  aom_tile_group_cb_t tile_group_cb;
+
+  /*!
+   * If true, the time spent in each decoding stage is accumulated in
+   * stage_stats. See AV1D_GET_STAGE_STATS.
+   */
+  int stage_stats_enabled;
+  aom_decode_stage_stats_t stage_stats;
+
+  /*!
+   * Selects the frames whose tiles are decoded. See AV1D_SET_DECODE_MODE.
+   */
+  aom_decode_mode_t decode_mode;
+
+  /*!
+   * Whether the mode info of common describes the last frame header read,
+   * i.e. whether the tiles of that frame were decoded. See
+   * AV1D_GET_FRAME_MI_INFO.
+   */
+  int mi_grid_valid;
 } AV1Decoder;
 
 // Returns 0 on success. Sets pbi->common.error.error_code to a nonzero error
@@ -376,6 +510,12 @@ typedef struct AV1Decoder {
 int av1_receive_compressed_data(struct AV1Decoder *pbi, size_t size,
                                 const uint8_t **psource);
 
+// Decodes the tile groups deferred by av1_receive_compressed_data() in frame
+// parallel decoding and releases the current frame. Returns 0 on success.
+// Sets pbi->error.error_code to a nonzero error code and returns a nonzero
+// value on failure.
+int av1_decode_deferred_frame(struct AV1Decoder *pbi);
+
 // Get the frame at a particular index in the output queue
 int av1_get_raw_frame(AV1Decoder *pbi, size_t index, YV12_BUFFER_CONFIG **sd,
                       aom_film_grain_t **grain_params);
@@ -388,6 +528,13 @@ aom_codec_err_t av1_copy_reference_dec(struct AV1Decoder *pbi, int idx,
 aom_codec_err_t av1_set_reference_dec(AV1_COMMON *cm, int idx,
                                       int use_external_ref,
                                       YV12_BUFFER_CONFIG *sd);
+
+// Checks that the external reference 'sd' can replace the planes of the
+// reference frame buffer 'idx', as av1_set_reference_dec() would do with
+// use_external_ref set, without modifying the buffer.
+aom_codec_err_t av1_check_external_reference_dec(AV1_COMMON *cm, int idx,
+                                                 const YV12_BUFFER_CONFIG *sd);
+
 aom_codec_err_t av1_copy_new_frame_dec(AV1_COMMON *cm,
                                        YV12_BUFFER_CONFIG *new_frame,
                                        YV12_BUFFER_CONFIG *sd);
@@ -401,6 +548,11 @@ void av1_dec_row_mt_dealloc(AV1DecRowMTSync *dec_row_mt_sync);
 
 void av1_dec_free_cb_buf(AV1Decoder *pbi);
 
+// Returns the number of bytes of the buffers of the decoder whose size
+// depends on the frame size or the tile layout. The frame buffers of the
+// buffer pool are not included.
+uint64_t av1_dec_context_buffers_size(const AV1Decoder *pbi);
+
 static INLINE void decrease_ref_count(RefCntBuffer *const buf,
                                       BufferPool *const pool) {
   if (buf != NULL) {
@@ -421,6 +573,23 @@ static INLINE void decrease_ref_count(RefCntBuffer *const buf,
   }
 }
 
+// Starts timing a decoding stage if the stage statistics are enabled.
+static INLINE void start_stage_timing(const AV1Decoder *pbi,
+                                      struct aom_usec_timer *timer) {
+  if (pbi->stage_stats_enabled) aom_usec_timer_start(timer);
+}
+
+// Adds the time since start_stage_timing() to *stage_time if the stage
+// statistics are enabled.
+static INLINE void end_stage_timing(const AV1Decoder *pbi,
+                                    struct aom_usec_timer *timer,
+                                    int64_t *stage_time) {
+  if (pbi->stage_stats_enabled) {
+    aom_usec_timer_mark(timer);
+    *stage_time += aom_usec_timer_elapsed(timer);
+  }
+}
+
 #define ACCT_STR __func__
 static INLINE int av1_read_uniform(aom_reader *r, int n) {
   const int l = get_unsigned_bits(n);
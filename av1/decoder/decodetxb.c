@@ -9,8 +9,12 @@
  * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
  */
 
+#include <stdlib.h>
+
 #include "av1/decoder/decodetxb.h"
 
+#include "config/av1_rtcd.h"
+
 #include "aom_ports/mem.h"
 #include "av1/common/idct.h"
 #include "av1/common/scan.h"
@@ -300,13 +304,26 @@ uint8_t av1_read_coeffs_txb(const AV1_COMMON *const cm, DecoderCodingBlock *dcb,
       //   The valid range for 8/10/12 bit vdieo is at most 14/16/18 bit
       level &= 0xfffff;
       cul_level += level;
-      tran_low_t dq_coeff;
+      tcoeffs[pos] = sign ? -level : level;
+    }
+  }
+
+  if (iqmatrix == NULL && *eob * 4 > *max_scan_line) {
+    // Most coefficients up to the last nonzero one in raster order are
+    // nonzero, so dequantize all of them at once.
+    av1_dequant_coeffs(tcoeffs, *max_scan_line + 1, dequant[0], dequant[1],
+                       shift, xd->bd);
+  } else {
+    for (int c = 0; c < *eob; ++c) {
+      const int pos = scan[c];
+      const tran_low_t level = tcoeffs[pos];
+      if (!level) continue;
+      const int dqv = get_dqv(dequant, pos, iqmatrix);
       // Bitmasking to clamp dq_coeff to valid range:
       //   The valid range for 8/10/12 bit video is at most 17/19/21 bit
-      dq_coeff = (tran_low_t)(
-          (int64_t)level * get_dqv(dequant, scan[c], iqmatrix) & 0xffffff);
+      tran_low_t dq_coeff = (tran_low_t)((int64_t)abs(level) * dqv & 0xffffff);
       dq_coeff = dq_coeff >> shift;
-      if (sign) {
+      if (level < 0) {
         dq_coeff = -dq_coeff;
       }
       tcoeffs[pos] = clamp(dq_coeff, min_value, max_value);
@@ -321,6 +338,20 @@ uint8_t av1_read_coeffs_txb(const AV1_COMMON *const cm, DecoderCodingBlock *dcb,
   return cul_level;
 }
 
+void av1_dequant_coeffs_c(tran_low_t *coeffs, int n, int dc_q, int ac_q,
+                          int shift, int bd) {
+  const int32_t max_value = (1 << (7 + bd)) - 1;
+  const int32_t min_value = -(1 << (7 + bd));
+  for (int i = 0; i < n; ++i) {
+    const tran_low_t level = coeffs[i];
+    const int dqv = i == 0 ? dc_q : ac_q;
+    tran_low_t dq_coeff =
+        (tran_low_t)((int64_t)abs(level) * dqv & 0xffffff) >> shift;
+    if (level < 0) dq_coeff = -dq_coeff;
+    coeffs[i] = clamp(dq_coeff, min_value, max_value);
+  }
+}
+
 void av1_read_coeffs_txb_facade(const AV1_COMMON *const cm,
                                 DecoderCodingBlock *dcb, aom_reader *const r,
                                 const int plane, const int row, const int col,
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <assert.h>
+#include <limits.h>
+#include <string.h>
+
+#include "config/aom_config.h"
+
+#include "aom/internal/aom_image_internal.h"
+#include "aom_mem/aom_mem.h"
+#include "av1/common/av1_common_int.h"
+#include "av1/decoder/decoder.h"
+#include "av1/decoder/dthread.h"
+
+int av1_frameworker_wait_parse_done(BufferPool *pool, RefCntBuffer *buf) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&pool->pool_mutex);
+  while (buf->decode_in_progress && !buf->parse_done)
+    pthread_cond_wait(&pool->progress_cond, &pool->pool_mutex);
+  const int corrupted = buf->buf.corrupted;
+  pthread_mutex_unlock(&pool->pool_mutex);
+  return corrupted;
+#else
+  (void)pool;
+  return buf->buf.corrupted;
+#endif
+}
+
+int av1_frameworker_wait_rows(BufferPool *pool, RefCntBuffer *buf, int rows) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&pool->pool_mutex);
+  while (buf->decode_in_progress && buf->decoded_rows < rows)
+    pthread_cond_wait(&pool->progress_cond, &pool->pool_mutex);
+  const int ready = buf->decode_in_progress ? buf->decoded_rows : INT_MAX;
+  pthread_mutex_unlock(&pool->pool_mutex);
+  return ready;
+#else
+  (void)pool;
+  (void)buf;
+  (void)rows;
+  return INT_MAX;
+#endif
+}
+
+void av1_frameworker_set_parse_done(BufferPool *pool, RefCntBuffer *buf) {
+  lock_buffer_pool(pool);
+  buf->parse_done = 1;
+#if CONFIG_MULTITHREAD
+  pthread_cond_broadcast(&pool->progress_cond);
+#endif
+  unlock_buffer_pool(pool);
+}
+
+void av1_frameworker_set_decoded_rows(BufferPool *pool, RefCntBuffer *buf,
+                                      int rows) {
+  lock_buffer_pool(pool);
+  if (rows == INT_MAX) {
+    buf->parse_done = 1;
+    buf->decode_in_progress = 0;
+  }
+  buf->decoded_rows = rows;
+#if CONFIG_MULTITHREAD
+  pthread_cond_broadcast(&pool->progress_cond);
+#endif
+  unlock_buffer_pool(pool);
+}
+
+void av1_frameworker_defer_tile_group(AV1Decoder *pbi, const uint8_t *data,
+                                      const uint8_t *data_end, int start_tile,
+                                      int end_tile, int is_first_tg) {
+  const CommonTileParams *const tiles = &pbi->common.tiles;
+
+  if (is_first_tg) pbi->num_deferred_tgs = 0;
+  // A frame has at most one tile group per tile.
+  const int max_tgs = tiles->rows * tiles->cols;
+  if (pbi->deferred_tgs_alloc_size < max_tgs) {
+    assert(pbi->num_deferred_tgs == 0);
+    aom_free(pbi->deferred_tgs);
+    pbi->deferred_tgs_alloc_size = 0;
+    pbi->deferred_tgs = (DeferredTileGroup *)aom_malloc(
+        max_tgs * sizeof(*pbi->deferred_tgs));
+    if (pbi->deferred_tgs == NULL) {
+      aom_internal_error(&pbi->error, AOM_CODEC_MEM_ERROR,
+                         "Failed to allocate pbi->deferred_tgs");
+    }
+    pbi->deferred_tgs_alloc_size = max_tgs;
+  }
+  if (pbi->num_deferred_tgs >= pbi->deferred_tgs_alloc_size) {
+    aom_internal_error(&pbi->error, AOM_CODEC_CORRUPT_FRAME,
+                       "Too many tile groups");
+  }
+
+  DeferredTileGroup *const tg = &pbi->deferred_tgs[pbi->num_deferred_tgs++];
+  tg->data = data;
+  tg->data_end = data_end;
+  tg->start_tile = start_tile;
+  tg->end_tile = end_tile;
+  tg->is_first_tg = is_first_tg;
+}
+
+void av1_frameworker_copy_context(AV1Decoder *dst, AV1Decoder *src) {
+  AV1_COMMON *const dst_cm = &dst->common;
+  const AV1_COMMON *const src_cm = &src->common;
+  BufferPool *const pool = dst_cm->buffer_pool;
+
+  lock_buffer_pool(pool);
+  for (int i = 0; i < REF_FRAMES; ++i) {
+    decrease_ref_count(dst_cm->ref_frame_map[i], pool);
+    decrease_ref_count(dst->next_ref_frame_map[i], pool);
+    dst->next_ref_frame_map[i] = NULL;
+    dst_cm->ref_frame_map[i] = src->next_ref_frame_map[i];
+    if (dst_cm->ref_frame_map[i] != NULL)
+      ++dst_cm->ref_frame_map[i]->ref_count;
+  }
+  unlock_buffer_pool(pool);
+
+  dst->seq_params = src->seq_params;
+  dst->sequence_header_ready = src->sequence_header_ready;
+  dst->sequence_header_changed = src->sequence_header_changed;
+  dst->current_operating_point = src->current_operating_point;
+  dst->number_temporal_layers = src->number_temporal_layers;
+  dst->number_spatial_layers = src->number_spatial_layers;
+  dst->buffer_removal_time_present = src->buffer_removal_time_present;
+  dst->decoding_first_frame = src->decoding_first_frame;
+  dst->need_resync = src->need_resync;
+  dst->is_fwd_kf_present = src->is_fwd_kf_present;
+  dst->is_arf_frame_present = src->is_arf_frame_present;
+  memcpy(dst->valid_for_referencing, src->valid_for_referencing,
+         sizeof(dst->valid_for_referencing));
+
+  dst_cm->current_frame = src_cm->current_frame;
+  dst_cm->current_frame_id = src_cm->current_frame_id;
+  memcpy(dst_cm->ref_frame_id, src_cm->ref_frame_id,
+         sizeof(dst_cm->ref_frame_id));
+  *dst_cm->default_frame_context = *src_cm->default_frame_context;
+
+  // Metadata OBUs are attached to the next output frame, so they follow the
+  // parsing order.
+  aom_img_metadata_array_free(dst->metadata);
+  dst->metadata = src->metadata;
+  src->metadata = NULL;
+}
+
+void av1_frameworker_commit_ref_frame_map(AV1Decoder *pbi) {
+  AV1_COMMON *const cm = &pbi->common;
+  BufferPool *const pool = cm->buffer_pool;
+
+  lock_buffer_pool(pool);
+  for (int i = 0; i < REF_FRAMES; ++i) {
+    decrease_ref_count(cm->ref_frame_map[i], pool);
+    cm->ref_frame_map[i] = pbi->next_ref_frame_map[i];
+    if (cm->ref_frame_map[i] != NULL) ++cm->ref_frame_map[i]->ref_count;
+  }
+  unlock_buffer_pool(pool);
+}
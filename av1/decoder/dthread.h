@@ -22,6 +22,8 @@ extern "C" {
 
 struct AV1Common;
 struct AV1Decoder;
+struct BufferPool;
+struct RefCntBuffer;
 struct ThreadData;
 
 typedef struct DecWorkerData {
@@ -41,8 +43,44 @@ typedef struct FrameWorkerData {
   int received_frame;
   int frame_context_ready;  // Current frame's context is ready to read.
   int frame_decoded;        // Finished decoding current frame.
+  // Private copy of the compressed data in frame parallel decoding. The tile
+  // groups deferred to the frame worker thread point into this buffer.
+  uint8_t *scratch_buffer;
+  size_t scratch_buffer_size;
 } FrameWorkerData;
 
+// Blocks until the mvs, seg_map and frame_context of buf are available.
+// Returns nonzero if buf is corrupted.
+int av1_frameworker_wait_parse_done(struct BufferPool *pool,
+                                    struct RefCntBuffer *buf);
+
+// Blocks until at least 'rows' luma rows of buf are decoded. Returns the
+// number of rows known to be ready, which is INT_MAX once buf is complete.
+int av1_frameworker_wait_rows(struct BufferPool *pool,
+                              struct RefCntBuffer *buf, int rows);
+
+void av1_frameworker_set_parse_done(struct BufferPool *pool,
+                                    struct RefCntBuffer *buf);
+
+// Publishes the decode progress of buf. Passing INT_MAX marks buf complete.
+void av1_frameworker_set_decoded_rows(struct BufferPool *pool,
+                                      struct RefCntBuffer *buf, int rows);
+
+// Records a tile group whose decoding is deferred to the frame worker thread.
+void av1_frameworker_defer_tile_group(struct AV1Decoder *pbi,
+                                      const uint8_t *data,
+                                      const uint8_t *data_end, int start_tile,
+                                      int end_tile, int is_first_tg);
+
+// Copies the state needed to parse the next frame from src, which parsed the
+// previous frame, into dst. dst must be idle.
+void av1_frameworker_copy_context(struct AV1Decoder *dst,
+                                  struct AV1Decoder *src);
+
+// Makes cm->ref_frame_map reflect the reference updates of the last frame
+// parsed by pbi. pbi must be idle.
+void av1_frameworker_commit_ref_frame_map(struct AV1Decoder *pbi);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
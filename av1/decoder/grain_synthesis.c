@@ -19,6 +19,9 @@
 #include <string.h>
 #include <stdlib.h>
 #include <assert.h>
+
+#include "config/av1_rtcd.h"
+
 #include "aom_dsp/aom_dsp_common.h"
 #include "aom_mem/aom_mem.h"
 #include "av1/decoder/grain_synthesis.h"
@@ -218,11 +221,8 @@ static const int gaussian_sequence[2048] = {
 
 static const int gauss_bits = 11;
 
-static int luma_subblock_size_y = 32;
-static int luma_subblock_size_x = 32;
-
-static int chroma_subblock_size_y = 16;
-static int chroma_subblock_size_x = 16;
+static const int luma_subblock_size_y = 32;
+static const int luma_subblock_size_x = 32;
 
 static const int min_luma_legal_range = 16;
 static const int max_luma_legal_range = 235;
@@ -230,21 +230,72 @@ static const int max_luma_legal_range = 235;
 static const int min_chroma_legal_range = 16;
 static const int max_chroma_legal_range = 240;
 
-static int scaling_lut_y[256];
-static int scaling_lut_cb[256];
-static int scaling_lut_cr[256];
-
-static int grain_min;
-static int grain_max;
-
-static uint16_t random_register = 0;  // random number generator register
+// Grain state shared by all the block rows of a frame. It is read-only once
+// set up, so several workers can add grain to different block rows at a time.
+typedef struct {
+  const aom_film_grain_t *params;
+  // Image the block rows are copied from before the grain is added to them, or
+  // NULL if the grain is added in place.
+  const aom_image_t *src;
+  uint8_t *luma;
+  uint8_t *cb;
+  uint8_t *cr;
+  int height;
+  int width;
+  int luma_stride;
+  int chroma_stride;
+  int use_high_bit_depth;
+  int chroma_subsamp_y;
+  int chroma_subsamp_x;
+  int chroma_subblock_size_y;
+  int chroma_subblock_size_x;
+  int *luma_grain_block;
+  int *cb_grain_block;
+  int *cr_grain_block;
+  int luma_grain_stride;
+  int chroma_grain_stride;
+  // Position of the unpadded part of the grain blocks.
+  int luma_grain_offset;
+  int chroma_grain_offset_y;
+  int chroma_grain_offset_x;
+  // Scaling functions sampled at every value of the output bit depth.
+  int *scaling_lut_y;
+  int *scaling_lut_cb;
+  int *scaling_lut_cr;
+  int grain_min;
+  int grain_max;
+  int apply_y;
+  int apply_cb;
+  int apply_cr;
+  int cb_mult;
+  int cb_luma_mult;
+  int cb_offset;
+  int cr_mult;
+  int cr_luma_mult;
+  int cr_offset;
+  int min_luma;
+  int max_luma;
+  int min_chroma;
+  int max_chroma;
+} GrainFrameInfo;
+
+// A range of block rows and the buffers used to blend the grain across block
+// boundaries in it.
+typedef struct {
+  const GrainFrameInfo *info;
+  int *y_line_buf;
+  int *cb_line_buf;
+  int *cr_line_buf;
+  int *y_col_buf;
+  int *cb_col_buf;
+  int *cr_col_buf;
+  // First and last (exclusive) block row, in units of two luma rows.
+  int start_y;
+  int end_y;
+} GrainRowsJob;
 
 static void dealloc_arrays(const aom_film_grain_t *params, int ***pred_pos_luma,
-                           int ***pred_pos_chroma, int **luma_grain_block,
-                           int **cb_grain_block, int **cr_grain_block,
-                           int **y_line_buf, int **cb_line_buf,
-                           int **cr_line_buf, int **y_col_buf, int **cb_col_buf,
-                           int **cr_col_buf) {
+                           int ***pred_pos_chroma, GrainFrameInfo *info) {
   int num_pos_luma = 2 * params->ar_coeff_lag * (params->ar_coeff_lag + 1);
   int num_pos_chroma = num_pos_luma;
   if (params->num_y_points > 0) ++num_pos_chroma;
@@ -265,57 +316,37 @@ static void dealloc_arrays(const aom_film_grain_t *params, int ***pred_pos_luma,
     *pred_pos_chroma = NULL;
   }
 
-  aom_free(*y_line_buf);
-  *y_line_buf = NULL;
-
-  aom_free(*cb_line_buf);
-  *cb_line_buf = NULL;
+  aom_free(info->luma_grain_block);
+  info->luma_grain_block = NULL;
 
-  aom_free(*cr_line_buf);
-  *cr_line_buf = NULL;
+  aom_free(info->cb_grain_block);
+  info->cb_grain_block = NULL;
 
-  aom_free(*y_col_buf);
-  *y_col_buf = NULL;
+  aom_free(info->cr_grain_block);
+  info->cr_grain_block = NULL;
 
-  aom_free(*cb_col_buf);
-  *cb_col_buf = NULL;
+  aom_free(info->scaling_lut_y);
+  info->scaling_lut_y = NULL;
 
-  aom_free(*cr_col_buf);
-  *cr_col_buf = NULL;
+  aom_free(info->scaling_lut_cb);
+  info->scaling_lut_cb = NULL;
 
-  aom_free(*luma_grain_block);
-  *luma_grain_block = NULL;
-
-  aom_free(*cb_grain_block);
-  *cb_grain_block = NULL;
-
-  aom_free(*cr_grain_block);
-  *cr_grain_block = NULL;
+  aom_free(info->scaling_lut_cr);
+  info->scaling_lut_cr = NULL;
 }
 
-static bool init_arrays(const aom_film_grain_t *params, int luma_stride,
-                        int chroma_stride, int ***pred_pos_luma_p,
-                        int ***pred_pos_chroma_p, int **luma_grain_block,
-                        int **cb_grain_block, int **cr_grain_block,
-                        int **y_line_buf, int **cb_line_buf, int **cr_line_buf,
-                        int **y_col_buf, int **cb_col_buf, int **cr_col_buf,
+static bool init_arrays(const aom_film_grain_t *params, int ***pred_pos_luma_p,
+                        int ***pred_pos_chroma_p, GrainFrameInfo *info,
                         int luma_grain_samples, int chroma_grain_samples,
-                        int chroma_subsamp_y, int chroma_subsamp_x) {
+                        int scaling_lut_size) {
   *pred_pos_luma_p = NULL;
   *pred_pos_chroma_p = NULL;
-  *luma_grain_block = NULL;
-  *cb_grain_block = NULL;
-  *cr_grain_block = NULL;
-  *y_line_buf = NULL;
-  *cb_line_buf = NULL;
-  *cr_line_buf = NULL;
-  *y_col_buf = NULL;
-  *cb_col_buf = NULL;
-  *cr_col_buf = NULL;
-
-  memset(scaling_lut_y, 0, sizeof(*scaling_lut_y) * 256);
-  memset(scaling_lut_cb, 0, sizeof(*scaling_lut_cb) * 256);
-  memset(scaling_lut_cr, 0, sizeof(*scaling_lut_cr) * 256);
+  info->luma_grain_block = NULL;
+  info->cb_grain_block = NULL;
+  info->cr_grain_block = NULL;
+  info->scaling_lut_y = NULL;
+  info->scaling_lut_cb = NULL;
+  info->scaling_lut_cr = NULL;
 
   int num_pos_luma = 2 * params->ar_coeff_lag * (params->ar_coeff_lag + 1);
   int num_pos_chroma = num_pos_luma;
@@ -326,14 +357,12 @@ static bool init_arrays(const aom_film_grain_t *params, int luma_stride,
 
   pred_pos_luma = (int **)aom_calloc(num_pos_luma, sizeof(*pred_pos_luma));
   if (!pred_pos_luma) return false;
+  *pred_pos_luma_p = pred_pos_luma;
 
   for (int row = 0; row < num_pos_luma; row++) {
     pred_pos_luma[row] = (int *)aom_malloc(sizeof(**pred_pos_luma) * 3);
     if (!pred_pos_luma[row]) {
-      dealloc_arrays(params, pred_pos_luma_p, pred_pos_chroma_p,
-                     luma_grain_block, cb_grain_block, cr_grain_block,
-                     y_line_buf, cb_line_buf, cr_line_buf, y_col_buf,
-                     cb_col_buf, cr_col_buf);
+      dealloc_arrays(params, pred_pos_luma_p, pred_pos_chroma_p, info);
       return false;
     }
   }
@@ -341,19 +370,15 @@ static bool init_arrays(const aom_film_grain_t *params, int luma_stride,
   pred_pos_chroma =
       (int **)aom_calloc(num_pos_chroma, sizeof(*pred_pos_chroma));
   if (!pred_pos_chroma) {
-    dealloc_arrays(params, pred_pos_luma_p, pred_pos_chroma_p, luma_grain_block,
-                   cb_grain_block, cr_grain_block, y_line_buf, cb_line_buf,
-                   cr_line_buf, y_col_buf, cb_col_buf, cr_col_buf);
+    dealloc_arrays(params, pred_pos_luma_p, pred_pos_chroma_p, info);
     return false;
   }
+  *pred_pos_chroma_p = pred_pos_chroma;
 
   for (int row = 0; row < num_pos_chroma; row++) {
     pred_pos_chroma[row] = (int *)aom_malloc(sizeof(**pred_pos_chroma) * 3);
     if (!pred_pos_chroma[row]) {
-      dealloc_arrays(params, pred_pos_luma_p, pred_pos_chroma_p,
-                     luma_grain_block, cb_grain_block, cr_grain_block,
-                     y_line_buf, cb_line_buf, cr_line_buf, y_col_buf,
-                     cb_col_buf, cr_col_buf);
+      dealloc_arrays(params, pred_pos_luma_p, pred_pos_chroma_p, info);
       return false;
     }
   }
@@ -392,72 +417,108 @@ static bool init_arrays(const aom_film_grain_t *params, int luma_stride,
     pred_pos_chroma[pos_ar_index][2] = 1;
   }
 
-  *pred_pos_luma_p = pred_pos_luma;
-  *pred_pos_chroma_p = pred_pos_chroma;
+  info->luma_grain_block = (int *)aom_malloc(
+      sizeof(*info->luma_grain_block) * luma_grain_samples);
+  info->cb_grain_block =
+      (int *)aom_malloc(sizeof(*info->cb_grain_block) * chroma_grain_samples);
+  info->cr_grain_block =
+      (int *)aom_malloc(sizeof(*info->cr_grain_block) * chroma_grain_samples);
+  info->scaling_lut_y =
+      (int *)aom_malloc(sizeof(*info->scaling_lut_y) * scaling_lut_size);
+  info->scaling_lut_cb =
+      (int *)aom_malloc(sizeof(*info->scaling_lut_cb) * scaling_lut_size);
+  info->scaling_lut_cr =
+      (int *)aom_malloc(sizeof(*info->scaling_lut_cr) * scaling_lut_size);
+  if (!(info->luma_grain_block && info->cb_grain_block &&
+        info->cr_grain_block && info->scaling_lut_y && info->scaling_lut_cb &&
+        info->scaling_lut_cr)) {
+    dealloc_arrays(params, pred_pos_luma_p, pred_pos_chroma_p, info);
+    return false;
+  }
+  return true;
+}
+
+static void dealloc_job_buffers(GrainRowsJob *job) {
+  aom_free(job->y_line_buf);
+  job->y_line_buf = NULL;
+
+  aom_free(job->cb_line_buf);
+  job->cb_line_buf = NULL;
+
+  aom_free(job->cr_line_buf);
+  job->cr_line_buf = NULL;
+
+  aom_free(job->y_col_buf);
+  job->y_col_buf = NULL;
+
+  aom_free(job->cb_col_buf);
+  job->cb_col_buf = NULL;
 
-  *y_line_buf = (int *)aom_malloc(sizeof(**y_line_buf) * luma_stride * 2);
-  *cb_line_buf = (int *)aom_malloc(sizeof(**cb_line_buf) * chroma_stride *
-                                   (2 >> chroma_subsamp_y));
-  *cr_line_buf = (int *)aom_malloc(sizeof(**cr_line_buf) * chroma_stride *
-                                   (2 >> chroma_subsamp_y));
-
-  *y_col_buf =
-      (int *)aom_malloc(sizeof(**y_col_buf) * (luma_subblock_size_y + 2) * 2);
-  *cb_col_buf =
-      (int *)aom_malloc(sizeof(**cb_col_buf) *
-                        (chroma_subblock_size_y + (2 >> chroma_subsamp_y)) *
-                        (2 >> chroma_subsamp_x));
-  *cr_col_buf =
-      (int *)aom_malloc(sizeof(**cr_col_buf) *
-                        (chroma_subblock_size_y + (2 >> chroma_subsamp_y)) *
-                        (2 >> chroma_subsamp_x));
-
-  *luma_grain_block =
-      (int *)aom_malloc(sizeof(**luma_grain_block) * luma_grain_samples);
-  *cb_grain_block =
-      (int *)aom_malloc(sizeof(**cb_grain_block) * chroma_grain_samples);
-  *cr_grain_block =
-      (int *)aom_malloc(sizeof(**cr_grain_block) * chroma_grain_samples);
-  if (!(*pred_pos_luma_p && *pred_pos_chroma_p && *y_line_buf && *cb_line_buf &&
-        *cr_line_buf && *y_col_buf && *cb_col_buf && *cr_col_buf &&
-        *luma_grain_block && *cb_grain_block && *cr_grain_block)) {
-    dealloc_arrays(params, pred_pos_luma_p, pred_pos_chroma_p, luma_grain_block,
-                   cb_grain_block, cr_grain_block, y_line_buf, cb_line_buf,
-                   cr_line_buf, y_col_buf, cb_col_buf, cr_col_buf);
+  aom_free(job->cr_col_buf);
+  job->cr_col_buf = NULL;
+}
+
+static bool init_job_buffers(GrainRowsJob *job, const GrainFrameInfo *info) {
+  const int chroma_subsamp_y = info->chroma_subsamp_y;
+  const int chroma_subsamp_x = info->chroma_subsamp_x;
+  const int chroma_col_buf_size =
+      (info->chroma_subblock_size_y + (2 >> chroma_subsamp_y)) *
+      (2 >> chroma_subsamp_x);
+  const int chroma_line_buf_size =
+      info->chroma_stride * (2 >> chroma_subsamp_y);
+
+  job->y_line_buf =
+      (int *)aom_malloc(sizeof(*job->y_line_buf) * info->luma_stride * 2);
+  job->cb_line_buf =
+      (int *)aom_malloc(sizeof(*job->cb_line_buf) * chroma_line_buf_size);
+  job->cr_line_buf =
+      (int *)aom_malloc(sizeof(*job->cr_line_buf) * chroma_line_buf_size);
+
+  job->y_col_buf = (int *)aom_malloc(sizeof(*job->y_col_buf) *
+                                     (luma_subblock_size_y + 2) * 2);
+  job->cb_col_buf =
+      (int *)aom_malloc(sizeof(*job->cb_col_buf) * chroma_col_buf_size);
+  job->cr_col_buf =
+      (int *)aom_malloc(sizeof(*job->cr_col_buf) * chroma_col_buf_size);
+  if (!(job->y_line_buf && job->cb_line_buf && job->cr_line_buf &&
+        job->y_col_buf && job->cb_col_buf && job->cr_col_buf)) {
+    dealloc_job_buffers(job);
     return false;
   }
   return true;
 }
 
 // get a number between 0 and 2^bits - 1
-static INLINE int get_random_number(int bits) {
+static INLINE int get_random_number(uint16_t *random_register, int bits) {
   uint16_t bit;
-  bit = ((random_register >> 0) ^ (random_register >> 1) ^
-         (random_register >> 3) ^ (random_register >> 12)) &
+  bit = ((*random_register >> 0) ^ (*random_register >> 1) ^
+         (*random_register >> 3) ^ (*random_register >> 12)) &
         1;
-  random_register = (random_register >> 1) | (bit << 15);
-  return (random_register >> (16 - bits)) & ((1 << bits) - 1);
+  *random_register = (*random_register >> 1) | (bit << 15);
+  return (*random_register >> (16 - bits)) & ((1 << bits) - 1);
 }
 
-static void init_random_generator(int luma_line, uint16_t seed) {
+static void init_random_generator(uint16_t *random_register, int luma_line,
+                                  uint16_t seed) {
   // same for the picture
 
   uint16_t msb = (seed >> 8) & 255;
   uint16_t lsb = seed & 255;
 
-  random_register = (msb << 8) + lsb;
+  *random_register = (msb << 8) + lsb;
 
   //  changes for each row
   int luma_num = luma_line >> 5;
 
-  random_register ^= ((luma_num * 37 + 178) & 255) << 8;
-  random_register ^= ((luma_num * 173 + 105) & 255);
+  *random_register ^= ((luma_num * 37 + 178) & 255) << 8;
+  *random_register ^= ((luma_num * 173 + 105) & 255);
 }
 
 static void generate_luma_grain_block(
     const aom_film_grain_t *params, int **pred_pos_luma, int *luma_grain_block,
     int luma_block_size_y, int luma_block_size_x, int luma_grain_stride,
-    int left_pad, int top_pad, int right_pad, int bottom_pad) {
+    int left_pad, int top_pad, int right_pad, int bottom_pad,
+    uint16_t *random_register, int grain_min, int grain_max) {
   if (params->num_y_points == 0) {
     memset(luma_grain_block, 0,
            sizeof(*luma_grain_block) * luma_block_size_y * luma_grain_stride);
@@ -473,7 +534,7 @@ static void generate_luma_grain_block(
   for (int i = 0; i < luma_block_size_y; i++)
     for (int j = 0; j < luma_block_size_x; j++)
       luma_grain_block[i * luma_grain_stride + j] =
-          (gaussian_sequence[get_random_number(gauss_bits)] +
+          (gaussian_sequence[get_random_number(random_register, gauss_bits)] +
            ((1 << gauss_sec_shift) >> 1)) >>
           gauss_sec_shift;
 
@@ -498,7 +559,8 @@ static bool generate_chroma_grain_blocks(
     int *luma_grain_block, int *cb_grain_block, int *cr_grain_block,
     int luma_grain_stride, int chroma_block_size_y, int chroma_block_size_x,
     int chroma_grain_stride, int left_pad, int top_pad, int right_pad,
-    int bottom_pad, int chroma_subsamp_y, int chroma_subsamp_x) {
+    int bottom_pad, int chroma_subsamp_y, int chroma_subsamp_x,
+    uint16_t *random_register, int grain_min, int grain_max) {
   int bit_depth = params->bit_depth;
   int gauss_sec_shift = 12 - bit_depth + params->grain_scale_shift;
 
@@ -508,12 +570,13 @@ static bool generate_chroma_grain_blocks(
   int chroma_grain_block_size = chroma_block_size_y * chroma_grain_stride;
 
   if (params->num_cb_points || params->chroma_scaling_from_luma) {
-    init_random_generator(7 << 5, params->random_seed);
+    init_random_generator(random_register, 7 << 5, params->random_seed);
 
     for (int i = 0; i < chroma_block_size_y; i++)
       for (int j = 0; j < chroma_block_size_x; j++)
         cb_grain_block[i * chroma_grain_stride + j] =
-            (gaussian_sequence[get_random_number(gauss_bits)] +
+            (gaussian_sequence[get_random_number(random_register,
+                                                 gauss_bits)] +
              ((1 << gauss_sec_shift) >> 1)) >>
             gauss_sec_shift;
   } else {
@@ -522,12 +585,13 @@ static bool generate_chroma_grain_blocks(
   }
 
   if (params->num_cr_points || params->chroma_scaling_from_luma) {
-    init_random_generator(11 << 5, params->random_seed);
+    init_random_generator(random_register, 11 << 5, params->random_seed);
 
     for (int i = 0; i < chroma_block_size_y; i++)
       for (int j = 0; j < chroma_block_size_x; j++)
         cr_grain_block[i * chroma_grain_stride + j] =
-            (gaussian_sequence[get_random_number(gauss_bits)] +
+            (gaussian_sequence[get_random_number(random_register,
+                                                 gauss_bits)] +
              ((1 << gauss_sec_shift) >> 1)) >>
             gauss_sec_shift;
   } else {
@@ -625,234 +689,190 @@ static int scale_LUT(int *scaling_lut, int index, int bit_depth) {
                              (bit_depth - 8));
 }
 
-static void add_noise_to_block(const aom_film_grain_t *params, uint8_t *luma,
-                               uint8_t *cb, uint8_t *cr, int luma_stride,
-                               int chroma_stride, int *luma_grain,
-                               int *cb_grain, int *cr_grain,
-                               int luma_grain_stride, int chroma_grain_stride,
-                               int half_luma_height, int half_luma_width,
-                               int bit_depth, int chroma_subsamp_y,
-                               int chroma_subsamp_x, int mc_identity) {
-  int cb_mult = params->cb_mult - 128;            // fixed scale
-  int cb_luma_mult = params->cb_luma_mult - 128;  // fixed scale
-  int cb_offset = params->cb_offset - 256;
-
-  int cr_mult = params->cr_mult - 128;            // fixed scale
-  int cr_luma_mult = params->cr_luma_mult - 128;  // fixed scale
-  int cr_offset = params->cr_offset - 256;
-
-  int rounding_offset = (1 << (params->scaling_shift - 1));
-
-  int apply_y = params->num_y_points > 0 ? 1 : 0;
-  int apply_cb =
-      (params->num_cb_points > 0 || params->chroma_scaling_from_luma) ? 1 : 0;
-  int apply_cr =
-      (params->num_cr_points > 0 || params->chroma_scaling_from_luma) ? 1 : 0;
-
-  if (params->chroma_scaling_from_luma) {
-    cb_mult = 0;        // fixed scale
-    cb_luma_mult = 64;  // fixed scale
-    cb_offset = 0;
+// Samples the scaling function at every value of the given bit depth, so that
+// adding the noise needs a single table lookup per sample.
+static void expand_scaling_lut(int *scaling_lut, int bit_depth,
+                               int *expanded_lut) {
+  for (int i = 0; i < (256 << (bit_depth - 8)); i++)
+    expanded_lut[i] = scale_LUT(scaling_lut, i, bit_depth);
+}
 
-    cr_mult = 0;        // fixed scale
-    cr_luma_mult = 64;  // fixed scale
-    cr_offset = 0;
+void av1_add_luma_grain_c(uint8_t *luma, int luma_stride, const int *grain,
+                          int grain_stride, const int *scaling_lut, int width,
+                          int height, int scaling_shift, int min_val,
+                          int max_val) {
+  const int rounding_offset = (1 << (scaling_shift - 1));
+
+  for (int i = 0; i < height; i++) {
+    for (int j = 0; j < width; j++) {
+      luma[j] = clamp(
+          luma[j] + ((scaling_lut[luma[j]] * grain[j] + rounding_offset) >>
+                     scaling_shift),
+          min_val, max_val);
+    }
+    luma += luma_stride;
+    grain += grain_stride;
   }
+}
 
-  int min_luma, max_luma, min_chroma, max_chroma;
-
-  if (params->clip_to_restricted_range) {
-    min_luma = min_luma_legal_range;
-    max_luma = max_luma_legal_range;
-
-    if (mc_identity) {
-      min_chroma = min_luma_legal_range;
-      max_chroma = max_luma_legal_range;
-    } else {
-      min_chroma = min_chroma_legal_range;
-      max_chroma = max_chroma_legal_range;
+void av1_highbd_add_luma_grain_c(uint16_t *luma, int luma_stride,
+                                 const int *grain, int grain_stride,
+                                 const int *scaling_lut, int width, int height,
+                                 int scaling_shift, int min_val, int max_val) {
+  const int rounding_offset = (1 << (scaling_shift - 1));
+
+  for (int i = 0; i < height; i++) {
+    for (int j = 0; j < width; j++) {
+      luma[j] = clamp(
+          luma[j] + ((scaling_lut[luma[j]] * grain[j] + rounding_offset) >>
+                     scaling_shift),
+          min_val, max_val);
     }
-  } else {
-    min_luma = min_chroma = 0;
-    max_luma = max_chroma = 255;
+    luma += luma_stride;
+    grain += grain_stride;
   }
+}
 
-  for (int i = 0; i < (half_luma_height << (1 - chroma_subsamp_y)); i++) {
-    for (int j = 0; j < (half_luma_width << (1 - chroma_subsamp_x)); j++) {
+void av1_add_chroma_grain_c(uint8_t *chroma, int chroma_stride,
+                            const uint8_t *luma, int luma_stride,
+                            const int *grain, int grain_stride,
+                            const int *scaling_lut, int width, int height,
+                            int chroma_subsamp_x, int luma_mult, int mult,
+                            int offset, int scaling_shift, int min_val,
+                            int max_val) {
+  const int rounding_offset = (1 << (scaling_shift - 1));
+
+  for (int i = 0; i < height; i++) {
+    for (int j = 0; j < width; j++) {
       int average_luma = 0;
       if (chroma_subsamp_x) {
-        average_luma = (luma[(i << chroma_subsamp_y) * luma_stride +
-                             (j << chroma_subsamp_x)] +
-                        luma[(i << chroma_subsamp_y) * luma_stride +
-                             (j << chroma_subsamp_x) + 1] +
-                        1) >>
-                       1;
+        average_luma = (luma[j << 1] + luma[(j << 1) + 1] + 1) >> 1;
       } else {
-        average_luma = luma[(i << chroma_subsamp_y) * luma_stride + j];
-      }
-
-      if (apply_cb) {
-        cb[i * chroma_stride + j] = clamp(
-            cb[i * chroma_stride + j] +
-                ((scale_LUT(scaling_lut_cb,
-                            clamp(((average_luma * cb_luma_mult +
-                                    cb_mult * cb[i * chroma_stride + j]) >>
-                                   6) +
-                                      cb_offset,
-                                  0, (256 << (bit_depth - 8)) - 1),
-                            8) *
-                      cb_grain[i * chroma_grain_stride + j] +
-                  rounding_offset) >>
-                 params->scaling_shift),
-            min_chroma, max_chroma);
-      }
-
-      if (apply_cr) {
-        cr[i * chroma_stride + j] = clamp(
-            cr[i * chroma_stride + j] +
-                ((scale_LUT(scaling_lut_cr,
-                            clamp(((average_luma * cr_luma_mult +
-                                    cr_mult * cr[i * chroma_stride + j]) >>
-                                   6) +
-                                      cr_offset,
-                                  0, (256 << (bit_depth - 8)) - 1),
-                            8) *
-                      cr_grain[i * chroma_grain_stride + j] +
-                  rounding_offset) >>
-                 params->scaling_shift),
-            min_chroma, max_chroma);
-      }
-    }
-  }
-
-  if (apply_y) {
-    for (int i = 0; i < (half_luma_height << 1); i++) {
-      for (int j = 0; j < (half_luma_width << 1); j++) {
-        luma[i * luma_stride + j] =
-            clamp(luma[i * luma_stride + j] +
-                      ((scale_LUT(scaling_lut_y, luma[i * luma_stride + j], 8) *
-                            luma_grain[i * luma_grain_stride + j] +
-                        rounding_offset) >>
-                       params->scaling_shift),
-                  min_luma, max_luma);
+        average_luma = luma[j];
       }
+      const int merged = clamp(
+          ((average_luma * luma_mult + mult * chroma[j]) >> 6) + offset, 0,
+          255);
+      chroma[j] = clamp(
+          chroma[j] + ((scaling_lut[merged] * grain[j] + rounding_offset) >>
+                       scaling_shift),
+          min_val, max_val);
     }
+    chroma += chroma_stride;
+    luma += luma_stride;
+    grain += grain_stride;
   }
 }
 
-static void add_noise_to_block_hbd(
-    const aom_film_grain_t *params, uint16_t *luma, uint16_t *cb, uint16_t *cr,
-    int luma_stride, int chroma_stride, int *luma_grain, int *cb_grain,
-    int *cr_grain, int luma_grain_stride, int chroma_grain_stride,
-    int half_luma_height, int half_luma_width, int bit_depth,
-    int chroma_subsamp_y, int chroma_subsamp_x, int mc_identity) {
-  int cb_mult = params->cb_mult - 128;            // fixed scale
-  int cb_luma_mult = params->cb_luma_mult - 128;  // fixed scale
-  // offset value depends on the bit depth
-  int cb_offset = (params->cb_offset << (bit_depth - 8)) - (1 << bit_depth);
-
-  int cr_mult = params->cr_mult - 128;            // fixed scale
-  int cr_luma_mult = params->cr_luma_mult - 128;  // fixed scale
-  // offset value depends on the bit depth
-  int cr_offset = (params->cr_offset << (bit_depth - 8)) - (1 << bit_depth);
-
-  int rounding_offset = (1 << (params->scaling_shift - 1));
-
-  int apply_y = params->num_y_points > 0 ? 1 : 0;
-  int apply_cb =
-      (params->num_cb_points > 0 || params->chroma_scaling_from_luma) > 0 ? 1
-                                                                          : 0;
-  int apply_cr =
-      (params->num_cr_points > 0 || params->chroma_scaling_from_luma) > 0 ? 1
-                                                                          : 0;
-
-  if (params->chroma_scaling_from_luma) {
-    cb_mult = 0;        // fixed scale
-    cb_luma_mult = 64;  // fixed scale
-    cb_offset = 0;
-
-    cr_mult = 0;        // fixed scale
-    cr_luma_mult = 64;  // fixed scale
-    cr_offset = 0;
-  }
-
-  int min_luma, max_luma, min_chroma, max_chroma;
-
-  if (params->clip_to_restricted_range) {
-    min_luma = min_luma_legal_range << (bit_depth - 8);
-    max_luma = max_luma_legal_range << (bit_depth - 8);
-
-    if (mc_identity) {
-      min_chroma = min_luma_legal_range << (bit_depth - 8);
-      max_chroma = max_luma_legal_range << (bit_depth - 8);
-    } else {
-      min_chroma = min_chroma_legal_range << (bit_depth - 8);
-      max_chroma = max_chroma_legal_range << (bit_depth - 8);
-    }
-  } else {
-    min_luma = min_chroma = 0;
-    max_luma = max_chroma = (256 << (bit_depth - 8)) - 1;
-  }
-
-  for (int i = 0; i < (half_luma_height << (1 - chroma_subsamp_y)); i++) {
-    for (int j = 0; j < (half_luma_width << (1 - chroma_subsamp_x)); j++) {
+void av1_highbd_add_chroma_grain_c(uint16_t *chroma, int chroma_stride,
+                                   const uint16_t *luma, int luma_stride,
+                                   const int *grain, int grain_stride,
+                                   const int *scaling_lut, int width,
+                                   int height, int chroma_subsamp_x,
+                                   int luma_mult, int mult, int offset,
+                                   int scaling_shift, int min_val, int max_val,
+                                   int bd) {
+  const int rounding_offset = (1 << (scaling_shift - 1));
+  const int max_index = (256 << (bd - 8)) - 1;
+
+  for (int i = 0; i < height; i++) {
+    for (int j = 0; j < width; j++) {
       int average_luma = 0;
       if (chroma_subsamp_x) {
-        average_luma = (luma[(i << chroma_subsamp_y) * luma_stride +
-                             (j << chroma_subsamp_x)] +
-                        luma[(i << chroma_subsamp_y) * luma_stride +
-                             (j << chroma_subsamp_x) + 1] +
-                        1) >>
-                       1;
+        average_luma = (luma[j << 1] + luma[(j << 1) + 1] + 1) >> 1;
       } else {
-        average_luma = luma[(i << chroma_subsamp_y) * luma_stride + j];
-      }
-
-      if (apply_cb) {
-        cb[i * chroma_stride + j] = clamp(
-            cb[i * chroma_stride + j] +
-                ((scale_LUT(scaling_lut_cb,
-                            clamp(((average_luma * cb_luma_mult +
-                                    cb_mult * cb[i * chroma_stride + j]) >>
-                                   6) +
-                                      cb_offset,
-                                  0, (256 << (bit_depth - 8)) - 1),
-                            bit_depth) *
-                      cb_grain[i * chroma_grain_stride + j] +
-                  rounding_offset) >>
-                 params->scaling_shift),
-            min_chroma, max_chroma);
-      }
-      if (apply_cr) {
-        cr[i * chroma_stride + j] = clamp(
-            cr[i * chroma_stride + j] +
-                ((scale_LUT(scaling_lut_cr,
-                            clamp(((average_luma * cr_luma_mult +
-                                    cr_mult * cr[i * chroma_stride + j]) >>
-                                   6) +
-                                      cr_offset,
-                                  0, (256 << (bit_depth - 8)) - 1),
-                            bit_depth) *
-                      cr_grain[i * chroma_grain_stride + j] +
-                  rounding_offset) >>
-                 params->scaling_shift),
-            min_chroma, max_chroma);
+        average_luma = luma[j];
       }
+      const int merged = clamp(
+          ((average_luma * luma_mult + mult * chroma[j]) >> 6) + offset, 0,
+          max_index);
+      chroma[j] = clamp(
+          chroma[j] + ((scaling_lut[merged] * grain[j] + rounding_offset) >>
+                       scaling_shift),
+          min_val, max_val);
     }
+    chroma += chroma_stride;
+    luma += luma_stride;
+    grain += grain_stride;
   }
+}
 
-  if (apply_y) {
-    for (int i = 0; i < (half_luma_height << 1); i++) {
-      for (int j = 0; j < (half_luma_width << 1); j++) {
-        luma[i * luma_stride + j] =
-            clamp(luma[i * luma_stride + j] +
-                      ((scale_LUT(scaling_lut_y, luma[i * luma_stride + j],
-                                  bit_depth) *
-                            luma_grain[i * luma_grain_stride + j] +
-                        rounding_offset) >>
-                       params->scaling_shift),
-                  min_luma, max_luma);
-      }
+// Adds grain to the block whose top left luma sample is at row 2 * half_row
+// and column 2 * half_col of the frame.
+static void add_noise_to_block(const GrainFrameInfo *info, int half_row,
+                               int half_col, int *luma_grain, int *cb_grain,
+                               int *cr_grain, int luma_grain_stride,
+                               int chroma_grain_stride, int half_luma_height,
+                               int half_luma_width) {
+  const aom_film_grain_t *const params = info->params;
+  const int chroma_subsamp_y = info->chroma_subsamp_y;
+  const int chroma_subsamp_x = info->chroma_subsamp_x;
+  const int luma_stride = info->luma_stride;
+  const int chroma_stride = info->chroma_stride;
+  const int chroma_height = half_luma_height << (1 - chroma_subsamp_y);
+  const int chroma_width = half_luma_width << (1 - chroma_subsamp_x);
+  const ptrdiff_t luma_offset =
+      (ptrdiff_t)(half_row << 1) * luma_stride + (half_col << 1);
+  const ptrdiff_t chroma_offset =
+      (ptrdiff_t)(half_row << (1 - chroma_subsamp_y)) * chroma_stride +
+      (half_col << (1 - chroma_subsamp_x));
+
+  // The chroma noise depends on the luma samples without grain.
+  if (info->use_high_bit_depth) {
+    uint16_t *luma = (uint16_t *)info->luma + luma_offset;
+    const int bit_depth = params->bit_depth;
+
+    if (info->apply_cb) {
+      av1_highbd_add_chroma_grain(
+          (uint16_t *)info->cb + chroma_offset, chroma_stride, luma,
+          luma_stride << chroma_subsamp_y, cb_grain, chroma_grain_stride,
+          info->scaling_lut_cb, chroma_width, chroma_height, chroma_subsamp_x,
+          info->cb_luma_mult, info->cb_mult, info->cb_offset,
+          params->scaling_shift, info->min_chroma, info->max_chroma,
+          bit_depth);
+    }
+    if (info->apply_cr) {
+      av1_highbd_add_chroma_grain(
+          (uint16_t *)info->cr + chroma_offset, chroma_stride, luma,
+          luma_stride << chroma_subsamp_y, cr_grain, chroma_grain_stride,
+          info->scaling_lut_cr, chroma_width, chroma_height, chroma_subsamp_x,
+          info->cr_luma_mult, info->cr_mult, info->cr_offset,
+          params->scaling_shift, info->min_chroma, info->max_chroma,
+          bit_depth);
+    }
+    if (info->apply_y) {
+      av1_highbd_add_luma_grain(luma, luma_stride, luma_grain,
+                                luma_grain_stride, info->scaling_lut_y,
+                                half_luma_width << 1, half_luma_height << 1,
+                                params->scaling_shift, info->min_luma,
+                                info->max_luma);
+    }
+  } else {
+    uint8_t *luma = info->luma + luma_offset;
+
+    if (info->apply_cb) {
+      av1_add_chroma_grain(info->cb + chroma_offset, chroma_stride, luma,
+                           luma_stride << chroma_subsamp_y, cb_grain,
+                           chroma_grain_stride, info->scaling_lut_cb,
+                           chroma_width, chroma_height, chroma_subsamp_x,
+                           info->cb_luma_mult, info->cb_mult, info->cb_offset,
+                           params->scaling_shift, info->min_chroma,
+                           info->max_chroma);
+    }
+    if (info->apply_cr) {
+      av1_add_chroma_grain(info->cr + chroma_offset, chroma_stride, luma,
+                           luma_stride << chroma_subsamp_y, cr_grain,
+                           chroma_grain_stride, info->scaling_lut_cr,
+                           chroma_width, chroma_height, chroma_subsamp_x,
+                           info->cr_luma_mult, info->cr_mult, info->cr_offset,
+                           params->scaling_shift, info->min_chroma,
+                           info->max_chroma);
+    }
+    if (info->apply_y) {
+      av1_add_luma_grain(luma, luma_stride, luma_grain, luma_grain_stride,
+                         info->scaling_lut_y, half_luma_width << 1,
+                         half_luma_height << 1, params->scaling_shift,
+                         info->min_luma, info->max_luma);
     }
   }
 }
@@ -909,10 +929,47 @@ static void extend_even(uint8_t *dst, int dst_stride, int width, int height,
   }
 }
 
+// Copies the block row starting at luma row 2 * y from info->src, extending
+// odd dimensions to even ones. Copying each block row right before the grain
+// is added to it keeps the rows in cache for the second pass.
+static void copy_block_row(const GrainFrameInfo *info, int y) {
+  const aom_image_t *const src = info->src;
+  const int use_high_bit_depth = info->use_high_bit_depth;
+  const int luma_start = y << 1;
+  const int luma_end = AOMMIN(luma_start + luma_subblock_size_y, info->height);
+  const int luma_stride = info->luma_stride << use_high_bit_depth;
+  uint8_t *const luma = info->luma + luma_start * luma_stride;
+
+  for (int i = luma_start; i < luma_end; i++) {
+    // The last row is duplicated when the height is odd.
+    const int src_row = AOMMIN(i, (int)src->d_h - 1);
+    copy_rect(src->planes[AOM_PLANE_Y] + src_row * src->stride[AOM_PLANE_Y],
+              src->stride[AOM_PLANE_Y], info->luma + i * luma_stride,
+              luma_stride, src->d_w, 1, use_high_bit_depth);
+  }
+  extend_even(luma, luma_stride, src->d_w, luma_end - luma_start,
+              use_high_bit_depth);
+
+  if (src->monochrome) return;
+
+  const int chroma_start = luma_start >> info->chroma_subsamp_y;
+  const int chroma_end = luma_end >> info->chroma_subsamp_y;
+  const int chroma_width = info->width >> info->chroma_subsamp_x;
+  const int chroma_stride = info->chroma_stride << use_high_bit_depth;
+  copy_rect(src->planes[AOM_PLANE_U] + chroma_start * src->stride[AOM_PLANE_U],
+            src->stride[AOM_PLANE_U], info->cb + chroma_start * chroma_stride,
+            chroma_stride, chroma_width, chroma_end - chroma_start,
+            use_high_bit_depth);
+  copy_rect(src->planes[AOM_PLANE_V] + chroma_start * src->stride[AOM_PLANE_V],
+            src->stride[AOM_PLANE_V], info->cr + chroma_start * chroma_stride,
+            chroma_stride, chroma_width, chroma_end - chroma_start,
+            use_high_bit_depth);
+}
+
 static void ver_boundary_overlap(int *left_block, int left_stride,
                                  int *right_block, int right_stride,
                                  int *dst_block, int dst_stride, int width,
-                                 int height) {
+                                 int height, int grain_min, int grain_max) {
   if (width == 1) {
     while (height) {
       *dst_block = clamp((*left_block * 23 + *right_block * 22 + 16) >> 5,
@@ -941,7 +998,7 @@ static void ver_boundary_overlap(int *left_block, int left_stride,
 static void hor_boundary_overlap(int *top_block, int top_stride,
                                  int *bottom_block, int bottom_stride,
                                  int *dst_block, int dst_stride, int width,
-                                 int height) {
+                                 int height, int grain_min, int grain_max) {
   if (height == 1) {
     while (width) {
       *dst_block = clamp((*top_block * 23 + *bottom_block * 22 + 16) >> 5,
@@ -969,8 +1026,495 @@ static void hor_boundary_overlap(int *top_block, int top_stride,
   }
 }
 
-int av1_add_film_grain(const aom_film_grain_t *params, const aom_image_t *src,
-                       aom_image_t *dst) {
+// Adds grain to the block row starting at luma row 2 * y. When apply_noise is
+// 0 only the overlap buffers are updated, which is what the next block row
+// needs from this one.
+static void add_grain_to_block_row(GrainRowsJob *job, int y, int apply_noise) {
+  const GrainFrameInfo *const info = job->info;
+  const aom_film_grain_t *const params = info->params;
+  const int height = info->height;
+  const int width = info->width;
+  const int luma_stride = info->luma_stride;
+  const int chroma_stride = info->chroma_stride;
+  const int chroma_subsamp_y = info->chroma_subsamp_y;
+  const int chroma_subsamp_x = info->chroma_subsamp_x;
+  const int chroma_subblock_size_y = info->chroma_subblock_size_y;
+  const int chroma_subblock_size_x = info->chroma_subblock_size_x;
+  const int luma_grain_stride = info->luma_grain_stride;
+  const int chroma_grain_stride = info->chroma_grain_stride;
+  const int grain_min = info->grain_min;
+  const int grain_max = info->grain_max;
+  const int overlap = params->overlap_flag;
+  int *const luma_grain_block = info->luma_grain_block;
+  int *const cb_grain_block = info->cb_grain_block;
+  int *const cr_grain_block = info->cr_grain_block;
+  int *const y_line_buf = job->y_line_buf;
+  int *const cb_line_buf = job->cb_line_buf;
+  int *const cr_line_buf = job->cr_line_buf;
+  int *const y_col_buf = job->y_col_buf;
+  int *const cb_col_buf = job->cb_col_buf;
+  int *const cr_col_buf = job->cr_col_buf;
+
+  uint16_t random_register;
+  init_random_generator(&random_register, y * 2, params->random_seed);
+
+  for (int x = 0; x < width / 2; x += (luma_subblock_size_x >> 1)) {
+    int offset_y = get_random_number(&random_register, 8);
+    int offset_x = (offset_y >> 4) & 15;
+    offset_y &= 15;
+
+    int luma_offset_y = info->luma_grain_offset + (offset_y << 1);
+    int luma_offset_x = info->luma_grain_offset + (offset_x << 1);
+
+    int chroma_offset_y =
+        info->chroma_grain_offset_y + offset_y * (2 >> chroma_subsamp_y);
+    int chroma_offset_x =
+        info->chroma_grain_offset_x + offset_x * (2 >> chroma_subsamp_x);
+
+    if (overlap && x) {
+      ver_boundary_overlap(
+          y_col_buf, 2,
+          luma_grain_block + luma_offset_y * luma_grain_stride + luma_offset_x,
+          luma_grain_stride, y_col_buf, 2, 2,
+          AOMMIN(luma_subblock_size_y + 2, height - (y << 1)), grain_min,
+          grain_max);
+
+      ver_boundary_overlap(
+          cb_col_buf, 2 >> chroma_subsamp_x,
+          cb_grain_block + chroma_offset_y * chroma_grain_stride +
+              chroma_offset_x,
+          chroma_grain_stride, cb_col_buf, 2 >> chroma_subsamp_x,
+          2 >> chroma_subsamp_x,
+          AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
+                 (height - (y << 1)) >> chroma_subsamp_y),
+          grain_min, grain_max);
+
+      ver_boundary_overlap(
+          cr_col_buf, 2 >> chroma_subsamp_x,
+          cr_grain_block + chroma_offset_y * chroma_grain_stride +
+              chroma_offset_x,
+          chroma_grain_stride, cr_col_buf, 2 >> chroma_subsamp_x,
+          2 >> chroma_subsamp_x,
+          AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
+                 (height - (y << 1)) >> chroma_subsamp_y),
+          grain_min, grain_max);
+
+      int i = y ? 1 : 0;
+
+      if (apply_noise) {
+        add_noise_to_block(
+            info, y + i, x, y_col_buf + i * 4,
+            cb_col_buf + i * (2 - chroma_subsamp_y) * (2 - chroma_subsamp_x),
+            cr_col_buf + i * (2 - chroma_subsamp_y) * (2 - chroma_subsamp_x),
+            2, (2 - chroma_subsamp_x),
+            AOMMIN(luma_subblock_size_y >> 1, height / 2 - y) - i, 1);
+      }
+    }
+
+    if (overlap && y) {
+      if (x) {
+        hor_boundary_overlap(y_line_buf + (x << 1), luma_stride, y_col_buf, 2,
+                             y_line_buf + (x << 1), luma_stride, 2, 2,
+                             grain_min, grain_max);
+
+        hor_boundary_overlap(cb_line_buf + x * (2 >> chroma_subsamp_x),
+                             chroma_stride, cb_col_buf, 2 >> chroma_subsamp_x,
+                             cb_line_buf + x * (2 >> chroma_subsamp_x),
+                             chroma_stride, 2 >> chroma_subsamp_x,
+                             2 >> chroma_subsamp_y, grain_min, grain_max);
+
+        hor_boundary_overlap(cr_line_buf + x * (2 >> chroma_subsamp_x),
+                             chroma_stride, cr_col_buf, 2 >> chroma_subsamp_x,
+                             cr_line_buf + x * (2 >> chroma_subsamp_x),
+                             chroma_stride, 2 >> chroma_subsamp_x,
+                             2 >> chroma_subsamp_y, grain_min, grain_max);
+      }
+
+      hor_boundary_overlap(
+          y_line_buf + ((x ? x + 1 : 0) << 1), luma_stride,
+          luma_grain_block + luma_offset_y * luma_grain_stride +
+              luma_offset_x + (x ? 2 : 0),
+          luma_grain_stride, y_line_buf + ((x ? x + 1 : 0) << 1), luma_stride,
+          AOMMIN(luma_subblock_size_x - ((x ? 1 : 0) << 1),
+                 width - ((x ? x + 1 : 0) << 1)),
+          2, grain_min, grain_max);
+
+      hor_boundary_overlap(
+          cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+          chroma_stride,
+          cb_grain_block + chroma_offset_y * chroma_grain_stride +
+              chroma_offset_x + ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
+          chroma_grain_stride,
+          cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+          chroma_stride,
+          AOMMIN(chroma_subblock_size_x -
+                     ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
+                 (width - ((x ? x + 1 : 0) << 1)) >> chroma_subsamp_x),
+          2 >> chroma_subsamp_y, grain_min, grain_max);
+
+      hor_boundary_overlap(
+          cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+          chroma_stride,
+          cr_grain_block + chroma_offset_y * chroma_grain_stride +
+              chroma_offset_x + ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
+          chroma_grain_stride,
+          cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+          chroma_stride,
+          AOMMIN(chroma_subblock_size_x -
+                     ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
+                 (width - ((x ? x + 1 : 0) << 1)) >> chroma_subsamp_x),
+          2 >> chroma_subsamp_y, grain_min, grain_max);
+
+      if (apply_noise) {
+        add_noise_to_block(info, y, x, y_line_buf + (x << 1),
+                           cb_line_buf + (x << (1 - chroma_subsamp_x)),
+                           cr_line_buf + (x << (1 - chroma_subsamp_x)),
+                           luma_stride, chroma_stride, 1,
+                           AOMMIN(luma_subblock_size_x >> 1, width / 2 - x));
+      }
+    }
+
+    int i = overlap && y ? 1 : 0;
+    int j = overlap && x ? 1 : 0;
+
+    if (apply_noise) {
+      add_noise_to_block(
+          info, y + i, x + j,
+          luma_grain_block + (luma_offset_y + (i << 1)) * luma_grain_stride +
+              luma_offset_x + (j << 1),
+          cb_grain_block +
+              (chroma_offset_y + (i << (1 - chroma_subsamp_y))) *
+                  chroma_grain_stride +
+              chroma_offset_x + (j << (1 - chroma_subsamp_x)),
+          cr_grain_block +
+              (chroma_offset_y + (i << (1 - chroma_subsamp_y))) *
+                  chroma_grain_stride +
+              chroma_offset_x + (j << (1 - chroma_subsamp_x)),
+          luma_grain_stride, chroma_grain_stride,
+          AOMMIN(luma_subblock_size_y >> 1, height / 2 - y) - i,
+          AOMMIN(luma_subblock_size_x >> 1, width / 2 - x) - j);
+    }
+
+    if (overlap) {
+      if (x) {
+        // Copy overlapped column bufer to line buffer
+        copy_area(y_col_buf + (luma_subblock_size_y << 1), 2,
+                  y_line_buf + (x << 1), luma_stride, 2, 2);
+
+        copy_area(
+            cb_col_buf + (chroma_subblock_size_y << (1 - chroma_subsamp_x)),
+            2 >> chroma_subsamp_x, cb_line_buf + (x << (1 - chroma_subsamp_x)),
+            chroma_stride, 2 >> chroma_subsamp_x, 2 >> chroma_subsamp_y);
+
+        copy_area(
+            cr_col_buf + (chroma_subblock_size_y << (1 - chroma_subsamp_x)),
+            2 >> chroma_subsamp_x, cr_line_buf + (x << (1 - chroma_subsamp_x)),
+            chroma_stride, 2 >> chroma_subsamp_x, 2 >> chroma_subsamp_y);
+      }
+
+      // Copy grain to the line buffer for overlap with a bottom block
+      copy_area(
+          luma_grain_block +
+              (luma_offset_y + luma_subblock_size_y) * luma_grain_stride +
+              luma_offset_x + ((x ? 2 : 0)),
+          luma_grain_stride, y_line_buf + ((x ? x + 1 : 0) << 1), luma_stride,
+          AOMMIN(luma_subblock_size_x, width - (x << 1)) - (x ? 2 : 0), 2);
+
+      copy_area(cb_grain_block +
+                    (chroma_offset_y + chroma_subblock_size_y) *
+                        chroma_grain_stride +
+                    chroma_offset_x + (x ? 2 >> chroma_subsamp_x : 0),
+                chroma_grain_stride,
+                cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+                chroma_stride,
+                AOMMIN(chroma_subblock_size_x,
+                       ((width - (x << 1)) >> chroma_subsamp_x)) -
+                    (x ? 2 >> chroma_subsamp_x : 0),
+                2 >> chroma_subsamp_y);
+
+      copy_area(cr_grain_block +
+                    (chroma_offset_y + chroma_subblock_size_y) *
+                        chroma_grain_stride +
+                    chroma_offset_x + (x ? 2 >> chroma_subsamp_x : 0),
+                chroma_grain_stride,
+                cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+                chroma_stride,
+                AOMMIN(chroma_subblock_size_x,
+                       ((width - (x << 1)) >> chroma_subsamp_x)) -
+                    (x ? 2 >> chroma_subsamp_x : 0),
+                2 >> chroma_subsamp_y);
+
+      // Copy grain to the column buffer for overlap with the next block to
+      // the right
+
+      copy_area(luma_grain_block + luma_offset_y * luma_grain_stride +
+                    luma_offset_x + luma_subblock_size_x,
+                luma_grain_stride, y_col_buf, 2, 2,
+                AOMMIN(luma_subblock_size_y + 2, height - (y << 1)));
+
+      copy_area(cb_grain_block + chroma_offset_y * chroma_grain_stride +
+                    chroma_offset_x + chroma_subblock_size_x,
+                chroma_grain_stride, cb_col_buf, 2 >> chroma_subsamp_x,
+                2 >> chroma_subsamp_x,
+                AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
+                       (height - (y << 1)) >> chroma_subsamp_y));
+
+      copy_area(cr_grain_block + chroma_offset_y * chroma_grain_stride +
+                    chroma_offset_x + chroma_subblock_size_x,
+                chroma_grain_stride, cr_col_buf, 2 >> chroma_subsamp_x,
+                2 >> chroma_subsamp_x,
+                AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
+                       (height - (y << 1)) >> chroma_subsamp_y));
+    }
+  }
+}
+
+static void add_grain_to_rows(GrainRowsJob *job) {
+  const int step = luma_subblock_size_y >> 1;
+
+  // The line buffers carry the grain of the block row above into the overlap
+  // with the current one, so rebuild them when starting mid-frame.
+  if (job->info->params->overlap_flag && job->start_y > 0)
+    add_grain_to_block_row(job, job->start_y - step, 0);
+
+  for (int y = job->start_y; y < job->end_y; y += step) {
+    if (job->info->src) copy_block_row(job->info, y);
+    add_grain_to_block_row(job, y, 1);
+  }
+}
+
+static int grain_rows_worker_hook(void *arg1, void *unused) {
+  (void)unused;
+  add_grain_to_rows((GrainRowsJob *)arg1);
+  return 1;
+}
+
+static int add_film_grain_run(const aom_film_grain_t *params,
+                              const aom_image_t *src, uint8_t *luma,
+                              uint8_t *cb, uint8_t *cr, int height, int width,
+                              int luma_stride, int chroma_stride,
+                              int use_high_bit_depth, int chroma_subsamp_y,
+                              int chroma_subsamp_x, int mc_identity,
+                              AVxWorker *workers, int num_workers) {
+  int **pred_pos_luma;
+  int **pred_pos_chroma;
+  GrainFrameInfo info;
+
+  uint16_t random_register = params->random_seed;
+
+  int left_pad = 3;
+  int right_pad = 3;  // padding to offset for AR coefficients
+  int top_pad = 3;
+  int bottom_pad = 0;
+
+  int ar_padding = 3;  // maximum lag used for stabilization of AR coefficients
+
+  int chroma_subblock_size_y = luma_subblock_size_y >> chroma_subsamp_y;
+  int chroma_subblock_size_x = luma_subblock_size_x >> chroma_subsamp_x;
+
+  // Initial padding is only needed for generation of
+  // film grain templates (to stabilize the AR process)
+  // Only a 64x64 luma and 32x32 chroma part of a template
+  // is used later for adding grain, padding can be discarded
+
+  int luma_block_size_y =
+      top_pad + 2 * ar_padding + luma_subblock_size_y * 2 + bottom_pad;
+  int luma_block_size_x = left_pad + 2 * ar_padding + luma_subblock_size_x * 2 +
+                          2 * ar_padding + right_pad;
+
+  int chroma_block_size_y = top_pad + (2 >> chroma_subsamp_y) * ar_padding +
+                            chroma_subblock_size_y * 2 + bottom_pad;
+  int chroma_block_size_x = left_pad + (2 >> chroma_subsamp_x) * ar_padding +
+                            chroma_subblock_size_x * 2 +
+                            (2 >> chroma_subsamp_x) * ar_padding + right_pad;
+
+  int luma_grain_stride = luma_block_size_x;
+  int chroma_grain_stride = chroma_block_size_x;
+
+  int bit_depth = params->bit_depth;
+  // Bit depth of the samples the grain is added to.
+  int sample_bit_depth = use_high_bit_depth ? bit_depth : 8;
+
+  const int grain_center = 128 << (bit_depth - 8);
+  int grain_min = 0 - grain_center;
+  int grain_max = grain_center - 1;
+
+  if (!init_arrays(params, &pred_pos_luma, &pred_pos_chroma, &info,
+                   luma_block_size_y * luma_block_size_x,
+                   chroma_block_size_y * chroma_block_size_x,
+                   256 << (sample_bit_depth - 8)))
+    return -1;
+
+  generate_luma_grain_block(params, pred_pos_luma, info.luma_grain_block,
+                            luma_block_size_y, luma_block_size_x,
+                            luma_grain_stride, left_pad, top_pad, right_pad,
+                            bottom_pad, &random_register, grain_min,
+                            grain_max);
+
+  if (!generate_chroma_grain_blocks(
+          params, pred_pos_chroma, info.luma_grain_block, info.cb_grain_block,
+          info.cr_grain_block, luma_grain_stride, chroma_block_size_y,
+          chroma_block_size_x, chroma_grain_stride, left_pad, top_pad,
+          right_pad, bottom_pad, chroma_subsamp_y, chroma_subsamp_x,
+          &random_register, grain_min, grain_max)) {
+    dealloc_arrays(params, &pred_pos_luma, &pred_pos_chroma, &info);
+    return -1;
+  }
+
+  int scaling_lut_y[256] = { 0 };
+  int scaling_lut_cb[256] = { 0 };
+  int scaling_lut_cr[256] = { 0 };
+
+  init_scaling_function(params->scaling_points_y, params->num_y_points,
+                        scaling_lut_y);
+
+  if (params->chroma_scaling_from_luma) {
+    memcpy(scaling_lut_cb, scaling_lut_y, sizeof(*scaling_lut_y) * 256);
+    memcpy(scaling_lut_cr, scaling_lut_y, sizeof(*scaling_lut_y) * 256);
+  } else {
+    init_scaling_function(params->scaling_points_cb, params->num_cb_points,
+                          scaling_lut_cb);
+    init_scaling_function(params->scaling_points_cr, params->num_cr_points,
+                          scaling_lut_cr);
+  }
+  expand_scaling_lut(scaling_lut_y, sample_bit_depth, info.scaling_lut_y);
+  expand_scaling_lut(scaling_lut_cb, sample_bit_depth, info.scaling_lut_cb);
+  expand_scaling_lut(scaling_lut_cr, sample_bit_depth, info.scaling_lut_cr);
+
+  info.params = params;
+  info.src = src;
+  info.luma = luma;
+  info.cb = cb;
+  info.cr = cr;
+  info.height = height;
+  info.width = width;
+  info.luma_stride = luma_stride;
+  info.chroma_stride = chroma_stride;
+  info.use_high_bit_depth = use_high_bit_depth;
+  info.chroma_subsamp_y = chroma_subsamp_y;
+  info.chroma_subsamp_x = chroma_subsamp_x;
+  info.chroma_subblock_size_y = chroma_subblock_size_y;
+  info.chroma_subblock_size_x = chroma_subblock_size_x;
+  info.luma_grain_stride = luma_grain_stride;
+  info.chroma_grain_stride = chroma_grain_stride;
+  info.luma_grain_offset = left_pad + 2 * ar_padding;
+  info.chroma_grain_offset_y = top_pad + (2 >> chroma_subsamp_y) * ar_padding;
+  info.chroma_grain_offset_x = left_pad + (2 >> chroma_subsamp_x) * ar_padding;
+  info.grain_min = grain_min;
+  info.grain_max = grain_max;
+
+  info.apply_y = params->num_y_points > 0 ? 1 : 0;
+  info.apply_cb =
+      (params->num_cb_points > 0 || params->chroma_scaling_from_luma) ? 1 : 0;
+  info.apply_cr =
+      (params->num_cr_points > 0 || params->chroma_scaling_from_luma) ? 1 : 0;
+
+  if (params->chroma_scaling_from_luma) {
+    info.cb_mult = 0;        // fixed scale
+    info.cb_luma_mult = 64;  // fixed scale
+    info.cb_offset = 0;
+
+    info.cr_mult = 0;        // fixed scale
+    info.cr_luma_mult = 64;  // fixed scale
+    info.cr_offset = 0;
+  } else {
+    info.cb_mult = params->cb_mult - 128;            // fixed scale
+    info.cb_luma_mult = params->cb_luma_mult - 128;  // fixed scale
+    // offset value depends on the bit depth
+    info.cb_offset = (params->cb_offset << (sample_bit_depth - 8)) -
+                     (1 << sample_bit_depth);
+
+    info.cr_mult = params->cr_mult - 128;            // fixed scale
+    info.cr_luma_mult = params->cr_luma_mult - 128;  // fixed scale
+    // offset value depends on the bit depth
+    info.cr_offset = (params->cr_offset << (sample_bit_depth - 8)) -
+                     (1 << sample_bit_depth);
+  }
+
+  if (params->clip_to_restricted_range) {
+    info.min_luma = min_luma_legal_range << (sample_bit_depth - 8);
+    info.max_luma = max_luma_legal_range << (sample_bit_depth - 8);
+
+    if (mc_identity) {
+      info.min_chroma = min_luma_legal_range << (sample_bit_depth - 8);
+      info.max_chroma = max_luma_legal_range << (sample_bit_depth - 8);
+    } else {
+      info.min_chroma = min_chroma_legal_range << (sample_bit_depth - 8);
+      info.max_chroma = max_chroma_legal_range << (sample_bit_depth - 8);
+    }
+  } else {
+    info.min_luma = info.min_chroma = 0;
+    info.max_luma = info.max_chroma = (256 << (sample_bit_depth - 8)) - 1;
+  }
+
+  // Split the block rows evenly between the workers. The grain of each block
+  // row only depends on its position, so the result does not depend on the
+  // number of workers.
+  const int step = luma_subblock_size_y >> 1;
+  const int num_block_rows = (height / 2 + step - 1) / step;
+  const int max_jobs = AOMMAX(1, AOMMIN(num_workers, num_block_rows));
+  const int rows_per_job = (num_block_rows + max_jobs - 1) / max_jobs;
+  const int num_jobs =
+      AOMMAX(1, (num_block_rows + rows_per_job - 1) / rows_per_job);
+
+  GrainRowsJob *jobs = (GrainRowsJob *)aom_calloc(num_jobs, sizeof(*jobs));
+  if (!jobs) {
+    dealloc_arrays(params, &pred_pos_luma, &pred_pos_chroma, &info);
+    return -1;
+  }
+  int ret = 0;
+  for (int i = 0; i < num_jobs; i++) {
+    GrainRowsJob *const job = &jobs[i];
+    job->info = &info;
+    job->start_y = i * rows_per_job * step;
+    job->end_y = AOMMIN((i + 1) * rows_per_job * step, height / 2);
+    if (!init_job_buffers(job, &info)) {
+      ret = -1;
+      break;
+    }
+  }
+
+  if (ret == 0) {
+    if (num_jobs == 1) {
+      add_grain_to_rows(&jobs[0]);
+    } else {
+      const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+      for (int i = num_jobs - 1; i >= 0; i--) {
+        AVxWorker *const worker = &workers[i];
+        worker->hook = grain_rows_worker_hook;
+        worker->data1 = &jobs[i];
+        worker->data2 = NULL;
+        // The first worker runs on the calling thread.
+        if (i == 0)
+          winterface->execute(worker);
+        else
+          winterface->launch(worker);
+      }
+      for (int i = num_jobs - 1; i > 0; i--) winterface->sync(&workers[i]);
+    }
+  }
+
+  for (int i = 0; i < num_jobs; i++) dealloc_job_buffers(&jobs[i]);
+  aom_free(jobs);
+  dealloc_arrays(params, &pred_pos_luma, &pred_pos_chroma, &info);
+  return ret;
+}
+
+int av1_add_film_grain_run(const aom_film_grain_t *params, uint8_t *luma,
+                           uint8_t *cb, uint8_t *cr, int height, int width,
+                           int luma_stride, int chroma_stride,
+                           int use_high_bit_depth, int chroma_subsamp_y,
+                           int chroma_subsamp_x, int mc_identity) {
+  av1_rtcd();
+  return add_film_grain_run(params, NULL, luma, cb, cr, height, width,
+                            luma_stride, chroma_stride, use_high_bit_depth,
+                            chroma_subsamp_y, chroma_subsamp_x, mc_identity,
+                            NULL, 0);
+}
+
+int av1_add_film_grain_mt(const aom_film_grain_t *params,
+                          const aom_image_t *src, aom_image_t *dst,
+                          AVxWorker *workers, int num_workers) {
   uint8_t *luma, *cb, *cr;
   int height, width, luma_stride, chroma_stride;
   int use_high_bit_depth = 0;
@@ -1043,23 +1587,13 @@ int av1_add_film_grain(const aom_film_grain_t *params, const aom_image_t *src,
   width = src->d_w % 2 ? src->d_w + 1 : src->d_w;
   height = src->d_h % 2 ? src->d_h + 1 : src->d_h;
 
-  copy_rect(src->planes[AOM_PLANE_Y], src->stride[AOM_PLANE_Y],
-            dst->planes[AOM_PLANE_Y], dst->stride[AOM_PLANE_Y], src->d_w,
-            src->d_h, use_high_bit_depth);
-  // Note that dst is already assumed to be aligned to even.
-  extend_even(dst->planes[AOM_PLANE_Y], dst->stride[AOM_PLANE_Y], src->d_w,
-              src->d_h, use_high_bit_depth);
-
-  if (!src->monochrome) {
-    copy_rect(src->planes[AOM_PLANE_U], src->stride[AOM_PLANE_U],
-              dst->planes[AOM_PLANE_U], dst->stride[AOM_PLANE_U],
-              width >> chroma_subsamp_x, height >> chroma_subsamp_y,
-              use_high_bit_depth);
-
-    copy_rect(src->planes[AOM_PLANE_V], src->stride[AOM_PLANE_V],
-              dst->planes[AOM_PLANE_V], dst->stride[AOM_PLANE_V],
-              width >> chroma_subsamp_x, height >> chroma_subsamp_y,
-              use_high_bit_depth);
+  // The block rows are copied from src by the jobs that add grain to them,
+  // unless the grain is added in place.
+  const int in_place = src->planes[AOM_PLANE_Y] == dst->planes[AOM_PLANE_Y];
+  if (in_place) {
+    // Note that dst is already assumed to be aligned to even.
+    extend_even(dst->planes[AOM_PLANE_Y], dst->stride[AOM_PLANE_Y], src->d_w,
+                src->d_h, use_high_bit_depth);
   }
 
   luma = dst->planes[AOM_PLANE_Y];
@@ -1070,392 +1604,15 @@ int av1_add_film_grain(const aom_film_grain_t *params, const aom_image_t *src,
   luma_stride = dst->stride[AOM_PLANE_Y] >> use_high_bit_depth;
   chroma_stride = dst->stride[AOM_PLANE_U] >> use_high_bit_depth;
 
-  return av1_add_film_grain_run(
-      params, luma, cb, cr, height, width, luma_stride, chroma_stride,
-      use_high_bit_depth, chroma_subsamp_y, chroma_subsamp_x, mc_identity);
+  av1_rtcd();
+  return add_film_grain_run(params, in_place ? NULL : src, luma, cb, cr, height,
+                            width, luma_stride, chroma_stride,
+                            use_high_bit_depth, chroma_subsamp_y,
+                            chroma_subsamp_x, mc_identity, workers,
+                            num_workers);
 }
 
-int av1_add_film_grain_run(const aom_film_grain_t *params, uint8_t *luma,
-                           uint8_t *cb, uint8_t *cr, int height, int width,
-                           int luma_stride, int chroma_stride,
-                           int use_high_bit_depth, int chroma_subsamp_y,
-                           int chroma_subsamp_x, int mc_identity) {
-  int **pred_pos_luma;
-  int **pred_pos_chroma;
-  int *luma_grain_block;
-  int *cb_grain_block;
-  int *cr_grain_block;
-
-  int *y_line_buf;
-  int *cb_line_buf;
-  int *cr_line_buf;
-
-  int *y_col_buf;
-  int *cb_col_buf;
-  int *cr_col_buf;
-
-  random_register = params->random_seed;
-
-  int left_pad = 3;
-  int right_pad = 3;  // padding to offset for AR coefficients
-  int top_pad = 3;
-  int bottom_pad = 0;
-
-  int ar_padding = 3;  // maximum lag used for stabilization of AR coefficients
-
-  luma_subblock_size_y = 32;
-  luma_subblock_size_x = 32;
-
-  chroma_subblock_size_y = luma_subblock_size_y >> chroma_subsamp_y;
-  chroma_subblock_size_x = luma_subblock_size_x >> chroma_subsamp_x;
-
-  // Initial padding is only needed for generation of
-  // film grain templates (to stabilize the AR process)
-  // Only a 64x64 luma and 32x32 chroma part of a template
-  // is used later for adding grain, padding can be discarded
-
-  int luma_block_size_y =
-      top_pad + 2 * ar_padding + luma_subblock_size_y * 2 + bottom_pad;
-  int luma_block_size_x = left_pad + 2 * ar_padding + luma_subblock_size_x * 2 +
-                          2 * ar_padding + right_pad;
-
-  int chroma_block_size_y = top_pad + (2 >> chroma_subsamp_y) * ar_padding +
-                            chroma_subblock_size_y * 2 + bottom_pad;
-  int chroma_block_size_x = left_pad + (2 >> chroma_subsamp_x) * ar_padding +
-                            chroma_subblock_size_x * 2 +
-                            (2 >> chroma_subsamp_x) * ar_padding + right_pad;
-
-  int luma_grain_stride = luma_block_size_x;
-  int chroma_grain_stride = chroma_block_size_x;
-
-  int overlap = params->overlap_flag;
-  int bit_depth = params->bit_depth;
-
-  const int grain_center = 128 << (bit_depth - 8);
-  grain_min = 0 - grain_center;
-  grain_max = grain_center - 1;
-
-  if (!init_arrays(params, luma_stride, chroma_stride, &pred_pos_luma,
-                   &pred_pos_chroma, &luma_grain_block, &cb_grain_block,
-                   &cr_grain_block, &y_line_buf, &cb_line_buf, &cr_line_buf,
-                   &y_col_buf, &cb_col_buf, &cr_col_buf,
-                   luma_block_size_y * luma_block_size_x,
-                   chroma_block_size_y * chroma_block_size_x, chroma_subsamp_y,
-                   chroma_subsamp_x))
-    return -1;
-
-  generate_luma_grain_block(params, pred_pos_luma, luma_grain_block,
-                            luma_block_size_y, luma_block_size_x,
-                            luma_grain_stride, left_pad, top_pad, right_pad,
-                            bottom_pad);
-
-  if (!generate_chroma_grain_blocks(
-          params, pred_pos_chroma, luma_grain_block, cb_grain_block,
-          cr_grain_block, luma_grain_stride, chroma_block_size_y,
-          chroma_block_size_x, chroma_grain_stride, left_pad, top_pad,
-          right_pad, bottom_pad, chroma_subsamp_y, chroma_subsamp_x))
-    return -1;
-
-  init_scaling_function(params->scaling_points_y, params->num_y_points,
-                        scaling_lut_y);
-
-  if (params->chroma_scaling_from_luma) {
-    memcpy(scaling_lut_cb, scaling_lut_y, sizeof(*scaling_lut_y) * 256);
-    memcpy(scaling_lut_cr, scaling_lut_y, sizeof(*scaling_lut_y) * 256);
-  } else {
-    init_scaling_function(params->scaling_points_cb, params->num_cb_points,
-                          scaling_lut_cb);
-    init_scaling_function(params->scaling_points_cr, params->num_cr_points,
-                          scaling_lut_cr);
-  }
-  for (int y = 0; y < height / 2; y += (luma_subblock_size_y >> 1)) {
-    init_random_generator(y * 2, params->random_seed);
-
-    for (int x = 0; x < width / 2; x += (luma_subblock_size_x >> 1)) {
-      int offset_y = get_random_number(8);
-      int offset_x = (offset_y >> 4) & 15;
-      offset_y &= 15;
-
-      int luma_offset_y = left_pad + 2 * ar_padding + (offset_y << 1);
-      int luma_offset_x = top_pad + 2 * ar_padding + (offset_x << 1);
-
-      int chroma_offset_y = top_pad + (2 >> chroma_subsamp_y) * ar_padding +
-                            offset_y * (2 >> chroma_subsamp_y);
-      int chroma_offset_x = left_pad + (2 >> chroma_subsamp_x) * ar_padding +
-                            offset_x * (2 >> chroma_subsamp_x);
-
-      if (overlap && x) {
-        ver_boundary_overlap(
-            y_col_buf, 2,
-            luma_grain_block + luma_offset_y * luma_grain_stride +
-                luma_offset_x,
-            luma_grain_stride, y_col_buf, 2, 2,
-            AOMMIN(luma_subblock_size_y + 2, height - (y << 1)));
-
-        ver_boundary_overlap(
-            cb_col_buf, 2 >> chroma_subsamp_x,
-            cb_grain_block + chroma_offset_y * chroma_grain_stride +
-                chroma_offset_x,
-            chroma_grain_stride, cb_col_buf, 2 >> chroma_subsamp_x,
-            2 >> chroma_subsamp_x,
-            AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
-                   (height - (y << 1)) >> chroma_subsamp_y));
-
-        ver_boundary_overlap(
-            cr_col_buf, 2 >> chroma_subsamp_x,
-            cr_grain_block + chroma_offset_y * chroma_grain_stride +
-                chroma_offset_x,
-            chroma_grain_stride, cr_col_buf, 2 >> chroma_subsamp_x,
-            2 >> chroma_subsamp_x,
-            AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
-                   (height - (y << 1)) >> chroma_subsamp_y));
-
-        int i = y ? 1 : 0;
-
-        if (use_high_bit_depth) {
-          add_noise_to_block_hbd(
-              params,
-              (uint16_t *)luma + ((y + i) << 1) * luma_stride + (x << 1),
-              (uint16_t *)cb +
-                  ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                  (x << (1 - chroma_subsamp_x)),
-              (uint16_t *)cr +
-                  ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                  (x << (1 - chroma_subsamp_x)),
-              luma_stride, chroma_stride, y_col_buf + i * 4,
-              cb_col_buf + i * (2 - chroma_subsamp_y) * (2 - chroma_subsamp_x),
-              cr_col_buf + i * (2 - chroma_subsamp_y) * (2 - chroma_subsamp_x),
-              2, (2 - chroma_subsamp_x),
-              AOMMIN(luma_subblock_size_y >> 1, height / 2 - y) - i, 1,
-              bit_depth, chroma_subsamp_y, chroma_subsamp_x, mc_identity);
-        } else {
-          add_noise_to_block(
-              params, luma + ((y + i) << 1) * luma_stride + (x << 1),
-              cb + ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                  (x << (1 - chroma_subsamp_x)),
-              cr + ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                  (x << (1 - chroma_subsamp_x)),
-              luma_stride, chroma_stride, y_col_buf + i * 4,
-              cb_col_buf + i * (2 - chroma_subsamp_y) * (2 - chroma_subsamp_x),
-              cr_col_buf + i * (2 - chroma_subsamp_y) * (2 - chroma_subsamp_x),
-              2, (2 - chroma_subsamp_x),
-              AOMMIN(luma_subblock_size_y >> 1, height / 2 - y) - i, 1,
-              bit_depth, chroma_subsamp_y, chroma_subsamp_x, mc_identity);
-        }
-      }
-
-      if (overlap && y) {
-        if (x) {
-          hor_boundary_overlap(y_line_buf + (x << 1), luma_stride, y_col_buf, 2,
-                               y_line_buf + (x << 1), luma_stride, 2, 2);
-
-          hor_boundary_overlap(cb_line_buf + x * (2 >> chroma_subsamp_x),
-                               chroma_stride, cb_col_buf, 2 >> chroma_subsamp_x,
-                               cb_line_buf + x * (2 >> chroma_subsamp_x),
-                               chroma_stride, 2 >> chroma_subsamp_x,
-                               2 >> chroma_subsamp_y);
-
-          hor_boundary_overlap(cr_line_buf + x * (2 >> chroma_subsamp_x),
-                               chroma_stride, cr_col_buf, 2 >> chroma_subsamp_x,
-                               cr_line_buf + x * (2 >> chroma_subsamp_x),
-                               chroma_stride, 2 >> chroma_subsamp_x,
-                               2 >> chroma_subsamp_y);
-        }
-
-        hor_boundary_overlap(
-            y_line_buf + ((x ? x + 1 : 0) << 1), luma_stride,
-            luma_grain_block + luma_offset_y * luma_grain_stride +
-                luma_offset_x + (x ? 2 : 0),
-            luma_grain_stride, y_line_buf + ((x ? x + 1 : 0) << 1), luma_stride,
-            AOMMIN(luma_subblock_size_x - ((x ? 1 : 0) << 1),
-                   width - ((x ? x + 1 : 0) << 1)),
-            2);
-
-        hor_boundary_overlap(
-            cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
-            chroma_stride,
-            cb_grain_block + chroma_offset_y * chroma_grain_stride +
-                chroma_offset_x + ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
-            chroma_grain_stride,
-            cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
-            chroma_stride,
-            AOMMIN(chroma_subblock_size_x -
-                       ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
-                   (width - ((x ? x + 1 : 0) << 1)) >> chroma_subsamp_x),
-            2 >> chroma_subsamp_y);
-
-        hor_boundary_overlap(
-            cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
-            chroma_stride,
-            cr_grain_block + chroma_offset_y * chroma_grain_stride +
-                chroma_offset_x + ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
-            chroma_grain_stride,
-            cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
-            chroma_stride,
-            AOMMIN(chroma_subblock_size_x -
-                       ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
-                   (width - ((x ? x + 1 : 0) << 1)) >> chroma_subsamp_x),
-            2 >> chroma_subsamp_y);
-
-        if (use_high_bit_depth) {
-          add_noise_to_block_hbd(
-              params, (uint16_t *)luma + (y << 1) * luma_stride + (x << 1),
-              (uint16_t *)cb + (y << (1 - chroma_subsamp_y)) * chroma_stride +
-                  (x << ((1 - chroma_subsamp_x))),
-              (uint16_t *)cr + (y << (1 - chroma_subsamp_y)) * chroma_stride +
-                  (x << ((1 - chroma_subsamp_x))),
-              luma_stride, chroma_stride, y_line_buf + (x << 1),
-              cb_line_buf + (x << (1 - chroma_subsamp_x)),
-              cr_line_buf + (x << (1 - chroma_subsamp_x)), luma_stride,
-              chroma_stride, 1,
-              AOMMIN(luma_subblock_size_x >> 1, width / 2 - x), bit_depth,
-              chroma_subsamp_y, chroma_subsamp_x, mc_identity);
-        } else {
-          add_noise_to_block(
-              params, luma + (y << 1) * luma_stride + (x << 1),
-              cb + (y << (1 - chroma_subsamp_y)) * chroma_stride +
-                  (x << ((1 - chroma_subsamp_x))),
-              cr + (y << (1 - chroma_subsamp_y)) * chroma_stride +
-                  (x << ((1 - chroma_subsamp_x))),
-              luma_stride, chroma_stride, y_line_buf + (x << 1),
-              cb_line_buf + (x << (1 - chroma_subsamp_x)),
-              cr_line_buf + (x << (1 - chroma_subsamp_x)), luma_stride,
-              chroma_stride, 1,
-              AOMMIN(luma_subblock_size_x >> 1, width / 2 - x), bit_depth,
-              chroma_subsamp_y, chroma_subsamp_x, mc_identity);
-        }
-      }
-
-      int i = overlap && y ? 1 : 0;
-      int j = overlap && x ? 1 : 0;
-
-      if (use_high_bit_depth) {
-        add_noise_to_block_hbd(
-            params,
-            (uint16_t *)luma + ((y + i) << 1) * luma_stride + ((x + j) << 1),
-            (uint16_t *)cb +
-                ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                ((x + j) << (1 - chroma_subsamp_x)),
-            (uint16_t *)cr +
-                ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                ((x + j) << (1 - chroma_subsamp_x)),
-            luma_stride, chroma_stride,
-            luma_grain_block + (luma_offset_y + (i << 1)) * luma_grain_stride +
-                luma_offset_x + (j << 1),
-            cb_grain_block +
-                (chroma_offset_y + (i << (1 - chroma_subsamp_y))) *
-                    chroma_grain_stride +
-                chroma_offset_x + (j << (1 - chroma_subsamp_x)),
-            cr_grain_block +
-                (chroma_offset_y + (i << (1 - chroma_subsamp_y))) *
-                    chroma_grain_stride +
-                chroma_offset_x + (j << (1 - chroma_subsamp_x)),
-            luma_grain_stride, chroma_grain_stride,
-            AOMMIN(luma_subblock_size_y >> 1, height / 2 - y) - i,
-            AOMMIN(luma_subblock_size_x >> 1, width / 2 - x) - j, bit_depth,
-            chroma_subsamp_y, chroma_subsamp_x, mc_identity);
-      } else {
-        add_noise_to_block(
-            params, luma + ((y + i) << 1) * luma_stride + ((x + j) << 1),
-            cb + ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                ((x + j) << (1 - chroma_subsamp_x)),
-            cr + ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                ((x + j) << (1 - chroma_subsamp_x)),
-            luma_stride, chroma_stride,
-            luma_grain_block + (luma_offset_y + (i << 1)) * luma_grain_stride +
-                luma_offset_x + (j << 1),
-            cb_grain_block +
-                (chroma_offset_y + (i << (1 - chroma_subsamp_y))) *
-                    chroma_grain_stride +
-                chroma_offset_x + (j << (1 - chroma_subsamp_x)),
-            cr_grain_block +
-                (chroma_offset_y + (i << (1 - chroma_subsamp_y))) *
-                    chroma_grain_stride +
-                chroma_offset_x + (j << (1 - chroma_subsamp_x)),
-            luma_grain_stride, chroma_grain_stride,
-            AOMMIN(luma_subblock_size_y >> 1, height / 2 - y) - i,
-            AOMMIN(luma_subblock_size_x >> 1, width / 2 - x) - j, bit_depth,
-            chroma_subsamp_y, chroma_subsamp_x, mc_identity);
-      }
-
-      if (overlap) {
-        if (x) {
-          // Copy overlapped column bufer to line buffer
-          copy_area(y_col_buf + (luma_subblock_size_y << 1), 2,
-                    y_line_buf + (x << 1), luma_stride, 2, 2);
-
-          copy_area(
-              cb_col_buf + (chroma_subblock_size_y << (1 - chroma_subsamp_x)),
-              2 >> chroma_subsamp_x,
-              cb_line_buf + (x << (1 - chroma_subsamp_x)), chroma_stride,
-              2 >> chroma_subsamp_x, 2 >> chroma_subsamp_y);
-
-          copy_area(
-              cr_col_buf + (chroma_subblock_size_y << (1 - chroma_subsamp_x)),
-              2 >> chroma_subsamp_x,
-              cr_line_buf + (x << (1 - chroma_subsamp_x)), chroma_stride,
-              2 >> chroma_subsamp_x, 2 >> chroma_subsamp_y);
-        }
-
-        // Copy grain to the line buffer for overlap with a bottom block
-        copy_area(
-            luma_grain_block +
-                (luma_offset_y + luma_subblock_size_y) * luma_grain_stride +
-                luma_offset_x + ((x ? 2 : 0)),
-            luma_grain_stride, y_line_buf + ((x ? x + 1 : 0) << 1), luma_stride,
-            AOMMIN(luma_subblock_size_x, width - (x << 1)) - (x ? 2 : 0), 2);
-
-        copy_area(cb_grain_block +
-                      (chroma_offset_y + chroma_subblock_size_y) *
-                          chroma_grain_stride +
-                      chroma_offset_x + (x ? 2 >> chroma_subsamp_x : 0),
-                  chroma_grain_stride,
-                  cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
-                  chroma_stride,
-                  AOMMIN(chroma_subblock_size_x,
-                         ((width - (x << 1)) >> chroma_subsamp_x)) -
-                      (x ? 2 >> chroma_subsamp_x : 0),
-                  2 >> chroma_subsamp_y);
-
-        copy_area(cr_grain_block +
-                      (chroma_offset_y + chroma_subblock_size_y) *
-                          chroma_grain_stride +
-                      chroma_offset_x + (x ? 2 >> chroma_subsamp_x : 0),
-                  chroma_grain_stride,
-                  cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
-                  chroma_stride,
-                  AOMMIN(chroma_subblock_size_x,
-                         ((width - (x << 1)) >> chroma_subsamp_x)) -
-                      (x ? 2 >> chroma_subsamp_x : 0),
-                  2 >> chroma_subsamp_y);
-
-        // Copy grain to the column buffer for overlap with the next block to
-        // the right
-
-        copy_area(luma_grain_block + luma_offset_y * luma_grain_stride +
-                      luma_offset_x + luma_subblock_size_x,
-                  luma_grain_stride, y_col_buf, 2, 2,
-                  AOMMIN(luma_subblock_size_y + 2, height - (y << 1)));
-
-        copy_area(cb_grain_block + chroma_offset_y * chroma_grain_stride +
-                      chroma_offset_x + chroma_subblock_size_x,
-                  chroma_grain_stride, cb_col_buf, 2 >> chroma_subsamp_x,
-                  2 >> chroma_subsamp_x,
-                  AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
-                         (height - (y << 1)) >> chroma_subsamp_y));
-
-        copy_area(cr_grain_block + chroma_offset_y * chroma_grain_stride +
-                      chroma_offset_x + chroma_subblock_size_x,
-                  chroma_grain_stride, cr_col_buf, 2 >> chroma_subsamp_x,
-                  2 >> chroma_subsamp_x,
-                  AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
-                         (height - (y << 1)) >> chroma_subsamp_y));
-      }
-    }
-  }
-
-  dealloc_arrays(params, &pred_pos_luma, &pred_pos_chroma, &luma_grain_block,
-                 &cb_grain_block, &cr_grain_block, &y_line_buf, &cb_line_buf,
-                 &cr_line_buf, &y_col_buf, &cb_col_buf, &cr_col_buf);
-  return 0;
+int av1_add_film_grain(const aom_film_grain_t *params, const aom_image_t *src,
+                       aom_image_t *dst) {
+  return av1_add_film_grain_mt(params, src, dst, NULL, 0);
 }
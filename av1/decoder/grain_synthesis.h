@@ -24,6 +24,7 @@ extern "C" {
 
 #include "aom_dsp/grain_params.h"
 #include "aom/aom_image.h"
+#include "aom_util/aom_thread.h"
 
 /*!\brief Add film grain
  *
@@ -59,6 +60,24 @@ int av1_add_film_grain_run(const aom_film_grain_t *grain_params, uint8_t *luma,
 int av1_add_film_grain(const aom_film_grain_t *grain_params,
                        const aom_image_t *src, aom_image_t *dst);
 
+/*!\brief Add film grain using several workers
+ *
+ * Add film grain to an image, splitting the rows between the workers. The
+ * first worker runs on the calling thread. The result is the same as with
+ * av1_add_film_grain().
+ *
+ * Returns 0 for success, -1 for failure
+ *
+ * \param[in]    grain_params     Grain parameters
+ * \param[in]    src              Source image
+ * \param[out]   dst              Resulting image with grain
+ * \param[in]    workers          Idle workers, may be NULL if num_workers is 0
+ * \param[in]    num_workers      Number of workers
+ */
+int av1_add_film_grain_mt(const aom_film_grain_t *grain_params,
+                          const aom_image_t *src, aom_image_t *dst,
+                          AVxWorker *workers, int num_workers);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
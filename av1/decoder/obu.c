@@ -16,10 +16,13 @@
 
 #include "aom/aom_codec.h"
 #include "aom_dsp/bitreader_buffer.h"
+#include "aom_mem/aom_mem.h"
 #include "aom_ports/mem_ops.h"
 
+#include "av1/av1_iface_common.h"
 #include "av1/common/common.h"
 #include "av1/common/obu_util.h"
+#include "av1/common/resize.h"
 #include "av1/common/timing.h"
 #include "av1/decoder/decoder.h"
 #include "av1/decoder/decodeframe.h"
@@ -341,6 +344,20 @@ static int32_t read_tile_group_header(AV1Decoder *pbi,
   return ((rb->bit_offset - saved_bit_offset + 7) >> 3);
 }
 
+// Passes the tile group that was just decoded to the tile group callback.
+static void report_decoded_tile_group(AV1Decoder *pbi, int start_tile,
+                                      int end_tile) {
+  const AV1_COMMON *const cm = &pbi->common;
+  aom_image_t img;
+  yuvconfig2image(&img, &cm->cur_frame->buf, NULL);
+  aom_tile_group_info_t info;
+  info.start_tile = start_tile;
+  info.end_tile = end_tile;
+  info.num_tiles = cm->tiles.rows * cm->tiles.cols;
+  info.img = &img;
+  pbi->tile_group_cb.cb(pbi->tile_group_cb.priv, &info);
+}
+
 // On success, returns the tile group OBU size. On failure, sets
 // pbi->common.error.error_code and returns 0.
 static uint32_t read_one_tile_group_obu(
@@ -358,12 +375,40 @@ static uint32_t read_one_tile_group_obu(
                                        tile_start_implicit);
   if (header_size == -1 || byte_alignment(cm, rb)) return 0;
   data += header_size;
-  av1_decode_tg_tiles_and_wrapup(pbi, data, data_end, p_data_end, start_tile,
-                                 end_tile, is_first_tg);
+  *is_last_tg = end_tile == cm->tiles.rows * cm->tiles.cols - 1;
 
-  tg_payload_size = (uint32_t)(*p_data_end - data);
+  if (cm->cur_frame->decode_skipped) {
+    // The decode mode leaves out this frame, so its tiles are not read.
+    *p_data_end = data_end;
+    if (*is_last_tg && cm->show_frame &&
+        !cm->seq_params->order_hint_info.enable_order_hint) {
+      ++cm->current_frame.frame_number;
+    }
+  } else if (pbi->frame_parallel_decode) {
+    // Superres upscaling reallocates the frame buffer, which the following
+    // frames read when parsing their headers. Such frames are decoded here.
+    if (!av1_superres_scaled(cm)) {
+      av1_frameworker_defer_tile_group(pbi, data, data_end, start_tile,
+                                       end_tile, is_first_tg);
+      *p_data_end = data_end;
+    } else {
+      if (is_first_tg) av1_setup_frame_refs_and_context(pbi);
+      av1_decode_tg_tiles_and_wrapup(pbi, data, data_end, p_data_end,
+                                     start_tile, end_tile, is_first_tg);
+    }
+    if (*is_last_tg && cm->show_frame &&
+        !cm->seq_params->order_hint_info.enable_order_hint) {
+      ++cm->current_frame.frame_number;
+    }
+  } else {
+    av1_decode_tg_tiles_and_wrapup(pbi, data, data_end, p_data_end, start_tile,
+                                   end_tile, is_first_tg);
+    if (pbi->tile_group_cb.cb != NULL) {
+      report_decoded_tile_group(pbi, start_tile, end_tile);
+    }
+  }
 
-  *is_last_tg = end_tile == cm->tiles.rows * cm->tiles.cols - 1;
+  tg_payload_size = (uint32_t)(*p_data_end - data);
   return header_size + tg_payload_size;
 }
 
@@ -525,6 +570,16 @@ static uint32_t read_and_decode_one_tile_list(AV1Decoder *pbi,
   tile_list_payload_size += tile_list_info_bytes;
   data += tile_list_info_bytes;
 
+  // With multiple threads, the tiles are decoded together once they are all
+  // read, each one straight into its slot of the output buffer. That needs the
+  // frame to be unfiltered and the output buffer to have its pixel format.
+  const int decode_mt =
+      pbi->max_threads > 1 && cm->tiles.single_tile_decoding &&
+      !(cm->seq_params->use_highbitdepth &&
+        cm->seq_params->bit_depth == AOM_BITS_8);
+  const int output_frame_width_in_tiles =
+      pbi->output_frame_width_in_tiles_minus_1 + 1;
+
   int tile_idx = 0;
   for (i = 0; i <= pbi->tile_count_minus_1; i++) {
     // Process 1 tile.
@@ -540,8 +595,13 @@ static uint32_t read_and_decode_one_tile_list(AV1Decoder *pbi,
       pbi->error.error_code = AOM_CODEC_CORRUPT_FRAME;
       return 0;
     }
-    av1_set_reference_dec(cm, cm->remapped_ref_idx[0], 1,
-                          &pbi->ext_refs.refs[ref_idx]);
+    if (decode_mt) {
+      av1_check_external_reference_dec(cm, cm->remapped_ref_idx[0],
+                                       &pbi->ext_refs.refs[ref_idx]);
+    } else {
+      av1_set_reference_dec(cm, cm->remapped_ref_idx[0], 1,
+                            &pbi->ext_refs.refs[ref_idx]);
+    }
 
     pbi->dec_tile_row = aom_rb_read_literal(rb, 8);
     pbi->dec_tile_col = aom_rb_read_literal(rb, 8);
@@ -559,8 +619,21 @@ static uint32_t read_and_decode_one_tile_list(AV1Decoder *pbi,
       return 0;
     }
 
-    av1_decode_tg_tiles_and_wrapup(pbi, data, data + pbi->coded_tile_data_size,
-                                   p_data_end, start_tile, end_tile, 0);
+    if (decode_mt) {
+      TileListEntryDec *const entry = &pbi->tile_list_entries[i];
+      entry->tile_buffer.data = data;
+      entry->tile_buffer.size = pbi->coded_tile_data_size;
+      entry->ext_ref = &pbi->ext_refs.refs[ref_idx];
+      entry->tile_row = pbi->dec_tile_row;
+      entry->tile_col = pbi->dec_tile_col;
+      entry->output_row = tile_idx / output_frame_width_in_tiles;
+      entry->output_col = tile_idx % output_frame_width_in_tiles;
+      *p_data_end = data + pbi->coded_tile_data_size;
+    } else {
+      av1_decode_tg_tiles_and_wrapup(pbi, data,
+                                     data + pbi->coded_tile_data_size,
+                                     p_data_end, start_tile, end_tile, 0);
+    }
     uint32_t tile_payload_size = (uint32_t)(*p_data_end - data);
 
     tile_list_payload_size += tile_info_bytes + tile_payload_size;
@@ -570,11 +643,15 @@ static uint32_t read_and_decode_one_tile_list(AV1Decoder *pbi,
     assert(data <= data_end);
 
     // Copy the decoded tile to the tile list output buffer.
-    copy_decoded_tile_to_tile_list_buffer(pbi, tile_idx, tile_width_in_pixels,
-                                          tile_height_in_pixels);
+    if (!decode_mt) {
+      copy_decoded_tile_to_tile_list_buffer(pbi, tile_idx, tile_width_in_pixels,
+                                            tile_height_in_pixels);
+    }
     tile_idx++;
   }
 
+  if (decode_mt) av1_decode_tile_list_mt(pbi, data_end, tile_idx);
+
   *frame_decoding_finished = 1;
   return tile_list_payload_size;
 }
@@ -854,6 +931,21 @@ static size_t read_padding(AV1_COMMON *const cm, const uint8_t *data,
   return sz;
 }
 
+// Keeps a copy of the frame header for the later calls that continue the frame
+// in streaming decoding. Returns 0 on success and -1 on allocation failure.
+static int save_frame_header(AV1Decoder *pbi, const uint8_t *frame_header,
+                             size_t size) {
+  if (size > pbi->frame_header_copy_alloc_size) {
+    aom_free(pbi->frame_header_copy);
+    pbi->frame_header_copy_alloc_size = 0;
+    pbi->frame_header_copy = (uint8_t *)aom_malloc(size);
+    if (pbi->frame_header_copy == NULL) return -1;
+    pbi->frame_header_copy_alloc_size = size;
+  }
+  if (size > 0) memcpy(pbi->frame_header_copy, frame_header, size);
+  return 0;
+}
+
 // On success, returns a boolean that indicates whether the decoding of the
 // current frame is finished. On failure, sets pbi->error.error_code and
 // returns -1.
@@ -876,9 +968,17 @@ int aom_decode_frame_from_obus(struct AV1Decoder *pbi, const uint8_t *data,
   uint32_t frame_header_size = 0;
   ObuHeader obu_header;
   memset(&obu_header, 0, sizeof(obu_header));
-  pbi->seen_frame_header = 0;
-  pbi->next_start_tile = 0;
-  pbi->num_tile_groups = 0;
+  if (pbi->frame_in_progress) {
+    // In streaming decoding, continue the frame of the previous call.
+    pbi->frame_in_progress = 0;
+    frame_header = pbi->frame_header_copy;
+    frame_header_size = (uint32_t)pbi->frame_header_size;
+    is_first_tg_obu_received = pbi->num_tile_groups == 0;
+  } else {
+    pbi->seen_frame_header = 0;
+    pbi->next_start_tile = 0;
+    pbi->num_tile_groups = 0;
+  }
 
   if (data_end < data) {
     pbi->error.error_code = AOM_CODEC_CORRUPT_FRAME;
@@ -903,6 +1003,14 @@ int aom_decode_frame_from_obus(struct AV1Decoder *pbi, const uint8_t *data,
       break;
     }
 
+    if (bytes_available == 0 && pbi->streaming_decode &&
+        !cm->tiles.large_scale) {
+      // The rest of the frame comes in a later call.
+      *p_data_end = data;
+      pbi->frame_in_progress = 1;
+      break;
+    }
+
     aom_codec_err_t status =
         aom_read_obu_header_and_size(data, bytes_available, pbi->is_annexb,
                                      &obu_header, &payload_size, &bytes_read);
@@ -979,6 +1087,13 @@ int aom_decode_frame_from_obus(struct AV1Decoder *pbi, const uint8_t *data,
           frame_header_size = read_frame_header_obu(
               pbi, &rb, data, p_data_end, obu_header.type != OBU_FRAME);
           frame_header = data;
+          if (pbi->streaming_decode) {
+            if (save_frame_header(pbi, data, frame_header_size)) {
+              pbi->error.error_code = AOM_CODEC_MEM_ERROR;
+              return -1;
+            }
+            frame_header = pbi->frame_header_copy;
+          }
           pbi->seen_frame_header = 1;
           if (!pbi->ext_tile_debug && cm->tiles.large_scale)
             pbi->camera_frame_header_ready = 1;
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "aom_dsp/aom_dsp_common.h"
+#include "av1/decoder/output_format.h"
+
+// Maximum number of jobs the rows of a frame are split into.
+#define MAX_CONVERT_JOBS 64
+
+typedef struct ConvertRowsJob {
+  const aom_image_t *src;
+  aom_image_t *dst;
+  // Range of chroma rows to convert, with the luma rows they cover.
+  int start_row;
+  int end_row;
+} ConvertRowsJob;
+
+static void convert_rows_lowbd(const aom_image_t *src, aom_image_t *dst,
+                               int start_row, int end_row) {
+  const int luma_w = (int)src->d_w;
+  const int luma_end = AOMMIN(2 * end_row, (int)src->d_h);
+  for (int y = 2 * start_row; y < luma_end; ++y) {
+    memcpy(dst->planes[AOM_PLANE_Y] + y * dst->stride[AOM_PLANE_Y],
+           src->planes[AOM_PLANE_Y] + y * src->stride[AOM_PLANE_Y], luma_w);
+  }
+
+  const int chroma_w = (luma_w + 1) >> 1;
+  for (int y = start_row; y < end_row; ++y) {
+    const uint8_t *const u =
+        src->planes[AOM_PLANE_U] + y * src->stride[AOM_PLANE_U];
+    const uint8_t *const v =
+        src->planes[AOM_PLANE_V] + y * src->stride[AOM_PLANE_V];
+    uint8_t *const uv = dst->planes[AOM_PLANE_U] + y * dst->stride[AOM_PLANE_U];
+    for (int x = 0; x < chroma_w; ++x) {
+      uv[2 * x] = u[x];
+      uv[2 * x + 1] = v[x];
+    }
+  }
+}
+
+static void convert_rows_highbd(const aom_image_t *src, aom_image_t *dst,
+                                int start_row, int end_row) {
+  const int shift = 16 - (int)src->bit_depth;
+  const int luma_w = (int)src->d_w;
+  const int luma_end = AOMMIN(2 * end_row, (int)src->d_h);
+  for (int y = 2 * start_row; y < luma_end; ++y) {
+    const uint16_t *const src_y =
+        (const uint16_t *)(src->planes[AOM_PLANE_Y] +
+                           y * src->stride[AOM_PLANE_Y]);
+    uint16_t *const dst_y =
+        (uint16_t *)(dst->planes[AOM_PLANE_Y] + y * dst->stride[AOM_PLANE_Y]);
+    for (int x = 0; x < luma_w; ++x) dst_y[x] = (uint16_t)(src_y[x] << shift);
+  }
+
+  const int chroma_w = (luma_w + 1) >> 1;
+  for (int y = start_row; y < end_row; ++y) {
+    const uint16_t *const u =
+        (const uint16_t *)(src->planes[AOM_PLANE_U] +
+                           y * src->stride[AOM_PLANE_U]);
+    const uint16_t *const v =
+        (const uint16_t *)(src->planes[AOM_PLANE_V] +
+                           y * src->stride[AOM_PLANE_V]);
+    uint16_t *const uv =
+        (uint16_t *)(dst->planes[AOM_PLANE_U] + y * dst->stride[AOM_PLANE_U]);
+    for (int x = 0; x < chroma_w; ++x) {
+      uv[2 * x] = (uint16_t)(u[x] << shift);
+      uv[2 * x + 1] = (uint16_t)(v[x] << shift);
+    }
+  }
+}
+
+static int convert_rows_worker_hook(void *arg1, void *unused) {
+  (void)unused;
+  const ConvertRowsJob *const job = (const ConvertRowsJob *)arg1;
+  if (job->src->fmt & AOM_IMG_FMT_HIGHBITDEPTH) {
+    convert_rows_highbd(job->src, job->dst, job->start_row, job->end_row);
+  } else {
+    convert_rows_lowbd(job->src, job->dst, job->start_row, job->end_row);
+  }
+  return 1;
+}
+
+aom_img_fmt_t av1_get_semi_planar_format(aom_img_fmt_t fmt) {
+  switch (fmt) {
+    case AOM_IMG_FMT_I420: return AOM_IMG_FMT_NV12;
+    case AOM_IMG_FMT_I42016: return AOM_IMG_FMT_P010;
+    default: return AOM_IMG_FMT_NONE;
+  }
+}
+
+int av1_convert_to_semi_planar_mt(const aom_image_t *src, aom_image_t *dst,
+                                  AVxWorker *workers, int num_workers) {
+  if (av1_get_semi_planar_format(src->fmt) == AOM_IMG_FMT_NONE) return -1;
+  assert(dst->fmt == av1_get_semi_planar_format(src->fmt));
+  assert(dst->d_w >= src->d_w && dst->d_h >= src->d_h);
+
+  dst->bit_depth = src->bit_depth;
+  dst->d_w = src->d_w;
+  dst->d_h = src->d_h;
+  dst->r_w = src->r_w;
+  dst->r_h = src->r_h;
+
+  dst->cp = src->cp;
+  dst->tc = src->tc;
+  dst->mc = src->mc;
+
+  dst->monochrome = src->monochrome;
+  dst->csp = src->csp;
+  dst->range = src->range;
+
+  dst->temporal_id = src->temporal_id;
+  dst->spatial_id = src->spatial_id;
+
+  // Split the chroma rows evenly between the workers.
+  const int num_rows = (int)(src->d_h + 1) >> 1;
+  const int max_jobs =
+      AOMMAX(1, AOMMIN(AOMMIN(num_workers, num_rows), MAX_CONVERT_JOBS));
+  const int rows_per_job = (num_rows + max_jobs - 1) / max_jobs;
+  const int num_jobs = AOMMAX(1, (num_rows + rows_per_job - 1) / rows_per_job);
+
+  ConvertRowsJob jobs[MAX_CONVERT_JOBS];
+  for (int i = 0; i < num_jobs; i++) {
+    jobs[i].src = src;
+    jobs[i].dst = dst;
+    jobs[i].start_row = i * rows_per_job;
+    jobs[i].end_row = AOMMIN((i + 1) * rows_per_job, num_rows);
+  }
+
+  if (num_jobs == 1) {
+    convert_rows_worker_hook(&jobs[0], NULL);
+    return 0;
+  }
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  for (int i = num_jobs - 1; i >= 0; i--) {
+    AVxWorker *const worker = &workers[i];
+    worker->hook = convert_rows_worker_hook;
+    worker->data1 = &jobs[i];
+    worker->data2 = NULL;
+    // The first worker runs on the calling thread.
+    if (i == 0)
+      winterface->execute(worker);
+    else
+      winterface->launch(worker);
+  }
+  for (int i = num_jobs - 1; i > 0; i--) winterface->sync(&workers[i]);
+  return 0;
+}
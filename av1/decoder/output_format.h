@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+/*!\file
+ * \brief Describes the conversion of output frames to semi-planar formats
+ *
+ */
+#ifndef AOM_AV1_DECODER_OUTPUT_FORMAT_H_
+#define AOM_AV1_DECODER_OUTPUT_FORMAT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "aom/aom_image.h"
+#include "aom_util/aom_thread.h"
+
+/*!\brief Get the semi-planar format of an image format
+ *
+ * Returns AOM_IMG_FMT_NV12 for AOM_IMG_FMT_I420, AOM_IMG_FMT_P010 for
+ * AOM_IMG_FMT_I42016, and AOM_IMG_FMT_NONE for the formats that have no
+ * semi-planar counterpart.
+ *
+ * \param[in]    fmt              Planar image format
+ */
+aom_img_fmt_t av1_get_semi_planar_format(aom_img_fmt_t fmt);
+
+/*!\brief Convert an image to its semi-planar format
+ *
+ * Copies the luma plane of src to dst and interleaves the U and V planes of
+ * src into the chroma plane of dst. 16-bit samples are moved to the most
+ * significant bits. The rows are split between the workers, or converted on
+ * the calling thread if num_workers is 0.
+ *
+ * Returns 0 for success, -1 for failure
+ *
+ * \param[in]    src              Source image
+ * \param[out]   dst              Image of format
+ *                                av1_get_semi_planar_format(src->fmt) and of
+ *                                the size of src
+ * \param[in]    workers          Idle workers to use
+ * \param[in]    num_workers      Number of workers
+ */
+int av1_convert_to_semi_planar_mt(const aom_image_t *src, aom_image_t *dst,
+                                  AVxWorker *workers, int num_workers);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // AOM_AV1_DECODER_OUTPUT_FORMAT_H_
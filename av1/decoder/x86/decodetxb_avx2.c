@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <immintrin.h>
+
+#include "config/av1_rtcd.h"
+
+#include "aom_dsp/x86/synonyms.h"
+#include "aom_dsp/x86/synonyms_avx2.h"
+
+void av1_dequant_coeffs_avx2(tran_low_t *coeffs, int n, int dc_q, int ac_q,
+                             int shift, int bd) {
+  const __m256i mask = _mm256_set1_epi32(0xffffff);
+  const __m128i count = _mm_cvtsi32_si128(shift);
+  const __m256i max = _mm256_set1_epi32((1 << (7 + bd)) - 1);
+  const __m256i min = _mm256_set1_epi32(-(1 << (7 + bd)));
+  __m256i dqv =
+      _mm256_setr_epi32(dc_q, ac_q, ac_q, ac_q, ac_q, ac_q, ac_q, ac_q);
+  int i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m256i level = yy_loadu_256(coeffs + i);
+    __m256i dq = _mm256_and_si256(
+        _mm256_mullo_epi32(_mm256_abs_epi32(level), dqv), mask);
+    dq = _mm256_sign_epi32(_mm256_srl_epi32(dq, count), level);
+    yy_storeu_256(coeffs + i,
+                  _mm256_min_epi32(_mm256_max_epi32(dq, min), max));
+    dqv = _mm256_set1_epi32(ac_q);
+  }
+  if (i < n) {
+    av1_dequant_coeffs_sse4_1(coeffs + i, n - i, i ? ac_q : dc_q, ac_q, shift,
+                              bd);
+  }
+}
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <smmintrin.h> /* SSE4.1 */
+
+#include "config/av1_rtcd.h"
+
+#include "aom_dsp/x86/synonyms.h"
+
+void av1_dequant_coeffs_sse4_1(tran_low_t *coeffs, int n, int dc_q, int ac_q,
+                               int shift, int bd) {
+  const __m128i mask = _mm_set1_epi32(0xffffff);
+  const __m128i count = _mm_cvtsi32_si128(shift);
+  const __m128i max = _mm_set1_epi32((1 << (7 + bd)) - 1);
+  const __m128i min = _mm_set1_epi32(-(1 << (7 + bd)));
+  __m128i dqv = _mm_setr_epi32(dc_q, ac_q, ac_q, ac_q);
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m128i level = xx_loadu_128(coeffs + i);
+    // The low 24 bits of the product do not depend on its high bits, so the
+    // 32-bit product is masked like the 64-bit one of the C function.
+    __m128i dq =
+        _mm_and_si128(_mm_mullo_epi32(_mm_abs_epi32(level), dqv), mask);
+    dq = _mm_sign_epi32(_mm_srl_epi32(dq, count), level);
+    xx_storeu_128(coeffs + i, _mm_min_epi32(_mm_max_epi32(dq, min), max));
+    dqv = _mm_set1_epi32(ac_q);
+  }
+  if (i < n) {
+    av1_dequant_coeffs_c(coeffs + i, n - i, i ? ac_q : dc_q, ac_q, shift, bd);
+  }
+}
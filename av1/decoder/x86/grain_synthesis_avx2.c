@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <immintrin.h>
+
+#include "config/av1_rtcd.h"
+
+#include "aom_dsp/x86/synonyms.h"
+#include "aom_dsp/x86/synonyms_avx2.h"
+
+// Returns clamp(pixel + ((scaling * grain + rounding) >> shift), min, max).
+static INLINE __m256i add_scaled_grain(const __m256i pixel,
+                                       const __m256i scaling, const int *grain,
+                                       const __m256i rounding,
+                                       const __m128i shift, const __m256i min,
+                                       const __m256i max) {
+  const __m256i noise = _mm256_sra_epi32(
+      _mm256_add_epi32(_mm256_mullo_epi32(scaling, yy_loadu_256(grain)),
+                       rounding),
+      shift);
+  return _mm256_min_epi32(_mm256_max_epi32(_mm256_add_epi32(pixel, noise), min),
+                          max);
+}
+
+// Returns the index into the chroma scaling function,
+// clamp(((average_luma * luma_mult + chroma * mult) >> 6) + offset, 0, max).
+static INLINE __m256i merge_luma_chroma(const __m256i average_luma,
+                                        const __m256i chroma,
+                                        const __m256i luma_mult,
+                                        const __m256i mult,
+                                        const __m256i offset,
+                                        const __m256i max_index) {
+  const __m256i merged =
+      _mm256_add_epi32(_mm256_mullo_epi32(average_luma, luma_mult),
+                       _mm256_mullo_epi32(chroma, mult));
+  return _mm256_min_epi32(
+      _mm256_max_epi32(
+          _mm256_add_epi32(_mm256_srai_epi32(merged, 6), offset),
+          _mm256_setzero_si256()),
+      max_index);
+}
+
+// Packs 8 32-bit values in [0, 65535] to 16 bits, keeping their order.
+static INLINE __m128i pack_epi32_to_epu16(const __m256i v) {
+  return _mm_packus_epi32(_mm256_castsi256_si128(v),
+                          _mm256_extracti128_si256(v, 1));
+}
+
+void av1_add_luma_grain_avx2(uint8_t *luma, int luma_stride, const int *grain,
+                             int grain_stride, const int *scaling_lut,
+                             int width, int height, int scaling_shift,
+                             int min_val, int max_val) {
+  const __m256i rounding = _mm256_set1_epi32(1 << (scaling_shift - 1));
+  const __m128i shift = _mm_cvtsi32_si128(scaling_shift);
+  const __m256i min = _mm256_set1_epi32(min_val);
+  const __m256i max = _mm256_set1_epi32(max_val);
+  const int width8 = width & ~7;
+
+  for (int i = 0; i < height; i++) {
+    uint8_t *const luma_row = luma + i * luma_stride;
+    const int *const grain_row = grain + i * grain_stride;
+    for (int j = 0; j < width8; j += 8) {
+      const __m256i pixel = _mm256_cvtepu8_epi32(xx_loadl_64(luma_row + j));
+      const __m256i scaling = _mm256_i32gather_epi32(scaling_lut, pixel, 4);
+      const __m256i res = add_scaled_grain(pixel, scaling, grain_row + j,
+                                           rounding, shift, min, max);
+      const __m128i res16 = pack_epi32_to_epu16(res);
+      xx_storel_64(luma_row + j, _mm_packus_epi16(res16, res16));
+    }
+  }
+
+  if (width8 < width) {
+    av1_add_luma_grain_sse4_1(luma + width8, luma_stride, grain + width8,
+                              grain_stride, scaling_lut, width - width8,
+                              height, scaling_shift, min_val, max_val);
+  }
+}
+
+void av1_highbd_add_luma_grain_avx2(uint16_t *luma, int luma_stride,
+                                    const int *grain, int grain_stride,
+                                    const int *scaling_lut, int width,
+                                    int height, int scaling_shift, int min_val,
+                                    int max_val) {
+  const __m256i rounding = _mm256_set1_epi32(1 << (scaling_shift - 1));
+  const __m128i shift = _mm_cvtsi32_si128(scaling_shift);
+  const __m256i min = _mm256_set1_epi32(min_val);
+  const __m256i max = _mm256_set1_epi32(max_val);
+  const int width8 = width & ~7;
+
+  for (int i = 0; i < height; i++) {
+    uint16_t *const luma_row = luma + i * luma_stride;
+    const int *const grain_row = grain + i * grain_stride;
+    for (int j = 0; j < width8; j += 8) {
+      const __m256i pixel = _mm256_cvtepu16_epi32(xx_loadu_128(luma_row + j));
+      const __m256i scaling = _mm256_i32gather_epi32(scaling_lut, pixel, 4);
+      const __m256i res = add_scaled_grain(pixel, scaling, grain_row + j,
+                                           rounding, shift, min, max);
+      xx_storeu_128(luma_row + j, pack_epi32_to_epu16(res));
+    }
+  }
+
+  if (width8 < width) {
+    av1_highbd_add_luma_grain_sse4_1(luma + width8, luma_stride,
+                                     grain + width8, grain_stride, scaling_lut,
+                                     width - width8, height, scaling_shift,
+                                     min_val, max_val);
+  }
+}
+
+void av1_add_chroma_grain_avx2(uint8_t *chroma, int chroma_stride,
+                               const uint8_t *luma, int luma_stride,
+                               const int *grain, int grain_stride,
+                               const int *scaling_lut, int width, int height,
+                               int chroma_subsamp_x, int luma_mult, int mult,
+                               int offset, int scaling_shift, int min_val,
+                               int max_val) {
+  const __m256i rounding = _mm256_set1_epi32(1 << (scaling_shift - 1));
+  const __m128i shift = _mm_cvtsi32_si128(scaling_shift);
+  const __m256i min = _mm256_set1_epi32(min_val);
+  const __m256i max = _mm256_set1_epi32(max_val);
+  const __m256i luma_mult_v = _mm256_set1_epi32(luma_mult);
+  const __m256i mult_v = _mm256_set1_epi32(mult);
+  const __m256i offset_v = _mm256_set1_epi32(offset);
+  const __m256i max_index = _mm256_set1_epi32(255);
+  const __m256i one16 = _mm256_set1_epi16(1);
+  const __m256i one32 = _mm256_set1_epi32(1);
+  const int width8 = width & ~7;
+
+  for (int i = 0; i < height; i++) {
+    uint8_t *const chroma_row = chroma + i * chroma_stride;
+    const uint8_t *const luma_row = luma + i * luma_stride;
+    const int *const grain_row = grain + i * grain_stride;
+    for (int j = 0; j < width8; j += 8) {
+      __m256i average_luma;
+      if (chroma_subsamp_x) {
+        const __m256i pair_sum = _mm256_madd_epi16(
+            _mm256_cvtepu8_epi16(xx_loadu_128(luma_row + (j << 1))), one16);
+        average_luma = _mm256_srai_epi32(_mm256_add_epi32(pair_sum, one32), 1);
+      } else {
+        average_luma = _mm256_cvtepu8_epi32(xx_loadl_64(luma_row + j));
+      }
+      const __m256i pixel = _mm256_cvtepu8_epi32(xx_loadl_64(chroma_row + j));
+      const __m256i index = merge_luma_chroma(average_luma, pixel, luma_mult_v,
+                                              mult_v, offset_v, max_index);
+      const __m256i scaling = _mm256_i32gather_epi32(scaling_lut, index, 4);
+      const __m256i res = add_scaled_grain(pixel, scaling, grain_row + j,
+                                           rounding, shift, min, max);
+      const __m128i res16 = pack_epi32_to_epu16(res);
+      xx_storel_64(chroma_row + j, _mm_packus_epi16(res16, res16));
+    }
+  }
+
+  if (width8 < width) {
+    av1_add_chroma_grain_sse4_1(
+        chroma + width8, chroma_stride, luma + (width8 << chroma_subsamp_x),
+        luma_stride, grain + width8, grain_stride, scaling_lut, width - width8,
+        height, chroma_subsamp_x, luma_mult, mult, offset, scaling_shift,
+        min_val, max_val);
+  }
+}
+
+void av1_highbd_add_chroma_grain_avx2(
+    uint16_t *chroma, int chroma_stride, const uint16_t *luma, int luma_stride,
+    const int *grain, int grain_stride, const int *scaling_lut, int width,
+    int height, int chroma_subsamp_x, int luma_mult, int mult, int offset,
+    int scaling_shift, int min_val, int max_val, int bd) {
+  const __m256i rounding = _mm256_set1_epi32(1 << (scaling_shift - 1));
+  const __m128i shift = _mm_cvtsi32_si128(scaling_shift);
+  const __m256i min = _mm256_set1_epi32(min_val);
+  const __m256i max = _mm256_set1_epi32(max_val);
+  const __m256i luma_mult_v = _mm256_set1_epi32(luma_mult);
+  const __m256i mult_v = _mm256_set1_epi32(mult);
+  const __m256i offset_v = _mm256_set1_epi32(offset);
+  const __m256i max_index = _mm256_set1_epi32((256 << (bd - 8)) - 1);
+  const __m256i one16 = _mm256_set1_epi16(1);
+  const __m256i one32 = _mm256_set1_epi32(1);
+  const int width8 = width & ~7;
+
+  for (int i = 0; i < height; i++) {
+    uint16_t *const chroma_row = chroma + i * chroma_stride;
+    const uint16_t *const luma_row = luma + i * luma_stride;
+    const int *const grain_row = grain + i * grain_stride;
+    for (int j = 0; j < width8; j += 8) {
+      __m256i average_luma;
+      if (chroma_subsamp_x) {
+        // Samples of at most 12 bits do not overflow the signed 16-bit madd.
+        const __m256i pair_sum =
+            _mm256_madd_epi16(yy_loadu_256(luma_row + (j << 1)), one16);
+        average_luma = _mm256_srai_epi32(_mm256_add_epi32(pair_sum, one32), 1);
+      } else {
+        average_luma = _mm256_cvtepu16_epi32(xx_loadu_128(luma_row + j));
+      }
+      const __m256i pixel =
+          _mm256_cvtepu16_epi32(xx_loadu_128(chroma_row + j));
+      const __m256i index = merge_luma_chroma(average_luma, pixel, luma_mult_v,
+                                              mult_v, offset_v, max_index);
+      const __m256i scaling = _mm256_i32gather_epi32(scaling_lut, index, 4);
+      const __m256i res = add_scaled_grain(pixel, scaling, grain_row + j,
+                                           rounding, shift, min, max);
+      xx_storeu_128(chroma_row + j, pack_epi32_to_epu16(res));
+    }
+  }
+
+  if (width8 < width) {
+    av1_highbd_add_chroma_grain_sse4_1(
+        chroma + width8, chroma_stride, luma + (width8 << chroma_subsamp_x),
+        luma_stride, grain + width8, grain_stride, scaling_lut, width - width8,
+        height, chroma_subsamp_x, luma_mult, mult, offset, scaling_shift,
+        min_val, max_val, bd);
+  }
+}
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <smmintrin.h> /* SSE4.1 */
+
+#include "config/av1_rtcd.h"
+
+#include "aom_dsp/x86/synonyms.h"
+
+static INLINE __m128i scaling_lut_lookup(const int *scaling_lut,
+                                         const __m128i index) {
+  return _mm_setr_epi32(scaling_lut[_mm_extract_epi32(index, 0)],
+                        scaling_lut[_mm_extract_epi32(index, 1)],
+                        scaling_lut[_mm_extract_epi32(index, 2)],
+                        scaling_lut[_mm_extract_epi32(index, 3)]);
+}
+
+// Returns clamp(pixel + ((scaling * grain + rounding) >> shift), min, max).
+static INLINE __m128i add_scaled_grain(const __m128i pixel,
+                                       const __m128i scaling, const int *grain,
+                                       const __m128i rounding,
+                                       const __m128i shift, const __m128i min,
+                                       const __m128i max) {
+  const __m128i noise = _mm_sra_epi32(
+      _mm_add_epi32(_mm_mullo_epi32(scaling, xx_loadu_128(grain)), rounding),
+      shift);
+  return _mm_min_epi32(_mm_max_epi32(_mm_add_epi32(pixel, noise), min), max);
+}
+
+// Returns the index into the chroma scaling function,
+// clamp(((average_luma * luma_mult + chroma * mult) >> 6) + offset, 0, max).
+static INLINE __m128i merge_luma_chroma(const __m128i average_luma,
+                                        const __m128i chroma,
+                                        const __m128i luma_mult,
+                                        const __m128i mult,
+                                        const __m128i offset,
+                                        const __m128i max_index) {
+  const __m128i merged =
+      _mm_add_epi32(_mm_mullo_epi32(average_luma, luma_mult),
+                    _mm_mullo_epi32(chroma, mult));
+  return _mm_min_epi32(
+      _mm_max_epi32(_mm_add_epi32(_mm_srai_epi32(merged, 6), offset),
+                    _mm_setzero_si128()),
+      max_index);
+}
+
+void av1_add_luma_grain_sse4_1(uint8_t *luma, int luma_stride,
+                               const int *grain, int grain_stride,
+                               const int *scaling_lut, int width, int height,
+                               int scaling_shift, int min_val, int max_val) {
+  const __m128i rounding = _mm_set1_epi32(1 << (scaling_shift - 1));
+  const __m128i shift = _mm_cvtsi32_si128(scaling_shift);
+  const __m128i min = _mm_set1_epi32(min_val);
+  const __m128i max = _mm_set1_epi32(max_val);
+  const int width4 = width & ~3;
+
+  for (int i = 0; i < height; i++) {
+    uint8_t *const luma_row = luma + i * luma_stride;
+    const int *const grain_row = grain + i * grain_stride;
+    for (int j = 0; j < width4; j += 4) {
+      const __m128i pixel = _mm_cvtepu8_epi32(xx_loadl_32(luma_row + j));
+      const __m128i scaling = scaling_lut_lookup(scaling_lut, pixel);
+      const __m128i res = add_scaled_grain(pixel, scaling, grain_row + j,
+                                           rounding, shift, min, max);
+      const __m128i res16 = _mm_packus_epi32(res, res);
+      xx_storel_32(luma_row + j, _mm_packus_epi16(res16, res16));
+    }
+  }
+
+  if (width4 < width) {
+    av1_add_luma_grain_c(luma + width4, luma_stride, grain + width4,
+                         grain_stride, scaling_lut, width - width4, height,
+                         scaling_shift, min_val, max_val);
+  }
+}
+
+void av1_highbd_add_luma_grain_sse4_1(uint16_t *luma, int luma_stride,
+                                      const int *grain, int grain_stride,
+                                      const int *scaling_lut, int width,
+                                      int height, int scaling_shift,
+                                      int min_val, int max_val) {
+  const __m128i rounding = _mm_set1_epi32(1 << (scaling_shift - 1));
+  const __m128i shift = _mm_cvtsi32_si128(scaling_shift);
+  const __m128i min = _mm_set1_epi32(min_val);
+  const __m128i max = _mm_set1_epi32(max_val);
+  const int width4 = width & ~3;
+
+  for (int i = 0; i < height; i++) {
+    uint16_t *const luma_row = luma + i * luma_stride;
+    const int *const grain_row = grain + i * grain_stride;
+    for (int j = 0; j < width4; j += 4) {
+      const __m128i pixel = _mm_cvtepu16_epi32(xx_loadl_64(luma_row + j));
+      const __m128i scaling = scaling_lut_lookup(scaling_lut, pixel);
+      const __m128i res = add_scaled_grain(pixel, scaling, grain_row + j,
+                                           rounding, shift, min, max);
+      xx_storel_64(luma_row + j, _mm_packus_epi32(res, res));
+    }
+  }
+
+  if (width4 < width) {
+    av1_highbd_add_luma_grain_c(luma + width4, luma_stride, grain + width4,
+                                grain_stride, scaling_lut, width - width4,
+                                height, scaling_shift, min_val, max_val);
+  }
+}
+
+void av1_add_chroma_grain_sse4_1(uint8_t *chroma, int chroma_stride,
+                                 const uint8_t *luma, int luma_stride,
+                                 const int *grain, int grain_stride,
+                                 const int *scaling_lut, int width, int height,
+                                 int chroma_subsamp_x, int luma_mult, int mult,
+                                 int offset, int scaling_shift, int min_val,
+                                 int max_val) {
+  const __m128i rounding = _mm_set1_epi32(1 << (scaling_shift - 1));
+  const __m128i shift = _mm_cvtsi32_si128(scaling_shift);
+  const __m128i min = _mm_set1_epi32(min_val);
+  const __m128i max = _mm_set1_epi32(max_val);
+  const __m128i luma_mult_v = _mm_set1_epi32(luma_mult);
+  const __m128i mult_v = _mm_set1_epi32(mult);
+  const __m128i offset_v = _mm_set1_epi32(offset);
+  const __m128i max_index = _mm_set1_epi32(255);
+  const __m128i one16 = _mm_set1_epi16(1);
+  const __m128i one32 = _mm_set1_epi32(1);
+  const int width4 = width & ~3;
+
+  for (int i = 0; i < height; i++) {
+    uint8_t *const chroma_row = chroma + i * chroma_stride;
+    const uint8_t *const luma_row = luma + i * luma_stride;
+    const int *const grain_row = grain + i * grain_stride;
+    for (int j = 0; j < width4; j += 4) {
+      __m128i average_luma;
+      if (chroma_subsamp_x) {
+        const __m128i pair_sum = _mm_madd_epi16(
+            _mm_cvtepu8_epi16(xx_loadl_64(luma_row + (j << 1))), one16);
+        average_luma = _mm_srai_epi32(_mm_add_epi32(pair_sum, one32), 1);
+      } else {
+        average_luma = _mm_cvtepu8_epi32(xx_loadl_32(luma_row + j));
+      }
+      const __m128i pixel = _mm_cvtepu8_epi32(xx_loadl_32(chroma_row + j));
+      const __m128i index = merge_luma_chroma(average_luma, pixel, luma_mult_v,
+                                              mult_v, offset_v, max_index);
+      const __m128i scaling = scaling_lut_lookup(scaling_lut, index);
+      const __m128i res = add_scaled_grain(pixel, scaling, grain_row + j,
+                                           rounding, shift, min, max);
+      const __m128i res16 = _mm_packus_epi32(res, res);
+      xx_storel_32(chroma_row + j, _mm_packus_epi16(res16, res16));
+    }
+  }
+
+  if (width4 < width) {
+    av1_add_chroma_grain_c(chroma + width4, chroma_stride,
+                           luma + (width4 << chroma_subsamp_x), luma_stride,
+                           grain + width4, grain_stride, scaling_lut,
+                           width - width4, height, chroma_subsamp_x, luma_mult,
+                           mult, offset, scaling_shift, min_val, max_val);
+  }
+}
+
+void av1_highbd_add_chroma_grain_sse4_1(
+    uint16_t *chroma, int chroma_stride, const uint16_t *luma, int luma_stride,
+    const int *grain, int grain_stride, const int *scaling_lut, int width,
+    int height, int chroma_subsamp_x, int luma_mult, int mult, int offset,
+    int scaling_shift, int min_val, int max_val, int bd) {
+  const __m128i rounding = _mm_set1_epi32(1 << (scaling_shift - 1));
+  const __m128i shift = _mm_cvtsi32_si128(scaling_shift);
+  const __m128i min = _mm_set1_epi32(min_val);
+  const __m128i max = _mm_set1_epi32(max_val);
+  const __m128i luma_mult_v = _mm_set1_epi32(luma_mult);
+  const __m128i mult_v = _mm_set1_epi32(mult);
+  const __m128i offset_v = _mm_set1_epi32(offset);
+  const __m128i max_index = _mm_set1_epi32((256 << (bd - 8)) - 1);
+  const __m128i one16 = _mm_set1_epi16(1);
+  const __m128i one32 = _mm_set1_epi32(1);
+  const int width4 = width & ~3;
+
+  for (int i = 0; i < height; i++) {
+    uint16_t *const chroma_row = chroma + i * chroma_stride;
+    const uint16_t *const luma_row = luma + i * luma_stride;
+    const int *const grain_row = grain + i * grain_stride;
+    for (int j = 0; j < width4; j += 4) {
+      __m128i average_luma;
+      if (chroma_subsamp_x) {
+        // Samples of at most 12 bits do not overflow the signed 16-bit madd.
+        const __m128i pair_sum =
+            _mm_madd_epi16(xx_loadu_128(luma_row + (j << 1)), one16);
+        average_luma = _mm_srai_epi32(_mm_add_epi32(pair_sum, one32), 1);
+      } else {
+        average_luma = _mm_cvtepu16_epi32(xx_loadl_64(luma_row + j));
+      }
+      const __m128i pixel = _mm_cvtepu16_epi32(xx_loadl_64(chroma_row + j));
+      const __m128i index = merge_luma_chroma(average_luma, pixel, luma_mult_v,
+                                              mult_v, offset_v, max_index);
+      const __m128i scaling = scaling_lut_lookup(scaling_lut, index);
+      const __m128i res = add_scaled_grain(pixel, scaling, grain_row + j,
+                                           rounding, shift, min, max);
+      xx_storel_64(chroma_row + j, _mm_packus_epi32(res, res));
+    }
+  }
+
+  if (width4 < width) {
+    av1_highbd_add_chroma_grain_c(
+        chroma + width4, chroma_stride, luma + (width4 << chroma_subsamp_x),
+        luma_stride, grain + width4, grain_stride, scaling_lut, width - width4,
+        height, chroma_subsamp_x, luma_mult, mult, offset, scaling_shift,
+        min_val, max_val, bd);
+  }
+}
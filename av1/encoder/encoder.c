@@ -2288,7 +2288,7 @@ static INLINE int extend_borders_mt(const AV1_COMP *cpi,
  */
 static void cdef_restoration_frame(AV1_COMP *cpi, AV1_COMMON *cm,
                                    MACROBLOCKD *xd, int use_restoration,
-                                   int use_cdef,
+                                   int use_cdef, int cdef_mse_calc_done,
                                    unsigned int skip_apply_postproc_filters) {
 #if !CONFIG_REALTIME_ONLY
   if (use_restoration)
@@ -2303,7 +2303,7 @@ static void cdef_restoration_frame(AV1_COMP *cpi, AV1_COMMON *cm,
 #endif
     const int num_workers = cpi->mt_info.num_mod_workers[MOD_CDEF];
     // Find CDEF parameters
-    av1_cdef_search(cpi);
+    av1_cdef_search(cpi, cdef_mse_calc_done);
 
     // Apply the filter
     if ((skip_apply_postproc_filters & SKIP_APPLY_CDEF) == 0) {
@@ -2405,6 +2405,7 @@ static void loopfilter_frame(AV1_COMP *cpi, AV1_COMMON *cm) {
   const unsigned int skip_apply_postproc_filters =
       derive_skip_apply_postproc_filters(cpi, use_loopfilter, use_cdef,
                                          use_superres, use_restoration);
+  int cdef_mse_calc_done = 0;
 
 #if CONFIG_COLLECT_COMPONENT_TIMING
   start_timing(cpi, loop_filter_time);
@@ -2424,9 +2425,18 @@ static void loopfilter_frame(AV1_COMP *cpi, AV1_COMMON *cm) {
       // pick method is LPF_PICK_FROM_Q as u and v plane filter levels are
       // equal.
       int lpf_opt_level = get_lpf_opt_level(&cpi->sf);
-      av1_loop_filter_frame_mt(&cm->cur_frame->buf, cm, xd, 0, num_planes, 0,
-                               mt_info->workers, num_workers,
-                               &mt_info->lf_row_sync, lpf_opt_level);
+      if (use_cdef && num_workers > 1 && av1_cdef_search_uses_mse(cpi)) {
+        // The filtering error of the CDEF search is computed by the loop
+        // filter workers, each filter block as soon as the rows it reads are
+        // filtered, instead of in a separate pass over the frame.
+        av1_cdef_search_init(cpi);
+        av1_loop_filter_cdef_search_mt(cpi, lpf_opt_level);
+        cdef_mse_calc_done = 1;
+      } else {
+        av1_loop_filter_frame_mt(&cm->cur_frame->buf, cm, xd, 0, num_planes,
+                                 0, mt_info->workers, num_workers,
+                                 &mt_info->lf_row_sync, lpf_opt_level);
+      }
     }
   }
 
@@ -2435,7 +2445,7 @@ static void loopfilter_frame(AV1_COMP *cpi, AV1_COMMON *cm) {
 #endif
 
   cdef_restoration_frame(cpi, cm, xd, use_restoration, use_cdef,
-                         skip_apply_postproc_filters);
+                         cdef_mse_calc_done, skip_apply_postproc_filters);
 }
 
 static void update_motion_stat(AV1_COMP *const cpi) {
@@ -886,6 +886,11 @@ void av1_init_mt_sync(AV1_COMP *cpi, int is_first_pass) {
                       aom_malloc(sizeof(*(cdef_sync->mutex_))));
       if (cdef_sync->mutex_) pthread_mutex_init(cdef_sync->mutex_, NULL);
     }
+    if (cdef_sync->cond_ == NULL) {
+      CHECK_MEM_ERROR(cm, cdef_sync->cond_,
+                      aom_malloc(sizeof(*(cdef_sync->cond_))));
+      if (cdef_sync->cond_) pthread_cond_init(cdef_sync->cond_, NULL);
+    }
 
     // Initialize loop filter MT object.
     AV1LfSync *lf_sync = &mt_info->lf_row_sync;
@@ -3241,7 +3246,14 @@ void av1_cdef_mt_dealloc(AV1CdefSync *cdef_sync) {
     pthread_mutex_destroy(cdef_sync->mutex_);
     aom_free(cdef_sync->mutex_);
   }
+  if (cdef_sync->cond_ != NULL) {
+    pthread_cond_destroy(cdef_sync->cond_);
+    aom_free(cdef_sync->cond_);
+  }
 #endif  // CONFIG_MULTITHREAD
+  aom_free(cdef_sync->lf_planes_done);
+  cdef_sync->lf_planes_done = NULL;
+  cdef_sync->lf_rows_alloc = 0;
 }
 
 // Updates the row and column indices of the next job to be processed.
@@ -3369,6 +3381,155 @@ void av1_cdef_mse_calc_frame_mt(AV1_COMP *cpi) {
   sync_enc_workers(mt_info, &cpi->common, num_workers);
 }
 
+// Records that the horizontal edges of a plane in the loop filter row mi_row
+// are filtered, and wakes up the workers waiting for the row to run the CDEF
+// search.
+static void lf_cdef_search_set_row_done(AV1CdefSync *const cdef_sync,
+                                        int mi_row) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(cdef_sync->mutex_);
+#endif  // CONFIG_MULTITHREAD
+  cdef_sync->lf_planes_done[mi_row >> MAX_MIB_SIZE_LOG2]++;
+  while (cdef_sync->lf_rows_done < cdef_sync->lf_rows &&
+         cdef_sync->lf_planes_done[cdef_sync->lf_rows_done] ==
+             cdef_sync->lf_num_planes) {
+    cdef_sync->lf_rows_done++;
+  }
+#if CONFIG_MULTITHREAD
+  pthread_cond_broadcast(cdef_sync->cond_);
+  pthread_mutex_unlock(cdef_sync->mutex_);
+#endif  // CONFIG_MULTITHREAD
+}
+
+// Waits until the loop filter rows read by the CDEF search of the filter block
+// row fbr are done. Returns 0 if the processing is aborted.
+static int lf_cdef_search_wait_rows(AV1CdefSync *const cdef_sync,
+                                    const CdefSearchCtx *cdef_search_ctx,
+                                    int fbr) {
+  // A filter block of up to 128x128 is read with CDEF_VBORDER rows below it,
+  // whose pixels are final once the horizontal edges of the loop filter row
+  // below them are also filtered.
+  const int mi_rows = cdef_search_ctx->mi_params->mi_rows;
+  const int end_mi_row = AOMMIN(mi_rows, (fbr + 2) * MI_SIZE_64X64);
+  const int lf_row = AOMMIN(cdef_sync->lf_rows - 1,
+                            (end_mi_row >> MAX_MIB_SIZE_LOG2) + 1);
+  int do_next_block = 1;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(cdef_sync->mutex_);
+  while (!cdef_sync->cdef_mt_exit && cdef_sync->lf_rows_done <= lf_row) {
+    pthread_cond_wait(cdef_sync->cond_, cdef_sync->mutex_);
+  }
+  do_next_block = !cdef_sync->cdef_mt_exit;
+  pthread_mutex_unlock(cdef_sync->mutex_);
+#else
+  (void)lf_row;
+#endif  // CONFIG_MULTITHREAD
+  return do_next_block;
+}
+
+// Hook function for each thread in the loop filter multi-threading along with
+// the CDEF search. The search of a filter block starts as soon as the loop
+// filter rows it reads are done, instead of waiting for the whole frame.
+static int lpf_cdef_search_worker_hook(void *arg1, void *arg2) {
+  EncWorkerData *const thread_data = (EncWorkerData *)arg1;
+  AV1CdefSync *const cdef_sync = (AV1CdefSync *)arg2;
+  AV1LfSync *const lf_sync = thread_data->lf_sync;
+  LFWorkerData *const lf_data = thread_data->lf_data;
+  CdefSearchCtx *const cdef_search_ctx = thread_data->cpi->cdef_search_ctx;
+  struct aom_internal_error_info *const error_info = &thread_data->error_info;
+  AV1LfMTInfo *cur_job_info;
+
+  // The jmp_buf is valid only for the duration of the function that calls
+  // setjmp(). Therefore, this function must reset the 'setjmp' field to 0
+  // before it returns.
+  if (setjmp(error_info->jmp)) {
+    error_info->setjmp = 0;
+#if CONFIG_MULTITHREAD
+    pthread_mutex_lock(lf_sync->job_mutex);
+    lf_sync->lf_mt_exit = true;
+    pthread_mutex_unlock(lf_sync->job_mutex);
+    pthread_mutex_lock(cdef_sync->mutex_);
+    cdef_sync->cdef_mt_exit = true;
+    pthread_cond_broadcast(cdef_sync->cond_);
+    pthread_mutex_unlock(cdef_sync->mutex_);
+#endif  // CONFIG_MULTITHREAD
+    av1_set_vert_loop_filter_done(lf_data->cm, lf_sync, MAX_MIB_SIZE_LOG2);
+    return 0;
+  }
+  error_info->setjmp = 1;
+
+  while ((cur_job_info = get_lf_job_info(lf_sync)) != NULL) {
+    av1_thread_loop_filter_rows(
+        lf_data->frame_buffer, lf_data->cm, lf_data->planes, lf_data->xd,
+        cur_job_info->mi_row, cur_job_info->plane, cur_job_info->dir,
+        cur_job_info->lpf_opt_level, lf_sync, error_info, lf_data->params_buf,
+        lf_data->tx_buf, MAX_MIB_SIZE_LOG2);
+    if (cur_job_info->dir == 1)
+      lf_cdef_search_set_row_done(cdef_sync, cur_job_info->mi_row);
+  }
+
+  volatile int cur_fbr, cur_fbc, sb_count;
+  while (cdef_get_next_job(cdef_sync, cdef_search_ctx, &cur_fbr, &cur_fbc,
+                           &sb_count)) {
+    if (!lf_cdef_search_wait_rows(cdef_sync, cdef_search_ctx, cur_fbr)) break;
+    av1_cdef_mse_calc_block(cdef_search_ctx, error_info, cur_fbr, cur_fbc,
+                            sb_count);
+  }
+  error_info->setjmp = 0;
+  return 1;
+}
+
+// Implements multi-threading for the loop filter along with the filtering
+// error calculation of the CDEF search, which must be initialized with
+// av1_cdef_search_init().
+void av1_loop_filter_cdef_search_mt(AV1_COMP *cpi, int lpf_opt_level) {
+  AV1_COMMON *const cm = &cpi->common;
+  MultiThreadInfo *const mt_info = &cpi->mt_info;
+  AV1LfSync *const lf_sync = &mt_info->lf_row_sync;
+  AV1CdefSync *const cdef_sync = &mt_info->cdef_sync;
+  MACROBLOCKD *const xd = &cpi->td.mb.e_mbd;
+  const int num_workers = mt_info->num_mod_workers[MOD_LPF];
+  const int num_planes = av1_num_planes(cm);
+  const int mi_rows = cm->mi_params.mi_rows;
+  int planes_to_lf[MAX_MB_PLANE];
+
+  set_planes_to_loop_filter(&cm->lf, planes_to_lf, 0, num_planes);
+  av1_loop_filter_frame_init(cm, 0, num_planes);
+  loop_filter_frame_mt_init(cm, 0, mi_rows, planes_to_lf, num_workers,
+                            lf_sync, lpf_opt_level, MAX_MIB_SIZE_LOG2);
+
+  const int lf_rows = CEIL_POWER_OF_TWO(mi_rows, MAX_MIB_SIZE_LOG2);
+  if (cdef_sync->lf_rows_alloc < lf_rows) {
+    aom_free(cdef_sync->lf_planes_done);
+    cdef_sync->lf_rows_alloc = 0;
+    CHECK_MEM_ERROR(cm, cdef_sync->lf_planes_done,
+                    aom_malloc(lf_rows * sizeof(*cdef_sync->lf_planes_done)));
+    cdef_sync->lf_rows_alloc = lf_rows;
+  }
+  memset(cdef_sync->lf_planes_done, 0,
+         lf_rows * sizeof(*cdef_sync->lf_planes_done));
+  cdef_sync->lf_rows = lf_rows;
+  // Each loop filter row has one job per plane and direction.
+  cdef_sync->lf_num_planes = lf_sync->jobs_enqueued / (2 * lf_rows);
+  cdef_sync->lf_rows_done = 0;
+  cdef_reset_job_info(cdef_sync);
+
+  for (int i = num_workers - 1; i >= 0; i--) {
+    AVxWorker *const worker = &mt_info->workers[i];
+    EncWorkerData *const thread_data = &mt_info->tile_thr_data[i];
+
+    thread_data->cpi = cpi;
+    thread_data->lf_sync = lf_sync;
+    thread_data->lf_data = &lf_sync->lfdata[i];
+    loop_filter_data_reset(thread_data->lf_data, &cm->cur_frame->buf, cm, xd);
+    worker->hook = lpf_cdef_search_worker_hook;
+    worker->data1 = thread_data;
+    worker->data2 = cdef_sync;
+  }
+  launch_workers(mt_info, num_workers);
+  sync_enc_workers(mt_info, cm, num_workers);
+}
+
 // Computes num_workers for temporal filter multi-threading.
 static AOM_INLINE int compute_num_tf_workers(const AV1_COMP *cpi) {
   // For single-pass encode, using no. of workers as per tf block size was not
@@ -109,6 +109,8 @@ void av1_init_tile_thread_data(AV1_PRIMARY *ppi, int is_first_pass);
 
 void av1_cdef_mse_calc_frame_mt(AV1_COMP *cpi);
 
+void av1_loop_filter_cdef_search_mt(AV1_COMP *cpi, int lpf_opt_level);
+
 void av1_cdef_mt_dealloc(AV1CdefSync *cdef_sync);
 
 void av1_write_tile_obu_mt(
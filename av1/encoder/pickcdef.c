@@ -821,11 +821,36 @@ void av1_pick_cdef_from_qp(AV1_COMMON *const cm, int skip_cdef,
   }
 }
 
-void av1_cdef_search(AV1_COMP *cpi) {
+int av1_cdef_search_uses_mse(const AV1_COMP *cpi) {
+  if (cpi->oxcf.tool_cfg.cdef_control == CDEF_REFERENCE &&
+      cpi->ppi->rtc_ref.non_reference_frame)
+    return 0;
+  if (cpi->rc.rtc_external_ratectrl) return 0;
+  return cpi->sf.lpf_sf.cdef_pick_method != CDEF_PICK_FROM_Q;
+}
+
+void av1_cdef_search_init(AV1_COMP *cpi) {
+  AV1_COMMON *cm = &cpi->common;
+  MACROBLOCKD *xd = &cpi->td.mb.e_mbd;
+
+  if (!cpi->cdef_search_ctx)
+    CHECK_MEM_ERROR(cm, cpi->cdef_search_ctx,
+                    aom_malloc(sizeof(*cpi->cdef_search_ctx)));
+  CdefSearchCtx *cdef_search_ctx = cpi->cdef_search_ctx;
+
+  // Initialize parameters related to CDEF search context.
+  cdef_params_init(&cm->cur_frame->buf, cpi->source, cm, xd, cdef_search_ctx,
+                   cpi->sf.lpf_sf.cdef_pick_method);
+  // Allocate CDEF search context buffers.
+  cdef_alloc_data(cm, cdef_search_ctx);
+}
+
+void av1_cdef_search(AV1_COMP *cpi, int mse_calc_done) {
   AV1_COMMON *cm = &cpi->common;
   CDEF_CONTROL cdef_control = cpi->oxcf.tool_cfg.cdef_control;
 
   assert(cdef_control != CDEF_NONE);
+  assert(IMPLIES(mse_calc_done, av1_cdef_search_uses_mse(cpi)));
   if (cdef_control == CDEF_REFERENCE && cpi->ppi->rtc_ref.non_reference_frame) {
     CdefInfo *const cdef_info = &cm->cdef_info;
     cdef_info->nb_cdef_strengths = 1;
@@ -857,24 +882,17 @@ void av1_cdef_search(AV1_COMP *cpi) {
   const int fast = (pick_method >= CDEF_FAST_SEARCH_LVL1 &&
                     pick_method <= CDEF_FAST_SEARCH_LVL5);
   const int num_planes = av1_num_planes(cm);
-  MACROBLOCKD *xd = &cpi->td.mb.e_mbd;
-
-  if (!cpi->cdef_search_ctx)
-    CHECK_MEM_ERROR(cm, cpi->cdef_search_ctx,
-                    aom_malloc(sizeof(*cpi->cdef_search_ctx)));
-  CdefSearchCtx *cdef_search_ctx = cpi->cdef_search_ctx;
 
-  // Initialize parameters related to CDEF search context.
-  cdef_params_init(&cm->cur_frame->buf, cpi->source, cm, xd, cdef_search_ctx,
-                   pick_method);
-  // Allocate CDEF search context buffers.
-  cdef_alloc_data(cm, cdef_search_ctx);
-  // Frame level mse calculation.
-  if (cpi->mt_info.num_workers > 1) {
-    av1_cdef_mse_calc_frame_mt(cpi);
-  } else {
-    cdef_mse_calc_frame(cdef_search_ctx, cm->error);
+  if (!mse_calc_done) {
+    av1_cdef_search_init(cpi);
+    // Frame level mse calculation.
+    if (cpi->mt_info.num_workers > 1) {
+      av1_cdef_mse_calc_frame_mt(cpi);
+    } else {
+      cdef_mse_calc_frame(cpi->cdef_search_ctx, cm->error);
+    }
   }
+  CdefSearchCtx *cdef_search_ctx = cpi->cdef_search_ctx;
 
   /* Search for different number of signaling bits. */
   int nb_strength_bits = 0;
@@ -220,6 +220,31 @@ void av1_cdef_mse_calc_block(CdefSearchCtx *cdef_search_ctx,
                              int fbr, int fbc, int sb_count);
 /*!\endcond */
 
+/*!\brief Checks whether the CDEF search computes the filtering error of the
+ * frame
+ *
+ * \ingroup in_loop_cdef
+ *
+ * \param[in]  cpi                 Top level encoder structure
+ *
+ * \return Returns 1 if av1_cdef_search() selects the strengths from the
+ * filtering error of each filter block, and 0 if they are derived without
+ * filtering the frame.
+ */
+int av1_cdef_search_uses_mse(const struct AV1_COMP *cpi);
+
+/*!\brief Initializes the CDEF search context of the current frame
+ *
+ * \ingroup in_loop_cdef
+ *
+ * Sets up and allocates \c cpi->cdef_search_ctx so that the filtering error
+ * of the frame can be computed by av1_cdef_mse_calc_block() before
+ * av1_cdef_search() is called with \c mse_calc_done set.
+ *
+ * \param[in,out]  cpi                 Top level encoder structure
+ */
+void av1_cdef_search_init(struct AV1_COMP *cpi);
+
 /*!\brief AV1 CDEF parameter search
  *
  * \ingroup in_loop_cdef
@@ -227,6 +252,9 @@ void av1_cdef_mse_calc_block(CdefSearchCtx *cdef_search_ctx,
  * Searches for optimal CDEF parameters for frame
  *
  * \param[in,out]  cpi                 Top level encoder structure
+ * \param[in]      mse_calc_done       Whether av1_cdef_search_init() was
+ *                                     called and the filtering error of all
+ *                                     the filter blocks is already computed
  *
  * \remark Nothing is returned. Instead, optimal CDEF parameters are stored
  * in the \c cdef_info structure of type \ref CdefInfo inside \c cm:
@@ -239,7 +267,7 @@ void av1_cdef_mse_calc_block(CdefSearchCtx *cdef_search_ctx,
  * \arg \c damping_factor: CDEF damping factor.
  *
  */
-void av1_cdef_search(struct AV1_COMP *cpi);
+void av1_cdef_search(struct AV1_COMP *cpi, int mse_calc_done);
 
 /*!\brief AV1 CDEF level from QP
  *
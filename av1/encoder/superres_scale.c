@@ -404,7 +404,9 @@ void av1_superres_post_encode(AV1_COMP *cpi) {
   assert(!is_lossless_requested(&cpi->oxcf.rc_cfg));
   assert(!cm->features.all_lossless);
 
-  av1_superres_upscale(cm, NULL, cpi->alloc_pyramid);
+  // The upscale follows CDEF, so it uses the CDEF workers.
+  av1_superres_upscale(cm, NULL, cpi->alloc_pyramid, cpi->mt_info.workers,
+                       cpi->mt_info.num_mod_workers[MOD_CDEF]);
 
   // If regular resizing is occurring the source will need to be downscaled to
   // match the upscaled superres resolution. Otherwise the original source is
@@ -20,10 +20,11 @@
 // the number of anchor frames coded at the beginning of the light field file.
 // num_tile_lists is the number of tile lists need to be decoded. There is an
 // optional parameter allowing to choose the output format, and the supported
-// formats are YUV1D(default), YUV, and NV12.
+// formats are YUV1D(default), YUV, and NV12. Another optional parameter sets
+// the number of threads that decode the tiles of a tile list.
 // Run lightfield tile list decoder to decode an AV1 tile list file:
 // examples/lightfield_tile_list_decoder vase_tile_list.ivf vase_tile_list.yuv
-// 4 2 0(optional)
+// 4 2 0(optional) 4(optional)
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -48,7 +49,7 @@ static const char *exec_name;
 void usage_exit(void) {
   fprintf(stderr,
           "Usage: %s <infile> <outfile> <num_references> <num_tile_lists> "
-          "<output format(optional)>\n",
+          "<output format(optional)> <num_threads(optional)>\n",
           exec_name);
   exit(EXIT_FAILURE);
 }
@@ -131,6 +132,9 @@ int main(int argc, char **argv) {
   if (output_format < YUV1D || output_format > NV12)
     die("Output format out of range [0, 2]");
 
+  aom_codec_dec_cfg_t cfg = { 0, 0, 0, !FORCE_HIGHBITDEPTH_DECODING };
+  if (argc > 6) cfg.threads = (unsigned int)strtoul(argv[6], NULL, 0);
+
   info = aom_video_reader_get_info(reader);
 
   aom_codec_iface_t *decoder = get_aom_decoder_by_fourcc(info->codec_fourcc);
@@ -138,7 +142,7 @@ int main(int argc, char **argv) {
   printf("Using %s\n", aom_codec_iface_name(decoder));
 
   aom_codec_ctx_t codec;
-  if (aom_codec_dec_init(&codec, decoder, NULL, 0))
+  if (aom_codec_dec_init(&codec, decoder, &cfg, 0))
     die("Failed to initialize decoder.");
 
   if (AOM_CODEC_CONTROL_TYPECHECKED(&codec, AV1D_SET_IS_ANNEXB,
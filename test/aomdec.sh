@@ -111,6 +111,27 @@ aomdec_av1_ivf_multithread_row_mt() {
   ivf_multithread 1  # --row-mt=1
 }
 
+# Decodes with and without --pipeline and checks that the MD5 sums match.
+aomdec_av1_ivf_pipeline() {
+  if [ "$(aomdec_can_decode_av1)" = "yes" ] && \
+     [ "$(aom_config_option_enabled CONFIG_MULTITHREAD)" = "yes" ]; then
+    local file="${AV1_IVF_FILE}"
+    if [ ! -e "${file}" ]; then
+      encode_yuv_raw_input_av1 "${file}" --ivf || return 1
+    fi
+    local md5file="${AOM_TEST_OUTPUT_DIR}/av1_ivf.md5"
+    local pipeline_md5file="${AOM_TEST_OUTPUT_DIR}/av1_ivf_pipeline.md5"
+    local decoder="$(aom_tool_path aomdec)"
+    eval "${AOM_TEST_PREFIX}" "${decoder}" --md5 "${file}" ">" "${md5file}" \
+      || return 1
+    for depth in 1 4; do
+      eval "${AOM_TEST_PREFIX}" "${decoder}" --md5 --pipeline=${depth} \
+        "${file}" ">" "${pipeline_md5file}" || return 1
+      diff "${md5file}" "${pipeline_md5file}" || return 1
+    done
+  fi
+}
+
 aomdec_aom_ivf_pipe_input() {
   if [ "$(aomdec_can_decode_av1)" = "yes" ]; then
     local file="${AV1_IVF_FILE}"
@@ -198,6 +219,7 @@ aomdec_av1_monochrome_yuv_10bit() {
 aomdec_tests="aomdec_av1_ivf
               aomdec_av1_ivf_multithread
               aomdec_av1_ivf_multithread_row_mt
+              aomdec_av1_ivf_pipeline
               aomdec_aom_ivf_pipe_input
               aomdec_av1_monochrome_yuv_8bit"
 
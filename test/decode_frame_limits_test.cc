@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include "config/aom_config.h"
+
+#include "aom/aom_decoder.h"
+#include "aom/aomdx.h"
+#include "av1/encoder/encoder.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/i420_video_source.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+
+namespace {
+
+const int kWidth = 352;
+const int kHeight = 288;
+const int kNumFrames = 8;
+// The frames before this one are coded at half the size.
+const int kStepUpFrame = 4;
+
+// Decodes a stream that switches from 176x144 to 352x288 with and without
+// AV1D_SET_FRAME_LIMITS, and checks that the decoder with limits decodes the
+// same frames without growing its buffers, and that a decoder whose limits
+// are too small rejects the larger frames.
+class AV1DecodeFrameLimitsTest
+    : public ::libaom_test::CodecTestWithParam<int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  AV1DecodeFrameLimitsTest()
+      : EncoderTest(GET_PARAM(0)), threads_(GET_PARAM(1)), num_frames_(0) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.threads = threads_;
+    dec_ = codec_->CreateDecoder(cfg, 0);
+    limited_dec_ = codec_->CreateDecoder(cfg, 0);
+    small_dec_ = codec_->CreateDecoder(cfg, 0);
+    aom_dec_frame_limits_t limits = { kWidth, kHeight, 0 };
+    limited_dec_->Control(AV1D_SET_FRAME_LIMITS, &limits);
+    limits.max_width = kWidth / 2;
+    limits.max_height = kHeight / 2;
+    small_dec_->Control(AV1D_SET_FRAME_LIMITS, &limits);
+  }
+
+  ~AV1DecodeFrameLimitsTest() override {
+    delete dec_;
+    delete limited_dec_;
+    delete small_dec_;
+  }
+
+  void SetUp() override { InitializeConfig(::libaom_test::kRealTime); }
+
+  void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                          ::libaom_test::Encoder *encoder) override {
+    if (video->frame() == 0) {
+      encoder->Control(AOME_SET_CPUUSED, 8);
+    } else if (video->frame() == kStepUpFrame) {
+      cfg_.rc_resize_mode = RESIZE_NONE;
+      encoder->Config(&cfg_);
+    }
+  }
+
+  static aom_dec_memory_footprint_t GetFootprint(::libaom_test::Decoder *dec) {
+    aom_dec_memory_footprint_t footprint;
+    EXPECT_EQ(AOM_CODEC_OK, aom_codec_control(dec->GetDecoder(),
+                                              AV1D_GET_MEMORY_FOOTPRINT,
+                                              &footprint));
+    EXPECT_EQ(footprint.total,
+              footprint.frame_buffers + footprint.context_buffers);
+    return footprint;
+  }
+
+  void FramePktHook(const aom_codec_cx_pkt_t *pkt) override {
+    const uint8_t *buf = reinterpret_cast<uint8_t *>(pkt->data.frame.buf);
+    ASSERT_EQ(AOM_CODEC_OK, dec_->DecodeFrame(buf, pkt->data.frame.sz));
+    ASSERT_EQ(AOM_CODEC_OK, limited_dec_->DecodeFrame(buf, pkt->data.frame.sz));
+    // The frames after the first one beyond the limits reference it, so they
+    // are not passed to the decoder whose limits are too small.
+    if (num_frames_ < kStepUpFrame) {
+      ASSERT_EQ(AOM_CODEC_OK, small_dec_->DecodeFrame(buf, pkt->data.frame.sz))
+          << small_dec_->DecodeError();
+    } else if (num_frames_ == kStepUpFrame) {
+      ASSERT_EQ(AOM_CODEC_UNSUP_BITSTREAM,
+                small_dec_->DecodeFrame(buf, pkt->data.frame.sz));
+    }
+    if (num_frames_ == 0) {
+      // The limits can only be set before the first frame.
+      aom_dec_frame_limits_t limits = { kWidth, kHeight, 0 };
+      EXPECT_EQ(AOM_CODEC_ERROR,
+                aom_codec_control(limited_dec_->GetDecoder(),
+                                  AV1D_SET_FRAME_LIMITS, &limits));
+    }
+
+    ::libaom_test::DxDataIterator iter = dec_->GetDxData();
+    ::libaom_test::DxDataIterator limited_iter = limited_dec_->GetDxData();
+    const aom_image_t *img;
+    while ((img = iter.Next()) != nullptr) {
+      const aom_image_t *const limited_img = limited_iter.Next();
+      ASSERT_NE(limited_img, nullptr);
+      ::libaom_test::MD5 md5;
+      md5.Add(img);
+      ::libaom_test::MD5 limited_md5;
+      limited_md5.Add(limited_img);
+      ASSERT_STREQ(md5.Get(), limited_md5.Get()) << "frame " << num_frames_;
+      ASSERT_EQ(img->d_w, num_frames_ < kStepUpFrame ? kWidth / 2u : kWidth);
+    }
+    ASSERT_EQ(limited_iter.Next(), nullptr);
+
+    // The buffers of the decoder with limits do not grow with the frame size.
+    if (num_frames_ == kStepUpFrame - 1) {
+      footprint_before_step_up_ = GetFootprint(dec_);
+      limited_footprint_before_step_up_ = GetFootprint(limited_dec_);
+    } else if (num_frames_ == kStepUpFrame) {
+      EXPECT_GT(GetFootprint(dec_).context_buffers,
+                footprint_before_step_up_.context_buffers);
+      EXPECT_EQ(GetFootprint(limited_dec_).context_buffers,
+                limited_footprint_before_step_up_.context_buffers);
+    }
+    ++num_frames_;
+  }
+
+  void DoTest() {
+    cfg_.rc_target_bitrate = 500;
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_resize_mode = RESIZE_FIXED;
+    cfg_.rc_resize_denominator = 16;
+    cfg_.rc_resize_kf_denominator = 16;
+
+    ::libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", kWidth,
+                                         kHeight, 30, 1, 0, kNumFrames);
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    EXPECT_EQ(num_frames_, kNumFrames);
+  }
+
+ private:
+  int threads_;
+  int num_frames_;
+  aom_dec_memory_footprint_t footprint_before_step_up_;
+  aom_dec_memory_footprint_t limited_footprint_before_step_up_;
+  ::libaom_test::Decoder *dec_;
+  ::libaom_test::Decoder *limited_dec_;
+  ::libaom_test::Decoder *small_dec_;
+};
+
+TEST_P(AV1DecodeFrameLimitsTest, ReusesBuffers) { DoTest(); }
+
+AV1_INSTANTIATE_TEST_SUITE(AV1DecodeFrameLimitsTest, ::testing::Values(1, 4));
+
+TEST(AV1DecodeFrameLimitsControlTest, RejectsInvalidLimits) {
+  aom_codec_ctx_t dec;
+  ASSERT_EQ(AOM_CODEC_OK,
+            aom_codec_dec_init(&dec, aom_codec_av1_dx(), nullptr, 0));
+  aom_dec_frame_limits_t limits = { 0, 288, 0 };
+  EXPECT_EQ(AOM_CODEC_INVALID_PARAM,
+            aom_codec_control(&dec, AV1D_SET_FRAME_LIMITS, &limits));
+  limits = { 352, 288, 513 };
+  EXPECT_EQ(AOM_CODEC_INVALID_PARAM,
+            aom_codec_control(&dec, AV1D_SET_FRAME_LIMITS, &limits));
+  limits = { 352, 288, 4 };
+  EXPECT_EQ(AOM_CODEC_OK,
+            aom_codec_control(&dec, AV1D_SET_FRAME_LIMITS, &limits));
+  // Nothing is allocated before the first frame.
+  aom_dec_memory_footprint_t footprint;
+  EXPECT_EQ(AOM_CODEC_OK,
+            aom_codec_control(&dec, AV1D_GET_MEMORY_FOOTPRINT, &footprint));
+  EXPECT_EQ(footprint.total, 0u);
+  EXPECT_EQ(AOM_CODEC_OK, aom_codec_destroy(&dec));
+}
+
+}  // namespace
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include "aom/aom_decoder.h"
+#include "aom/aomdx.h"
+#include "av1/common/blockd.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/i420_video_source.h"
+#include "test/util.h"
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+
+namespace {
+
+// Checks the arrays returned by AV1D_GET_FRAME_MI_INFO against the mode info
+// returned unit by unit by AV1D_GET_MI_INFO.
+class AV1FrameMiInfoTest
+    : public ::libaom_test::CodecTestWith2Params<int, int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  AV1FrameMiInfoTest()
+      : EncoderTest(GET_PARAM(0)), cpu_used_(GET_PARAM(1)),
+        deltaq_mode_(GET_PARAM(2)), num_frames_(0) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.w = 352;
+    cfg.h = 288;
+    cfg.allow_lowbitdepth = 1;
+    dec_ = codec_->CreateDecoder(cfg, 0);
+  }
+
+  ~AV1FrameMiInfoTest() override { delete dec_; }
+
+  void SetUp() override { InitializeConfig(::libaom_test::kOnePassGood); }
+
+  void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                          ::libaom_test::Encoder *encoder) override {
+    if (video->frame() == 0) {
+      encoder->Control(AOME_SET_CPUUSED, cpu_used_);
+      encoder->Control(AV1E_SET_DELTAQ_MODE, deltaq_mode_);
+    }
+  }
+
+  void FramePktHook(const aom_codec_cx_pkt_t *pkt) override {
+    const aom_codec_err_t res = dec_->DecodeFrame(
+        reinterpret_cast<uint8_t *>(pkt->data.frame.buf), pkt->data.frame.sz);
+    if (res != AOM_CODEC_OK) {
+      abort_ = true;
+      ASSERT_EQ(AOM_CODEC_OK, res) << dec_->DecodeError();
+    }
+    aom_codec_ctx_t *const dec = dec_->GetDecoder();
+    aom_frame_mi_info_t info;
+    if (aom_codec_control(dec, AV1D_GET_FRAME_MI_INFO, &info) !=
+        AOM_CODEC_OK) {
+      // Only a frame without tiles of its own has no mode info.
+      int show_existing_frame = 0;
+      ASSERT_EQ(AOM_CODEC_OK,
+                aom_codec_control(dec, AOMD_GET_SHOW_EXISTING_FRAME_FLAG,
+                                  &show_existing_frame));
+      ASSERT_EQ(show_existing_frame, 1);
+      return;
+    }
+    ++num_frames_;
+    ASSERT_EQ(info.mi_rows, 72);
+    ASSERT_EQ(info.mi_cols, 88);
+
+    // A second call returns the same arrays.
+    aom_frame_mi_info_t info2;
+    ASSERT_EQ(AOM_CODEC_OK,
+              aom_codec_control(dec, AV1D_GET_FRAME_MI_INFO, &info2));
+    EXPECT_EQ(info.bsize, info2.bsize);
+    EXPECT_EQ(info.mv[1], info2.mv[1]);
+
+    for (int mi_row = 0; mi_row < info.mi_rows; ++mi_row) {
+      for (int mi_col = 0; mi_col < info.mi_cols; ++mi_col) {
+        MB_MODE_INFO mbmi;
+        ASSERT_EQ(AOM_CODEC_OK, aom_codec_control(dec, AV1D_GET_MI_INFO,
+                                                  mi_row, mi_col, &mbmi));
+        const int idx = mi_row * info.stride + mi_col;
+        ASSERT_EQ(info.bsize[idx], mbmi.bsize);
+        ASSERT_EQ(info.mode[idx], mbmi.mode);
+        ASSERT_EQ(info.ref_frame[0][idx], mbmi.ref_frame[0]);
+        ASSERT_EQ(info.ref_frame[1][idx], mbmi.ref_frame[1]);
+        if (is_inter_block(&mbmi)) {
+          ASSERT_EQ(info.mv[0][idx].row, mbmi.mv[0].as_mv.row);
+          ASSERT_EQ(info.mv[0][idx].col, mbmi.mv[0].as_mv.col);
+          ASSERT_EQ(info.mv[1][idx].row, mbmi.mv[1].as_mv.row);
+          ASSERT_EQ(info.mv[1][idx].col, mbmi.mv[1].as_mv.col);
+        } else {
+          ASSERT_EQ(info.tx_size[idx], mbmi.tx_size);
+        }
+        // No segmentation, so the q index is the one of the block.
+        ASSERT_EQ(info.qindex[idx], mbmi.current_qindex);
+        ASSERT_EQ(info.skip_txfm[idx], mbmi.skip_txfm);
+        ASSERT_EQ(info.segment_id[idx], mbmi.segment_id);
+      }
+    }
+  }
+
+  void DoTest() {
+    cfg_.rc_target_bitrate = 500;
+    cfg_.g_lag_in_frames = 4;
+
+    ::libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", 352,
+                                         288, 30, 1, 0, 6);
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    EXPECT_GT(num_frames_, 0);
+  }
+
+ private:
+  int cpu_used_;
+  int deltaq_mode_;
+  int num_frames_;
+  ::libaom_test::Decoder *dec_;
+};
+
+TEST_P(AV1FrameMiInfoTest, MatchesMiInfo) { DoTest(); }
+
+AV1_INSTANTIATE_TEST_SUITE(AV1FrameMiInfoTest, ::testing::Values(4, 6),
+                           ::testing::Values(0, 1));
+
+TEST(AV1FrameMiInfoControlTest, NeedsDecodedFrame) {
+  aom_codec_ctx_t dec;
+  ASSERT_EQ(AOM_CODEC_OK,
+            aom_codec_dec_init(&dec, aom_codec_av1_dx(), nullptr, 0));
+  aom_frame_mi_info_t info;
+  EXPECT_EQ(AOM_CODEC_INVALID_PARAM,
+            aom_codec_control(&dec, AV1D_GET_FRAME_MI_INFO, nullptr));
+  EXPECT_EQ(AOM_CODEC_ERROR,
+            aom_codec_control(&dec, AV1D_GET_FRAME_MI_INFO, &info));
+  EXPECT_EQ(AOM_CODEC_OK, aom_codec_destroy(&dec));
+}
+
+}  // namespace
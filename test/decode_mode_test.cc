@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <string>
+#include <vector>
+
+#include "aom/aom_decoder.h"
+#include "aom/aomdx.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/i420_video_source.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+
+namespace {
+
+const int kKeyFrameInterval = 4;
+
+// Encodes every other inter frame as a non-reference frame, and checks that a
+// decoder in each AV1D_SET_DECODE_MODE mode outputs exactly the frames the
+// mode keeps, identical to the frames a decoder of every frame outputs. The
+// frames kept are told by the flags of the encoded packets.
+class AV1DecodeModeTest
+    : public ::libaom_test::CodecTestWith2Params<int, int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  AV1DecodeModeTest()
+      : EncoderTest(GET_PARAM(0)), decode_mode_(GET_PARAM(1)),
+        frame_parallel_(GET_PARAM(2)), num_frames_(0) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.w = 352;
+    cfg.h = 288;
+    cfg.allow_lowbitdepth = 1;
+    ref_dec_ = codec_->CreateDecoder(cfg, 0);
+
+    cfg.threads = frame_parallel_ ? 2 : 1;
+    dec_ = codec_->CreateDecoder(cfg, 0);
+    dec_->Control(AV1D_SET_DECODE_MODE, decode_mode_);
+    dec_->Control(AV1D_SET_FRAME_PARALLEL, frame_parallel_ ? 2 : 0);
+  }
+
+  ~AV1DecodeModeTest() override {
+    delete ref_dec_;
+    delete dec_;
+  }
+
+  void SetUp() override { InitializeConfig(::libaom_test::kOnePassGood); }
+
+  void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                          ::libaom_test::Encoder *encoder) override {
+    if (video->frame() == 0) encoder->Control(AOME_SET_CPUUSED, 6);
+    frame_flags_ = 0;
+    if (video->frame() % kKeyFrameInterval == 0) {
+      frame_flags_ = AOM_EFLAG_FORCE_KF;
+    } else if (video->frame() % 2 == 1) {
+      frame_flags_ = AOM_EFLAG_NO_UPD_LAST | AOM_EFLAG_NO_UPD_GF |
+                     AOM_EFLAG_NO_UPD_ARF;
+    }
+  }
+
+  static void AddFrames(::libaom_test::Decoder *dec,
+                        std::vector<std::string> *md5s) {
+    ::libaom_test::DxDataIterator dec_iter = dec->GetDxData();
+    const aom_image_t *img;
+    while ((img = dec_iter.Next()) != nullptr) {
+      ::libaom_test::MD5 md5;
+      md5.Add(img);
+      md5s->push_back(md5.Get());
+    }
+  }
+
+  void FramePktHook(const aom_codec_cx_pkt_t *pkt) override {
+    const uint8_t *buf = reinterpret_cast<uint8_t *>(pkt->data.frame.buf);
+    aom_codec_err_t res = ref_dec_->DecodeFrame(buf, pkt->data.frame.sz);
+    if (res != AOM_CODEC_OK) {
+      abort_ = true;
+      ASSERT_EQ(AOM_CODEC_OK, res);
+    }
+    std::vector<std::string> md5s;
+    AddFrames(ref_dec_, &md5s);
+    ASSERT_EQ(md5s.size(), 1u);
+
+    const aom_codec_frame_flags_t flags = pkt->data.frame.flags;
+    bool keep = true;
+    if (decode_mode_ == AOM_DECODE_REFERENCE_FRAMES) {
+      // A key frame refreshes every reference frame, even when droppable.
+      keep = (flags & AOM_FRAME_IS_KEY) || !(flags & AOM_FRAME_IS_DROPPABLE);
+    } else if (decode_mode_ == AOM_DECODE_INTRA_FRAMES) {
+      keep = (flags & (AOM_FRAME_IS_KEY | AOM_FRAME_IS_INTRAONLY)) != 0;
+    }
+    if (keep) expected_md5s_.push_back(md5s[0]);
+    ++num_frames_;
+
+    res = dec_->DecodeFrame(buf, pkt->data.frame.sz);
+    if (res != AOM_CODEC_OK) {
+      abort_ = true;
+      ASSERT_EQ(AOM_CODEC_OK, res) << dec_->DecodeError();
+    }
+    AddFrames(dec_, &md5s_);
+  }
+
+  void DoTest() {
+    cfg_.rc_target_bitrate = 500;
+    cfg_.g_lag_in_frames = 0;
+    cfg_.kf_mode = AOM_KF_DISABLED;
+
+    ::libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", 352,
+                                         288, 30, 1, 0, 10);
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+
+    // Flush the frames still being decoded.
+    ASSERT_EQ(AOM_CODEC_OK, dec_->DecodeFrame(nullptr, 0));
+    AddFrames(dec_, &md5s_);
+
+    ASSERT_EQ(md5s_.size(), expected_md5s_.size());
+    if (decode_mode_ == AOM_DECODE_ALL_FRAMES) {
+      EXPECT_EQ(md5s_.size(), static_cast<size_t>(num_frames_));
+    } else {
+      EXPECT_LT(md5s_.size(), static_cast<size_t>(num_frames_));
+    }
+    for (size_t i = 0; i < md5s_.size(); ++i) {
+      EXPECT_EQ(md5s_[i], expected_md5s_[i]) << "frame " << i;
+    }
+  }
+
+ private:
+  int decode_mode_;
+  int frame_parallel_;
+  int num_frames_;
+  ::libaom_test::Decoder *ref_dec_;
+  ::libaom_test::Decoder *dec_;
+  std::vector<std::string> md5s_;
+  std::vector<std::string> expected_md5s_;
+};
+
+TEST_P(AV1DecodeModeTest, OutputsKeptFrames) { DoTest(); }
+
+TEST(AV1DecodeModeControlTest, RejectsInvalidMode) {
+  aom_codec_ctx_t dec;
+  ASSERT_EQ(AOM_CODEC_OK, aom_codec_dec_init(&dec, aom_codec_av1_dx(), nullptr,
+                                             0));
+  EXPECT_EQ(AOM_CODEC_INVALID_PARAM,
+            aom_codec_control(&dec, AV1D_SET_DECODE_MODE, -1));
+  EXPECT_EQ(AOM_CODEC_INVALID_PARAM,
+            aom_codec_control(&dec, AV1D_SET_DECODE_MODE,
+                              AOM_DECODE_INTRA_FRAMES + 1));
+  EXPECT_EQ(AOM_CODEC_OK, aom_codec_control(&dec, AV1D_SET_DECODE_MODE,
+                                            AOM_DECODE_INTRA_FRAMES));
+  EXPECT_EQ(AOM_CODEC_OK, aom_codec_destroy(&dec));
+}
+
+AV1_INSTANTIATE_TEST_SUITE(AV1DecodeModeTest,
+                           ::testing::Values(AOM_DECODE_ALL_FRAMES,
+                                             AOM_DECODE_REFERENCE_FRAMES,
+                                             AOM_DECODE_INTRA_FRAMES),
+                           ::testing::Values(0, 1));
+
+}  // namespace
@@ -12,7 +12,9 @@
 #include <cstdio>
 #include <cstdlib>
 #include <string>
+#include <vector>
 
+#include "aom/aom_integer.h"
 #include "aom_mem/aom_mem.h"
 #include "test/codec_factory.h"
 #include "test/encode_test_driver.h"
@@ -163,6 +165,26 @@ AV1_INSTANTIATE_TEST_SUITE(AV1DecodeMultiThreadedTestLarge,
                            ::testing::Values(1, 4), ::testing::Values(0),
                            ::testing::Values(0, 1));
 
+// Superres frames are upscaled by the tile workers in bands of rows.
+class AV1DecodeMultiThreadedSuperresTest : public AV1DecodeMultiThreadedTest {
+};
+
+TEST_P(AV1DecodeMultiThreadedSuperresTest, MD5Match) {
+  cfg_.large_scale_tile = 0;
+  cfg_.rc_superres_mode = AOM_SUPERRES_FIXED;
+  cfg_.rc_superres_denominator = 13;
+  cfg_.rc_superres_kf_denominator = 11;
+  single_thread_dec_->Control(AV1_SET_TILE_MODE, 0);
+  for (int i = 0; i < kNumMultiThreadDecoders; ++i)
+    multi_thread_dec_[i]->Control(AV1_SET_TILE_MODE, 0);
+  DoTest();
+}
+
+AV1_INSTANTIATE_TEST_SUITE(AV1DecodeMultiThreadedSuperresTest,
+                           ::testing::Values(1, 2), ::testing::Values(1),
+                           ::testing::Values(1), ::testing::Values(3),
+                           ::testing::Values(1));
+
 class AV1DecodeMultiThreadedLSTestLarge
     : public AV1DecodeMultiThreadedTestLarge {};
 
@@ -179,4 +201,537 @@ AV1_INSTANTIATE_TEST_SUITE(AV1DecodeMultiThreadedLSTestLarge,
                            ::testing::Values(1), ::testing::Values(0, 3),
                            ::testing::Values(0, 1));
 
+// Decodes the encoded frames with a serial decoder and a frame parallel
+// decoder and checks that both output the same frames in the same order.
+class AV1DecodeFrameParallelTest
+    : public ::libaom_test::CodecTestWith2Params<int, int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  AV1DecodeFrameParallelTest()
+      : EncoderTest(GET_PARAM(0)), n_tile_cols_(GET_PARAM(1)),
+        frame_parallel_(GET_PARAM(2)) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.w = 352;
+    cfg.h = 288;
+    cfg.threads = 1;
+    cfg.allow_lowbitdepth = 1;
+    serial_dec_ = codec_->CreateDecoder(cfg, 0);
+
+    cfg.threads = 4;
+    frame_parallel_dec_ = codec_->CreateDecoder(cfg, 0);
+    frame_parallel_dec_->Control(AV1D_SET_FRAME_PARALLEL, frame_parallel_);
+  }
+
+  ~AV1DecodeFrameParallelTest() override {
+    delete serial_dec_;
+    delete frame_parallel_dec_;
+  }
+
+  void SetUp() override { InitializeConfig(libaom_test::kOnePassGood); }
+
+  void PreEncodeFrameHook(libaom_test::VideoSource *video,
+                          libaom_test::Encoder *encoder) override {
+    if (video->frame() == 0) {
+      encoder->Control(AV1E_SET_TILE_COLUMNS, n_tile_cols_);
+      encoder->Control(AOME_SET_CPUUSED, 5);
+    }
+  }
+
+  static void AddFrames(::libaom_test::Decoder *dec,
+                        std::vector<std::string> *md5s) {
+    ::libaom_test::DxDataIterator dec_iter = dec->GetDxData();
+    const aom_image_t *img;
+    while ((img = dec_iter.Next()) != nullptr) {
+      ::libaom_test::MD5 md5;
+      md5.Add(img);
+      md5s->push_back(md5.Get());
+    }
+  }
+
+  void FramePktHook(const aom_codec_cx_pkt_t *pkt) override {
+    const uint8_t *buf = reinterpret_cast<uint8_t *>(pkt->data.frame.buf);
+    aom_codec_err_t res = serial_dec_->DecodeFrame(buf, pkt->data.frame.sz);
+    if (res != AOM_CODEC_OK) {
+      abort_ = true;
+      ASSERT_EQ(AOM_CODEC_OK, res);
+    }
+    AddFrames(serial_dec_, &serial_md5s_);
+
+    res = frame_parallel_dec_->DecodeFrame(buf, pkt->data.frame.sz);
+    if (res != AOM_CODEC_OK) {
+      abort_ = true;
+      ASSERT_EQ(AOM_CODEC_OK, res) << frame_parallel_dec_->DecodeError();
+    }
+    AddFrames(frame_parallel_dec_, &frame_parallel_md5s_);
+  }
+
+  void DoTest() {
+    cfg_.rc_target_bitrate = 300;
+    cfg_.g_lag_in_frames = 12;
+    cfg_.rc_end_usage = AOM_VBR;
+
+    libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", 352, 288,
+                                       30, 1, 0, 12);
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+
+    // Flush the frames still being decoded.
+    ASSERT_EQ(AOM_CODEC_OK, frame_parallel_dec_->DecodeFrame(nullptr, 0));
+    AddFrames(frame_parallel_dec_, &frame_parallel_md5s_);
+
+    ASSERT_FALSE(serial_md5s_.empty());
+    ASSERT_EQ(serial_md5s_.size(), frame_parallel_md5s_.size());
+    for (size_t i = 0; i < serial_md5s_.size(); ++i) {
+      EXPECT_EQ(serial_md5s_[i], frame_parallel_md5s_[i]) << "frame " << i;
+    }
+  }
+
+  ::libaom_test::Decoder *serial_dec_;
+  ::libaom_test::Decoder *frame_parallel_dec_;
+  std::vector<std::string> serial_md5s_;
+  std::vector<std::string> frame_parallel_md5s_;
+
+ private:
+  int n_tile_cols_;
+  int frame_parallel_;
+};
+
+TEST_P(AV1DecodeFrameParallelTest, MD5Match) { DoTest(); }
+
+AV1_INSTANTIATE_TEST_SUITE(AV1DecodeFrameParallelTest, ::testing::Values(0, 1),
+                           ::testing::Values(2, 4));
+
+// Decodes each temporal unit with one call per OBU in streaming mode and
+// checks that the output matches decoding the whole temporal unit.
+class AV1StreamingDecodeTest
+    : public ::libaom_test::CodecTestWith2Params<int, int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  AV1StreamingDecodeTest()
+      : EncoderTest(GET_PARAM(0)), n_tile_groups_(GET_PARAM(1)),
+        threads_(GET_PARAM(2)), num_tile_groups_decoded_(0),
+        num_frames_completed_(0), started_(false) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.w = 352;
+    cfg.h = 288;
+    cfg.threads = 1;
+    cfg.allow_lowbitdepth = 1;
+    tu_dec_ = codec_->CreateDecoder(cfg, 0);
+
+    cfg.threads = threads_;
+    streaming_dec_ = codec_->CreateDecoder(cfg, 0);
+    streaming_dec_->Control(AV1D_SET_STREAMING_DECODE, 1);
+    aom_tile_group_cb_t tile_group_cb = { TileGroupCallback, this };
+    streaming_dec_->Control(AV1D_SET_TILE_GROUP_CALLBACK, &tile_group_cb);
+  }
+
+  ~AV1StreamingDecodeTest() override {
+    delete tu_dec_;
+    delete streaming_dec_;
+  }
+
+  void SetUp() override { InitializeConfig(libaom_test::kOnePassGood); }
+
+  void PreEncodeFrameHook(libaom_test::VideoSource *video,
+                          libaom_test::Encoder *encoder) override {
+    if (video->frame() == 0) {
+      encoder->Control(AV1E_SET_TILE_COLUMNS, 1);
+      encoder->Control(AV1E_SET_TILE_ROWS, 1);
+      encoder->Control(AV1E_SET_NUM_TG, n_tile_groups_);
+      encoder->Control(AOME_SET_CPUUSED, 5);
+    }
+  }
+
+  static void TileGroupCallback(void *priv, const aom_tile_group_info_t *info) {
+    AV1StreamingDecodeTest *const test =
+        static_cast<AV1StreamingDecodeTest *>(priv);
+    EXPECT_LE(0, info->start_tile);
+    EXPECT_LE(info->start_tile, info->end_tile);
+    EXPECT_LT(info->end_tile, info->num_tiles);
+    EXPECT_NE(info->img, nullptr);
+    ++test->num_tile_groups_decoded_;
+    if (info->end_tile == info->num_tiles - 1) ++test->num_frames_completed_;
+  }
+
+  static void AddFrames(::libaom_test::Decoder *dec,
+                        std::vector<std::string> *md5s) {
+    ::libaom_test::DxDataIterator dec_iter = dec->GetDxData();
+    const aom_image_t *img;
+    while ((img = dec_iter.Next()) != nullptr) {
+      ::libaom_test::MD5 md5;
+      md5.Add(img);
+      md5s->push_back(md5.Get());
+    }
+  }
+
+  // Returns the size of the OBU at data, which must have an obu_size field.
+  static size_t GetObuSize(const uint8_t *data, size_t size, int *obu_type) {
+    EXPECT_GE(size, 2u);
+    *obu_type = (data[0] >> 3) & 0xF;
+    EXPECT_TRUE(data[0] & 0x2);
+    const size_t header_size = (data[0] & 0x4) ? 2 : 1;
+    uint64_t payload_size;
+    size_t length_size;
+    EXPECT_EQ(aom_uleb_decode(data + header_size, size - header_size,
+                              &payload_size, &length_size),
+              0);
+    const size_t obu_size =
+        header_size + length_size + static_cast<size_t>(payload_size);
+    EXPECT_LE(obu_size, size);
+    return obu_size;
+  }
+
+  void FramePktHook(const aom_codec_cx_pkt_t *pkt) override {
+    const uint8_t *buf = reinterpret_cast<uint8_t *>(pkt->data.frame.buf);
+    const size_t size = pkt->data.frame.sz;
+    aom_codec_err_t res = tu_dec_->DecodeFrame(buf, size);
+    if (res != AOM_CODEC_OK) {
+      abort_ = true;
+      ASSERT_EQ(AOM_CODEC_OK, res);
+    }
+    AddFrames(tu_dec_, &tu_md5s_);
+
+    // The first call must contain the sequence header and a frame header, so
+    // the OBUs up to the first tile data are passed together.
+    size_t start = 0;
+    size_t end = 0;
+    while (end < size) {
+      int obu_type;
+      end += GetObuSize(buf + end, size - end, &obu_type);
+      if (!started_) {
+        if (obu_type != OBU_TILE_GROUP && obu_type != OBU_FRAME) continue;
+        started_ = true;
+      }
+      res = streaming_dec_->DecodeFrame(buf + start, end - start);
+      if (res != AOM_CODEC_OK) {
+        abort_ = true;
+        ASSERT_EQ(AOM_CODEC_OK, res) << streaming_dec_->DecodeError();
+      }
+      AddFrames(streaming_dec_, &streaming_md5s_);
+      start = end;
+    }
+  }
+
+  void DoTest() {
+    cfg_.rc_target_bitrate = 300;
+    cfg_.g_lag_in_frames = 12;
+    cfg_.rc_end_usage = AOM_VBR;
+
+    libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", 352, 288,
+                                       30, 1, 0, 10);
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+
+    ASSERT_FALSE(tu_md5s_.empty());
+    ASSERT_EQ(tu_md5s_.size(), streaming_md5s_.size());
+    for (size_t i = 0; i < tu_md5s_.size(); ++i) {
+      EXPECT_EQ(tu_md5s_[i], streaming_md5s_[i]) << "frame " << i;
+    }
+    EXPECT_GT(num_frames_completed_, 0);
+    EXPECT_GE(num_tile_groups_decoded_,
+              num_frames_completed_ * n_tile_groups_);
+  }
+
+  ::libaom_test::Decoder *tu_dec_;
+  ::libaom_test::Decoder *streaming_dec_;
+  std::vector<std::string> tu_md5s_;
+  std::vector<std::string> streaming_md5s_;
+
+ private:
+  int n_tile_groups_;
+  int threads_;
+  int num_tile_groups_decoded_;
+  int num_frames_completed_;
+  bool started_;
+};
+
+TEST_P(AV1StreamingDecodeTest, MD5Match) { DoTest(); }
+
+AV1_INSTANTIATE_TEST_SUITE(AV1StreamingDecodeTest, ::testing::Values(1, 4),
+                           ::testing::Values(1, 4));
+
+// Decodes the encoded frames with several decoders that share a thread pool
+// smaller than their thread count and checks that they match a serial decoder.
+class AV1DecodeThreadPoolTest
+    : public ::libaom_test::CodecTestWith2Params<int, int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  static const int kNumPoolDecoders = 3;
+
+  AV1DecodeThreadPoolTest()
+      : EncoderTest(GET_PARAM(0)), pool_threads_(GET_PARAM(1)),
+        row_mt_(GET_PARAM(2)) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.w = 352;
+    cfg.h = 288;
+    cfg.threads = 1;
+    cfg.allow_lowbitdepth = 1;
+    serial_dec_ = codec_->CreateDecoder(cfg, 0);
+
+    pool_ = aom_codec_thread_pool_create(pool_threads_);
+    cfg.threads = 4;
+    for (int i = 0; i < kNumPoolDecoders; ++i) {
+      pool_dec_[i] = codec_->CreateDecoder(cfg, 0);
+      pool_dec_[i]->Control(AV1D_SET_THREAD_POOL, pool_);
+      pool_dec_[i]->Control(AV1D_SET_ROW_MT, row_mt_);
+    }
+  }
+
+  ~AV1DecodeThreadPoolTest() override {
+    delete serial_dec_;
+    for (int i = 0; i < kNumPoolDecoders; ++i) delete pool_dec_[i];
+    aom_codec_thread_pool_destroy(pool_);
+  }
+
+  void SetUp() override {
+    ASSERT_NE(pool_, nullptr);
+    InitializeConfig(libaom_test::kOnePassGood);
+  }
+
+  void PreEncodeFrameHook(libaom_test::VideoSource *video,
+                          libaom_test::Encoder *encoder) override {
+    if (video->frame() == 0) {
+      encoder->Control(AV1E_SET_TILE_COLUMNS, 2);
+      encoder->Control(AOME_SET_CPUUSED, 5);
+    }
+  }
+
+  static std::string DecodeAndGetMD5(::libaom_test::Decoder *dec,
+                                     const uint8_t *buf, size_t size) {
+    const aom_codec_err_t res = dec->DecodeFrame(buf, size);
+    EXPECT_EQ(AOM_CODEC_OK, res) << dec->DecodeError();
+    ::libaom_test::DxDataIterator dec_iter = dec->GetDxData();
+    ::libaom_test::MD5 md5;
+    const aom_image_t *img;
+    while ((img = dec_iter.Next()) != nullptr) md5.Add(img);
+    return md5.Get();
+  }
+
+  void FramePktHook(const aom_codec_cx_pkt_t *pkt) override {
+    const uint8_t *buf = reinterpret_cast<uint8_t *>(pkt->data.frame.buf);
+    const size_t size = pkt->data.frame.sz;
+    const std::string expected = DecodeAndGetMD5(serial_dec_, buf, size);
+    for (int i = 0; i < kNumPoolDecoders; ++i) {
+      EXPECT_EQ(expected, DecodeAndGetMD5(pool_dec_[i], buf, size))
+          << "decoder " << i;
+    }
+    if (HasFailure()) abort_ = true;
+  }
+
+  void DoTest() {
+    cfg_.rc_target_bitrate = 300;
+    cfg_.g_lag_in_frames = 12;
+    cfg_.rc_end_usage = AOM_VBR;
+
+    libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", 352, 288,
+                                       30, 1, 0, 6);
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  }
+
+ private:
+  int pool_threads_;
+  int row_mt_;
+  aom_codec_thread_pool_t *pool_;
+  ::libaom_test::Decoder *serial_dec_;
+  ::libaom_test::Decoder *pool_dec_[kNumPoolDecoders];
+};
+
+TEST_P(AV1DecodeThreadPoolTest, MD5Match) { DoTest(); }
+
+AV1_INSTANTIATE_TEST_SUITE(AV1DecodeThreadPoolTest, ::testing::Values(1, 2),
+                           ::testing::Values(0, 1));
+
+// Decodes the encoded frames of several streams with aom_codec_decode_batch()
+// and checks that they match a serial decoder. Half of the decoders share the
+// thread pool of the batch and the others decode their tiles serially.
+class AV1DecodeBatchTest
+    : public ::libaom_test::CodecTestWith2Params<int, int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  static const int kNumStreams = 4;
+
+  AV1DecodeBatchTest()
+      : EncoderTest(GET_PARAM(0)), pool_threads_(GET_PARAM(1)),
+        row_mt_(GET_PARAM(2)) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.w = 352;
+    cfg.h = 288;
+    cfg.threads = 1;
+    cfg.allow_lowbitdepth = 1;
+    serial_dec_ = codec_->CreateDecoder(cfg, 0);
+
+    pool_ = aom_codec_thread_pool_create(pool_threads_);
+    for (int i = 0; i < kNumStreams; ++i) {
+      cfg.threads = i % 2 ? 4 : 1;
+      stream_dec_[i] = codec_->CreateDecoder(cfg, 0);
+      if (i % 2) stream_dec_[i]->Control(AV1D_SET_THREAD_POOL, pool_);
+      stream_dec_[i]->Control(AV1D_SET_ROW_MT, row_mt_);
+    }
+  }
+
+  ~AV1DecodeBatchTest() override {
+    delete serial_dec_;
+    for (int i = 0; i < kNumStreams; ++i) delete stream_dec_[i];
+    aom_codec_thread_pool_destroy(pool_);
+  }
+
+  void SetUp() override {
+    ASSERT_NE(pool_, nullptr);
+    InitializeConfig(libaom_test::kOnePassGood);
+  }
+
+  void PreEncodeFrameHook(libaom_test::VideoSource *video,
+                          libaom_test::Encoder *encoder) override {
+    if (video->frame() == 0) {
+      encoder->Control(AV1E_SET_TILE_COLUMNS, 1);
+      encoder->Control(AOME_SET_CPUUSED, 5);
+    }
+  }
+
+  static std::string GetMD5(::libaom_test::Decoder *dec) {
+    ::libaom_test::DxDataIterator dec_iter = dec->GetDxData();
+    ::libaom_test::MD5 md5;
+    const aom_image_t *img;
+    while ((img = dec_iter.Next()) != nullptr) md5.Add(img);
+    return md5.Get();
+  }
+
+  void FramePktHook(const aom_codec_cx_pkt_t *pkt) override {
+    const uint8_t *buf = reinterpret_cast<uint8_t *>(pkt->data.frame.buf);
+    const size_t size = pkt->data.frame.sz;
+    ASSERT_EQ(AOM_CODEC_OK, serial_dec_->DecodeFrame(buf, size));
+    const std::string expected = GetMD5(serial_dec_);
+
+    aom_codec_decode_batch_item_t items[kNumStreams];
+    for (int i = 0; i < kNumStreams; ++i) {
+      items[i].ctx = stream_dec_[i]->GetDecoder();
+      items[i].data = buf;
+      items[i].data_sz = size;
+      items[i].user_priv = nullptr;
+      items[i].res = AOM_CODEC_ERROR;
+    }
+    // A decoder cannot be in a batch twice.
+    items[kNumStreams - 1].ctx = items[0].ctx;
+    EXPECT_EQ(AOM_CODEC_INVALID_PARAM,
+              aom_codec_decode_batch(pool_, items, kNumStreams));
+    items[kNumStreams - 1].ctx = stream_dec_[kNumStreams - 1]->GetDecoder();
+
+    ASSERT_EQ(AOM_CODEC_OK, aom_codec_decode_batch(pool_, items, kNumStreams));
+    for (int i = 0; i < kNumStreams; ++i) {
+      EXPECT_EQ(AOM_CODEC_OK, items[i].res) << "stream " << i;
+      EXPECT_EQ(expected, GetMD5(stream_dec_[i])) << "stream " << i;
+    }
+    if (HasFailure()) abort_ = true;
+  }
+
+  void DoTest() {
+    cfg_.rc_target_bitrate = 300;
+    cfg_.g_lag_in_frames = 12;
+    cfg_.rc_end_usage = AOM_VBR;
+
+    libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", 352, 288,
+                                       30, 1, 0, 6);
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  }
+
+ private:
+  int pool_threads_;
+  int row_mt_;
+  aom_codec_thread_pool_t *pool_;
+  ::libaom_test::Decoder *serial_dec_;
+  ::libaom_test::Decoder *stream_dec_[kNumStreams];
+};
+
+TEST_P(AV1DecodeBatchTest, MD5Match) { DoTest(); }
+
+AV1_INSTANTIATE_TEST_SUITE(AV1DecodeBatchTest, ::testing::Values(1, 2),
+                           ::testing::Values(0, 1));
+
+// Checks that AV1D_GET_STAGE_STATS reports the time of the stages that ran.
+class AV1DecodeStageStatsTest
+    : public ::libaom_test::CodecTestWith2Params<int, int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  AV1DecodeStageStatsTest()
+      : EncoderTest(GET_PARAM(0)), threads_(GET_PARAM(1)),
+        row_mt_(GET_PARAM(2)), total_() {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.w = 352;
+    cfg.h = 288;
+    cfg.threads = threads_;
+    cfg.allow_lowbitdepth = 1;
+    dec_ = codec_->CreateDecoder(cfg, 0);
+    dec_->Control(AV1D_SET_ROW_MT, row_mt_);
+  }
+
+  ~AV1DecodeStageStatsTest() override { delete dec_; }
+
+  void SetUp() override { InitializeConfig(libaom_test::kOnePassGood); }
+
+  void PreEncodeFrameHook(libaom_test::VideoSource *video,
+                          libaom_test::Encoder *encoder) override {
+    if (video->frame() == 0) {
+      encoder->Control(AV1E_SET_TILE_COLUMNS, 1);
+      encoder->Control(AOME_SET_CPUUSED, 5);
+    }
+  }
+
+  void FramePktHook(const aom_codec_cx_pkt_t *pkt) override {
+    aom_decode_stage_stats_t stats;
+    if (total_.tile_decode_us == 0 && total_.obu_parse_us == 0) {
+      // The statistics are only available once enabled.
+      EXPECT_EQ(AOM_CODEC_ERROR, aom_codec_control(dec_->GetDecoder(),
+                                                   AV1D_GET_STAGE_STATS,
+                                                   &stats));
+      dec_->Control(AV1D_SET_STAGE_STATS, 1);
+    }
+    const aom_codec_err_t res =
+        dec_->DecodeFrame(reinterpret_cast<uint8_t *>(pkt->data.frame.buf),
+                          pkt->data.frame.sz);
+    if (res != AOM_CODEC_OK) {
+      abort_ = true;
+      ASSERT_EQ(AOM_CODEC_OK, res);
+    }
+    dec_->Control(AV1D_GET_STAGE_STATS, &stats);
+    EXPECT_GE(stats.obu_parse_us, 0);
+    EXPECT_GE(stats.worker_idle_us, 0);
+    total_.obu_parse_us += stats.obu_parse_us;
+    total_.tile_decode_us += stats.tile_decode_us;
+    total_.entropy_decode_us += stats.entropy_decode_us;
+    total_.reconstruction_us += stats.reconstruction_us;
+    total_.worker_busy_us += stats.worker_busy_us;
+  }
+
+  void DoTest() {
+    cfg_.rc_target_bitrate = 300;
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_end_usage = AOM_VBR;
+
+    libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", 352, 288,
+                                       30, 1, 0, 4);
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+
+    EXPECT_GT(total_.tile_decode_us, 0);
+    EXPECT_GT(total_.worker_busy_us, 0);
+    // Entropy decoding and reconstruction are only timed separately in row-mt
+    // decoding.
+    if (threads_ > 1 && row_mt_) {
+      EXPECT_GT(total_.entropy_decode_us, 0);
+      EXPECT_GT(total_.reconstruction_us, 0);
+    } else {
+      EXPECT_EQ(total_.entropy_decode_us, 0);
+      EXPECT_EQ(total_.reconstruction_us, 0);
+    }
+  }
+
+ private:
+  int threads_;
+  int row_mt_;
+  ::libaom_test::Decoder *dec_;
+  aom_decode_stage_stats_t total_;
+};
+
+TEST_P(AV1DecodeStageStatsTest, ReportsStages) { DoTest(); }
+
+AV1_INSTANTIATE_TEST_SUITE(AV1DecodeStageStatsTest, ::testing::Values(1, 4),
+                           ::testing::Values(0, 1));
+
 }  // namespace
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include "config/aom_config.h"
+
+#include "aom/aom_decoder.h"
+#include "aom/aomdx.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/i420_video_source.h"
+#include "test/util.h"
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+
+namespace {
+
+// Decodes each frame to its planar format and with AV1D_SET_OUTPUT_FORMAT, and
+// checks that the second frame is the interleaved copy of the first one.
+class AV1DecodeOutputFormatTest
+    : public ::libaom_test::CodecTestWith2Params<int, int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  AV1DecodeOutputFormatTest()
+      : EncoderTest(GET_PARAM(0)), allow_lowbitdepth_(GET_PARAM(1)),
+        threads_(GET_PARAM(2)), num_frames_(0) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.w = 352;
+    cfg.h = 288;
+    cfg.threads = threads_;
+    cfg.allow_lowbitdepth = allow_lowbitdepth_;
+    planar_dec_ = codec_->CreateDecoder(cfg, 0);
+    semi_planar_dec_ = codec_->CreateDecoder(cfg, 0);
+    semi_planar_dec_->Control(AV1D_SET_OUTPUT_FORMAT,
+                              allow_lowbitdepth_ ? AOM_IMG_FMT_NV12
+                                                 : AOM_IMG_FMT_P010);
+  }
+
+  ~AV1DecodeOutputFormatTest() override {
+    delete planar_dec_;
+    delete semi_planar_dec_;
+  }
+
+  void SetUp() override { InitializeConfig(::libaom_test::kRealTime); }
+
+  void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                          ::libaom_test::Encoder *encoder) override {
+    if (video->frame() == 0) encoder->Control(AOME_SET_CPUUSED, 8);
+  }
+
+  static void CheckSemiPlanar(const aom_image_t *planar,
+                              const aom_image_t *semi_planar) {
+    const bool highbd = (planar->fmt & AOM_IMG_FMT_HIGHBITDEPTH) != 0;
+    ASSERT_EQ(semi_planar->fmt, highbd ? AOM_IMG_FMT_P010 : AOM_IMG_FMT_NV12);
+    ASSERT_EQ(semi_planar->d_w, planar->d_w);
+    ASSERT_EQ(semi_planar->d_h, planar->d_h);
+    ASSERT_EQ(semi_planar->bit_depth, planar->bit_depth);
+    const int shift = highbd ? 16 - static_cast<int>(planar->bit_depth) : 0;
+    const int bytes = highbd ? 2 : 1;
+
+    auto sample = [bytes](const aom_image_t *img, int plane, int x, int y) {
+      const uint8_t *const row = img->planes[plane] + y * img->stride[plane];
+      if (bytes == 2) {
+        return static_cast<int>(reinterpret_cast<const uint16_t *>(row)[x]);
+      }
+      return static_cast<int>(row[x]);
+    };
+    for (int y = 0; y < static_cast<int>(planar->d_h); ++y) {
+      for (int x = 0; x < static_cast<int>(planar->d_w); ++x) {
+        ASSERT_EQ(sample(semi_planar, AOM_PLANE_Y, x, y),
+                  sample(planar, AOM_PLANE_Y, x, y) << shift)
+            << "luma " << x << "," << y;
+      }
+    }
+    const int chroma_w = (planar->d_w + 1) >> 1;
+    const int chroma_h = (planar->d_h + 1) >> 1;
+    for (int y = 0; y < chroma_h; ++y) {
+      for (int x = 0; x < chroma_w; ++x) {
+        ASSERT_EQ(sample(semi_planar, AOM_PLANE_U, 2 * x, y),
+                  sample(planar, AOM_PLANE_U, x, y) << shift)
+            << "u " << x << "," << y;
+        ASSERT_EQ(sample(semi_planar, AOM_PLANE_U, 2 * x + 1, y),
+                  sample(planar, AOM_PLANE_V, x, y) << shift)
+            << "v " << x << "," << y;
+      }
+    }
+  }
+
+  void FramePktHook(const aom_codec_cx_pkt_t *pkt) override {
+    const uint8_t *buf = reinterpret_cast<uint8_t *>(pkt->data.frame.buf);
+    ASSERT_EQ(AOM_CODEC_OK, planar_dec_->DecodeFrame(buf, pkt->data.frame.sz));
+    ASSERT_EQ(AOM_CODEC_OK,
+              semi_planar_dec_->DecodeFrame(buf, pkt->data.frame.sz));
+
+    ::libaom_test::DxDataIterator planar_iter = planar_dec_->GetDxData();
+    ::libaom_test::DxDataIterator semi_planar_iter =
+        semi_planar_dec_->GetDxData();
+    const aom_image_t *planar;
+    while ((planar = planar_iter.Next()) != nullptr) {
+      const aom_image_t *const semi_planar = semi_planar_iter.Next();
+      ASSERT_NE(semi_planar, nullptr);
+      ASSERT_NO_FATAL_FAILURE(CheckSemiPlanar(planar, semi_planar));
+      ++num_frames_;
+    }
+    ASSERT_EQ(semi_planar_iter.Next(), nullptr);
+  }
+
+  void DoTest() {
+    cfg_.rc_target_bitrate = 500;
+    cfg_.g_lag_in_frames = 0;
+
+    ::libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", 352,
+                                         288, 30, 1, 0, 4);
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    EXPECT_EQ(num_frames_, 4);
+  }
+
+ private:
+  int allow_lowbitdepth_;
+  int threads_;
+  int num_frames_;
+  ::libaom_test::Decoder *planar_dec_;
+  ::libaom_test::Decoder *semi_planar_dec_;
+};
+
+TEST_P(AV1DecodeOutputFormatTest, InterleavesChroma) { DoTest(); }
+
+AV1_INSTANTIATE_TEST_SUITE(AV1DecodeOutputFormatTest,
+#if CONFIG_AV1_HIGHBITDEPTH
+                           ::testing::Values(1, 0),
+#else
+                           ::testing::Values(1),
+#endif
+                           ::testing::Values(1, 4));
+
+TEST(AV1DecodeOutputFormatControlTest, RejectsOtherFormats) {
+  aom_codec_ctx_t dec;
+  ASSERT_EQ(AOM_CODEC_OK,
+            aom_codec_dec_init(&dec, aom_codec_av1_dx(), nullptr, 0));
+  EXPECT_EQ(AOM_CODEC_INVALID_PARAM,
+            aom_codec_control(&dec, AV1D_SET_OUTPUT_FORMAT, AOM_IMG_FMT_I420));
+  EXPECT_EQ(AOM_CODEC_OK,
+            aom_codec_control(&dec, AV1D_SET_OUTPUT_FORMAT, AOM_IMG_FMT_NV12));
+  EXPECT_EQ(AOM_CODEC_OK,
+            aom_codec_control(&dec, AV1D_SET_OUTPUT_FORMAT, AOM_IMG_FMT_NONE));
+  EXPECT_EQ(AOM_CODEC_OK, aom_codec_destroy(&dec));
+}
+
+}  // namespace
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <string.h>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+
+#include "config/aom_config.h"
+#include "config/av1_rtcd.h"
+
+#include "aom_ports/mem.h"
+#include "test/acm_random.h"
+
+namespace {
+
+using libaom_test::ACMRandom;
+
+// Largest number of coefficients of a transform block.
+const int kMaxCoeffs = 32 * 32;
+
+typedef void (*DequantCoeffsFunc)(tran_low_t *coeffs, int n, int dc_q,
+                                  int ac_q, int shift, int bd);
+
+class DequantCoeffsTest : public ::testing::TestWithParam<DequantCoeffsFunc> {
+ protected:
+  ACMRandom rnd_{ ACMRandom::DeterministicSeed() };
+};
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(DequantCoeffsTest);
+
+TEST_P(DequantCoeffsTest, MatchesC) {
+  DECLARE_ALIGNED(32, tran_low_t, ref[kMaxCoeffs]);
+  DECLARE_ALIGNED(32, tran_low_t, test[kMaxCoeffs]);
+  for (int iter = 0; iter < 1000; ++iter) {
+    const int bd = 8 + 2 * rnd_.PseudoUniform(3);
+    const int n = 1 + rnd_.PseudoUniform(kMaxCoeffs);
+    const int shift = rnd_.PseudoUniform(3);
+    const int dc_q = 4 + rnd_.PseudoUniform(21384 << (bd - 8) >> 2);
+    const int ac_q = 4 + rnd_.PseudoUniform(29244 << (bd - 8) >> 2);
+    // Signed levels as read by av1_read_coeffs_txb(), mostly small and some
+    // as large as the 20-bit mask lets them be.
+    const int max_level = rnd_.PseudoUniform(2) ? 16 : 0xfffff;
+    for (int i = 0; i < n; ++i) {
+      const int level =
+          rnd_.PseudoUniform(4) ? 0 : 1 + rnd_.PseudoUniform(max_level);
+      ref[i] = test[i] = rnd_.PseudoUniform(2) ? -level : level;
+    }
+    av1_dequant_coeffs_c(ref, n, dc_q, ac_q, shift, bd);
+    GetParam()(test, n, dc_q, ac_q, shift, bd);
+    ASSERT_EQ(memcmp(ref, test, n * sizeof(ref[0])), 0)
+        << "n " << n << " shift " << shift << " bd " << bd;
+  }
+}
+
+#if HAVE_SSE4_1
+INSTANTIATE_TEST_SUITE_P(SSE4_1, DequantCoeffsTest,
+                         ::testing::Values(av1_dequant_coeffs_sse4_1));
+#endif  // HAVE_SSE4_1
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_SUITE_P(AVX2, DequantCoeffsTest,
+                         ::testing::Values(av1_dequant_coeffs_avx2));
+#endif  // HAVE_AVX2
+
+#if HAVE_NEON
+INSTANTIATE_TEST_SUITE_P(NEON, DequantCoeffsTest,
+                         ::testing::Values(av1_dequant_coeffs_neon));
+#endif  // HAVE_NEON
+
+}  // namespace
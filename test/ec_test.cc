@@ -11,12 +11,19 @@
 
 #include "third_party/googletest/src/googletest/include/gtest/gtest.h"
 
+#include <cstdio>
 #include <cstdlib>
 #include <memory>
 #include <new>
+#include <vector>
+
+#include "config/aom_config.h"
+#include "config/aom_dsp_rtcd.h"
 
 #include "aom_dsp/entenc.h"
 #include "aom_dsp/entdec.h"
+#include "aom_ports/aom_timer.h"
+#include "test/acm_random.h"
 
 TEST(EC_TEST, random_ec_test) {
   od_ec_enc enc;
@@ -152,3 +159,137 @@ TEST(EC_TEST, random_ec_test) {
   od_ec_enc_clear(&enc);
   EXPECT_EQ(ret, 0);
 }
+
+namespace {
+
+typedef int (*DecodeCdfFunc)(struct od_ec_dec *dec, const uint16_t *icdf,
+                             int nsyms);
+
+// Encodes symbols drawn from a set of random CDFs of 2 to 16 symbols, and
+// checks that a version of od_ec_decode_cdf_q15() decodes them like the C
+// version.
+class ECDecodeCdfTest : public ::testing::TestWithParam<DecodeCdfFunc> {
+ protected:
+  static const int kNumCdfs = 64;
+
+  void SetUp() override {
+    rnd_.Reset(libaom_test::ACMRandom::DeterministicSeed());
+  }
+
+  // Builds kNumCdfs random inverse CDFs of min_nsyms to max_nsyms symbols.
+  // Each array holds exactly nsyms values so that reading past the end of it
+  // is caught by the sanitizers.
+  void MakeCdfs(int min_nsyms, int max_nsyms) {
+    cdfs_.clear();
+    for (int i = 0; i < kNumCdfs; ++i) {
+      const int nsyms =
+          min_nsyms + static_cast<int>(rnd_(max_nsyms - min_nsyms + 1));
+      std::vector<uint16_t> icdf(nsyms);
+      // Give every symbol a non-zero probability, and some symbols the
+      // minimum probability.
+      int cdf = 0;
+      for (int s = 0; s < nsyms - 1; ++s) {
+        const int room = CDF_PROB_TOP - cdf - (nsyms - 1 - s);
+        const int max_step = AOMMAX(room / (nsyms - 1 - s) * 2, 1);
+        cdf += rnd_(4) ? 1 + static_cast<int>(rnd_(max_step)) : 1;
+        cdf = AOMMIN(cdf, CDF_PROB_TOP - (nsyms - 1 - s));
+        icdf[s] = OD_ICDF(cdf);
+      }
+      icdf[nsyms - 1] = OD_ICDF(CDF_PROB_TOP);
+      cdfs_.push_back(icdf);
+    }
+  }
+
+  // Encodes num_symbols symbols, sampled according to their CDFs.
+  void EncodeSymbols(int num_symbols) {
+    od_ec_enc enc;
+    od_ec_enc_init(&enc, 1);
+    cdf_index_.resize(num_symbols);
+    symbols_.resize(num_symbols);
+    for (int i = 0; i < num_symbols; ++i) {
+      const int index = rnd_(kNumCdfs);
+      const std::vector<uint16_t> &icdf = cdfs_[index];
+      const int nsyms = static_cast<int>(icdf.size());
+      const int u = rnd_(CDF_PROB_TOP);
+      int s = 0;
+      while (s < nsyms - 1 && OD_ICDF(icdf[s]) <= u) ++s;
+      cdf_index_[i] = index;
+      symbols_[i] = s;
+      od_ec_encode_cdf_q15(&enc, s, icdf.data(), nsyms);
+    }
+    uint32_t size;
+    const unsigned char *buf = od_ec_enc_done(&enc, &size);
+    ASSERT_NE(buf, nullptr);
+    buf_.assign(buf, buf + size);
+    od_ec_enc_clear(&enc);
+  }
+
+  void CheckDecode(DecodeCdfFunc decode) {
+    od_ec_dec dec;
+    od_ec_dec_init(&dec, buf_.data(), static_cast<uint32_t>(buf_.size()));
+    for (size_t i = 0; i < symbols_.size(); ++i) {
+      const std::vector<uint16_t> &icdf = cdfs_[cdf_index_[i]];
+      const int nsyms = static_cast<int>(icdf.size());
+      ASSERT_EQ(decode(&dec, icdf.data(), nsyms), symbols_[i])
+          << "symbol " << i << " of " << nsyms;
+    }
+  }
+
+  // Returns the number of symbols decoded per second.
+  double TimeDecode(DecodeCdfFunc decode, int num_loops) {
+    aom_usec_timer timer;
+    int sum = 0;
+    aom_usec_timer_start(&timer);
+    for (int loop = 0; loop < num_loops; ++loop) {
+      od_ec_dec dec;
+      od_ec_dec_init(&dec, buf_.data(), static_cast<uint32_t>(buf_.size()));
+      for (size_t i = 0; i < symbols_.size(); ++i) {
+        const std::vector<uint16_t> &icdf = cdfs_[cdf_index_[i]];
+        sum += decode(&dec, icdf.data(), static_cast<int>(icdf.size()));
+      }
+    }
+    aom_usec_timer_mark(&timer);
+    EXPECT_GT(sum, 0);
+    const double elapsed = static_cast<double>(aom_usec_timer_elapsed(&timer));
+    return 1e6 * num_loops * symbols_.size() / AOMMAX(elapsed, 1.0);
+  }
+
+  libaom_test::ACMRandom rnd_;
+  std::vector<std::vector<uint16_t>> cdfs_;
+  std::vector<int> cdf_index_;
+  std::vector<int> symbols_;
+  std::vector<unsigned char> buf_;
+};
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(ECDecodeCdfTest);
+
+TEST_P(ECDecodeCdfTest, MatchesC) {
+  for (int nsyms = 2; nsyms <= 16; ++nsyms) {
+    MakeCdfs(nsyms, nsyms);
+    EncodeSymbols(20000);
+    CheckDecode(od_ec_decode_cdf_q15_c);
+    CheckDecode(GetParam());
+  }
+  MakeCdfs(2, 16);
+  EncodeSymbols(100000);
+  CheckDecode(GetParam());
+}
+
+TEST_P(ECDecodeCdfTest, DISABLED_Speed) {
+  static const int kAlphabets[][2] = { { 2, 2 },   { 4, 4 },  { 8, 8 },
+                                       { 9, 12 },  { 13, 16 }, { 2, 16 } };
+  for (const auto &alphabet : kAlphabets) {
+    MakeCdfs(alphabet[0], alphabet[1]);
+    EncodeSymbols(1 << 20);
+    const double c_rate = TimeDecode(od_ec_decode_cdf_q15_c, 10);
+    const double simd_rate = TimeDecode(GetParam(), 10);
+    printf("nsyms %2d-%2d: %6.1f / %6.1f Msymbols/s (%3.2f)\n", alphabet[0],
+           alphabet[1], c_rate / 1e6, simd_rate / 1e6, simd_rate / c_rate);
+  }
+}
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_SUITE_P(SSE2, ECDecodeCdfTest,
+                         ::testing::Values(od_ec_decode_cdf_q15_sse2));
+#endif
+
+}  // namespace
@@ -181,6 +181,17 @@ TEST_P(AVxFrameParallelThreadEncodeLowResTest, FrameParallelThreadEncodeTest) {
   DoTest(&video);
 }
 
+class AVxFrameParallelThreadEncodeCBRTest
+    : public AVxFrameParallelThreadEncodeTest {};
+
+TEST_P(AVxFrameParallelThreadEncodeCBRTest, FrameParallelThreadEncodeTest) {
+  ::libaom_test::YUVVideoSource video("hantro_collage_w352h288.yuv",
+                                      AOM_IMG_FMT_I420, 352, 288, 30, 1, 0, 60);
+  cfg_.rc_end_usage = AOM_CBR;
+  cfg_.rc_target_bitrate = 200;
+  DoTest(&video);
+}
+
 AV1_INSTANTIATE_TEST_SUITE(AVxFrameParallelThreadEncodeHDResTestLarge,
                            ::testing::Values(2, 3, 4, 5, 6),
                            ::testing::Values(0, 1, 2), ::testing::Values(0, 1));
@@ -192,6 +203,10 @@ AV1_INSTANTIATE_TEST_SUITE(AVxFrameParallelThreadEncodeLowResTestLarge,
 AV1_INSTANTIATE_TEST_SUITE(AVxFrameParallelThreadEncodeLowResTest,
                            ::testing::Values(4, 5, 6), ::testing::Values(1),
                            ::testing::Values(0));
+
+AV1_INSTANTIATE_TEST_SUITE(AVxFrameParallelThreadEncodeCBRTest,
+                           ::testing::Values(4, 6), ::testing::Values(1),
+                           ::testing::Values(0));
 #endif  // CONFIG_FPMT_TEST && !CONFIG_REALTIME_ONLY
 
 }  // namespace
@@ -0,0 +1,421 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <string.h>
+#include <tuple>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+
+#include "config/aom_config.h"
+#include "config/av1_rtcd.h"
+
+#include "aom/aom_image.h"
+#include "aom_ports/mem.h"
+#include "aom_util/aom_thread.h"
+#include "av1/decoder/grain_synthesis.h"
+#include "test/acm_random.h"
+#include "test/util.h"
+
+namespace {
+
+using libaom_test::ACMRandom;
+
+// Largest chroma block the grain is added to in one call.
+const int kMaxWidth = 36;
+const int kMaxHeight = 34;
+const int kStride = 2 * kMaxWidth + 8;
+const int kBufSize = kMaxHeight * kStride;
+
+typedef void (*AddLumaGrainFunc)(uint8_t *luma, int luma_stride,
+                                 const int *grain, int grain_stride,
+                                 const int *scaling_lut, int width, int height,
+                                 int scaling_shift, int min_val, int max_val);
+typedef void (*HighbdAddLumaGrainFunc)(uint16_t *luma, int luma_stride,
+                                       const int *grain, int grain_stride,
+                                       const int *scaling_lut, int width,
+                                       int height, int scaling_shift,
+                                       int min_val, int max_val);
+typedef void (*AddChromaGrainFunc)(
+    uint8_t *chroma, int chroma_stride, const uint8_t *luma, int luma_stride,
+    const int *grain, int grain_stride, const int *scaling_lut, int width,
+    int height, int chroma_subsamp_x, int luma_mult, int mult, int offset,
+    int scaling_shift, int min_val, int max_val);
+typedef void (*HighbdAddChromaGrainFunc)(
+    uint16_t *chroma, int chroma_stride, const uint16_t *luma, int luma_stride,
+    const int *grain, int grain_stride, const int *scaling_lut, int width,
+    int height, int chroma_subsamp_x, int luma_mult, int mult, int offset,
+    int scaling_shift, int min_val, int max_val, int bd);
+
+// Random grain, scaling function and block parameters for one kernel call.
+class GrainKernelTestBase {
+ protected:
+  void Randomize(int bd) {
+    const int grain_center = 128 << (bd - 8);
+    for (int i = 0; i < kBufSize; ++i) {
+      grain_[i] = rnd_.PseudoUniform(2 * grain_center) - grain_center;
+    }
+    for (int i = 0; i < (256 << (bd - 8)); ++i) {
+      scaling_lut_[i] = rnd_.Rand8();
+    }
+    width_ = rnd_.PseudoUniform(kMaxWidth + 1);
+    height_ = rnd_.PseudoUniform(kMaxHeight + 1);
+    scaling_shift_ = 8 + rnd_.PseudoUniform(4);
+    chroma_subsamp_x_ = rnd_.PseudoUniform(2);
+    luma_mult_ = rnd_.PseudoUniform(256) - 128;
+    mult_ = rnd_.PseudoUniform(256) - 128;
+    offset_ = (rnd_.PseudoUniform(512) << (bd - 8)) - (1 << bd);
+    if (rnd_.PseudoUniform(2)) {
+      min_val_ = 16 << (bd - 8);
+      max_val_ = 235 << (bd - 8);
+    } else {
+      min_val_ = 0;
+      max_val_ = (1 << bd) - 1;
+    }
+  }
+
+  ACMRandom rnd_{ ACMRandom::DeterministicSeed() };
+  int grain_[kBufSize];
+  int scaling_lut_[4096];
+  int width_;
+  int height_;
+  int scaling_shift_;
+  int chroma_subsamp_x_;
+  int luma_mult_;
+  int mult_;
+  int offset_;
+  int min_val_;
+  int max_val_;
+};
+
+class AddLumaGrainTest : public GrainKernelTestBase,
+                         public ::testing::TestWithParam<AddLumaGrainFunc> {};
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(AddLumaGrainTest);
+
+TEST_P(AddLumaGrainTest, MatchesC) {
+  DECLARE_ALIGNED(32, uint8_t, ref[kBufSize]);
+  DECLARE_ALIGNED(32, uint8_t, test[kBufSize]);
+  for (int iter = 0; iter < 1000; ++iter) {
+    Randomize(8);
+    for (int i = 0; i < kBufSize; ++i) ref[i] = test[i] = rnd_.Rand8();
+    const int width = width_ << 1;
+    av1_add_luma_grain_c(ref, kStride, grain_, kStride, scaling_lut_, width,
+                         height_, scaling_shift_, min_val_, max_val_);
+    GetParam()(test, kStride, grain_, kStride, scaling_lut_, width, height_,
+               scaling_shift_, min_val_, max_val_);
+    ASSERT_EQ(memcmp(ref, test, sizeof(ref)), 0)
+        << "width " << width << " height " << height_;
+  }
+}
+
+class HighbdAddLumaGrainTest
+    : public GrainKernelTestBase,
+      public ::testing::TestWithParam<std::tuple<HighbdAddLumaGrainFunc, int>> {
+};
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(HighbdAddLumaGrainTest);
+
+TEST_P(HighbdAddLumaGrainTest, MatchesC) {
+  const int bd = GET_PARAM(1);
+  DECLARE_ALIGNED(32, uint16_t, ref[kBufSize]);
+  DECLARE_ALIGNED(32, uint16_t, test[kBufSize]);
+  for (int iter = 0; iter < 1000; ++iter) {
+    Randomize(bd);
+    for (int i = 0; i < kBufSize; ++i) {
+      ref[i] = test[i] = rnd_.Rand16() & ((1 << bd) - 1);
+    }
+    const int width = width_ << 1;
+    av1_highbd_add_luma_grain_c(ref, kStride, grain_, kStride, scaling_lut_,
+                                width, height_, scaling_shift_, min_val_,
+                                max_val_);
+    GET_PARAM(0)(test, kStride, grain_, kStride, scaling_lut_, width, height_,
+                 scaling_shift_, min_val_, max_val_);
+    ASSERT_EQ(memcmp(ref, test, sizeof(ref)), 0)
+        << "width " << width << " height " << height_;
+  }
+}
+
+class AddChromaGrainTest : public GrainKernelTestBase,
+                           public ::testing::TestWithParam<AddChromaGrainFunc> {
+};
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(AddChromaGrainTest);
+
+TEST_P(AddChromaGrainTest, MatchesC) {
+  DECLARE_ALIGNED(32, uint8_t, luma[kBufSize]);
+  DECLARE_ALIGNED(32, uint8_t, ref[kBufSize]);
+  DECLARE_ALIGNED(32, uint8_t, test[kBufSize]);
+  for (int iter = 0; iter < 1000; ++iter) {
+    Randomize(8);
+    for (int i = 0; i < kBufSize; ++i) {
+      luma[i] = rnd_.Rand8();
+      ref[i] = test[i] = rnd_.Rand8();
+    }
+    av1_add_chroma_grain_c(ref, kStride, luma, kStride, grain_, kStride,
+                           scaling_lut_, width_, height_, chroma_subsamp_x_,
+                           luma_mult_, mult_, offset_, scaling_shift_,
+                           min_val_, max_val_);
+    GetParam()(test, kStride, luma, kStride, grain_, kStride, scaling_lut_,
+               width_, height_, chroma_subsamp_x_, luma_mult_, mult_, offset_,
+               scaling_shift_, min_val_, max_val_);
+    ASSERT_EQ(memcmp(ref, test, sizeof(ref)), 0)
+        << "width " << width_ << " height " << height_ << " subsampling "
+        << chroma_subsamp_x_;
+  }
+}
+
+class HighbdAddChromaGrainTest
+    : public GrainKernelTestBase,
+      public ::testing::TestWithParam<
+          std::tuple<HighbdAddChromaGrainFunc, int>> {};
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(HighbdAddChromaGrainTest);
+
+TEST_P(HighbdAddChromaGrainTest, MatchesC) {
+  const int bd = GET_PARAM(1);
+  DECLARE_ALIGNED(32, uint16_t, luma[kBufSize]);
+  DECLARE_ALIGNED(32, uint16_t, ref[kBufSize]);
+  DECLARE_ALIGNED(32, uint16_t, test[kBufSize]);
+  for (int iter = 0; iter < 1000; ++iter) {
+    Randomize(bd);
+    for (int i = 0; i < kBufSize; ++i) {
+      luma[i] = rnd_.Rand16() & ((1 << bd) - 1);
+      ref[i] = test[i] = rnd_.Rand16() & ((1 << bd) - 1);
+    }
+    av1_highbd_add_chroma_grain_c(ref, kStride, luma, kStride, grain_, kStride,
+                                  scaling_lut_, width_, height_,
+                                  chroma_subsamp_x_, luma_mult_, mult_,
+                                  offset_, scaling_shift_, min_val_, max_val_,
+                                  bd);
+    GET_PARAM(0)(test, kStride, luma, kStride, grain_, kStride, scaling_lut_,
+                 width_, height_, chroma_subsamp_x_, luma_mult_, mult_,
+                 offset_, scaling_shift_, min_val_, max_val_, bd);
+    ASSERT_EQ(memcmp(ref, test, sizeof(ref)), 0)
+        << "width " << width_ << " height " << height_ << " subsampling "
+        << chroma_subsamp_x_;
+  }
+}
+
+#if HAVE_SSE4_1
+INSTANTIATE_TEST_SUITE_P(SSE4_1, AddLumaGrainTest,
+                         ::testing::Values(av1_add_luma_grain_sse4_1));
+INSTANTIATE_TEST_SUITE_P(
+    SSE4_1, HighbdAddLumaGrainTest,
+    ::testing::Combine(::testing::Values(av1_highbd_add_luma_grain_sse4_1),
+                       ::testing::Values(10, 12)));
+INSTANTIATE_TEST_SUITE_P(SSE4_1, AddChromaGrainTest,
+                         ::testing::Values(av1_add_chroma_grain_sse4_1));
+INSTANTIATE_TEST_SUITE_P(
+    SSE4_1, HighbdAddChromaGrainTest,
+    ::testing::Combine(::testing::Values(av1_highbd_add_chroma_grain_sse4_1),
+                       ::testing::Values(10, 12)));
+#endif  // HAVE_SSE4_1
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_SUITE_P(AVX2, AddLumaGrainTest,
+                         ::testing::Values(av1_add_luma_grain_avx2));
+INSTANTIATE_TEST_SUITE_P(
+    AVX2, HighbdAddLumaGrainTest,
+    ::testing::Combine(::testing::Values(av1_highbd_add_luma_grain_avx2),
+                       ::testing::Values(10, 12)));
+INSTANTIATE_TEST_SUITE_P(AVX2, AddChromaGrainTest,
+                         ::testing::Values(av1_add_chroma_grain_avx2));
+INSTANTIATE_TEST_SUITE_P(
+    AVX2, HighbdAddChromaGrainTest,
+    ::testing::Combine(::testing::Values(av1_highbd_add_chroma_grain_avx2),
+                       ::testing::Values(10, 12)));
+#endif  // HAVE_AVX2
+
+// Image format, bit depth and overlap flag.
+typedef std::tuple<aom_img_fmt_t, int, int> FilmGrainMTParam;
+
+// Checks that splitting the rows between workers and adding the grain in place
+// give the same image as the single-threaded path.
+class FilmGrainMTTest : public ::testing::TestWithParam<FilmGrainMTParam> {
+ protected:
+  static const int kNumWorkers = 4;
+  // Odd dimensions exercise the extension of the last row and column.
+  static const int kWidth = 353;
+  static const int kHeight = 287;
+
+  void SetUp() override {
+    const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+    for (int i = 0; i < kNumWorkers; ++i) {
+      winterface->init(&workers_[i]);
+      if (i > 0) {
+        ASSERT_TRUE(winterface->reset(&workers_[i]));
+      }
+    }
+  }
+
+  void TearDown() override {
+    const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+    for (int i = 0; i < kNumWorkers; ++i) winterface->end(&workers_[i]);
+  }
+
+  void RandomPoints(int points[][2], int num_points) {
+    int x = 0;
+    for (int i = 0; i < num_points; ++i) {
+      x += 1 + rnd_.PseudoUniform(255 / num_points);
+      points[i][0] = x;
+      points[i][1] = rnd_.Rand8();
+    }
+  }
+
+  void RandomParams(aom_film_grain_t *params) {
+    const int bd = GET_PARAM(1);
+    memset(params, 0, sizeof(*params));
+    params->apply_grain = 1;
+    params->bit_depth = bd;
+    params->num_y_points = 1 + rnd_.PseudoUniform(14);
+    RandomPoints(params->scaling_points_y, params->num_y_points);
+    params->num_cb_points = 1 + rnd_.PseudoUniform(10);
+    RandomPoints(params->scaling_points_cb, params->num_cb_points);
+    params->num_cr_points = 1 + rnd_.PseudoUniform(10);
+    RandomPoints(params->scaling_points_cr, params->num_cr_points);
+    params->scaling_shift = 8 + rnd_.PseudoUniform(4);
+    params->ar_coeff_lag = rnd_.PseudoUniform(4);
+    for (int i = 0; i < 24; ++i) params->ar_coeffs_y[i] = rnd_.Rand8() - 128;
+    for (int i = 0; i < 25; ++i) {
+      params->ar_coeffs_cb[i] = rnd_.Rand8() - 128;
+      params->ar_coeffs_cr[i] = rnd_.Rand8() - 128;
+    }
+    params->ar_coeff_shift = 6 + rnd_.PseudoUniform(4);
+    params->cb_mult = rnd_.Rand8();
+    params->cb_luma_mult = rnd_.Rand8();
+    params->cb_offset = rnd_.PseudoUniform(512);
+    params->cr_mult = rnd_.Rand8();
+    params->cr_luma_mult = rnd_.Rand8();
+    params->cr_offset = rnd_.PseudoUniform(512);
+    params->overlap_flag = GET_PARAM(2);
+    params->clip_to_restricted_range = rnd_.PseudoUniform(2);
+    params->grain_scale_shift = rnd_.PseudoUniform(4);
+    params->random_seed = rnd_.Rand16();
+  }
+
+  // Number of allocated rows of the plane.
+  static int PlaneHeight(const aom_image_t &img, int plane) {
+    return plane ? (kHeight + 1) >> img.y_chroma_shift : kHeight + 1;
+  }
+
+  // Allocates an image with even dimensions and sets its display size to the
+  // odd one, like the decoder output.
+  void AllocImage(aom_image_t *img) {
+    ASSERT_NE(aom_img_alloc(img, GET_PARAM(0), kWidth + 1, kHeight + 1, 32),
+              nullptr);
+    img->d_w = kWidth;
+    img->d_h = kHeight;
+    img->bit_depth = GET_PARAM(1);
+  }
+
+  void AllocRandomImage(aom_image_t *img) {
+    AllocImage(img);
+    const int bd = GET_PARAM(1);
+    const int use_hbd = (img->fmt & AOM_IMG_FMT_HIGHBITDEPTH) ? 1 : 0;
+    for (int plane = 0; plane < 3; ++plane) {
+      for (int r = 0; r < PlaneHeight(*img, plane); ++r) {
+        uint8_t *const row = img->planes[plane] + r * img->stride[plane];
+        for (int c = 0; c < img->stride[plane] >> use_hbd; ++c) {
+          if (use_hbd) {
+            reinterpret_cast<uint16_t *>(row)[c] =
+                rnd_.Rand16() & ((1 << bd) - 1);
+          } else {
+            row[c] = rnd_.Rand8();
+          }
+        }
+      }
+    }
+  }
+
+  // Compares the displayed area, plus the chroma samples of an odd column or
+  // row.
+  void ExpectImagesEqual(const aom_image_t &ref, const aom_image_t &test) {
+    const int use_hbd = (ref.fmt & AOM_IMG_FMT_HIGHBITDEPTH) ? 1 : 0;
+    for (int plane = 0; plane < 3; ++plane) {
+      const int plane_width =
+          plane ? (kWidth + 1) >> ref.x_chroma_shift : kWidth;
+      const int plane_height =
+          plane ? (kHeight + 1) >> ref.y_chroma_shift : kHeight;
+      for (int r = 0; r < plane_height; ++r) {
+        ASSERT_EQ(memcmp(ref.planes[plane] + r * ref.stride[plane],
+                         test.planes[plane] + r * test.stride[plane],
+                         plane_width << use_hbd),
+                  0)
+            << "plane " << plane << " row " << r;
+      }
+    }
+  }
+
+  ACMRandom rnd_{ ACMRandom::DeterministicSeed() };
+  AVxWorker workers_[kNumWorkers];
+};
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(FilmGrainMTTest);
+
+TEST_P(FilmGrainMTTest, MatchesSingleThread) {
+  aom_image_t src;
+  AllocRandomImage(&src);
+  aom_image_t ref;
+  aom_image_t test;
+  AllocImage(&ref);
+  AllocImage(&test);
+  for (int iter = 0; iter < 4; ++iter) {
+    aom_film_grain_t params;
+    RandomParams(&params);
+    ASSERT_EQ(av1_add_film_grain(&params, &src, &ref), 0);
+    for (int num_workers = 2; num_workers <= kNumWorkers; ++num_workers) {
+      SCOPED_TRACE(num_workers);
+      ASSERT_EQ(
+          av1_add_film_grain_mt(&params, &src, &test, workers_, num_workers),
+          0);
+      ASSERT_NO_FATAL_FAILURE(ExpectImagesEqual(ref, test));
+    }
+  }
+  aom_img_free(&src);
+  aom_img_free(&ref);
+  aom_img_free(&test);
+}
+
+TEST_P(FilmGrainMTTest, InPlaceMatchesCopy) {
+  aom_image_t src;
+  AllocRandomImage(&src);
+  aom_image_t ref;
+  aom_image_t test;
+  AllocImage(&ref);
+  AllocImage(&test);
+  for (int iter = 0; iter < 4; ++iter) {
+    aom_film_grain_t params;
+    RandomParams(&params);
+    ASSERT_EQ(av1_add_film_grain(&params, &src, &ref), 0);
+    for (int num_workers = 0; num_workers <= kNumWorkers; num_workers += 2) {
+      SCOPED_TRACE(num_workers);
+      for (int plane = 0; plane < 3; ++plane) {
+        memcpy(test.planes[plane], src.planes[plane],
+               src.stride[plane] * PlaneHeight(src, plane));
+      }
+      ASSERT_EQ(
+          av1_add_film_grain_mt(&params, &test, &test, workers_, num_workers),
+          0);
+      ASSERT_NO_FATAL_FAILURE(ExpectImagesEqual(ref, test));
+    }
+  }
+  aom_img_free(&src);
+  aom_img_free(&ref);
+  aom_img_free(&test);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    C, FilmGrainMTTest,
+    ::testing::Values(
+        std::make_tuple(AOM_IMG_FMT_I420, 8, 0),
+        std::make_tuple(AOM_IMG_FMT_I420, 8, 1),
+        std::make_tuple(AOM_IMG_FMT_I422, 8, 1),
+        std::make_tuple(AOM_IMG_FMT_I444, 8, 1),
+        std::make_tuple(AOM_IMG_FMT_I42016, 10, 0),
+        std::make_tuple(AOM_IMG_FMT_I42016, 10, 1),
+        std::make_tuple(AOM_IMG_FMT_I44416, 12, 1)));
+
+}  // namespace
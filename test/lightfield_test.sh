@@ -90,6 +90,19 @@ lightfield_test() {
 
   [ -e "${tl_outfile}" ] || return 1
 
+  # Run lightfield tile list decoder with multiple threads.
+  local tl_mt_outfile="${AOM_TEST_OUTPUT_DIR}/vase_tile_list_mt.yuv"
+  eval "${AOM_TEST_PREFIX}" "${tl_decoder}" "${tl_file}" "${tl_mt_outfile}" \
+      "${num_references}" "${num_tile_lists}" 0 4 ${devnull} || return 1
+
+  [ -e "${tl_mt_outfile}" ] || return 1
+
+  # The multi-threaded output must match the single-threaded output.
+  diff ${tl_outfile} ${tl_mt_outfile} > /dev/null
+  if [ $? -eq 1 ]; then
+    return 1
+  fi
+
   # Run reference lightfield decoder
   local ref_decoder="${LIBAOM_BIN_PATH}/lightfield_decoder${AOM_TEST_EXE_SUFFIX}"
   local tl_reffile="${AOM_TEST_OUTPUT_DIR}/vase_reference.yuv"
@@ -52,7 +52,9 @@ add_to_libaom_test_srcs(AOM_UNIT_TEST_COMMON_SOURCES)
 
 list(APPEND AOM_UNIT_TEST_DECODER_SOURCES "${AOM_ROOT}/test/decode_api_test.cc"
             "${AOM_ROOT}/test/decode_scalability_test.cc"
+            "${AOM_ROOT}/test/decodetxb_test.cc"
             "${AOM_ROOT}/test/external_frame_buffer_test.cc"
+            "${AOM_ROOT}/test/grain_synthesis_test.cc"
             "${AOM_ROOT}/test/invalid_file_test.cc"
             "${AOM_ROOT}/test/test_vector_test.cc"
             "${AOM_ROOT}/test/ivf_video_source.h")
@@ -252,7 +254,11 @@ if(NOT BUILD_SHARED_LIBS)
                 "${AOM_ROOT}/test/binary_codes_test.cc"
                 "${AOM_ROOT}/test/boolcoder_test.cc"
                 "${AOM_ROOT}/test/cnn_test.cc"
+                "${AOM_ROOT}/test/decode_frame_limits_test.cc"
+                "${AOM_ROOT}/test/decode_mi_info_test.cc"
+                "${AOM_ROOT}/test/decode_mode_test.cc"
                 "${AOM_ROOT}/test/decode_multithreaded_test.cc"
+                "${AOM_ROOT}/test/decode_output_format_test.cc"
                 "${AOM_ROOT}/test/divu_small_test.cc"
                 "${AOM_ROOT}/test/dr_prediction_test.cc"
                 "${AOM_ROOT}/test/ec_test.cc"
@@ -285,6 +291,7 @@ if(NOT BUILD_SHARED_LIBS)
                      "${AOM_ROOT}/test/av1_ext_tile_test.cc"
                      "${AOM_ROOT}/test/cnn_test.cc"
                      "${AOM_ROOT}/test/decode_multithreaded_test.cc"
+                     "${AOM_ROOT}/test/decode_output_format_test.cc"
                      "${AOM_ROOT}/test/error_resilience_test.cc"
                      "${AOM_ROOT}/test/kf_test.cc"
                      "${AOM_ROOT}/test/lossless_test.cc"
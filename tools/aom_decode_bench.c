@@ -0,0 +1,362 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+// Decoder benchmark.
+//
+// Decodes each input stream from memory with every combination of the given
+// thread counts and row-mt settings, and writes the decoding speed, the time
+// spent in each decoding stage and the utilization of the tile workers as
+// JSON. The tile layout of a stream is fixed by its encoder, so layouts are
+// compared by passing one stream per layout; the layout of each stream is
+// reported with its results.
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config/aom_config.h"
+
+#include "aom/aom_decoder.h"
+#include "aom/aomdx.h"
+#include "aom_ports/aom_timer.h"
+#include "common/ivfdec.h"
+#include "common/obudec.h"
+#include "common/tools_common.h"
+
+#define MAX_SWEEP 16
+
+typedef struct {
+  uint8_t *data;
+  size_t size;
+} TemporalUnit;
+
+typedef struct {
+  TemporalUnit *units;
+  int num_units;
+  int is_annexb;
+} Stream;
+
+typedef struct {
+  int threads[MAX_SWEEP];
+  int num_threads;
+  int row_mt[2];
+  int num_row_mt;
+  int loops;
+  int annexb;
+  const char *output;
+} BenchConfig;
+
+typedef struct {
+  int64_t decode_us;
+  int frames;
+  int width;
+  int height;
+  int bit_depth;
+  aom_tile_info tile_info;
+  aom_decode_stage_stats_t stages;
+} BenchResult;
+
+static void usage(void) {
+  fprintf(stderr,
+          "Usage: aom_decode_bench [options] <input files>\n"
+          "Options:\n"
+          "  --threads=<list>  Comma separated thread counts (default 1)\n"
+          "  --row-mt=<list>   Comma separated row-mt settings, 0 or 1 "
+          "(default 1)\n"
+          "  --loops=<n>       Times each stream is decoded (default 1)\n"
+          "  --annexb          OBU inputs are in Annex B format\n"
+          "  --output=<file>   JSON output file (default stdout)\n"
+          "Inputs are IVF or OBU files.\n");
+  exit(EXIT_FAILURE);
+}
+
+static int parse_list(const char *arg, int *values, int max_values) {
+  int num_values = 0;
+  while (*arg != '\0') {
+    char *end;
+    const long value = strtol(arg, &end, 10);
+    if (end == arg || value < 0 || num_values == max_values) return -1;
+    values[num_values++] = (int)value;
+    if (*end == ',') ++end;
+    arg = end;
+  }
+  return num_values;
+}
+
+// Reads all the temporal units of a file into memory.
+static void read_stream(const char *filename, int annexb, Stream *stream) {
+  struct AvxInputContext input;
+  struct ObuDecInputContext obu_ctx;
+  memset(&input, 0, sizeof(input));
+  memset(&obu_ctx, 0, sizeof(obu_ctx));
+  memset(stream, 0, sizeof(*stream));
+  obu_ctx.avx_ctx = &input;
+  obu_ctx.is_annexb = annexb;
+  input.filename = filename;
+  input.file = fopen(filename, "rb");
+  if (!input.file) fatal("Failed to open %s", filename);
+
+  if (file_is_ivf(&input)) {
+    input.file_type = FILE_TYPE_IVF;
+  } else if (file_is_obu(&obu_ctx)) {
+    input.file_type = FILE_TYPE_OBU;
+    stream->is_annexb = obu_ctx.is_annexb;
+  } else {
+    die("%s is not an IVF or OBU file.\n", filename);
+  }
+
+  int capacity = 0;
+  for (;;) {
+    uint8_t *buf = NULL;
+    size_t bytes = 0;
+    size_t buffer_size = 0;
+    const int status =
+        input.file_type == FILE_TYPE_IVF
+            ? ivf_read_frame(&input, &buf, &bytes, &buffer_size, NULL)
+            : obudec_read_temporal_unit(&obu_ctx, &buf, &bytes, &buffer_size);
+    if (status < 0) die("Failed to read %s.\n", filename);
+    if (status) {
+      free(buf);
+      break;
+    }
+    if (stream->num_units == capacity) {
+      capacity = capacity ? 2 * capacity : 64;
+      stream->units = (TemporalUnit *)realloc(
+          stream->units, capacity * sizeof(*stream->units));
+      if (!stream->units) die("Failed to allocate the temporal units.\n");
+    }
+    // Each unit keeps the buffer it was read into.
+    TemporalUnit *const unit = &stream->units[stream->num_units++];
+    unit->data = buf;
+    unit->size = bytes;
+  }
+  if (input.file_type == FILE_TYPE_OBU) obudec_free(&obu_ctx);
+  fclose(input.file);
+}
+
+static void free_stream(Stream *stream) {
+  for (int i = 0; i < stream->num_units; ++i) free(stream->units[i].data);
+  free(stream->units);
+}
+
+static void add_stage_stats(aom_decode_stage_stats_t *sum,
+                            const aom_decode_stage_stats_t *stats) {
+  sum->obu_parse_us += stats->obu_parse_us;
+  sum->tile_decode_us += stats->tile_decode_us;
+  sum->entropy_decode_us += stats->entropy_decode_us;
+  sum->reconstruction_us += stats->reconstruction_us;
+  sum->loop_filter_us += stats->loop_filter_us;
+  sum->cdef_us += stats->cdef_us;
+  sum->superres_us += stats->superres_us;
+  sum->loop_restoration_us += stats->loop_restoration_us;
+  sum->film_grain_us += stats->film_grain_us;
+  sum->worker_busy_us += stats->worker_busy_us;
+  sum->worker_idle_us += stats->worker_idle_us;
+}
+
+// Decodes the stream config->loops times with a new decoder each time. Only
+// aom_codec_decode() and aom_codec_get_frame() are timed.
+static void run_bench(const Stream *stream, const BenchConfig *config,
+                      int threads, int row_mt, BenchResult *result) {
+  memset(result, 0, sizeof(*result));
+  for (int loop = 0; loop < config->loops; ++loop) {
+    aom_codec_ctx_t decoder;
+    aom_codec_dec_cfg_t cfg = { 0, 0, 0, !FORCE_HIGHBITDEPTH_DECODING };
+    cfg.threads = threads;
+    if (aom_codec_dec_init(&decoder, aom_codec_av1_dx(), &cfg, 0))
+      die("Failed to initialize the decoder.\n");
+    if (AOM_CODEC_CONTROL_TYPECHECKED(&decoder, AV1D_SET_ROW_MT,
+                                      (unsigned int)row_mt) ||
+        AOM_CODEC_CONTROL_TYPECHECKED(&decoder, AV1D_SET_IS_ANNEXB,
+                                      (unsigned int)stream->is_annexb) ||
+        AOM_CODEC_CONTROL_TYPECHECKED(&decoder, AV1D_SET_STAGE_STATS, 1)) {
+      die_codec(&decoder, "Failed to configure the decoder");
+    }
+
+    for (int i = 0; i < stream->num_units; ++i) {
+      const TemporalUnit *const unit = &stream->units[i];
+      struct aom_usec_timer timer;
+      aom_usec_timer_start(&timer);
+      if (aom_codec_decode(&decoder, unit->data, unit->size, NULL))
+        die_codec(&decoder, "Failed to decode frame");
+      aom_codec_iter_t iter = NULL;
+      aom_image_t *img;
+      while ((img = aom_codec_get_frame(&decoder, &iter)) != NULL) {
+        ++result->frames;
+        result->width = (int)img->d_w;
+        result->height = (int)img->d_h;
+        result->bit_depth = (int)img->bit_depth;
+      }
+      aom_usec_timer_mark(&timer);
+      result->decode_us += aom_usec_timer_elapsed(&timer);
+
+      // The stats cover the last aom_codec_decode() call and the frames
+      // returned since.
+      aom_decode_stage_stats_t stats;
+      if (AOM_CODEC_CONTROL_TYPECHECKED(&decoder, AV1D_GET_STAGE_STATS,
+                                        &stats)) {
+        die_codec(&decoder, "Failed to get the stage stats");
+      }
+      add_stage_stats(&result->stages, &stats);
+    }
+    // A stream that ends with a frame without tiles has no tile info.
+    if (AOM_CODEC_CONTROL_TYPECHECKED(&decoder, AOMD_GET_TILE_INFO,
+                                      &result->tile_info)) {
+      memset(&result->tile_info, 0, sizeof(result->tile_info));
+    }
+    if (aom_codec_destroy(&decoder)) die("Failed to destroy the decoder.\n");
+  }
+}
+
+static void print_json_string(FILE *out, const char *str) {
+  fputc('"', out);
+  for (; *str != '\0'; ++str) {
+    if (*str == '"' || *str == '\\') {
+      fprintf(out, "\\%c", *str);
+    } else if ((unsigned char)*str < 0x20) {
+      fprintf(out, "\\u%04x", (unsigned char)*str);
+    } else {
+      fputc(*str, out);
+    }
+  }
+  fputc('"', out);
+}
+
+static void print_result(FILE *out, int threads, int row_mt,
+                         const BenchResult *result) {
+  const aom_decode_stage_stats_t *const s = &result->stages;
+  const double fps =
+      result->decode_us > 0 ? result->frames * 1e6 / result->decode_us : 0;
+  const int64_t worker_us = s->worker_busy_us + s->worker_idle_us;
+  const double utilization =
+      worker_us > 0 ? (double)s->worker_busy_us / worker_us : 0;
+  fprintf(out,
+          "        {\n"
+          "          \"threads\": %d,\n"
+          "          \"row_mt\": %d,\n"
+          "          \"frames\": %d,\n"
+          "          \"decode_us\": %" PRId64 ",\n"
+          "          \"fps\": %.3f,\n",
+          threads, row_mt, result->frames, result->decode_us, fps);
+  fprintf(out,
+          "          \"stages_us\": {\n"
+          "            \"obu_parse\": %" PRId64 ",\n"
+          "            \"tile_decode\": %" PRId64 ",\n"
+          "            \"entropy_decode\": %" PRId64 ",\n"
+          "            \"reconstruction\": %" PRId64 ",\n"
+          "            \"loop_filter\": %" PRId64 ",\n"
+          "            \"cdef\": %" PRId64 ",\n"
+          "            \"superres\": %" PRId64 ",\n"
+          "            \"loop_restoration\": %" PRId64 ",\n"
+          "            \"film_grain\": %" PRId64 "\n"
+          "          },\n",
+          s->obu_parse_us, s->tile_decode_us, s->entropy_decode_us,
+          s->reconstruction_us, s->loop_filter_us, s->cdef_us, s->superres_us,
+          s->loop_restoration_us, s->film_grain_us);
+  fprintf(out,
+          "          \"worker_busy_us\": %" PRId64 ",\n"
+          "          \"worker_idle_us\": %" PRId64 ",\n"
+          "          \"worker_utilization\": %.4f\n"
+          "        }",
+          s->worker_busy_us, s->worker_idle_us, utilization);
+}
+
+int main(int argc, char **argv) {
+  BenchConfig config;
+  memset(&config, 0, sizeof(config));
+  config.threads[0] = 1;
+  config.num_threads = 1;
+  config.row_mt[0] = 1;
+  config.num_row_mt = 1;
+  config.loops = 1;
+
+  int argi = 1;
+  for (; argi < argc && strncmp(argv[argi], "--", 2) == 0; ++argi) {
+    const char *const arg = argv[argi];
+    if (strncmp(arg, "--threads=", 10) == 0) {
+      config.num_threads = parse_list(arg + 10, config.threads, MAX_SWEEP);
+      if (config.num_threads <= 0) usage();
+      for (int i = 0; i < config.num_threads; ++i) {
+        if (config.threads[i] == 0) usage();
+      }
+    } else if (strncmp(arg, "--row-mt=", 9) == 0) {
+      config.num_row_mt = parse_list(arg + 9, config.row_mt, 2);
+      if (config.num_row_mt <= 0) usage();
+      for (int i = 0; i < config.num_row_mt; ++i) {
+        if (config.row_mt[i] > 1) usage();
+      }
+    } else if (strncmp(arg, "--loops=", 8) == 0) {
+      config.loops = atoi(arg + 8);
+      if (config.loops <= 0) usage();
+    } else if (strcmp(arg, "--annexb") == 0) {
+      config.annexb = 1;
+    } else if (strncmp(arg, "--output=", 9) == 0) {
+      config.output = arg + 9;
+    } else {
+      usage();
+    }
+  }
+  if (argi == argc) usage();
+
+  // Read all the streams first so that no output is written for a bad input.
+  const int num_streams = argc - argi;
+  Stream *const streams = (Stream *)calloc(num_streams, sizeof(*streams));
+  if (!streams) die("Failed to allocate the streams.\n");
+  for (int i = 0; i < num_streams; ++i) {
+    read_stream(argv[argi + i], config.annexb, &streams[i]);
+  }
+
+  FILE *const out = config.output ? fopen(config.output, "w") : stdout;
+  if (!out) fatal("Failed to open %s", config.output);
+
+  fprintf(out, "{\n  \"version\": ");
+  print_json_string(out, aom_codec_version_str());
+  fprintf(out, ",\n  \"loops\": %d,\n  \"streams\": [\n", config.loops);
+  for (int i = 0; i < num_streams; ++i) {
+    const Stream *const stream = &streams[i];
+    fprintf(out, "    {\n      \"file\": ");
+    print_json_string(out, argv[argi + i]);
+    fprintf(out, ",\n      \"temporal_units\": %d,\n", stream->num_units);
+
+    BenchResult result;
+    int first_run = 1;
+    for (int t = 0; t < config.num_threads; ++t) {
+      for (int r = 0; r < config.num_row_mt; ++r) {
+        run_bench(stream, &config, config.threads[t], config.row_mt[r],
+                  &result);
+        if (first_run) {
+          const aom_tile_info *const tiles = &result.tile_info;
+          fprintf(out,
+                  "      \"width\": %d,\n"
+                  "      \"height\": %d,\n"
+                  "      \"bit_depth\": %d,\n"
+                  "      \"tile_columns\": %d,\n"
+                  "      \"tile_rows\": %d,\n"
+                  "      \"runs\": [\n",
+                  result.width, result.height, result.bit_depth,
+                  tiles->tile_columns, tiles->tile_rows);
+          first_run = 0;
+        } else {
+          fprintf(out, ",\n");
+        }
+        print_result(out, config.threads[t], config.row_mt[r], &result);
+      }
+    }
+    fprintf(out, "\n      ]\n    }%s\n", i + 1 < num_streams ? "," : "");
+  }
+  fprintf(out, "  ]\n}\n");
+  if (out != stdout) fclose(out);
+
+  for (int i = 0; i < num_streams; ++i) free_stream(&streams[i]);
+  free(streams);
+  return EXIT_SUCCESS;
+}